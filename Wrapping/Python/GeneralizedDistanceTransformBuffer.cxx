@@ -0,0 +1,453 @@
+// Python entry point to itk::GeneralizedDistanceTransformImageFilter that
+// works on arrays instead of ITK images.
+//
+// The arrays can be NumPy arrays or any other object that supports the
+// buffer protocol. Neither the function array nor the output arrays are
+// copied: The function array is imported into an ITK image, and the filter
+// computes the distance and the voronoi map directly in the output arrays.
+// The Python interpreter lock is released during the computation, so other
+// Python threads can go on while the filter uses all of its threads.
+//
+// USAGE
+//   import GeneralizedDistanceTransformBuffer as gdt
+//   gdt.GeneralizedDistanceTransform(function, distance)
+//   gdt.GeneralizedDistanceTransform(function, distance, labels, voronoiMap,
+//                                    spacing=(2.0, 1.0, 1.0), numberOfThreads=4)
+//   gdt.GetMaximumApexHeight(distance)
+//
+// The arrays must be C-contiguous and have 2 or 3 dimensions. Array axes are
+// in NumPy order, i.e. the last axis is ITK's dimension 0. The same holds for
+// the spacing. The function array and the distance array must have the same
+// shape and element type, which may be int16, int32, float32 or float64. The
+// distance array may be the function array itself; the transform is then
+// computed in place. The labels and the voronoi map must have the same shape
+// and element type, which may be uint8, uint16, uint32 or int32.
+#include "Python.h"
+
+#include "itkImage.h"
+#include "itkImportImageFilter.h"
+#include "itkGeneralizedDistanceTransformImageFilter.h"
+
+#include <string>
+
+namespace
+{
+
+// The element types supported for the arrays
+enum ElementType
+{
+  UnsupportedElement, Int16Element, Int32Element, Float32Element,
+  Float64Element, UInt8Element, UInt16Element, UInt32Element
+};
+
+// Map a buffer format string and item size to one of the supported
+// element types. Only native byte order is accepted.
+ElementType GetElementType(const Py_buffer &view)
+{
+  const char *format = view.format ? view.format : "B";
+
+  if (*format == '@' || *format == '=')
+    ++format;
+  else if (*format == '<' || *format == '>' || *format == '!')
+  {
+    const long one = 1;
+    const bool littleEndian = *reinterpret_cast<const char *>(&one) == 1;
+    if ((*format == '<') != littleEndian)
+      return UnsupportedElement;
+    ++format;
+  }
+
+  if (format[0] == 0 || format[1] != 0)
+    return UnsupportedElement;
+
+  switch (format[0])
+  {
+    case 'f':
+      return view.itemsize == 4 ? Float32Element : UnsupportedElement;
+    case 'd':
+      return view.itemsize == 8 ? Float64Element : UnsupportedElement;
+    case 'h': case 'i': case 'l': case 'q':
+      if (view.itemsize == 2)
+        return Int16Element;
+      if (view.itemsize == 4)
+        return Int32Element;
+      return UnsupportedElement;
+    case 'B': case 'H': case 'I': case 'L': case 'Q':
+      if (view.itemsize == 1)
+        return UInt8Element;
+      if (view.itemsize == 2)
+        return UInt16Element;
+      if (view.itemsize == 4)
+        return UInt32Element;
+      return UnsupportedElement;
+    default:
+      return UnsupportedElement;
+  }
+}
+
+// A Py_buffer that is released automatically
+class Buffer
+{
+  public:
+    Buffer() : m_Acquired(false) {}
+    ~Buffer() { if (m_Acquired) PyBuffer_Release(&m_View); }
+
+    bool Acquire(PyObject *object, bool writable, const char *name)
+    {
+      int flags = PyBUF_C_CONTIGUOUS | PyBUF_FORMAT;
+      if (writable)
+        flags |= PyBUF_WRITABLE;
+      if (PyObject_GetBuffer(object, &m_View, flags) != 0)
+      {
+        PyErr_Format(PyExc_TypeError,
+            "%s must be a C-contiguous%s buffer", name, writable ? " writable" : "");
+        return false;
+      }
+      m_Acquired = true;
+      return true;
+    }
+
+    Py_buffer &View() { return m_View; }
+
+  private:
+    Py_buffer m_View;
+    bool m_Acquired;
+};
+
+bool SameShape(const Py_buffer &a, const Py_buffer &b)
+{
+  if (a.ndim != b.ndim)
+    return false;
+  for (int i = 0; i < a.ndim; ++i)
+    if (a.shape[i] != b.shape[i])
+      return false;
+  return true;
+}
+
+// Run the filter on the buffers. The interpreter lock is released while the
+// filter is updated. Spacing is not used if spacing is NULL. Returns false
+// and sets a Python exception on error.
+template < unsigned int VDimension, class TDistancePixel, class TLabelPixel >
+bool Transform(Py_buffer &function, Py_buffer &distance,
+    Py_buffer *labels, Py_buffer *voronoiMap,
+    const double *spacing, int numberOfThreads)
+{
+  typedef itk::Image<TDistancePixel, VDimension> DistanceImageType;
+  typedef itk::Image<TLabelPixel, VDimension> LabelImageType;
+  typedef itk::ImportImageFilter<TDistancePixel, VDimension> FunctionImportType;
+  typedef itk::ImportImageFilter<TLabelPixel, VDimension> LabelImportType;
+  typedef itk::GeneralizedDistanceTransformImageFilter<DistanceImageType,
+          DistanceImageType, LabelImageType> FilterType;
+
+  // NumPy's last axis is ITK's dimension 0
+  typename DistanceImageType::RegionType region;
+  double itkSpacing[VDimension];
+  double origin[VDimension];
+  for (unsigned int i = 0; i < VDimension; ++i)
+  {
+    region.SetSize(i, function.shape[VDimension - 1 - i]);
+    region.SetIndex(i, 0);
+    itkSpacing[i] = spacing ? spacing[VDimension - 1 - i] : 1.0;
+    origin[i] = 0.0;
+  }
+  const unsigned long numberOfPixels = region.GetNumberOfPixels();
+
+  std::string error;
+
+  Py_BEGIN_ALLOW_THREADS
+  try
+  {
+    typename FunctionImportType::Pointer functionImport = FunctionImportType::New();
+    functionImport->SetRegion(region);
+    functionImport->SetSpacing(itkSpacing);
+    functionImport->SetOrigin(origin);
+    functionImport->SetImportPointer(
+        static_cast<TDistancePixel *>(function.buf), numberOfPixels, false);
+
+    typename FilterType::Pointer filter = FilterType::New();
+    filter->SetInput1(functionImport->GetOutput());
+    filter->SetDistanceImportPointer(static_cast<TDistancePixel *>(distance.buf));
+    filter->SetUseSpacing(spacing != 0);
+    if (numberOfThreads > 0)
+      filter->SetNumberOfThreads(numberOfThreads);
+
+    typename LabelImportType::Pointer labelImport = LabelImportType::New();
+    if (labels)
+    {
+      labelImport->SetRegion(region);
+      labelImport->SetSpacing(itkSpacing);
+      labelImport->SetOrigin(origin);
+      labelImport->SetImportPointer(
+          static_cast<TLabelPixel *>(labels->buf), numberOfPixels, false);
+
+      filter->SetInput2(labelImport->GetOutput());
+      filter->SetVoronoiMapImportPointer(static_cast<TLabelPixel *>(voronoiMap->buf));
+    }
+    else
+      filter->SetCreateVoronoiMap(false);
+
+    filter->Update();
+  }
+  catch (itk::ExceptionObject &e)
+  {
+    error = e.GetDescription();
+  }
+  catch (std::exception &e)
+  {
+    error = e.what();
+  }
+  Py_END_ALLOW_THREADS
+
+  if (!error.empty())
+  {
+    PyErr_SetString(PyExc_RuntimeError, error.c_str());
+    return false;
+  }
+  return true;
+}
+
+// Dispatch on the label element type
+template < unsigned int VDimension, class TDistancePixel >
+bool TransformWithLabels(ElementType labelType, Py_buffer &function,
+    Py_buffer &distance, Py_buffer *labels, Py_buffer *voronoiMap,
+    const double *spacing, int numberOfThreads)
+{
+  switch (labelType)
+  {
+    case UInt8Element:
+      return Transform<VDimension, TDistancePixel, unsigned char>(
+          function, distance, labels, voronoiMap, spacing, numberOfThreads);
+    case UInt16Element:
+      return Transform<VDimension, TDistancePixel, unsigned short>(
+          function, distance, labels, voronoiMap, spacing, numberOfThreads);
+    case UInt32Element:
+      return Transform<VDimension, TDistancePixel, unsigned int>(
+          function, distance, labels, voronoiMap, spacing, numberOfThreads);
+    case Int32Element:
+      return Transform<VDimension, TDistancePixel, int>(
+          function, distance, labels, voronoiMap, spacing, numberOfThreads);
+    case UnsupportedElement:
+      // No voronoi map. The label type is not used.
+      return Transform<VDimension, TDistancePixel, TDistancePixel>(
+          function, distance, 0, 0, spacing, numberOfThreads);
+    default:
+      PyErr_SetString(PyExc_TypeError,
+          "labels must be of type uint8, uint16, uint32 or int32");
+      return false;
+  }
+}
+
+// Dispatch on the distance element type
+template < unsigned int VDimension >
+bool TransformWithDistance(ElementType distanceType, ElementType labelType,
+    Py_buffer &function, Py_buffer &distance, Py_buffer *labels,
+    Py_buffer *voronoiMap, const double *spacing, int numberOfThreads)
+{
+  switch (distanceType)
+  {
+    case Int16Element:
+      return TransformWithLabels<VDimension, short>(labelType,
+          function, distance, labels, voronoiMap, spacing, numberOfThreads);
+    case Int32Element:
+      return TransformWithLabels<VDimension, int>(labelType,
+          function, distance, labels, voronoiMap, spacing, numberOfThreads);
+    case Float32Element:
+      return TransformWithLabels<VDimension, float>(labelType,
+          function, distance, labels, voronoiMap, spacing, numberOfThreads);
+    case Float64Element:
+      return TransformWithLabels<VDimension, double>(labelType,
+          function, distance, labels, voronoiMap, spacing, numberOfThreads);
+    default:
+      PyErr_SetString(PyExc_TypeError,
+          "function and distance must be of type int16, int32, float32 or float64");
+      return false;
+  }
+}
+
+template < class TDistancePixel >
+PyObject *MaximumApexHeight()
+{
+  typedef itk::Image<TDistancePixel, 3> ImageType;
+  typedef itk::GeneralizedDistanceTransformImageFilter<ImageType, ImageType> FilterType;
+  return PyFloat_FromDouble(static_cast<double>(FilterType::GetMaximumApexHeight()));
+}
+
+const char GeneralizedDistanceTransformDoc[] =
+"GeneralizedDistanceTransform(function, distance, labels=None, voronoiMap=None,\n"
+"                             spacing=None, numberOfThreads=0)\n"
+"\n"
+"Compute the generalized distance transform of the function array into the\n"
+"distance array, and optionally the voronoi map of the labels array into the\n"
+"voronoiMap array. No array is copied. Background voxels of the function\n"
+"must be set to GetMaximumApexHeight(distance). The spacing is given in\n"
+"array axis order. If it is omitted, spacing is not used. numberOfThreads\n"
+"defaults to ITK's global default.";
+
+PyObject *GeneralizedDistanceTransform(PyObject *, PyObject *args, PyObject *kwargs)
+{
+  static const char *keywords[] = {
+    "function", "distance", "labels", "voronoiMap", "spacing", "numberOfThreads", 0 };
+
+  PyObject *functionObject = 0;
+  PyObject *distanceObject = 0;
+  PyObject *labelsObject = Py_None;
+  PyObject *voronoiMapObject = Py_None;
+  PyObject *spacingObject = Py_None;
+  int numberOfThreads = 0;
+
+  if (!PyArg_ParseTupleAndKeywords(args, kwargs, "OO|OOOi",
+        const_cast<char **>(keywords), &functionObject, &distanceObject,
+        &labelsObject, &voronoiMapObject, &spacingObject, &numberOfThreads))
+    return 0;
+
+  if ((labelsObject == Py_None) != (voronoiMapObject == Py_None))
+  {
+    PyErr_SetString(PyExc_ValueError,
+        "labels and voronoiMap must be given together");
+    return 0;
+  }
+
+  Buffer function, distance, labels, voronoiMap;
+  if (!function.Acquire(functionObject, false, "function") ||
+      !distance.Acquire(distanceObject, true, "distance"))
+    return 0;
+
+  const int dimension = function.View().ndim;
+  if (dimension != 2 && dimension != 3)
+  {
+    PyErr_SetString(PyExc_ValueError, "arrays must have 2 or 3 dimensions");
+    return 0;
+  }
+
+  const ElementType distanceType = GetElementType(distance.View());
+  if (!SameShape(function.View(), distance.View()) ||
+      GetElementType(function.View()) != distanceType)
+  {
+    PyErr_SetString(PyExc_ValueError,
+        "function and distance must have the same shape and type");
+    return 0;
+  }
+
+  ElementType labelType = UnsupportedElement;
+  if (labelsObject != Py_None)
+  {
+    if (!labels.Acquire(labelsObject, false, "labels") ||
+        !voronoiMap.Acquire(voronoiMapObject, true, "voronoiMap"))
+      return 0;
+
+    labelType = GetElementType(labels.View());
+    if (!SameShape(function.View(), labels.View()) ||
+        !SameShape(labels.View(), voronoiMap.View()) ||
+        GetElementType(voronoiMap.View()) != labelType)
+    {
+      PyErr_SetString(PyExc_ValueError,
+          "labels and voronoiMap must have the shape of function and the same type");
+      return 0;
+    }
+    if (labelType == UnsupportedElement)
+    {
+      PyErr_SetString(PyExc_TypeError,
+          "labels must be of type uint8, uint16, uint32 or int32");
+      return 0;
+    }
+  }
+
+  double spacingValues[3];
+  const double *spacing = 0;
+  if (spacingObject != Py_None)
+  {
+    PyObject *sequence = PySequence_Fast(spacingObject, "spacing must be a sequence");
+    if (!sequence)
+      return 0;
+    if (PySequence_Fast_GET_SIZE(sequence) != dimension)
+    {
+      Py_DECREF(sequence);
+      PyErr_SetString(PyExc_ValueError,
+          "spacing must have one value per array dimension");
+      return 0;
+    }
+    for (int i = 0; i < dimension; ++i)
+      spacingValues[i] = PyFloat_AsDouble(PySequence_Fast_GET_ITEM(sequence, i));
+    Py_DECREF(sequence);
+    if (PyErr_Occurred())
+      return 0;
+    spacing = spacingValues;
+  }
+
+  Py_buffer *labelsView = labelsObject != Py_None ? &labels.View() : 0;
+  Py_buffer *voronoiMapView = labelsObject != Py_None ? &voronoiMap.View() : 0;
+
+  bool ok;
+  if (dimension == 2)
+    ok = TransformWithDistance<2>(distanceType, labelType, function.View(),
+        distance.View(), labelsView, voronoiMapView, spacing, numberOfThreads);
+  else
+    ok = TransformWithDistance<3>(distanceType, labelType, function.View(),
+        distance.View(), labelsView, voronoiMapView, spacing, numberOfThreads);
+
+  if (!ok)
+    return 0;
+
+  Py_RETURN_NONE;
+}
+
+const char GetMaximumApexHeightDoc[] =
+"GetMaximumApexHeight(distance)\n"
+"\n"
+"Return the value that marks background voxels in the function array for\n"
+"the element type of the distance array.";
+
+PyObject *GetMaximumApexHeight(PyObject *, PyObject *args)
+{
+  PyObject *distanceObject = 0;
+  if (!PyArg_ParseTuple(args, "O", &distanceObject))
+    return 0;
+
+  Buffer distance;
+  if (!distance.Acquire(distanceObject, false, "distance"))
+    return 0;
+
+  switch (GetElementType(distance.View()))
+  {
+    case Int16Element:
+      return MaximumApexHeight<short>();
+    case Int32Element:
+      return MaximumApexHeight<int>();
+    case Float32Element:
+      return MaximumApexHeight<float>();
+    case Float64Element:
+      return MaximumApexHeight<double>();
+    default:
+      PyErr_SetString(PyExc_TypeError,
+          "distance must be of type int16, int32, float32 or float64");
+      return 0;
+  }
+}
+
+PyMethodDef Methods[] = {
+  { "GeneralizedDistanceTransform",
+    reinterpret_cast<PyCFunction>(GeneralizedDistanceTransform),
+    METH_VARARGS | METH_KEYWORDS, GeneralizedDistanceTransformDoc },
+  { "GetMaximumApexHeight", GetMaximumApexHeight,
+    METH_VARARGS, GetMaximumApexHeightDoc },
+  { 0, 0, 0, 0 }
+};
+
+} // end anonymous namespace
+
+#if PY_MAJOR_VERSION >= 3
+static struct PyModuleDef ModuleDefinition = {
+  PyModuleDef_HEAD_INIT, "GeneralizedDistanceTransformBuffer", 0, -1, Methods,
+  0, 0, 0, 0
+};
+
+PyMODINIT_FUNC PyInit_GeneralizedDistanceTransformBuffer(void)
+{
+  return PyModule_Create(&ModuleDefinition);
+}
+#else
+PyMODINIT_FUNC initGeneralizedDistanceTransformBuffer(void)
+{
+  Py_InitModule("GeneralizedDistanceTransformBuffer", Methods);
+}
+#endif
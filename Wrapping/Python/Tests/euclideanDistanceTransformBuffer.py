@@ -0,0 +1,49 @@
+import numpy
+from sys import argv, exit
+import GeneralizedDistanceTransformBuffer as gdt
+
+if len(argv) != 4:
+  print("""Compute the euclidean distance transform and the voronoi map of an
+Analyze image with NumPy arrays, and compare them to references.
+
+USAGE:  <input image> <reference image> <reference label image>
+  <input image>: An Analyze image (.hdr) where background voxels have value 0.
+  <reference image>: An Analyze image (.hdr) with the euclidean distance to
+                     the closest foreground voxel.
+  <reference label image>: An Analyze image (.hdr) with the label of the
+                           closest foreground voxel.""")
+  exit(1)
+
+def readAnalyze(header):
+  """Read a 3D Analyze image of 16 bit pixels into a NumPy array."""
+  byteOrder = '<' if numpy.fromfile(header, dtype='<i4', count=1)[0] == 348 else '>'
+  dims = numpy.fromfile(header, dtype=byteOrder + 'i2', count=24)[20:24]
+  shape = (dims[3], dims[2], dims[1])
+  data = numpy.fromfile(header[:-4] + '.img', dtype=byteOrder + 'i2')
+  return data.reshape(shape).astype(numpy.int16)
+
+label = readAnalyze(argv[1])
+reference = readAnalyze(argv[2])
+referenceLabel = readAnalyze(argv[3])
+
+# The indicator function: 0 on the foreground, "infinity" on the background.
+function = numpy.zeros(label.shape, dtype=numpy.float32)
+function[label == 0] = gdt.GetMaximumApexHeight(function)
+
+# The distance is computed in place and without voronoi map.
+gdt.GeneralizedDistanceTransform(function, function, numberOfThreads=2)
+distance = numpy.sqrt(function).astype(numpy.int16)
+
+# The same with a caller-provided distance array, and a voronoi map.
+indicator = numpy.where(label == 0, gdt.GetMaximumApexHeight(function), 0).astype(numpy.float32)
+distance2 = numpy.empty_like(indicator)
+voronoi = numpy.empty(label.shape, dtype=numpy.uint16)
+gdt.GeneralizedDistanceTransform(indicator, distance2,
+                                 label.astype(numpy.uint16), voronoi,
+                                 spacing=(1.0, 1.0, 1.0))
+
+mismatches = numpy.count_nonzero(distance != reference)
+mismatches += numpy.count_nonzero(numpy.sqrt(distance2).astype(numpy.int16) != reference)
+mismatches += numpy.count_nonzero(voronoi.astype(numpy.int16) != referenceLabel)
+print("%d mismatching voxels" % mismatches)
+exit(mismatches != 0)
@@ -0,0 +1,188 @@
+// Compare itk::GeneralizedDistanceTransformImageFilter to a brute force
+// computation
+//
+// Random seeds with random heights are transformed in 1D to 4D, with and
+// without spacing, voronoi map, periodic boundaries and shrink factors.
+// The brute force takes the minimum over all seeds, with the offsets
+// wrapped along the periodic dimensions, at input index j*k of each output
+// index j. The images don't start at index 0, and the spacings are exact in
+// binary, so that the squared distances are exact as well.
+//
+// This reaches all kernels: those of the directions of 2D and 3D images,
+// the generic one of 1D and 4D images, the one that writes adjacent samples
+// along dimension 0 without shrinking, and the periodic sampling. Voronoi
+// labels may differ on ties, so a label is accepted if its seed is at the
+// same distance.
+//
+// Returns 1 if any voxel differs.
+
+#include <iostream>
+#include <vector>
+#include <cstdlib>
+#include <cmath>
+
+#include "itkImage.h"
+#include "itkImageRegionConstIteratorWithIndex.h"
+#include "itkGeneralizedDistanceTransformImageFilter.h"
+
+
+// The squared distance of a voxel to a seed
+template <class TIndex, class TSize, class TBooleanArray>
+double squaredDistance(const TIndex &index, const TIndex &seed, double height,
+    const TSize &size, const double *spacing, bool useSpacing,
+    const TBooleanArray &periodic)
+{
+  double result = height;
+  for (unsigned int d = 0; d < TIndex::GetIndexDimension(); ++d)
+  {
+    long offset = std::labs(index[d] - seed[d]);
+    if (periodic[d])
+      offset = std::min<long>(offset, size[d] - offset);
+    const double s = useSpacing ? spacing[d] : 1.0;
+    result += offset * offset * s * s;
+  }
+  return result;
+}
+
+template <unsigned int Dimension>
+unsigned long compare(unsigned int trial)
+{
+  typedef itk::Image<double, Dimension> FunctionImageType;
+  typedef itk::Image<short, Dimension> LabelImageType;
+  typedef itk::GeneralizedDistanceTransformImageFilter<FunctionImageType,
+          FunctionImageType, LabelImageType> Distance;
+  typedef typename FunctionImageType::IndexType IndexType;
+
+  srand(trial);
+  const bool useSpacing = trial % 4 != 3;
+  const bool createVoronoiMap = trial % 5 != 4;
+
+  // A different geometry and different options in each trial
+  typename FunctionImageType::RegionType region;
+  IndexType start;
+  typename FunctionImageType::SizeType size;
+  double spacing[Dimension];
+  typename Distance::BooleanArrayType periodic;
+  typename Distance::ShrinkFactorsType shrinkFactors;
+  for (unsigned int d = 0; d < Dimension; ++d)
+  {
+    start[d] = rand() % 7 - 3;
+    size[d] = (Dimension > 2 ? 4 : 9) + rand() % 5;
+    spacing[d] = 0.5 * (1 + rand() % 4);
+    periodic[d] = rand() % 3 == 0;
+    shrinkFactors[d] = rand() % 2 ? 1 : 2 + rand() % 2;
+  }
+  region.SetIndex(start);
+  region.SetSize(size);
+
+  typename FunctionImageType::Pointer function = FunctionImageType::New();
+  function->SetRegions(region);
+  function->SetSpacing(spacing);
+  function->Allocate();
+  function->FillBuffer(Distance::GetMaximumApexHeight());
+  typename LabelImageType::Pointer labels = LabelImageType::New();
+  labels->SetRegions(region);
+  labels->Allocate();
+  labels->FillBuffer(0);
+
+  std::vector<IndexType> seeds;
+  std::vector<double> heights;
+  typedef itk::ImageRegionConstIteratorWithIndex<FunctionImageType> IteratorType;
+  for (IteratorType it(function, region); !it.IsAtEnd(); ++it)
+  {
+    if (rand() % 19)
+      continue;
+    seeds.push_back(it.GetIndex());
+    heights.push_back(rand() % 5);
+    function->SetPixel(it.GetIndex(), heights.back());
+    labels->SetPixel(it.GetIndex(), seeds.size());
+  }
+
+  typename Distance::Pointer distance = Distance::New();
+  distance->SetInput1(function);
+  distance->SetInput2(labels);
+  distance->SetUseSpacing(useSpacing);
+  distance->SetCreateVoronoiMap(createVoronoiMap);
+  distance->SetPeriodicBoundary(periodic);
+  distance->SetShrinkFactors(shrinkFactors);
+  distance->SetNumberOfThreads(1 + trial % 3);
+  distance->Update();
+
+
+  unsigned long errors = 0;
+  const FunctionImageType *output = distance->GetDistance();
+  for (IteratorType it(output, output->GetBufferedRegion()); !it.IsAtEnd(); ++it)
+  {
+    IndexType index = it.GetIndex();
+    for (unsigned int d = 0; d < Dimension; ++d)
+      index[d] *= shrinkFactors[d];
+
+    double expected = Distance::GetMaximumApexHeight();
+    for (unsigned long s = 0; s < seeds.size(); ++s)
+      expected = std::min(expected, squaredDistance(index, seeds[s], heights[s],
+            size, spacing, useSpacing, periodic));
+
+    double atLabel = expected;
+    short label = 0;
+    if (createVoronoiMap && !seeds.empty())
+    {
+      label = distance->GetVoronoiMap()->GetPixel(it.GetIndex());
+      atLabel = label > 0 && label <= static_cast<short>(seeds.size()) ?
+        squaredDistance(index, seeds[label - 1], heights[label - 1], size,
+            spacing, useSpacing, periodic) : -1.0;
+    }
+
+    if (!region.IsInside(index) || it.Get() != expected || atLabel != expected)
+    {
+      if (errors < 10)
+        std::cerr << Dimension << "D trial " << trial << ": distance at "
+          << it.GetIndex() << " is " << it.Get() << " of label " << label
+          << ", expected " << expected << std::endl;
+      ++errors;
+    }
+  }
+
+  // Every sample in the input region is in the output
+  unsigned long numberOfSamples = 1;
+  for (unsigned int d = 0; d < Dimension; ++d)
+  {
+    unsigned long n = 0;
+    for (long x = start[d]; x < start[d] + static_cast<long>(size[d]); ++x)
+      if (x % static_cast<long>(shrinkFactors[d]) == 0)
+        ++n;
+    numberOfSamples *= n;
+  }
+  if (output->GetBufferedRegion().GetNumberOfPixels() != numberOfSamples)
+  {
+    std::cerr << Dimension << "D trial " << trial << ": output region is "
+      << output->GetBufferedRegion() << std::endl;
+    ++errors;
+  }
+  return errors;
+}
+
+int main(int argc, char **argv)
+{
+  if (argc > 1)
+  {
+    std::cerr <<
+      "Compare itk::GeneralizedDistanceTransformImageFilter to a brute force\n"
+      "computation in 1D to 4D, with spacing, periodic boundaries and shrink\n"
+      "factors. Produces no output files.\n"
+      "\n"
+      "USAGE: " << argv[0] << "\n";
+    return 1;
+  }
+
+  unsigned long errors = 0;
+  for (unsigned int trial = 0; trial < 50; ++trial)
+  {
+    errors += compare<1>(trial);
+    errors += compare<2>(trial);
+    errors += compare<3>(trial);
+    errors += compare<4>(trial);
+  }
+
+  std::cout << "Wrong voxels: " << errors << std::endl;
+  return errors ? 1 : 0;
+}
@@ -0,0 +1,89 @@
+#include <cstdlib>
+
+#include "itkImageFileReader.h"
+#include "itkBinaryThresholdImageFilter.h"
+#include "itkLazyGeneralizedDistanceTransform.h"
+#include "itkEnvelopeFileReader.h"
+#include "itkSqrtImageFilter.h"
+#include "itkImageFileWriter.h"
+
+int main(int argc, char *argv[])
+{
+  const unsigned int dimension=3;
+  if (argc != 5)
+  {
+    std::cerr <<
+      "Compute the euclidean distance transform and Voronoi map of an image,\n"
+      "store them as envelopes in a compact file and expand that file to the\n"
+      "dense images.\n"
+      "\n"
+      "USAGE: " << argv[0] << " <label image> <envelope file> <distance output> <label output>\n"
+      "  <label image>: An image where background voxels have label 0.\n"
+      "  <envelope file>: The file the envelopes are stored in.\n"
+      "  <distance output>: An image that denotes the euclidean distance to\n"
+      "     the closest foreground voxel.\n"
+      "  <label output>: An image that denotes the label of the closest\n"
+      "     foreground voxel.\n";
+    return 1;
+  }
+
+  typedef short PixelType;
+  typedef itk::Image<PixelType, dimension> ImageType;
+
+  // Read the label image
+  typedef itk::ImageFileReader<ImageType> ReaderType;
+  ReaderType::Pointer input = ReaderType::New();
+  input->SetFileName(argv[1]);
+
+  typedef itk::LazyGeneralizedDistanceTransform<ImageType, ImageType> Distance;
+
+  // For the label image l, create an indicator image i with
+  // i(x) = (l(x) == 0 ?  infinity : 0).
+  typedef itk::BinaryThresholdImageFilter<ImageType, ImageType> Indicator;
+  Indicator::Pointer indicator = Indicator::New();
+  indicator->SetLowerThreshold(0);
+  indicator->SetUpperThreshold(0);
+  indicator->SetOutsideValue(0);
+  indicator->SetInsideValue(Distance::GetMaximumApexHeight());
+  indicator->SetInput(input->GetOutput());
+
+  try
+  {
+    indicator->Update();
+
+    // Store the envelopes of the last dimension...
+    Distance::Pointer distance = Distance::New();
+    distance->SetInput1(indicator->GetOutput());
+    distance->SetInput2(input->GetOutput());
+    distance->Update();
+    distance->WriteEnvelopes(argv[2]);
+
+    // ...and read them back
+    typedef itk::EnvelopeFileReader<ImageType> EnvelopeReader;
+    EnvelopeReader::Pointer envelopes = EnvelopeReader::New();
+    envelopes->SetFileName(argv[2]);
+    envelopes->Update();
+    std::cout << envelopes->GetNumberOfParabolas() << " parabolas stored" << std::endl;
+
+    // The squared euclidean distance is converted to the regular euclidean
+    // distance
+    typedef itk::SqrtImageFilter<ImageType, ImageType> Sqrt;
+    Sqrt::Pointer sqrt = Sqrt::New();
+    sqrt->SetInput(envelopes->GenerateDistanceImage());
+
+    typedef itk::ImageFileWriter<ImageType> Writer;
+    Writer::Pointer writer = Writer::New();
+    writer->SetInput(sqrt->GetOutput());
+    writer->SetFileName(argv[3]);
+    writer->Update();
+
+    writer->SetInput(envelopes->GenerateVoronoiMap());
+    writer->SetFileName(argv[4]);
+    writer->Update();
+  }
+  catch (itk::ExceptionObject &e)
+  {
+    std::cerr << e << std::endl;
+    return 1;
+  }
+}
@@ -0,0 +1,129 @@
+#include <cstdlib>
+
+#include "itkImageFileReader.h"
+#include "itkImageRegionConstIterator.h"
+#include "itkImageRegionIterator.h"
+#include "itkDistributedGeneralizedDistanceTransform.h"
+#include "itkLocalSocketSlabTransport.h"
+#include "itkSqrtImageFilter.h"
+#include "itkImageFileWriter.h"
+
+int main(int argc, char *argv[])
+{
+  if (argc != 5 && argc != 6)
+  {
+    std::cerr <<
+      "Compute the euclidean distance transform and Voronoi map of an image\n"
+      "with several processes that own a slab of the image each.\n"
+      "\n"
+      "USAGE: " << argv[0] << " <label image> <processes> <distance output> <label output> [<exchange size>]\n"
+      "  <label image>: An image where background voxels have label 0.\n"
+      "  <processes>: The number of processes.\n"
+      "  <distance output>: An image that denotes the euclidean distance to\n"
+      "     the closest foreground voxel.\n"
+      "  <label output>: An image that denotes the label of the closest\n"
+      "     foreground voxel.\n"
+      "  <exchange size>: The largest number of bytes that a process sends\n"
+      "     to another one at once.\n";
+    return 1;
+  }
+
+  // Start the processes before any threads are created
+  typedef itk::LocalSocketSlabTransport Transport;
+  Transport::Pointer transport = Transport::Fork(atoi(argv[2]));
+  const int rank = transport->GetRank();
+
+  const unsigned int dimension=3;
+  typedef short PixelType;
+  typedef itk::Image<PixelType, dimension> ImageType;
+
+  typedef itk::DistributedGeneralizedDistanceTransform<ImageType, ImageType> Distance;
+
+  int result = 0;
+  try
+  {
+    // Read the slab of this process from the label image. The reader only
+    // reads the requested region if the file format supports it.
+    typedef itk::ImageFileReader<ImageType> ReaderType;
+    ReaderType::Pointer input = ReaderType::New();
+    input->SetFileName(argv[1]);
+    input->UpdateOutputInformation();
+
+    const ImageType::RegionType globalRegion = input->GetOutput()->GetLargestPossibleRegion();
+    const ImageType::RegionType slabRegion =
+      Distance::GetSlabRegion(globalRegion, rank, transport->GetNumberOfProcesses());
+    input->GetOutput()->SetRequestedRegion(slabRegion);
+    input->Update();
+
+    // For the label image l, create an indicator image i with 
+    // i(x) = (l(x) == 0 ?  infinity : 0) within the slab.
+    ImageType::Pointer indicator = ImageType::New();
+    ImageType::Pointer label = ImageType::New();
+    indicator->SetRegions(slabRegion);
+    label->SetRegions(slabRegion);
+    indicator->SetSpacing(input->GetOutput()->GetSpacing());
+    label->SetSpacing(input->GetOutput()->GetSpacing());
+    indicator->SetOrigin(input->GetOutput()->GetOrigin());
+    label->SetOrigin(input->GetOutput()->GetOrigin());
+    indicator->Allocate();
+    label->Allocate();
+
+    itk::ImageRegionConstIterator<ImageType> inputIt(input->GetOutput(), slabRegion);
+    itk::ImageRegionIterator<ImageType> indicatorIt(indicator, slabRegion);
+    itk::ImageRegionIterator<ImageType> labelIt(label, slabRegion);
+    for (inputIt.GoToBegin(), indicatorIt.GoToBegin(), labelIt.GoToBegin();
+        !inputIt.IsAtEnd(); ++inputIt, ++indicatorIt, ++labelIt)
+    {
+      indicatorIt.Set(inputIt.Get() == 0 ? Distance::GetMaximumApexHeight() : 0);
+      labelIt.Set(inputIt.Get());
+    }
+    input = 0;
+
+    // All processes compute the transform together...
+    Distance::Pointer distance = Distance::New();
+    distance->SetTransport(transport);
+    distance->SetGlobalRegion(globalRegion);
+    distance->SetInput1(indicator);
+    distance->SetInput2(label);
+    if (argc == 6)
+      distance->SetExchangeBufferSize(atoi(argv[5]));
+    distance->Update();
+
+    // ...and the first one collects the slabs
+    ImageType::Pointer distanceImage = distance->GatherImage<ImageType>(distance->GetDistance());
+    ImageType::Pointer voronoiMap = distance->GatherImage<ImageType>(distance->GetVoronoiMap());
+
+    if (rank == 0)
+    {
+      // The squared euclidean distance is converted to the regular
+      // euclidean distance
+      typedef itk::SqrtImageFilter<ImageType, ImageType> Sqrt;
+      Sqrt::Pointer sqrt = Sqrt::New();
+      sqrt->SetInput(distanceImage);
+
+      // Write the distance image
+      typedef itk::ImageFileWriter<ImageType> Writer;
+      Writer::Pointer writer = Writer::New();
+      writer->SetInput(sqrt->GetOutput());
+      writer->SetFileName(argv[3]);
+      writer->Update();
+
+      // Write the label image
+      writer->SetInput(voronoiMap);
+      writer->SetFileName(argv[4]);
+      writer->Update();
+    }
+  }
+  catch (itk::ExceptionObject &e)
+  {
+    std::cerr << "Process " << rank << ": " << e << std::endl;
+    result = 1;
+  }
+
+  if (rank != 0)
+    _exit(result);
+
+  if (!transport->WaitForChildren())
+    result = 1;
+  return result;
+}
@@ -0,0 +1,143 @@
+#include <cmath>
+#include <map>
+#include <vector>
+
+#include "itkImageFileReader.h"
+#include "itkBinaryThresholdImageFilter.h"
+#include "itkGeneralizedDistanceTransformImageFilter.h"
+#include "itkSqrtImageFilter.h"
+#include "itkImageFileWriter.h"
+#include "itkImageRegionConstIterator.h"
+
+int main(int argc, char *argv[])
+{
+  if (argc != 3)
+  {
+    std::cerr <<
+      "Compute the euclidean distance transform and Voronoi map of an image,\n"
+      "and print statistics of the distances, overall and per label. The\n"
+      "statistics are checked against a pass over the outputs, the program\n"
+      "returns 1 if they differ.\n"
+      "\n"
+      "USAGE: " << argv[0] << " <label image> <distance output>\n"
+      "  <label image>: An image where background voxels have label 0.\n"
+      "  <distance output>: An image that denotes the euclidean distance to\n"
+      "     the closest foreground voxel.\n";
+    return 1;
+  }
+
+  const unsigned int dimension=3;
+  typedef short PixelType;
+  typedef itk::Image<PixelType, dimension> ImageType;
+
+  // Read the label image
+  typedef itk::ImageFileReader<ImageType> ReaderType;
+  ReaderType::Pointer input = ReaderType::New();
+  input->SetFileName(argv[1]);
+
+  typedef itk::GeneralizedDistanceTransformImageFilter<ImageType, ImageType> Distance;
+
+  // For the label image l, create an indicator image i with
+  // i(x) = (l(x) == 0 ?  infinity : 0).
+  typedef itk::BinaryThresholdImageFilter<ImageType, ImageType> Indicator;
+  Indicator::Pointer indicator = Indicator::New();
+  indicator->SetLowerThreshold(0);
+  indicator->SetUpperThreshold(0);
+  indicator->SetOutsideValue(0);
+  indicator->SetInsideValue(Distance::GetMaximumApexHeight());
+  indicator->SetInput(input->GetOutput());
+
+  // The statistics are collected by the last iteration. A bin of the
+  // histogram counts the squared distances of one unit.
+  Distance::Pointer distance = Distance::New();
+  distance->SetInput1(indicator->GetOutput());
+  distance->SetInput2(input->GetOutput());
+  distance->ComputeStatisticsOn();
+  distance->SetNumberOfHistogramBins(64);
+  distance->SetHistogramBinWidth(1.0);
+
+  // The partial statistics of several threads are merged
+  distance->SetNumberOfThreads(4);
+
+  // The squared euclidean distance is converted to the regular euclidean
+  // distance
+  typedef itk::SqrtImageFilter<ImageType, ImageType> Sqrt;
+  Sqrt::Pointer sqrt = Sqrt::New();
+  sqrt->SetInput(distance->GetOutput());
+
+  // Write the distance image
+  typedef itk::ImageFileWriter<ImageType> Writer;
+  Writer::Pointer writer = Writer::New();
+  writer->SetInput(sqrt->GetOutput());
+  writer->SetFileName(argv[2]);
+  writer->Update();
+
+  // The statistics are on the squared distances
+  std::cout << "Voxels: " << distance->GetNumberOfMeasuredPixels() << "\n";
+  std::cout << "Maximum distance: " << std::sqrt(static_cast<double>(distance->GetMaximumDistance())) << "\n";
+  std::cout << "Mean squared distance: " << distance->GetMeanDistance() << "\n";
+
+  const Distance::LabelStatisticsContainerType &labels = distance->GetLabelStatistics();
+  for (Distance::LabelStatisticsContainerType::const_iterator it = labels.begin();
+      it != labels.end(); ++it)
+  {
+    std::cout << "Label " << it->first << ": " << it->second.Count << " voxels, "
+              << "maximum distance " << std::sqrt(static_cast<double>(it->second.Maximum)) << ", "
+              << "mean squared distance " << it->second.GetMean() << "\n";
+  }
+
+  const Distance::HistogramType &histogram = distance->GetDistanceHistogram();
+  std::cout << "Histogram of the squared distances:";
+  for (unsigned long bin = 0; bin < histogram.size(); ++bin)
+    std::cout << " " << histogram[bin];
+  std::cout << "\n";
+
+  // Compute the statistics again from the outputs
+  typedef itk::ImageRegionConstIterator<ImageType> Iterator;
+  Iterator distanceIt(distance->GetDistance(), distance->GetDistance()->GetBufferedRegion());
+  Iterator labelIt(distance->GetVoronoiMap(), distance->GetVoronoiMap()->GetBufferedRegion());
+  unsigned long count = 0;
+  double sum = 0.0;
+  PixelType maximum = 0;
+  Distance::HistogramType expectedHistogram(histogram.size(), 0);
+  std::map<PixelType, Distance::LabelStatisticsType> expectedLabels;
+  for (; !distanceIt.IsAtEnd(); ++distanceIt, ++labelIt)
+  {
+    const PixelType value = distanceIt.Get();
+    if (value >= Distance::GetMaximumApexHeight())
+      continue;
+    if (count == 0 || maximum < value)
+      maximum = value;
+    ++count;
+    sum += value;
+    const unsigned long lastBin = expectedHistogram.size() - 1;
+    const double bin = value / distance->GetHistogramBinWidth();
+    ++expectedHistogram[bin <= 0.0 ? 0 : bin >= lastBin ? lastBin : static_cast<unsigned long>(bin)];
+
+    Distance::LabelStatisticsType &label = expectedLabels[labelIt.Get()];
+    if (label.Count == 0 || label.Maximum < value)
+      label.Maximum = value;
+    ++label.Count;
+    label.Sum += value;
+  }
+
+  const double mean = count > 0 ? sum / count : 0.0;
+  bool ok = count == distance->GetNumberOfMeasuredPixels()
+    && maximum == distance->GetMaximumDistance()
+    && std::fabs(mean - distance->GetMeanDistance()) < 1e-9 * (1 + mean)
+    && expectedHistogram == histogram
+    && expectedLabels.size() == labels.size();
+  for (Distance::LabelStatisticsContainerType::const_iterator it = labels.begin();
+      ok && it != labels.end(); ++it)
+  {
+    const Distance::LabelStatisticsType &expected = expectedLabels[it->first];
+    ok = expected.Count == it->second.Count && expected.Maximum == it->second.Maximum
+      && std::fabs(expected.GetMean() - it->second.GetMean()) < 1e-9 * (1 + expected.GetMean());
+  }
+  if (!ok)
+  {
+    std::cerr << "The statistics differ from the ones of the outputs\n";
+    return 1;
+  }
+  return 0;
+}
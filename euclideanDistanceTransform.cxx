@@ -6,17 +6,20 @@
 
 #include "itkSimpleFilterWatcher.h"
 
+#include <cstdlib>
+
 int main(int argc, char *argv[])
 {
-  if (argc != 3)
+  if (argc != 3 && argc != 4)
   {
     std::cerr << 
       "Compute the euclidean distance transform of an image.\n"
       "\n"
-      "USAGE: " << argv[0] << " <input image> <output image>\n"
+      "USAGE: " << argv[0] << " <input image> <output image> [<label>]\n"
       "  <input image>: An image where background voxels have value 0.\n"
       "  <output image>: An image that denotes the euclidean distance to the\n"
-      "                  closest foreground voxel.\n";
+      "                  closest foreground voxel.\n"
+      "  <label>: Only the voxels with this value are foreground.\n";
     return 1;
   }
 
@@ -43,6 +46,16 @@ int main(int argc, char *argv[])
   indicator->SetInsideValue(Distance::GetMaximumApexHeight());
   indicator->SetInput(input->GetOutput());
 
+  // For a single label k, i(x) = (l(x) == k ? 0 : infinity) instead
+  if (argc == 4)
+  {
+    const PixelType label = atoi(argv[3]);
+    indicator->SetLowerThreshold(label);
+    indicator->SetUpperThreshold(label);
+    indicator->SetOutsideValue(Distance::GetMaximumApexHeight());
+    indicator->SetInsideValue(0);
+  }
+
   // Now the indicator image is fed into the distance transform...
   Distance::Pointer distance = Distance::New();
   distance->SetInput1(indicator->GetOutput());
@@ -0,0 +1,123 @@
+#ifndef __itkBoundedQueue_h
+#define __itkBoundedQueue_h
+
+#include "itkMutexLock.h"
+#include "itkConditionVariable.h"
+
+#include <deque>
+
+namespace itk
+{
+
+/** \class BoundedQueue
+*
+* A first-in first-out queue of limited length that connects the stages of a
+* pipeline running in separate threads.
+*
+* Push() blocks while the queue is full and Pop() blocks while it is empty.
+* The producer calls Close() after the last element: Pop() returns the
+* remaining elements and false afterwards. Abort() wakes up all threads and
+* makes Push() and Pop() return false at once, e.g. after an error in one of
+* the stages.
+*
+* \ingroup ImageFeatureExtraction
+*
+*/
+template < class TElement >
+class BoundedQueue
+{
+public:
+  typedef TElement ElementType;
+
+  BoundedQueue(unsigned int maximumLength = 1)
+    : m_MaximumLength(maximumLength > 0 ? maximumLength : 1),
+      m_Closed(false), m_Aborted(false)
+    {
+    m_NotFull = ConditionVariable::New();
+    m_NotEmpty = ConditionVariable::New();
+    }
+
+  /** Empty the queue and make it accept elements again. Must not be called
+   * while other threads use the queue. */
+  void Reset(unsigned int maximumLength)
+    {
+    m_Elements.clear();
+    m_MaximumLength = maximumLength > 0 ? maximumLength : 1;
+    m_Closed = false;
+    m_Aborted = false;
+    }
+
+  /** Append an element. Returns false if the queue has been closed or
+   * aborted. */
+  bool Push(const ElementType &element)
+    {
+    m_Lock.Lock();
+    while (m_Elements.size() >= m_MaximumLength && !m_Closed && !m_Aborted)
+      m_NotFull->Wait(&m_Lock);
+    const bool accepted = !m_Closed && !m_Aborted;
+    if (accepted)
+    {
+      m_Elements.push_back(element);
+      m_NotEmpty->Signal();
+    }
+    m_Lock.Unlock();
+    return accepted;
+    }
+
+  /** Remove the first element. Returns false if the queue is closed and
+   * empty or has been aborted. */
+  bool Pop(ElementType &element)
+    {
+    m_Lock.Lock();
+    while (m_Elements.empty() && !m_Closed && !m_Aborted)
+      m_NotEmpty->Wait(&m_Lock);
+    const bool found = !m_Aborted && !m_Elements.empty();
+    if (found)
+    {
+      element = m_Elements.front();
+      m_Elements.pop_front();
+      m_NotFull->Signal();
+    }
+    m_Lock.Unlock();
+    return found;
+    }
+
+  /** No more elements will be pushed. */
+  void Close()
+    {
+    m_Lock.Lock();
+    m_Closed = true;
+    m_NotEmpty->Broadcast();
+    m_NotFull->Broadcast();
+    m_Lock.Unlock();
+    }
+
+  /** Drop the elements and release all waiting threads. */
+  void Abort()
+    {
+    m_Lock.Lock();
+    m_Aborted = true;
+    m_Elements.clear();
+    m_NotEmpty->Broadcast();
+    m_NotFull->Broadcast();
+    m_Lock.Unlock();
+    }
+
+private:
+  BoundedQueue(const BoundedQueue&); //purposely not implemented
+  void operator=(const BoundedQueue&); //purposely not implemented
+
+  std::deque<ElementType> m_Elements;
+  unsigned int m_MaximumLength;
+  bool m_Closed;
+  bool m_Aborted;
+
+  SimpleMutexLock m_Lock;
+  ConditionVariable::Pointer m_NotFull;
+  ConditionVariable::Pointer m_NotEmpty;
+
+}; // end of BoundedQueue class
+
+} //end namespace itk
+
+#endif
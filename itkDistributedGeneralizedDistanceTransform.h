@@ -0,0 +1,217 @@
+#ifndef __itkDistributedGeneralizedDistanceTransform_h
+#define __itkDistributedGeneralizedDistanceTransform_h
+
+#include "itkObject.h"
+#include "itkSlabTransport.h"
+#include "itkGeneralizedDistanceTransformImageFilter.h"
+
+namespace itk
+{
+
+/** \class DistributedGeneralizedDistanceTransform
+*
+* Computes the generalized distance transform of an image that is
+* distributed over several processes, see
+* itk::GeneralizedDistanceTransformImageFilter for the transform itself.
+*
+* SLAB DECOMPOSITION
+* The image is split into slabs along the last dimension. Each process owns
+* one slab, i.e. GetSlabRegion() of the global region, and provides it with
+* SetInput1() and SetInput2(). The iterations over all dimensions but the last
+* one are computed within the slabs. Then the slabs are redistributed with an
+* all-to-all exchange: Each process receives full columns along the last
+* dimension, split along the dimension before it, see GetColumnRegion().
+* The iteration over the last dimension is computed in place within the
+* columns. Optionally, the result is redistributed back into the slabs.
+*
+* MEMORY
+* At its peak, a process holds its slab of the inputs, the result of the
+* iterations within the slab and the columns it receives, i.e. about three
+* times its share of the image. The pixels are exchanged in rounds of at
+* most GetExchangeBufferSize() bytes for each peer, so the buffers of an
+* exchange don't grow with the image. GatherImage() is the exception: The
+* root process allocates the whole image.
+*
+* TRANSPORT
+* The processes communicate through an itk::SlabTransport that must be set
+* with SetTransport(). itk::LocalSocketSlabTransport runs several processes on
+* a single machine.
+*
+* All processes must call Update() with the same parameters. The global
+* region must have at least as many pixels as there are processes along the
+* last two dimensions.
+*
+* \ingroup ImageFeatureExtraction
+*
+*/
+
+template <
+  class TFunctionImage,class TDistanceImage, class TLabelImage=TFunctionImage,
+        unsigned char MinimalSpacingPrecision=3,
+        class TAccumulator=typename TDistanceImage::PixelType >
+class ITK_EXPORT DistributedGeneralizedDistanceTransform : public Object
+{
+public:
+  /** Standard class typedefs. */
+  typedef DistributedGeneralizedDistanceTransform Self;
+  typedef Object Superclass;
+  typedef SmartPointer<Self> Pointer;
+  typedef SmartPointer<const Self> ConstPointer;
+
+  /** Method for creation through the object factory */
+  itkNewMacro(Self);
+
+  /** Run-time type information (and related methods). */
+  itkTypeMacro(DistributedGeneralizedDistanceTransform, Object);
+
+  /** Image dimension. */
+  itkStaticConstMacro(ImageDimension, unsigned int, TFunctionImage::ImageDimension);
+
+  /** Types and pointer types for the images. */
+  typedef TFunctionImage FunctionImageType;
+  typedef TDistanceImage DistanceImageType;
+  typedef TLabelImage LabelImageType;
+
+  typedef typename FunctionImageType::ConstPointer FunctionImageConstPointer;
+  typedef typename LabelImageType::ConstPointer LabelImageConstPointer;
+  typedef typename DistanceImageType::Pointer DistanceImagePointer;
+  typedef typename LabelImageType::Pointer LabelImagePointer;
+  typedef typename DistanceImageType::PixelType DistancePixelType;
+  typedef typename DistanceImageType::RegionType RegionType;
+
+  /** The filter that computes the iterations within the slabs. */
+  typedef GeneralizedDistanceTransformImageFilter<TFunctionImage, TDistanceImage,
+          TLabelImage, MinimalSpacingPrecision, TAccumulator> SlabFilterType;
+
+  /** The filter that computes the last iteration within the columns. */
+  typedef GeneralizedDistanceTransformImageFilter<TDistanceImage, TDistanceImage,
+          TLabelImage, MinimalSpacingPrecision, TAccumulator> ColumnFilterType;
+
+  typedef typename SlabFilterType::BooleanArrayType BooleanArrayType;
+
+  /** The apex height that marks background voxels. */
+  static DistancePixelType GetMaximumApexHeight()
+    { return SlabFilterType::GetMaximumApexHeight(); }
+
+  /** Set/Get the transport that connects the processes. */
+  itkSetObjectMacro(Transport, SlabTransport);
+  itkGetObjectMacro(Transport, SlabTransport);
+
+  /** Connect the slab of the function image that is owned by this
+   * process. */
+  void SetInput1(const FunctionImageType *functionImage);
+
+  /** Connect the slab of the label image that is owned by this process.
+   * Will only be used if a voronoi map is created. */
+  void SetInput2(const LabelImageType *labelImage);
+
+  /** Set/Get the region of the whole image. */
+  itkSetMacro(GlobalRegion, RegionType);
+  itkGetConstReferenceMacro(GlobalRegion, RegionType);
+
+  /** Set/Get wether spacing should be used or not. */
+  itkGetMacro(UseSpacing, bool);
+  itkSetMacro(UseSpacing, bool);
+  itkBooleanMacro(UseSpacing);
+
+  /** Set/Get wether voronoi map should be created or not. */
+  itkGetMacro(CreateVoronoiMap, bool);
+  itkSetMacro(CreateVoronoiMap, bool);
+  itkBooleanMacro(CreateVoronoiMap);
+
+  /** Set/Get wether the image is periodic along each of the dimensions. */
+  itkSetMacro(PeriodicBoundary, BooleanArrayType);
+  itkGetConstReferenceMacro(PeriodicBoundary, BooleanArrayType);
+
+  /** Set/Get the number of threads of each process. */
+  itkSetMacro(NumberOfThreads, int);
+  itkGetMacro(NumberOfThreads, int);
+
+  /** Set/Get the largest number of bytes that a process sends to one of
+   * its peers in one exchange. The images are redistributed and gathered
+   * in as many exchanges as needed. Default is 1 MB. */
+  itkSetMacro(ExchangeBufferSize, unsigned long);
+  itkGetMacro(ExchangeBufferSize, unsigned long);
+
+  /** Set/Get wether the result is redistributed back into the slabs.
+   * Otherwise, the outputs cover GetColumnRegion(). Default is true. */
+  itkGetMacro(TransposeBack, bool);
+  itkSetMacro(TransposeBack, bool);
+  itkBooleanMacro(TransposeBack);
+
+  /** Region of the slab of process rank out of numberOfProcesses. */
+  static RegionType GetSlabRegion(const RegionType &globalRegion,
+      int rank, int numberOfProcesses);
+
+  /** Region of the columns of process rank out of numberOfProcesses. */
+  static RegionType GetColumnRegion(const RegionType &globalRegion,
+      int rank, int numberOfProcesses);
+
+  /** Compute the transform. Must be called by all processes. */
+  void Update();
+
+  /** Get the part of the distance image owned by this process. */
+  DistanceImageType* GetDistance(void);
+
+  /** Get the part of the voronoi map owned by this process. */
+  LabelImageType* GetVoronoiMap(void);
+
+  /** Number of saturated samples in this process, see
+   * GeneralizedDistanceTransformImageFilter::GetNumberOfSaturatedPixels(). */
+  itkGetConstMacro(NumberOfSaturatedPixels, unsigned long);
+
+  /** Collect the parts of an image from all processes in the process with
+   * rank root. Returns the whole image there and NULL elsewhere. Must be
+   * called by all processes with the same root. */
+  template < class TImage >
+  typename TImage::Pointer GatherImage(const TImage *image, int root = 0);
+
+protected:
+  DistributedGeneralizedDistanceTransform();
+  virtual ~DistributedGeneralizedDistanceTransform() {};
+  void PrintSelf(std::ostream& os, Indent indent) const;
+
+  /** Split the global region into numberOfProcesses parts along
+   * dimension. */
+  static RegionType SplitRegion(const RegionType &globalRegion,
+      unsigned int dimension, int rank, int numberOfProcesses);
+
+  /** Move the pixels from the slabs of all processes into their columns or
+   * back. */
+  template < class TImage >
+  void Redistribute(const TImage *source, TImage *destination, bool toColumns);
+
+  /** Create an image with the spacing and origin of the input. */
+  template < class TImage >
+  typename TImage::Pointer CreateImage(const RegionType &region) const;
+
+private:
+  DistributedGeneralizedDistanceTransform(const Self&); //purposely not implemented
+  void operator=(const Self&); //purposely not implemented
+
+  SlabTransport::Pointer m_Transport;
+  FunctionImageConstPointer m_FunctionImage;
+  LabelImageConstPointer m_LabelImage;
+  RegionType m_GlobalRegion;
+
+  bool m_UseSpacing;
+  bool m_CreateVoronoiMap;
+  BooleanArrayType m_PeriodicBoundary;
+  int m_NumberOfThreads;
+  unsigned long m_ExchangeBufferSize;
+  bool m_TransposeBack;
+
+  DistanceImagePointer m_Distance;
+  LabelImagePointer m_VoronoiMap;
+  unsigned long m_NumberOfSaturatedPixels;
+
+}; // end of DistributedGeneralizedDistanceTransform class
+
+} //end namespace itk
+
+
+#ifndef ITK_MANUAL_INSTANTIATION
+#include "itkDistributedGeneralizedDistanceTransform.txx"
+#endif
+
+#endif
@@ -0,0 +1,461 @@
+#ifndef __itkDistributedGeneralizedDistanceTransform_txx
+#define __itkDistributedGeneralizedDistanceTransform_txx
+
+#include <cstring>
+#include <algorithm>
+
+#include "itkDistributedGeneralizedDistanceTransform.h"
+#include "itkImageRegionConstIterator.h"
+#include "itkImageRegionIterator.h"
+
+namespace itk
+{
+
+
+/**
+ *    Constructor
+ */
+template < class TFunctionImage,class TDistanceImage, class TLabelImage, unsigned char MinimalSpacingPrecision, class TAccumulator >
+DistributedGeneralizedDistanceTransform< TFunctionImage, TDistanceImage, TLabelImage, MinimalSpacingPrecision, TAccumulator >
+::DistributedGeneralizedDistanceTransform()
+{
+  m_UseSpacing = true;
+  m_CreateVoronoiMap = true;
+  m_PeriodicBoundary.Fill(false);
+  m_NumberOfThreads = MultiThreader::GetGlobalDefaultNumberOfThreads();
+  m_ExchangeBufferSize = 1 << 20;
+  m_TransposeBack = true;
+  m_NumberOfSaturatedPixels = 0;
+}
+
+template < class TFunctionImage,class TDistanceImage, class TLabelImage, unsigned char MinimalSpacingPrecision, class TAccumulator >
+void
+DistributedGeneralizedDistanceTransform< TFunctionImage, TDistanceImage, TLabelImage, MinimalSpacingPrecision, TAccumulator >
+::SetInput1(const FunctionImageType *functionImage)
+{
+  m_FunctionImage = functionImage;
+  this->Modified();
+}
+
+template < class TFunctionImage,class TDistanceImage, class TLabelImage, unsigned char MinimalSpacingPrecision, class TAccumulator >
+void
+DistributedGeneralizedDistanceTransform< TFunctionImage, TDistanceImage, TLabelImage, MinimalSpacingPrecision, TAccumulator >
+::SetInput2(const LabelImageType *labelImage)
+{
+  m_LabelImage = labelImage;
+  this->Modified();
+}
+
+template < class TFunctionImage,class TDistanceImage, class TLabelImage, unsigned char MinimalSpacingPrecision, class TAccumulator >
+typename
+DistributedGeneralizedDistanceTransform< TFunctionImage, TDistanceImage, TLabelImage, MinimalSpacingPrecision, TAccumulator >
+::DistanceImageType*
+DistributedGeneralizedDistanceTransform< TFunctionImage, TDistanceImage, TLabelImage, MinimalSpacingPrecision, TAccumulator >
+::GetDistance(void)
+{
+  return m_Distance;
+}
+
+template < class TFunctionImage,class TDistanceImage, class TLabelImage, unsigned char MinimalSpacingPrecision, class TAccumulator >
+typename
+DistributedGeneralizedDistanceTransform< TFunctionImage, TDistanceImage, TLabelImage, MinimalSpacingPrecision, TAccumulator >
+::LabelImageType*
+DistributedGeneralizedDistanceTransform< TFunctionImage, TDistanceImage, TLabelImage, MinimalSpacingPrecision, TAccumulator >
+::GetVoronoiMap(void)
+{
+  assert(m_CreateVoronoiMap);
+  return m_VoronoiMap;
+}
+
+/**
+ * Split the global region along a dimension
+ */
+template < class TFunctionImage,class TDistanceImage, class TLabelImage, unsigned char MinimalSpacingPrecision, class TAccumulator >
+typename
+DistributedGeneralizedDistanceTransform< TFunctionImage, TDistanceImage, TLabelImage, MinimalSpacingPrecision, TAccumulator >
+::RegionType
+DistributedGeneralizedDistanceTransform< TFunctionImage, TDistanceImage, TLabelImage, MinimalSpacingPrecision, TAccumulator >
+::SplitRegion(const RegionType &globalRegion, unsigned int dimension,
+    int rank, int numberOfProcesses)
+{
+  const unsigned long size = globalRegion.GetSize()[dimension];
+  const unsigned long first = size * rank / numberOfProcesses;
+  const unsigned long end = size * (rank + 1) / numberOfProcesses;
+
+  RegionType region = globalRegion;
+  typename RegionType::IndexType index = region.GetIndex();
+  typename RegionType::SizeType regionSize = region.GetSize();
+  index[dimension] += first;
+  regionSize[dimension] = end - first;
+  region.SetIndex(index);
+  region.SetSize(regionSize);
+  return region;
+}
+
+template < class TFunctionImage,class TDistanceImage, class TLabelImage, unsigned char MinimalSpacingPrecision, class TAccumulator >
+typename
+DistributedGeneralizedDistanceTransform< TFunctionImage, TDistanceImage, TLabelImage, MinimalSpacingPrecision, TAccumulator >
+::RegionType
+DistributedGeneralizedDistanceTransform< TFunctionImage, TDistanceImage, TLabelImage, MinimalSpacingPrecision, TAccumulator >
+::GetSlabRegion(const RegionType &globalRegion, int rank, int numberOfProcesses)
+{
+  return SplitRegion(globalRegion, ImageDimension - 1, rank, numberOfProcesses);
+}
+
+template < class TFunctionImage,class TDistanceImage, class TLabelImage, unsigned char MinimalSpacingPrecision, class TAccumulator >
+typename
+DistributedGeneralizedDistanceTransform< TFunctionImage, TDistanceImage, TLabelImage, MinimalSpacingPrecision, TAccumulator >
+::RegionType
+DistributedGeneralizedDistanceTransform< TFunctionImage, TDistanceImage, TLabelImage, MinimalSpacingPrecision, TAccumulator >
+::GetColumnRegion(const RegionType &globalRegion, int rank, int numberOfProcesses)
+{
+  return SplitRegion(globalRegion, ImageDimension - 2, rank, numberOfProcesses);
+}
+
+/**
+ * Create an image with the geometry of the input
+ */
+template < class TFunctionImage,class TDistanceImage, class TLabelImage, unsigned char MinimalSpacingPrecision, class TAccumulator >
+template < class TImage >
+typename TImage::Pointer
+DistributedGeneralizedDistanceTransform< TFunctionImage, TDistanceImage, TLabelImage, MinimalSpacingPrecision, TAccumulator >
+::CreateImage(const RegionType &region) const
+{
+  typename TImage::Pointer image = TImage::New();
+  image->SetRegions(region);
+  image->SetSpacing(m_FunctionImage->GetSpacing());
+  image->SetOrigin(m_FunctionImage->GetOrigin());
+  image->Allocate();
+  return image;
+}
+
+/**
+ * Move the pixels between the slabs and columns of all processes
+ */
+template < class TFunctionImage,class TDistanceImage, class TLabelImage, unsigned char MinimalSpacingPrecision, class TAccumulator >
+template < class TImage >
+void
+DistributedGeneralizedDistanceTransform< TFunctionImage, TDistanceImage, TLabelImage, MinimalSpacingPrecision, TAccumulator >
+::Redistribute(const TImage *source, TImage *destination, bool toColumns)
+{
+  typedef typename TImage::PixelType PixelType;
+  const int numberOfProcesses = m_Transport->GetNumberOfProcesses();
+
+  // The part of the own source region that goes to process q is the
+  // intersection with the destination region of q. Both sides iterate over
+  // the intersection in the same order.
+  std::vector<ImageRegionConstIterator<TImage> > sendIts;
+  std::vector<unsigned long> sendRemaining;
+  std::vector<ImageRegionIterator<TImage> > receiveIts;
+  std::vector<unsigned long> receiveRemaining;
+  for (int q = 0; q < numberOfProcesses; ++q)
+  {
+    RegionType block = toColumns ?
+      GetColumnRegion(m_GlobalRegion, q, numberOfProcesses) :
+      GetSlabRegion(m_GlobalRegion, q, numberOfProcesses);
+    block.Crop(source->GetBufferedRegion());
+    sendIts.push_back(ImageRegionConstIterator<TImage>(source, block));
+    sendRemaining.push_back(block.GetNumberOfPixels());
+
+    block = toColumns ?
+      GetSlabRegion(m_GlobalRegion, q, numberOfProcesses) :
+      GetColumnRegion(m_GlobalRegion, q, numberOfProcesses);
+    block.Crop(destination->GetBufferedRegion());
+    receiveIts.push_back(ImageRegionIterator<TImage>(destination, block));
+    receiveRemaining.push_back(block.GetNumberOfPixels());
+  }
+
+  // The blocks are exchanged in rounds of at most pixelsPerExchange pixels.
+  // All processes do as many rounds as the largest block of any pair
+  // needs.
+  unsigned long largestBlock = 0;
+  for (int p = 0; p < numberOfProcesses; ++p)
+  {
+    for (int q = 0; q < numberOfProcesses; ++q)
+    {
+      RegionType block = GetSlabRegion(m_GlobalRegion, p, numberOfProcesses);
+      block.Crop(GetColumnRegion(m_GlobalRegion, q, numberOfProcesses));
+      largestBlock = std::max(largestBlock, block.GetNumberOfPixels());
+    }
+  }
+  const unsigned long pixelsPerExchange =
+    std::max(1UL, m_ExchangeBufferSize / sizeof(PixelType));
+  const unsigned long numberOfExchanges =
+    (largestBlock + pixelsPerExchange - 1) / pixelsPerExchange;
+
+  SlabTransport::BufferArrayType send(numberOfProcesses);
+  SlabTransport::BufferArrayType receive;
+  for (unsigned long exchange = 0; exchange < numberOfExchanges; ++exchange)
+  {
+    for (int q = 0; q < numberOfProcesses; ++q)
+    {
+      const unsigned long count = std::min(sendRemaining[q], pixelsPerExchange);
+      sendRemaining[q] -= count;
+      send[q].resize(count * sizeof(PixelType));
+      char *data = count ? &send[q][0] : 0;
+      for (unsigned long i = 0; i < count; ++i, ++sendIts[q], data += sizeof(PixelType))
+      {
+        const PixelType value = sendIts[q].Get();
+        memcpy(data, &value, sizeof(PixelType));
+      }
+    }
+
+    m_Transport->AllToAll(send, receive);
+
+    for (int p = 0; p < numberOfProcesses; ++p)
+    {
+      const unsigned long count = std::min(receiveRemaining[p], pixelsPerExchange);
+      receiveRemaining[p] -= count;
+      if (receive[p].size() != count * sizeof(PixelType))
+        itkExceptionMacro(<< "Process " << p << " sent " << receive[p].size()
+            << " bytes instead of " << count * sizeof(PixelType));
+
+      const char *data = count ? &receive[p][0] : 0;
+      for (unsigned long i = 0; i < count; ++i, ++receiveIts[p], data += sizeof(PixelType))
+      {
+        PixelType value;
+        memcpy(&value, data, sizeof(PixelType));
+        receiveIts[p].Set(value);
+      }
+    }
+  }
+}
+
+/**
+ * Collect an image in one process
+ */
+template < class TFunctionImage,class TDistanceImage, class TLabelImage, unsigned char MinimalSpacingPrecision, class TAccumulator >
+template < class TImage >
+typename TImage::Pointer
+DistributedGeneralizedDistanceTransform< TFunctionImage, TDistanceImage, TLabelImage, MinimalSpacingPrecision, TAccumulator >
+::GatherImage(const TImage *image, int root)
+{
+  typedef typename TImage::PixelType PixelType;
+  const int rank = m_Transport->GetRank();
+  const int numberOfProcesses = m_Transport->GetNumberOfProcesses();
+
+  // Each process first sends its region to all processes, so that all of
+  // them know how many rounds the pixels need
+  const RegionType region = image->GetBufferedRegion();
+  long header[2 * ImageDimension];
+  for (unsigned int i = 0; i < ImageDimension; ++i)
+  {
+    header[i] = region.GetIndex()[i];
+    header[ImageDimension + i] = region.GetSize()[i];
+  }
+
+  SlabTransport::BufferArrayType send(numberOfProcesses,
+      SlabTransport::BufferType(reinterpret_cast<const char *>(header),
+        reinterpret_cast<const char *>(header) + sizeof(header)));
+  SlabTransport::BufferArrayType receive;
+  m_Transport->AllToAll(send, receive);
+
+  std::vector<RegionType> blocks(numberOfProcesses);
+  std::vector<unsigned long> receiveRemaining(numberOfProcesses);
+  unsigned long largestBlock = 0;
+  for (int p = 0; p < numberOfProcesses; ++p)
+  {
+    if (receive[p].size() != sizeof(header))
+      itkExceptionMacro(<< "Process " << p << " sent no region");
+
+    memcpy(header, &receive[p][0], sizeof(header));
+    typename RegionType::IndexType index;
+    typename RegionType::SizeType size;
+    for (unsigned int i = 0; i < ImageDimension; ++i)
+    {
+      index[i] = header[i];
+      size[i] = header[ImageDimension + i];
+    }
+    blocks[p].SetIndex(index);
+    blocks[p].SetSize(size);
+
+    if (!m_GlobalRegion.IsInside(blocks[p]))
+      itkExceptionMacro(<< "Process " << p << " sent an invalid region " << blocks[p]);
+    receiveRemaining[p] = blocks[p].GetNumberOfPixels();
+    largestBlock = std::max(largestBlock, receiveRemaining[p]);
+  }
+
+  typename TImage::Pointer result;
+  std::vector<ImageRegionIterator<TImage> > resultIts;
+  if (rank == root)
+  {
+    result = TImage::New();
+    result->SetRegions(m_GlobalRegion);
+    result->SetSpacing(image->GetSpacing());
+    result->SetOrigin(image->GetOrigin());
+    result->Allocate();
+    for (int p = 0; p < numberOfProcesses; ++p)
+      resultIts.push_back(ImageRegionIterator<TImage>(result, blocks[p]));
+  }
+
+  // Then the pixels, in rounds of at most pixelsPerExchange pixels
+  const unsigned long pixelsPerExchange =
+    std::max(1UL, m_ExchangeBufferSize / sizeof(PixelType));
+  const unsigned long numberOfExchanges =
+    (largestBlock + pixelsPerExchange - 1) / pixelsPerExchange;
+
+  ImageRegionConstIterator<TImage> it(image, region);
+  unsigned long sendRemaining = region.GetNumberOfPixels();
+  for (unsigned long exchange = 0; exchange < numberOfExchanges; ++exchange)
+  {
+    const unsigned long count = std::min(sendRemaining, pixelsPerExchange);
+    sendRemaining -= count;
+    send.assign(numberOfProcesses, SlabTransport::BufferType());
+    send[root].resize(count * sizeof(PixelType));
+    char *data = count ? &send[root][0] : 0;
+    for (unsigned long i = 0; i < count; ++i, ++it, data += sizeof(PixelType))
+    {
+      const PixelType value = it.Get();
+      memcpy(data, &value, sizeof(PixelType));
+    }
+
+    m_Transport->AllToAll(send, receive);
+    if (rank != root)
+      continue;
+
+    for (int p = 0; p < numberOfProcesses; ++p)
+    {
+      const unsigned long received = std::min(receiveRemaining[p], pixelsPerExchange);
+      receiveRemaining[p] -= received;
+      if (receive[p].size() != received * sizeof(PixelType))
+        itkExceptionMacro(<< "Process " << p << " sent " << receive[p].size()
+            << " bytes instead of " << received * sizeof(PixelType));
+
+      const char *blockData = received ? &receive[p][0] : 0;
+      for (unsigned long i = 0; i < received; ++i, ++resultIts[p], blockData += sizeof(PixelType))
+      {
+        PixelType value;
+        memcpy(&value, blockData, sizeof(PixelType));
+        resultIts[p].Set(value);
+      }
+    }
+  }
+
+  return result;
+}
+
+/**
+ * Compute the transform
+ */
+template < class TFunctionImage,class TDistanceImage, class TLabelImage, unsigned char MinimalSpacingPrecision, class TAccumulator >
+void
+DistributedGeneralizedDistanceTransform< TFunctionImage, TDistanceImage, TLabelImage, MinimalSpacingPrecision, TAccumulator >
+::Update()
+{
+  if (ImageDimension < 2)
+    itkExceptionMacro(<< "At least two dimensions are needed");
+  if (!m_Transport)
+    itkExceptionMacro(<< "No transport set");
+  if (!m_FunctionImage || (m_CreateVoronoiMap && !m_LabelImage))
+    itkExceptionMacro(<< "Inputs are missing");
+
+  const int rank = m_Transport->GetRank();
+  const int numberOfProcesses = m_Transport->GetNumberOfProcesses();
+
+  for (unsigned int d = ImageDimension - 2; d < ImageDimension; ++d)
+    if (m_GlobalRegion.GetSize()[d] < static_cast<unsigned long>(numberOfProcesses))
+      itkExceptionMacro(<< "The global region " << m_GlobalRegion
+          << " is too small along dimension " << d << " for "
+          << numberOfProcesses << " processes");
+
+  const RegionType slabRegion = GetSlabRegion(m_GlobalRegion, rank, numberOfProcesses);
+  const RegionType columnRegion = GetColumnRegion(m_GlobalRegion, rank, numberOfProcesses);
+
+  // The iterations over all dimensions but the last one within the slab
+  BooleanArrayType processedDimensions;
+  processedDimensions.Fill(true);
+  processedDimensions[ImageDimension - 1] = false;
+
+  typename SlabFilterType::Pointer slabFilter = SlabFilterType::New();
+  slabFilter->SetInput1(m_FunctionImage);
+  if (m_CreateVoronoiMap)
+    slabFilter->SetInput2(m_LabelImage);
+  slabFilter->SetUseSpacing(m_UseSpacing);
+  slabFilter->SetCreateVoronoiMap(m_CreateVoronoiMap);
+  slabFilter->SetPeriodicBoundary(m_PeriodicBoundary);
+  slabFilter->SetProcessedDimensions(processedDimensions);
+  slabFilter->SetNumberOfThreads(m_NumberOfThreads);
+  slabFilter->Update();
+
+  if (slabFilter->GetDistance()->GetBufferedRegion() != slabRegion)
+    itkExceptionMacro(<< "The input of process " << rank << " has region "
+        << slabFilter->GetDistance()->GetBufferedRegion() << " instead of "
+        << slabRegion);
+
+  // Each process receives full columns
+  DistanceImagePointer columnDistance = this->template CreateImage<DistanceImageType>(columnRegion);
+  this->template Redistribute<DistanceImageType>(slabFilter->GetDistance(), columnDistance, true);
+
+  LabelImagePointer columnVoronoiMap;
+  if (m_CreateVoronoiMap)
+  {
+    columnVoronoiMap = this->template CreateImage<LabelImageType>(columnRegion);
+    this->template Redistribute<LabelImageType>(slabFilter->GetVoronoiMap(), columnVoronoiMap, true);
+  }
+
+  m_NumberOfSaturatedPixels = slabFilter->GetNumberOfSaturatedPixels();
+  slabFilter = 0;
+
+  // The iteration over the last dimension, in place
+  processedDimensions.Fill(false);
+  processedDimensions[ImageDimension - 1] = true;
+
+  typename ColumnFilterType::Pointer columnFilter = ColumnFilterType::New();
+  columnFilter->SetInput1(columnDistance);
+  columnFilter->SetDistanceImportPointer(columnDistance->GetBufferPointer());
+  if (m_CreateVoronoiMap)
+  {
+    columnFilter->SetInput2(columnVoronoiMap);
+    columnFilter->SetVoronoiMapImportPointer(columnVoronoiMap->GetBufferPointer());
+  }
+  columnFilter->SetUseSpacing(m_UseSpacing);
+  columnFilter->SetCreateVoronoiMap(m_CreateVoronoiMap);
+  columnFilter->SetPeriodicBoundary(m_PeriodicBoundary);
+  columnFilter->SetProcessedDimensions(processedDimensions);
+  columnFilter->SetNumberOfThreads(m_NumberOfThreads);
+  columnFilter->Update();
+
+  m_NumberOfSaturatedPixels += columnFilter->GetNumberOfSaturatedPixels();
+  columnFilter = 0;
+
+  if (!m_TransposeBack)
+  {
+    m_Distance = columnDistance;
+    m_VoronoiMap = columnVoronoiMap;
+    return;
+  }
+
+  // Back into the slabs
+  m_Distance = this->template CreateImage<DistanceImageType>(slabRegion);
+  this->template Redistribute<DistanceImageType>(columnDistance, m_Distance, false);
+  columnDistance = 0;
+
+  m_VoronoiMap = 0;
+  if (m_CreateVoronoiMap)
+  {
+    m_VoronoiMap = this->template CreateImage<LabelImageType>(slabRegion);
+    this->template Redistribute<LabelImageType>(columnVoronoiMap, m_VoronoiMap, false);
+  }
+}
+
+/**
+ *  Print Self
+ */
+template < class TFunctionImage,class TDistanceImage, class TLabelImage, unsigned char MinimalSpacingPrecision, class TAccumulator >
+void
+DistributedGeneralizedDistanceTransform< TFunctionImage, TDistanceImage, TLabelImage, MinimalSpacingPrecision, TAccumulator >
+::PrintSelf(std::ostream& os, Indent indent) const
+{
+  Superclass::PrintSelf(os,indent);
+  os << indent << "Transport: " << m_Transport.GetPointer() << std::endl;
+  os << indent << "GlobalRegion: " << m_GlobalRegion << std::endl;
+  os << indent << "UseSpacing: " << m_UseSpacing << std::endl;
+  os << indent << "CreateVoronoiMap: " << m_CreateVoronoiMap << std::endl;
+  os << indent << "PeriodicBoundary: " << m_PeriodicBoundary << std::endl;
+  os << indent << "NumberOfThreads: " << m_NumberOfThreads << std::endl;
+  os << indent << "ExchangeBufferSize: " << m_ExchangeBufferSize << std::endl;
+  os << indent << "TransposeBack: " << m_TransposeBack << std::endl;
+  os << indent << "NumberOfSaturatedPixels: " << m_NumberOfSaturatedPixels << std::endl;
+}
+} // end namespace itk
+#endif
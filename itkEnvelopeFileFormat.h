@@ -0,0 +1,215 @@
+#ifndef __itkEnvelopeFileFormat_h
+#define __itkEnvelopeFileFormat_h
+
+#include <vector>
+#include <limits>
+#include <cstring>
+#include <stdint.h>
+
+namespace itk
+{
+
+/** Encoding of the apex heights and labels: Integers as the difference to
+ * the previous value, everything else as raw bytes. See
+ * itk::EnvelopeFileFormat. */
+template < bool IsInteger >
+struct EnvelopeValueCoder
+{
+  template < class T >
+  static void Write(std::vector<unsigned char> &buffer, const T &value, const T &previous);
+
+  template < class T >
+  static bool Read(const unsigned char *&pointer, const unsigned char *end, T &value);
+};
+
+template <>
+struct EnvelopeValueCoder<true>
+{
+  template < class T >
+  static void Write(std::vector<unsigned char> &buffer, const T &value, const T &previous);
+
+  template < class T >
+  static bool Read(const unsigned char *&pointer, const unsigned char *end, T &value);
+};
+
+/** \class EnvelopeFileFormat
+*
+* Encoding of the envelopes of the scanlines along the last dimension, as
+* kept by itk::LazyGeneralizedDistanceTransform. Written by
+* LazyGeneralizedDistanceTransform::WriteEnvelopes() and read by
+* itk::EnvelopeFileReader.
+*
+* LAYOUT
+* All numbers are in the byte order of the writing machine, which is
+* checked with the byte order mark.
+*   char[8]   "GDTENV1"
+*   uint32    byte order mark 0x01020304
+*   uint32    dimension D
+*   uint32    type code of the apex heights: bytes << 1 | is-integer
+*   uint32    type code of the labels, 0 without labels
+*   int64[D]  index of the region, uint64[D] its size
+*   double[D] spacing, double[D] origin
+*   double    spacing of the envelopes, 1 if spacing was not used
+*   double    the largest apex height, which marks the background
+*   label     the label of scanlines without parabolas, only with labels
+*   uint64    number of scanlines L, uint64 number of parabolas
+*   uint64[L+1] start of each scanline in the scanline data
+*   the scanline data
+*
+* A scanline is the number of its parabolas followed by the parabolas in
+* the order of their abscissas. A parabola is its abscissa and the
+* abscissa after which it is minimal, both as unsigned varints of the
+* difference to the previous parabola, and its apex height and label as
+* signed varints of the difference to the previous parabola if they are
+* integers, or as their raw bytes otherwise. Only the parabolas that are
+* minimal somewhere within the region are stored.
+*
+* \ingroup ImageFeatureExtraction
+*
+*/
+class EnvelopeFileFormat
+{
+public:
+  static const char *GetMagic()
+    { return "GDTENV1"; }
+  static uint32_t GetByteOrderMark()
+    { return 0x01020304; }
+
+  /** Append the raw bytes of value to buffer. */
+  template < class T >
+  static void WriteRaw(std::vector<unsigned char> &buffer, const T &value)
+    {
+    const unsigned char *bytes = reinterpret_cast<const unsigned char *>(&value);
+    buffer.insert(buffer.end(), bytes, bytes + sizeof(T));
+    }
+
+  /** Read a value from its raw bytes and advance pointer. */
+  template < class T >
+  static T ReadRaw(const unsigned char *&pointer)
+    {
+    T value;
+    memcpy(&value, pointer, sizeof(T));
+    pointer += sizeof(T);
+    return value;
+    }
+
+  /** Append value in 7-bit groups, the least significant first. The high
+   * bit of a byte tells whether more bytes follow. */
+  static void WriteVarint(std::vector<unsigned char> &buffer, uint64_t value)
+    {
+    while (value >= 0x80)
+    {
+      buffer.push_back(static_cast<unsigned char>(value | 0x80));
+      value >>= 7;
+    }
+    buffer.push_back(static_cast<unsigned char>(value));
+    }
+
+  /** Read a varint that must end before end and advance pointer. Returns
+   * false if it doesn't, or if it doesn't fit into 64 bits. */
+  static bool ReadVarint(const unsigned char *&pointer, const unsigned char *end,
+      uint64_t &value)
+    {
+    value = 0;
+    for (unsigned int shift = 0; shift < 64; shift += 7)
+    {
+      if (pointer == end)
+        return false;
+      const unsigned char byte = *pointer++;
+      // The tenth byte holds the highest bit only
+      if (shift == 63 && (byte & 0x7e))
+        return false;
+      value |= static_cast<uint64_t>(byte & 0x7f) << shift;
+      if (!(byte & 0x80))
+        return true;
+    }
+    return false;
+    }
+
+  /** Signed values are mapped to unsigned ones with small absolute values
+   * first: 0, -1, 1, -2, ... */
+  static void WriteSignedVarint(std::vector<unsigned char> &buffer, int64_t value)
+    {
+    WriteVarint(buffer, (static_cast<uint64_t>(value) << 1) ^ static_cast<uint64_t>(value >> 63));
+    }
+
+  static bool ReadSignedVarint(const unsigned char *&pointer, const unsigned char *end,
+      int64_t &value)
+    {
+    uint64_t code;
+    if (!ReadVarint(pointer, end, code))
+      return false;
+    value = static_cast<int64_t>(code >> 1) ^ -static_cast<int64_t>(code & 1);
+    return true;
+    }
+
+  /** Append value, as the difference to previous if T is an integer type.
+   * previous becomes value. */
+  template < class T >
+  static void WriteValue(std::vector<unsigned char> &buffer, const T &value, T &previous)
+    {
+    EnvelopeValueCoder<std::numeric_limits<T>::is_integer>::Write(buffer, value, previous);
+    previous = value;
+    }
+
+  /** Read a value that must end before end. previous becomes the value.
+   * Returns false if the value doesn't end before end. */
+  template < class T >
+  static bool ReadValue(const unsigned char *&pointer, const unsigned char *end, T &previous)
+    {
+    return EnvelopeValueCoder<std::numeric_limits<T>::is_integer>::Read(pointer, end, previous);
+    }
+
+  /** The type description of the header. */
+  template < class T >
+  static uint32_t GetTypeCode()
+    {
+    return static_cast<uint32_t>(sizeof(T) << 1) |
+      (std::numeric_limits<T>::is_integer ? 1 : 0);
+    }
+
+}; // end of EnvelopeFileFormat class
+
+template < bool IsInteger >
+template < class T >
+void EnvelopeValueCoder<IsInteger>
+::Write(std::vector<unsigned char> &buffer, const T &value, const T &)
+{
+  EnvelopeFileFormat::WriteRaw(buffer, value);
+}
+
+template < bool IsInteger >
+template < class T >
+bool EnvelopeValueCoder<IsInteger>
+::Read(const unsigned char *&pointer, const unsigned char *end, T &value)
+{
+  if (end - pointer < static_cast<long>(sizeof(T)))
+    return false;
+  value = EnvelopeFileFormat::ReadRaw<T>(pointer);
+  return true;
+}
+
+template < class T >
+void EnvelopeValueCoder<true>
+::Write(std::vector<unsigned char> &buffer, const T &value, const T &previous)
+{
+  EnvelopeFileFormat::WriteSignedVarint(buffer,
+      static_cast<int64_t>(value) - static_cast<int64_t>(previous));
+}
+
+template < class T >
+bool EnvelopeValueCoder<true>
+::Read(const unsigned char *&pointer, const unsigned char *end, T &value)
+{
+  int64_t difference;
+  if (!EnvelopeFileFormat::ReadSignedVarint(pointer, end, difference))
+    return false;
+  // Corrupt differences wrap around instead of overflowing
+  value = static_cast<T>(static_cast<int64_t>(
+        static_cast<uint64_t>(static_cast<int64_t>(value)) + static_cast<uint64_t>(difference)));
+  return true;
+}
+
+} //end namespace itk
+
+#endif
@@ -0,0 +1,188 @@
+#ifndef __itkEnvelopeFileReader_h
+#define __itkEnvelopeFileReader_h
+
+#include "itkObject.h"
+#include "itkImage.h"
+#include "itkEnvelopeFileFormat.h"
+
+#include <string>
+#include <vector>
+
+namespace itk
+{
+
+/** \class EnvelopeFileReader
+*
+* Reads the envelopes written by
+* itk::LazyGeneralizedDistanceTransform::WriteEnvelopes() and answers the
+* same queries, see itk::EnvelopeFileFormat for the layout.
+*
+* MEMORY MAPPING
+* Update() maps the file into memory and only checks its header and the
+* starts of the scanlines. The scanlines are decoded when they are queried,
+* so a query only touches the pages of its scanline. GetDistance() and
+* GetVoronoiLabel() decode the scanline up to the queried voxel, ReadLine()
+* decodes a whole scanline at once. On systems without mmap(), the file is
+* read into memory instead.
+*
+* CORRUPT FILES
+* A corrupt file throws an exception instead of reading or writing out of
+* bounds: Update() checks that the scanlines follow each other within the
+* file, and decoding stops at the end of the scanline.
+*
+* The types of the apex heights and labels must be the ones the file was
+* written with.
+*
+* \ingroup ImageFeatureExtraction
+*
+*/
+
+template <
+  class TDistanceImage, class TLabelImage=TDistanceImage,
+        class TAccumulator=typename TDistanceImage::PixelType >
+class ITK_EXPORT EnvelopeFileReader : public Object
+{
+public:
+  /** Standard class typedefs. */
+  typedef EnvelopeFileReader Self;
+  typedef Object Superclass;
+  typedef SmartPointer<Self> Pointer;
+  typedef SmartPointer<const Self> ConstPointer;
+
+  /** Method for creation through the object factory */
+  itkNewMacro(Self);
+
+  /** Run-time type information (and related methods). */
+  itkTypeMacro(EnvelopeFileReader, Object);
+
+  /** Image dimension. */
+  itkStaticConstMacro(ImageDimension, unsigned int, TDistanceImage::ImageDimension);
+
+  /** Types and pointer types for the images. */
+  typedef TDistanceImage DistanceImageType;
+  typedef TLabelImage LabelImageType;
+
+  typedef typename DistanceImageType::Pointer DistanceImagePointer;
+  typedef typename LabelImageType::Pointer LabelImagePointer;
+  typedef typename DistanceImageType::PixelType DistancePixelType;
+  typedef typename LabelImageType::PixelType LabelPixelType;
+  typedef TAccumulator AccumulatorType;
+  typedef typename DistanceImageType::IndexType IndexType;
+  typedef typename DistanceImageType::RegionType RegionType;
+  typedef typename DistanceImageType::SpacingType SpacingType;
+  typedef typename DistanceImageType::PointType PointType;
+  typedef typename DistanceImageType::OffsetValueType OffsetValueType;
+  typedef typename DistanceImageType::IndexValueType AbscissaIndexType;
+
+  /** Set/Get the name of the envelope file. */
+  itkSetStringMacro(FileName);
+  itkGetStringMacro(FileName);
+
+  /** Map the file and read its header. */
+  void Update();
+
+  /** The geometry stored in the file. */
+  itkGetConstReferenceMacro(Region, RegionType);
+  itkGetConstReferenceMacro(Spacing, SpacingType);
+  itkGetConstReferenceMacro(Origin, PointType);
+
+  /** The apex height that marks background voxels, as stored in the file. */
+  itkGetConstMacro(MaximumApexHeight, DistancePixelType);
+
+  /** Wether the file holds voronoi labels. */
+  itkGetConstMacro(HasVoronoiLabels, bool);
+
+  /** The label of the voxels without foreground in their scanline along the
+   * last dimension. */
+  itkGetConstReferenceMacro(BackgroundLabel, LabelPixelType);
+
+  /** Number of parabolas stored for all scanlines. */
+  itkGetConstMacro(NumberOfParabolas, unsigned long);
+
+  /** The squared euclidean distance at index. index must lie inside
+   * GetRegion(). */
+  DistancePixelType GetDistance(const IndexType &index) const;
+
+  /** The voronoi label at index. Only available if the file holds voronoi
+   * labels. */
+  LabelPixelType GetVoronoiLabel(const IndexType &index) const;
+
+  /** Decode the scanline along the last dimension through index into
+   * distance and voronoiMap, which must hold the length of the scanline.
+   * voronoiMap may be NULL. */
+  void ReadLine(const IndexType &index, DistancePixelType *distance,
+      LabelPixelType *voronoiMap) const;
+
+  /** Decode all scanlines into a new dense distance image. */
+  DistanceImagePointer GenerateDistanceImage() const;
+
+  /** Decode all scanlines into a new dense voronoi map. Only available if
+   * the file holds voronoi labels. */
+  LabelImagePointer GenerateVoronoiMap() const;
+
+protected:
+  EnvelopeFileReader();
+  virtual ~EnvelopeFileReader();
+  void PrintSelf(std::ostream& os, Indent indent) const;
+
+  /** Release the mapping of the file. */
+  void Close();
+
+  /** Number of the scanline through index. */
+  unsigned long GetLine(const IndexType &index) const;
+
+  /** The data of scanline number line is [begin, end). */
+  void GetLineData(unsigned long line, const unsigned char *&begin,
+      const unsigned char *&end) const;
+
+  /** Read a varint or a value of a scanline that ends at end. Throw if it
+   * doesn't. See EnvelopeFileFormat. */
+  uint64_t ReadVarint(const unsigned char *&pointer, const unsigned char *end) const;
+  template < class T >
+  void ReadValue(const unsigned char *&pointer, const unsigned char *end, T &previous) const;
+
+  /** Decode the scanline number line into distance and voronoiMap, with the
+   * given strides between the voxels. Both may be NULL. */
+  void DecodeLine(unsigned long line, DistancePixelType *distance, OffsetValueType distanceStride,
+      LabelPixelType *voronoiMap, OffsetValueType voronoiMapStride) const;
+
+  /** Value of a parabola at abscissa, saturated to the maximum apex
+   * height. */
+  DistancePixelType EvaluateParabola(AbscissaIndexType apex,
+      AccumulatorType height, AbscissaIndexType abscissa) const;
+
+private:
+  EnvelopeFileReader(const Self&); //purposely not implemented
+  void operator=(const Self&); //purposely not implemented
+
+  std::string m_FileName;
+
+  /** The mapped file, or the file read into m_Buffer. */
+  void *m_Mapping;
+  unsigned long m_MappingSize;
+  std::vector<unsigned char> m_Buffer;
+
+  /** The start of each scanline, relative to m_LineData. */
+  const unsigned char *m_LineStart;
+  const unsigned char *m_LineData;
+  unsigned long m_NumberOfLines;
+  unsigned long m_NumberOfParabolas;
+
+  RegionType m_Region;
+  SpacingType m_Spacing;
+  PointType m_Origin;
+  double m_EnvelopeSpacing;
+  DistancePixelType m_MaximumApexHeight;
+  bool m_HasVoronoiLabels;
+  LabelPixelType m_BackgroundLabel;
+
+}; // end of EnvelopeFileReader class
+
+} //end namespace itk
+
+
+#ifndef ITK_MANUAL_INSTANTIATION
+#include "itkEnvelopeFileReader.txx"
+#endif
+
+#endif
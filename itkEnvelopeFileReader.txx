@@ -0,0 +1,529 @@
+#ifndef __itkEnvelopeFileReader_txx
+#define __itkEnvelopeFileReader_txx
+
+#include <fstream>
+#include <limits>
+
+#include "itkEnvelopeFileReader.h"
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#define ITK_ENVELOPE_FILE_MMAP
+#endif
+
+namespace itk
+{
+
+
+/**
+ *    Constructor
+ */
+template < class TDistanceImage, class TLabelImage, class TAccumulator >
+EnvelopeFileReader< TDistanceImage, TLabelImage, TAccumulator >
+::EnvelopeFileReader()
+{
+  m_Mapping = 0;
+  m_MappingSize = 0;
+  m_LineStart = 0;
+  m_LineData = 0;
+  m_NumberOfLines = 0;
+  m_NumberOfParabolas = 0;
+  m_Spacing.Fill(1.0);
+  m_Origin.Fill(0.0);
+  m_EnvelopeSpacing = 1;
+  m_MaximumApexHeight = DistancePixelType();
+  m_HasVoronoiLabels = false;
+  m_BackgroundLabel = LabelPixelType();
+}
+
+template < class TDistanceImage, class TLabelImage, class TAccumulator >
+EnvelopeFileReader< TDistanceImage, TLabelImage, TAccumulator >
+::~EnvelopeFileReader()
+{
+  this->Close();
+}
+
+template < class TDistanceImage, class TLabelImage, class TAccumulator >
+void
+EnvelopeFileReader< TDistanceImage, TLabelImage, TAccumulator >
+::Close()
+{
+#ifdef ITK_ENVELOPE_FILE_MMAP
+  if (m_Mapping)
+    munmap(m_Mapping, m_MappingSize);
+#endif
+  m_Mapping = 0;
+  m_MappingSize = 0;
+  std::vector<unsigned char>().swap(m_Buffer);
+  m_LineStart = 0;
+  m_LineData = 0;
+  m_NumberOfLines = 0;
+  m_NumberOfParabolas = 0;
+}
+
+/**
+ * Map the file and read its header
+ */
+template < class TDistanceImage, class TLabelImage, class TAccumulator >
+void
+EnvelopeFileReader< TDistanceImage, TLabelImage, TAccumulator >
+::Update()
+{
+  typedef EnvelopeFileFormat Format;
+
+  this->Close();
+
+  const unsigned char *begin;
+  unsigned long size;
+#ifdef ITK_ENVELOPE_FILE_MMAP
+  const int file = open(m_FileName.c_str(), O_RDONLY);
+  if (file < 0)
+    itkExceptionMacro(<< "Can't open " << m_FileName);
+  struct stat status;
+  if (fstat(file, &status) != 0 || status.st_size == 0)
+  {
+    close(file);
+    itkExceptionMacro(<< "Can't read " << m_FileName);
+  }
+  size = status.st_size;
+  // The mapping stays valid after the file is closed
+  void *mapping = mmap(0, size, PROT_READ, MAP_SHARED, file, 0);
+  close(file);
+  if (mapping == MAP_FAILED)
+    itkExceptionMacro(<< "Can't map " << m_FileName);
+  m_Mapping = mapping;
+  m_MappingSize = size;
+  begin = static_cast<const unsigned char *>(mapping);
+#else
+  std::ifstream file(m_FileName.c_str(), std::ios::in | std::ios::binary);
+  if (!file)
+    itkExceptionMacro(<< "Can't open " << m_FileName);
+  file.seekg(0, std::ios::end);
+  size = file.tellg();
+  file.seekg(0, std::ios::beg);
+  m_Buffer.resize(size);
+  if (size == 0 || !file.read(reinterpret_cast<char *>(&m_Buffer[0]), size))
+    itkExceptionMacro(<< "Can't read " << m_FileName);
+  begin = &m_Buffer[0];
+#endif
+
+  // The header has a fixed size for given types
+  const unsigned int labelSize = sizeof(LabelPixelType);
+  const unsigned long headerSize = 8 + 4 * sizeof(uint32_t) +
+    ImageDimension * (2 * sizeof(int64_t) + 2 * sizeof(double)) +
+    2 * sizeof(double) + 2 * sizeof(uint64_t);
+  if (size < headerSize || memcmp(begin, Format::GetMagic(), 8) != 0)
+  {
+    this->Close();
+    itkExceptionMacro(<< m_FileName << " is not an envelope file");
+  }
+
+  const unsigned char *pointer = begin + 8;
+  const uint32_t byteOrderMark = Format::ReadRaw<uint32_t>(pointer);
+  const uint32_t dimension = Format::ReadRaw<uint32_t>(pointer);
+  const uint32_t heightType = Format::ReadRaw<uint32_t>(pointer);
+  const uint32_t labelType = Format::ReadRaw<uint32_t>(pointer);
+  if (byteOrderMark != Format::GetByteOrderMark() || dimension != ImageDimension ||
+      heightType != Format::GetTypeCode<AccumulatorType>() ||
+      (labelType != 0 && labelType != Format::GetTypeCode<LabelPixelType>()) ||
+      (labelType != 0 && size < headerSize + labelSize))
+  {
+    this->Close();
+    itkExceptionMacro(<< m_FileName << " was written on another platform or with other types");
+  }
+
+  IndexType index;
+  typename RegionType::SizeType regionSize;
+  for (unsigned int i = 0; i < ImageDimension; ++i)
+    index[i] = Format::ReadRaw<int64_t>(pointer);
+  for (unsigned int i = 0; i < ImageDimension; ++i)
+    regionSize[i] = Format::ReadRaw<uint64_t>(pointer);
+  m_Region.SetIndex(index);
+  m_Region.SetSize(regionSize);
+  for (unsigned int i = 0; i < ImageDimension; ++i)
+    m_Spacing[i] = Format::ReadRaw<double>(pointer);
+  for (unsigned int i = 0; i < ImageDimension; ++i)
+    m_Origin[i] = Format::ReadRaw<double>(pointer);
+  m_EnvelopeSpacing = Format::ReadRaw<double>(pointer);
+  m_MaximumApexHeight = static_cast<DistancePixelType>(Format::ReadRaw<double>(pointer));
+  m_HasVoronoiLabels = labelType != 0;
+  m_BackgroundLabel = m_HasVoronoiLabels ?
+    Format::ReadRaw<LabelPixelType>(pointer) : LabelPixelType();
+  m_NumberOfLines = Format::ReadRaw<uint64_t>(pointer);
+  m_NumberOfParabolas = Format::ReadRaw<uint64_t>(pointer);
+
+  // There is a scanline for each voxel of a slice across the last
+  // dimension, without overflow of the number of voxels, and their starts
+  // must fit into the file
+  const unsigned long maximumSize = std::numeric_limits<unsigned long>::max();
+  bool consistent = true;
+  unsigned long numberOfPixels = 1;
+  for (unsigned int i = 0; i < ImageDimension; ++i)
+  {
+    const unsigned long length = m_Region.GetSize()[i];
+    if (i == ImageDimension - 1)
+      consistent = consistent && numberOfPixels == m_NumberOfLines;
+    if (length != 0 && numberOfPixels > maximumSize / length)
+      consistent = false;
+    numberOfPixels *= length;
+  }
+  const unsigned long headerEnd = pointer - begin;
+  if (!consistent || m_NumberOfLines >= (size - headerEnd) / sizeof(uint64_t))
+  {
+    this->Close();
+    itkExceptionMacro(<< m_FileName << " is truncated");
+  }
+  m_LineStart = pointer;
+  m_LineData = m_LineStart + (m_NumberOfLines + 1) * sizeof(uint64_t);
+
+  // Each scanline must start after the previous one, and the scanline data
+  // must end with the file. Reading a scanline then stays within the file.
+  const uint64_t dataSize = begin + size - m_LineData;
+  uint64_t start = Format::ReadRaw<uint64_t>(pointer);
+  for (unsigned long line = 0; line < m_NumberOfLines; ++line)
+  {
+    const uint64_t next = Format::ReadRaw<uint64_t>(pointer);
+    if (next < start || next > dataSize)
+    {
+      this->Close();
+      itkExceptionMacro(<< m_FileName << " is corrupt: scanline " << line
+          << " ends outside of the scanline data");
+    }
+    start = next;
+  }
+  if (start != dataSize)
+  {
+    this->Close();
+    itkExceptionMacro(<< m_FileName << " is truncated");
+  }
+
+  this->Modified();
+}
+
+/**
+ * Number of the scanline through index
+ */
+template < class TDistanceImage, class TLabelImage, class TAccumulator >
+unsigned long
+EnvelopeFileReader< TDistanceImage, TLabelImage, TAccumulator >
+::GetLine(const IndexType &index) const
+{
+  if (!m_LineData)
+    itkExceptionMacro(<< "No envelope file was read");
+  if (!m_Region.IsInside(index))
+    itkExceptionMacro(<< "Index " << index << " is outside of the region " << m_Region);
+
+  // The scanlines are numbered like the voxels of a slice across the last
+  // dimension
+  unsigned long line = 0;
+  unsigned long stride = 1;
+  for (unsigned int i = 0; i < ImageDimension - 1; ++i)
+  {
+    line += (index[i] - m_Region.GetIndex()[i]) * stride;
+    stride *= m_Region.GetSize()[i];
+  }
+  return line;
+}
+
+/**
+ * The data of a scanline
+ */
+template < class TDistanceImage, class TLabelImage, class TAccumulator >
+void
+EnvelopeFileReader< TDistanceImage, TLabelImage, TAccumulator >
+::GetLineData(unsigned long line, const unsigned char *&begin,
+    const unsigned char *&end) const
+{
+  typedef EnvelopeFileFormat Format;
+
+  // The starts have been checked by Update()
+  const unsigned char *lineStart = m_LineStart + line * sizeof(uint64_t);
+  begin = m_LineData + Format::ReadRaw<uint64_t>(lineStart);
+  end = m_LineData + Format::ReadRaw<uint64_t>(lineStart);
+}
+
+/**
+ * Read a varint of a scanline
+ */
+template < class TDistanceImage, class TLabelImage, class TAccumulator >
+uint64_t
+EnvelopeFileReader< TDistanceImage, TLabelImage, TAccumulator >
+::ReadVarint(const unsigned char *&pointer, const unsigned char *end) const
+{
+  uint64_t value;
+  if (!EnvelopeFileFormat::ReadVarint(pointer, end, value))
+    itkExceptionMacro(<< m_FileName << " is corrupt: a scanline ends within a parabola");
+  return value;
+}
+
+/**
+ * Read an apex height or a label of a scanline
+ */
+template < class TDistanceImage, class TLabelImage, class TAccumulator >
+template < class T >
+void
+EnvelopeFileReader< TDistanceImage, TLabelImage, TAccumulator >
+::ReadValue(const unsigned char *&pointer, const unsigned char *end, T &previous) const
+{
+  if (!EnvelopeFileFormat::ReadValue(pointer, end, previous))
+    itkExceptionMacro(<< m_FileName << " is corrupt: a scanline ends within a parabola");
+}
+
+/**
+ * Value of a parabola at abscissa
+ */
+template < class TDistanceImage, class TLabelImage, class TAccumulator >
+typename EnvelopeFileReader< TDistanceImage, TLabelImage, TAccumulator >::DistancePixelType
+EnvelopeFileReader< TDistanceImage, TLabelImage, TAccumulator >
+::EvaluateParabola(AbscissaIndexType apex, AccumulatorType height,
+    AbscissaIndexType abscissa) const
+{
+  // Like LazyGeneralizedDistanceTransform::EvaluateParabola()
+  const double x = static_cast<double>(abscissa - apex);
+  const AccumulatorType value = static_cast<AccumulatorType>(
+      m_EnvelopeSpacing * m_EnvelopeSpacing * x * x + static_cast<double>(height));
+
+  if (static_cast<double>(value) < static_cast<double>(m_MaximumApexHeight))
+    return static_cast<DistancePixelType>(value);
+  return m_MaximumApexHeight;
+}
+
+/**
+ * The distance at index
+ */
+template < class TDistanceImage, class TLabelImage, class TAccumulator >
+typename EnvelopeFileReader< TDistanceImage, TLabelImage, TAccumulator >::DistancePixelType
+EnvelopeFileReader< TDistanceImage, TLabelImage, TAccumulator >
+::GetDistance(const IndexType &index) const
+{
+  const unsigned char *pointer;
+  const unsigned char *end;
+  this->GetLineData(this->GetLine(index), pointer, end);
+  const uint64_t count = this->ReadVarint(pointer, end);
+  if (count == 0)
+    return m_MaximumApexHeight;
+
+  // The parabola that is minimal at abscissa is the last one that is
+  // minimal after a smaller abscissa
+  const AbscissaIndexType abscissa = index[ImageDimension - 1];
+  AbscissaIndexType apex = m_Region.GetIndex()[ImageDimension - 1] - 1;
+  AbscissaIndexType from = apex;
+  AccumulatorType height = AccumulatorType();
+  LabelPixelType label = LabelPixelType();
+  AbscissaIndexType bestApex = apex;
+  AccumulatorType bestHeight = height;
+  for (uint64_t p = 0; p < count; ++p)
+  {
+    apex += this->ReadVarint(pointer, end) + 1;
+    from += this->ReadVarint(pointer, end);
+    if (from >= abscissa)
+      break;
+    this->ReadValue(pointer, end, height);
+    if (m_HasVoronoiLabels)
+      this->ReadValue(pointer, end, label);
+    bestApex = apex;
+    bestHeight = height;
+  }
+  return this->EvaluateParabola(bestApex, bestHeight, abscissa);
+}
+
+/**
+ * The voronoi label at index
+ */
+template < class TDistanceImage, class TLabelImage, class TAccumulator >
+typename EnvelopeFileReader< TDistanceImage, TLabelImage, TAccumulator >::LabelPixelType
+EnvelopeFileReader< TDistanceImage, TLabelImage, TAccumulator >
+::GetVoronoiLabel(const IndexType &index) const
+{
+  if (!m_HasVoronoiLabels)
+    itkExceptionMacro(<< "The envelope file holds no voronoi labels");
+
+  const unsigned char *pointer;
+  const unsigned char *end;
+  this->GetLineData(this->GetLine(index), pointer, end);
+  const uint64_t count = this->ReadVarint(pointer, end);
+  if (count == 0)
+    return m_BackgroundLabel;
+
+  // See GetDistance()
+  const AbscissaIndexType abscissa = index[ImageDimension - 1];
+  AbscissaIndexType from = m_Region.GetIndex()[ImageDimension - 1] - 1;
+  AccumulatorType height = AccumulatorType();
+  LabelPixelType label = LabelPixelType();
+  for (uint64_t p = 0; p < count; ++p)
+  {
+    this->ReadVarint(pointer, end);
+    from += this->ReadVarint(pointer, end);
+    if (from >= abscissa)
+      break;
+    this->ReadValue(pointer, end, height);
+    this->ReadValue(pointer, end, label);
+  }
+  return label;
+}
+
+/**
+ * Decode a scanline
+ */
+template < class TDistanceImage, class TLabelImage, class TAccumulator >
+void
+EnvelopeFileReader< TDistanceImage, TLabelImage, TAccumulator >
+::DecodeLine(unsigned long line, DistancePixelType *distance, OffsetValueType distanceStride,
+    LabelPixelType *voronoiMap, OffsetValueType voronoiMapStride) const
+{
+  const AbscissaIndexType first = m_Region.GetIndex()[ImageDimension - 1];
+  const AbscissaIndexType end = first + static_cast<AbscissaIndexType>(m_Region.GetSize()[ImageDimension - 1]);
+
+  const unsigned char *pointer;
+  const unsigned char *dataEnd;
+  this->GetLineData(line, pointer, dataEnd);
+  const uint64_t count = this->ReadVarint(pointer, dataEnd);
+  if (count == 0)
+  {
+    for (AbscissaIndexType x = first; x < end; ++x)
+    {
+      if (distance)
+      {
+        *distance = m_MaximumApexHeight;
+        distance += distanceStride;
+      }
+      if (voronoiMap)
+      {
+        *voronoiMap = m_BackgroundLabel;
+        voronoiMap += voronoiMapStride;
+      }
+    }
+    return;
+  }
+
+  // Each parabola is minimal from the abscissa after its dominantFrom up
+  // to the dominantFrom of the next one, so the abscissas of the next
+  // parabola are read before the current one is sampled
+  AbscissaIndexType apex = first - 1 + this->ReadVarint(pointer, dataEnd) + 1;
+  AbscissaIndexType from = first - 1 + this->ReadVarint(pointer, dataEnd);
+  AccumulatorType height = AccumulatorType();
+  LabelPixelType label = LabelPixelType();
+  this->ReadValue(pointer, dataEnd, height);
+  if (m_HasVoronoiLabels)
+    this->ReadValue(pointer, dataEnd, label);
+
+  AbscissaIndexType x = first;
+  for (uint64_t p = 1; p <= count; ++p)
+  {
+    AbscissaIndexType nextApex = apex;
+    AbscissaIndexType to = end - 1;
+    if (p < count)
+    {
+      nextApex += this->ReadVarint(pointer, dataEnd) + 1;
+      to = from + this->ReadVarint(pointer, dataEnd);
+      // A corrupt abscissa must not write past the scanline
+      if (to > end - 1)
+        to = end - 1;
+    }
+    for (; x <= to; ++x)
+    {
+      if (distance)
+      {
+        *distance = this->EvaluateParabola(apex, height, x);
+        distance += distanceStride;
+      }
+      if (voronoiMap)
+      {
+        *voronoiMap = label;
+        voronoiMap += voronoiMapStride;
+      }
+    }
+    if (p < count)
+    {
+      apex = nextApex;
+      from = to;
+      this->ReadValue(pointer, dataEnd, height);
+      if (m_HasVoronoiLabels)
+        this->ReadValue(pointer, dataEnd, label);
+    }
+  }
+}
+
+/**
+ * Decode the scanline through index
+ */
+template < class TDistanceImage, class TLabelImage, class TAccumulator >
+void
+EnvelopeFileReader< TDistanceImage, TLabelImage, TAccumulator >
+::ReadLine(const IndexType &index, DistancePixelType *distance,
+    LabelPixelType *voronoiMap) const
+{
+  if (voronoiMap && !m_HasVoronoiLabels)
+    itkExceptionMacro(<< "The envelope file holds no voronoi labels");
+  this->DecodeLine(this->GetLine(index), distance, 1, voronoiMap, 1);
+}
+
+/**
+ * Decode all scanlines into a dense distance image
+ */
+template < class TDistanceImage, class TLabelImage, class TAccumulator >
+typename EnvelopeFileReader< TDistanceImage, TLabelImage, TAccumulator >::DistanceImagePointer
+EnvelopeFileReader< TDistanceImage, TLabelImage, TAccumulator >
+::GenerateDistanceImage() const
+{
+  if (!m_LineData)
+    itkExceptionMacro(<< "No envelope file was read");
+
+  DistanceImagePointer image = DistanceImageType::New();
+  image->SetRegions(m_Region);
+  image->SetSpacing(m_Spacing);
+  image->SetOrigin(m_Origin);
+  image->Allocate();
+
+  // Scanline n starts at offset n, its voxels are one slice apart
+  DistancePixelType *buffer = image->GetBufferPointer();
+  for (unsigned long line = 0; line < m_NumberOfLines; ++line)
+    this->DecodeLine(line, buffer + line, m_NumberOfLines, 0, 0);
+  return image;
+}
+
+/**
+ * Decode all scanlines into a dense voronoi map
+ */
+template < class TDistanceImage, class TLabelImage, class TAccumulator >
+typename EnvelopeFileReader< TDistanceImage, TLabelImage, TAccumulator >::LabelImagePointer
+EnvelopeFileReader< TDistanceImage, TLabelImage, TAccumulator >
+::GenerateVoronoiMap() const
+{
+  if (!m_LineData)
+    itkExceptionMacro(<< "No envelope file was read");
+  if (!m_HasVoronoiLabels)
+    itkExceptionMacro(<< "The envelope file holds no voronoi labels");
+
+  LabelImagePointer image = LabelImageType::New();
+  image->SetRegions(m_Region);
+  image->SetSpacing(m_Spacing);
+  image->SetOrigin(m_Origin);
+  image->Allocate();
+
+  // See GenerateDistanceImage()
+  LabelPixelType *buffer = image->GetBufferPointer();
+  for (unsigned long line = 0; line < m_NumberOfLines; ++line)
+    this->DecodeLine(line, 0, 0, buffer + line, m_NumberOfLines);
+  return image;
+}
+
+/**
+ *  Print Self
+ */
+template < class TDistanceImage, class TLabelImage, class TAccumulator >
+void
+EnvelopeFileReader< TDistanceImage, TLabelImage, TAccumulator >
+::PrintSelf(std::ostream& os, Indent indent) const
+{
+  Superclass::PrintSelf(os,indent);
+  os << indent << "FileName: " << m_FileName << std::endl;
+  os << indent << "Region: " << m_Region << std::endl;
+  os << indent << "HasVoronoiLabels: " << m_HasVoronoiLabels << std::endl;
+  os << indent << "NumberOfParabolas: " << m_NumberOfParabolas << std::endl;
+}
+} // end namespace itk
+#endif
@@ -2,11 +2,59 @@
 #define __itkGeneralizedDistanceTransformImageFilter_h
 
 #include "itkImageToImageFilter.h"
+#include "itkMultiThreader.h"
+#include "itkSimpleFastMutexLock.h"
+#include "itkNumericTraits.h"
+#include "itkFixedArray.h"
 #include "itkLowerEnvelopeOfParabolas.h"
+#include "itkNumaTopology.h"
+#include "itkHugePageImageContainer.h"
+#include "itkTuningFile.h"
+#include "itkSparseBrickImage.h"
+
+#include <vector>
+#include <string>
+#include <map>
 
 namespace itk
 {
 
+template < class T, unsigned int NVectorDimension > class Vector;
+template < class T, unsigned int NVectorDimension > class CovariantVector;
+
+/** Order of the labels of the voronoi map, for the statistics per label.
+ * Labels that are arrays, e.g. the closest points of a vector distance
+ * transform, are ordered lexicographically. */
+template < class TLabel >
+struct VoronoiLabelLess
+{
+  bool operator()(const TLabel &a, const TLabel &b) const
+    { return a < b; }
+};
+
+template < class TArray, unsigned int NLength >
+struct VoronoiLabelArrayLess
+{
+  bool operator()(const TArray &a, const TArray &b) const
+    {
+    for (unsigned int i = 0; i < NLength; ++i)
+      {
+      if (a[i] < b[i])
+        return true;
+      if (b[i] < a[i])
+        return false;
+      }
+    return false;
+    }
+};
+
+template < class T, unsigned int N >
+struct VoronoiLabelLess< FixedArray<T, N> > : public VoronoiLabelArrayLess< FixedArray<T, N>, N > {};
+template < class T, unsigned int N >
+struct VoronoiLabelLess< Vector<T, N> > : public VoronoiLabelArrayLess< Vector<T, N>, N > {};
+template < class T, unsigned int N >
+struct VoronoiLabelLess< CovariantVector<T, N> > : public VoronoiLabelArrayLess< CovariantVector<T, N>, N > {};
+
 /** \class GeneralizedDistanceTransformImageFilter
 *
 * This filter computes a generalized variant of the distance transform with a
@@ -60,6 +108,21 @@ namespace itk
 * Fewer casts are made if 
 *   TFunctionImage::PixelType == TFunctionImage::IndexValueType == SpacingType.
 *
+* ACCUMULATOR TYPE
+* The apex heights and the samples of the lower envelope are computed in
+* TAccumulator, which defaults to TDistanceImage::PixelType. Between the
+* iterations over the dimensions and in the output, the values are stored
+* in TDistanceImage::PixelType. A wide TAccumulator (e.g. long or double)
+* combined with a narrow distance pixel type (e.g. int, float or unsigned
+* short) gives the safe range of the former with the memory footprint of the
+* latter.
+*
+* Values that do not fit into TDistanceImage::PixelType are saturated:
+* GetMaximumApexHeight() is the largest distance that can be stored, and it
+* marks background voxels as before. Every stored sample that had to be
+* clamped although its paraboloid was not a background one is counted, see
+* GetNumberOfSaturatedPixels().
+*
 * REFERENCES
 * The Implementation is based on the generalized distance transform with the
 * squared euclidean metric described in:
@@ -68,11 +131,29 @@ namespace itk
 * Pedro F. Felzenszwalb and Daniel P. Huttenlocher.
 * Cornell Computing and Information Science TR2004-1963.
 *
-* TODO
-* - The algorithm could be made multithreaded: It iterates over the image
-*   dimensions and during each iteration and individual scanlines are computed
-*   independently of each other.
+* MULTITHREADING
+* The algorithm iterates over the image dimensions. During each iteration the
+* individual scanlines are computed independently of each other, so they are
+* distributed over the threads of the filter's itk::MultiThreader. The
+* iterations themselves are carried out one after the other.
+*
+* The cost of a scanline varies a lot with the number of parabolas that are
+* removed from the envelope. Hence the scanlines are grouped into tiles of
+* GetLinesPerTile() consecutive lines. Each thread starts with a contiguous
+* range of tiles and, when it runs out of work, steals half of the remaining
+* tiles of another thread. GetLoadBalanceEfficiency() tells how well this
+* worked out.
 *
+* OPTIONS
+* The optional features are described with their settings: SetSeeds(),
+* SetSparseInputs(), SetPeriodicBoundary(), SetShrinkFactors(),
+* SetProcessedDimensions(), SetCreateRunLengthVoronoiMap(),
+* SetComputeStatistics(), SetDistanceImportPointer(), SetReuseBuffers(),
+* SetNumaAware(), SetUseHugePages() and Tune(). See
+* itkGeneralizedDistanceTransformImageFilterInstantiations.cxx for the
+* precompiled library.
+*
+* TODO
 * - The iteration scanlines for dimensions > 0 are not memory local due to the
 *   row-major layout of ITK's images. This trashes the cache. To solve this
 *   issue, a blocked image layout could be used internally.
@@ -85,7 +166,8 @@ namespace itk
 
 template <
   class TFunctionImage,class TDistanceImage, class TLabelImage=TFunctionImage,
-        unsigned char MinimalSpacingPrecision=3 >
+        unsigned char MinimalSpacingPrecision=3,
+        class TAccumulator=typename TDistanceImage::PixelType >
 class ITK_EXPORT GeneralizedDistanceTransformImageFilter :
     public ImageToImageFilter<TFunctionImage,TDistanceImage>
 {
@@ -102,6 +184,9 @@ public:
   /** Run-time type information (and related methods). */
   itkTypeMacro(GeneralizedDistanceTransformImageFilter, ImageToImageFilter);
 
+  /** Image dimension. */
+  itkStaticConstMacro(ImageDimension, unsigned int, TFunctionImage::ImageDimension);
+
   /** Types and pointer types for the images. */
   typedef TFunctionImage FunctionImageType;
   typedef TDistanceImage DistanceImageType;
@@ -110,7 +195,60 @@ public:
   typedef typename FunctionImageType::ConstPointer FunctionImageConstPointer;
   typedef typename DistanceImageType::Pointer DistanceImagePointer;
   typedef typename LabelImageType::Pointer LabelImagePointer;
+  typedef typename DistanceImageType::PixelType DistancePixelType;
+  typedef typename LabelImageType::PixelType LabelPixelType;
+  typedef ProcessObject::DataObjectPointer DataObjectPointer;
+  typedef TAccumulator AccumulatorType;
+  typedef typename DistanceImageType::IndexType IndexType;
+  typedef typename DistanceImageType::RegionType RegionType;
+  typedef typename DistanceImageType::SizeType SizeType;
   typedef typename TFunctionImage::SpacingType::ValueType TSpacingType;
+  typedef FixedArray<bool, itkGetStaticConstMacro(ImageDimension)> BooleanArrayType;
+  typedef FixedArray<unsigned int, itkGetStaticConstMacro(ImageDimension)> ShrinkFactorsType;
+  typedef typename DistanceImageType::SpacingType SpacingType;
+  typedef typename DistanceImageType::PointType PointType;
+
+  /** A seed of the sparse input: The function value Height at Index, with
+   * Label for the voronoi map. */
+  struct SeedType
+  {
+    IndexType Index;
+    DistancePixelType Height;
+    LabelPixelType Label;
+  };
+  typedef std::vector<SeedType> SeedContainerType;
+
+  /** A run of the run-length voronoi map: Length samples with Label, from
+   * output index Start on along GetVoronoiRunDirection(). */
+  struct VoronoiRunType
+  {
+    long Start;
+    unsigned long Length;
+    LabelPixelType Label;
+  };
+  typedef std::vector<VoronoiRunType> VoronoiRunContainerType;
+
+  /** Statistics of the distances of the voxels closest to one label. */
+  struct LabelStatisticsType
+  {
+    unsigned long Count;
+    double Sum;
+    DistancePixelType Maximum;
+
+    double GetMean() const
+      { return Count > 0 ? Sum / Count : 0.0; }
+  };
+  typedef std::map<LabelPixelType, LabelStatisticsType,
+          VoronoiLabelLess<LabelPixelType> > LabelStatisticsContainerType;
+  typedef std::vector<unsigned long> HistogramType;
+
+  /** Brick images of the sparse inputs and outputs. */
+  typedef SparseBrickImage<typename FunctionImageType::PixelType,
+          itkGetStaticConstMacro(ImageDimension)> FunctionBrickImageType;
+  typedef SparseBrickImage<DistancePixelType,
+          itkGetStaticConstMacro(ImageDimension)> DistanceBrickImageType;
+  typedef SparseBrickImage<LabelPixelType,
+          itkGetStaticConstMacro(ImageDimension)> LabelBrickImageType;
 
   /** The main work is done by a class that computes the lower envelope of
    * parabolas. It can be tuned for performance vs. functionality by providing
@@ -125,22 +263,30 @@ public:
   typedef itk::LowerEnvelopeOfParabolas<true, TSpacingType, MinimalSpacingPrecision, true,
           typename TLabelImage::PixelType,
           typename TFunctionImage::IndexValueType,
-          typename TDistanceImage::PixelType> LEOPDV;
+          AccumulatorType> LEOPDV;
   typedef itk::LowerEnvelopeOfParabolas<true, TSpacingType, MinimalSpacingPrecision, false,
           typename TLabelImage::PixelType,
           typename TFunctionImage::IndexValueType,
-          typename TDistanceImage::PixelType> LEOPDv;
+          AccumulatorType> LEOPDv;
   typedef itk::LowerEnvelopeOfParabolas<false, TSpacingType, MinimalSpacingPrecision, true,
           typename TLabelImage::PixelType,
           typename TFunctionImage::IndexValueType,
-          typename TDistanceImage::PixelType> LEOPdV;
+          AccumulatorType> LEOPdV;
   typedef itk::LowerEnvelopeOfParabolas<false, TSpacingType, MinimalSpacingPrecision, false,
           typename TLabelImage::PixelType,
           typename TFunctionImage::IndexValueType,
-          typename TDistanceImage::PixelType> LEOPdv;
+          AccumulatorType> LEOPdv;
 
-  static typename TDistanceImage::PixelType GetMaximumApexHeight()
-    { return LEOPDV::maxApexHeight; } 
+  /** The apex height that marks background voxels. It is the smaller one of
+   * the largest apex height of the envelope and the largest value of
+   * DistancePixelType. Larger distances are saturated to this value. */
+  static DistancePixelType GetMaximumApexHeight()
+    {
+    if (static_cast<double>(LEOPDV::maxApexHeight) <
+        static_cast<double>(NumericTraits<DistancePixelType>::max()))
+      return static_cast<DistancePixelType>(LEOPDV::maxApexHeight);
+    return NumericTraits<DistancePixelType>::max();
+    }
    
   /** Connect the function image */
   void SetInput1(const FunctionImageType *functionImage);
@@ -174,12 +320,324 @@ public:
   void SetCreateVoronoiMap(bool);
   itkBooleanMacro(CreateVoronoiMap);
 
+  /** Set/Get wether the image is periodic along each of the dimensions.
+   * Default is false for all dimensions.
+   *
+   * A periodic dimension is treated as one period of an infinitely repeated
+   * image, e.g. for simulation volumes on a torus. The distance wraps
+   * around the borders of the image without replicating it. */
+  itkSetMacro(PeriodicBoundary, BooleanArrayType);
+  itkGetConstReferenceMacro(PeriodicBoundary, BooleanArrayType);
+
+  /** Set the seeds. They replace the function and label images as input
+   * until ClearSeeds() is called. Several seeds at the same index are
+   * allowed, the one with the smallest height is used.
+   *
+   * Each seed is an index with a function value and a label, all other
+   * voxels are background. The geometry of the outputs is set with
+   * SetOutputRegion(), SetOutputSpacing() and SetOutputOrigin(). The
+   * working images are initialized to background directly, and the first
+   * iteration only computes the scanlines that contain seeds. */
+  void SetSeeds(const SeedContainerType &seeds);
+  itkGetConstReferenceMacro(Seeds, SeedContainerType);
+
+  /** Add a single seed. See SetSeeds(). */
+  void AddSeed(const IndexType &index, const DistancePixelType &height,
+      const LabelPixelType &label);
+
+  /** Remove all seeds and use the function and label images as input
+   * again. */
+  void ClearSeeds();
+
+  /** Wether the seeds are used as input instead of the images. */
+  itkGetMacro(UseSeeds, bool);
+
+  /** Set the sparse inputs. They replace the function and label images
+   * as input until ClearSparseInputs() is called, and the seeds are
+   * cleared. The label bricks must have the geometry of the function
+   * bricks, they are only used if a voronoi map is created. Voxels outside
+   * of the allocated label bricks get GetBackgroundLabel().
+   *
+   * The geometry of the outputs is the one of the function bricks. Like
+   * with seeds, the working images are filled with background, the bricks
+   * are copied into them, and the first iteration only computes the
+   * scanlines that pass through allocated bricks. The later iterations need
+   * all scanlines, so the outputs are dense, see SetCreateSparseOutputs(). */
+  void SetSparseInputs(const FunctionBrickImageType *function,
+      const LabelBrickImageType *labels = 0);
+
+  /** Use the function and label images as input again. */
+  void ClearSparseInputs();
+
+  /** Wether the sparse inputs are used instead of the images. */
+  bool GetUseSparseInputs() const
+    { return m_SparseFunction.GetPointer() != 0; }
+
+  /** Set/Get wether the outputs are also returned as bricks, see
+   * GetSparseDistance(). Only the bricks with distances up to
+   * GetNarrowBand() are allocated, so a narrow band around the foreground
+   * can be kept after the dense outputs are released. Default is false. */
+  itkSetMacro(CreateSparseOutputs, bool);
+  itkGetMacro(CreateSparseOutputs, bool);
+  itkBooleanMacro(CreateSparseOutputs);
+
+  /** Set/Get the largest distance of the sparse outputs. Bricks of the
+   * outputs are allocated if they contain a distance up to the narrow
+   * band. Default is GetMaximumApexHeight(), i.e. all bricks that aren't
+   * background only. */
+  itkSetMacro(NarrowBand, DistancePixelType);
+  itkGetConstReferenceMacro(NarrowBand, DistancePixelType);
+
+  /** Set/Get the brick size of the sparse outputs. Default is 16 voxels
+   * along each dimension. */
+  itkSetMacro(OutputBrickSize, SizeType);
+  itkGetConstReferenceMacro(OutputBrickSize, SizeType);
+
+  /** The sparse outputs of the last update. */
+  DistanceBrickImageType *GetSparseDistance()
+    { return m_SparseDistance; }
+  LabelBrickImageType *GetSparseVoronoiMap()
+    { return m_SparseVoronoiMap; }
+
+  /** Set/Get wether the last iteration records the voronoi map as runs.
+   * Default is false.
+   *
+   * Along the scanlines of the last iteration, the voronoi map is piecewise
+   * constant: Each parabola of the envelope covers a run of samples with
+   * its label. The runs are recorded while the envelopes are sampled, see
+   * GetVoronoiRuns(). Consumers that read the map as runs, e.g. for label
+   * propagation, then don't need the dense map, see
+   * SetWriteDenseVoronoiMap(). */
+  itkSetMacro(CreateRunLengthVoronoiMap, bool);
+  itkGetMacro(CreateRunLengthVoronoiMap, bool);
+  itkBooleanMacro(CreateRunLengthVoronoiMap);
+
+  /** Set/Get wether the last iteration writes the dense voronoi map. If
+   * false and runs are recorded, the dense voronoi map and the sparse one
+   * are not valid after the update. Default is true. */
+  itkSetMacro(WriteDenseVoronoiMap, bool);
+  itkGetMacro(WriteDenseVoronoiMap, bool);
+  itkBooleanMacro(WriteDenseVoronoiMap);
+
+  /** The runs of the last update, scanline after scanline. The runs of
+   * scanline k are [GetVoronoiRunLineStarts()[k],
+   * GetVoronoiRunLineStarts()[k + 1]). */
+  const VoronoiRunContainerType &GetVoronoiRuns() const
+    { return m_VoronoiRuns; }
+  const std::vector<unsigned long> &GetVoronoiRunLineStarts() const
+    { return m_VoronoiRunLineStarts; }
+
+  /** Number of scanlines of the runs. */
+  unsigned long GetNumberOfVoronoiRunLines() const
+    { return m_VoronoiRunLineStarts.empty() ? 0 : m_VoronoiRunLineStarts.size() - 1; }
+
+  /** The direction of the scanlines of the runs, i.e. the last processed
+   * dimension. */
+  itkGetConstMacro(VoronoiRunDirection, unsigned int);
+
+  /** Output index of the first sample of scanline number line of the runs.
+   * The scanlines are numbered with the lower dimensions varying
+   * fastest. */
+  IndexType GetVoronoiRunLineIndex(unsigned long line) const;
+
+  /** The modification time includes the one of the sparse inputs. */
+  unsigned long GetMTime() const;
+
+  /** Set/Get the geometry of the outputs if seeds are used. The region is
+   * the one before shrinking. */
+  itkSetMacro(OutputRegion, RegionType);
+  itkGetConstReferenceMacro(OutputRegion, RegionType);
+  itkSetMacro(OutputSpacing, SpacingType);
+  itkGetConstReferenceMacro(OutputSpacing, SpacingType);
+  itkSetMacro(OutputOrigin, PointType);
+  itkGetConstReferenceMacro(OutputOrigin, PointType);
+
+  /** Set/Get the label of the voronoi map for background voxels if seeds are
+   * used. Default is LabelPixelType(). */
+  itkSetMacro(BackgroundLabel, LabelPixelType);
+  itkGetConstReferenceMacro(BackgroundLabel, LabelPixelType);
+
+  /** Set/Get the dimensions that are iterated over. Default is true for all
+   * dimensions.
+   *
+   * Since the iterations are separable, a transform over the remaining
+   * dimensions can be applied later to the distance and voronoi outputs,
+   * e.g. after the data has been redistributed among processes. See
+   * itk::DistributedGeneralizedDistanceTransform. */
+  itkSetMacro(ProcessedDimensions, BooleanArrayType);
+  itkGetConstReferenceMacro(ProcessedDimensions, BooleanArrayType);
+
+  /** Set/Get the factors by which the outputs are subsampled along each
+   * dimension. Default is 1 for all dimensions, i.e. no subsampling.
+   *
+   * The samples are exact, not resampled: Output index j holds the
+   * transform at input index j*k, and the output spacing is k times the
+   * input spacing. Each iteration only computes the scanlines that pass
+   * through the sampled points of the dimensions already processed, and
+   * only stores the samples that are kept. The iterations still need a full
+   * resolution working buffer. */
+  itkSetMacro(ShrinkFactors, ShrinkFactorsType);
+  itkGetConstReferenceMacro(ShrinkFactors, ShrinkFactorsType);
+
+  /** Set/Get a caller-provided buffer for the distance image.
+   *
+   * If set, the distance image is computed in this buffer instead of a newly
+   * allocated one. It must hold as many pixels as the requested region of
+   * the output, in ITK's memory layout. The filter never frees the buffer.
+   * The buffer may be the one of the function image, in which case the
+   * transform is computed in place. Set it to NULL to let the filter
+   * allocate the output again. The buffer can be an array of a scripting
+   * language, or a memory mapped file, see itk::MappedImageFile. */
+  itkSetMacro(DistanceImportPointer, DistancePixelType *);
+  itkGetMacro(DistanceImportPointer, DistancePixelType *);
+
+  /** Set/Get a caller-provided buffer for the voronoi map.
+   * See SetDistanceImportPointer(). */
+  itkSetMacro(VoronoiMapImportPointer, LabelPixelType *);
+  itkGetMacro(VoronoiMapImportPointer, LabelPixelType *);
+
+  /** Number of samples that did not fit into DistancePixelType during the
+   * last update and were saturated to GetMaximumApexHeight(). Samples are
+   * counted in every iteration over the dimensions. Background voxels are
+   * not counted. */
+  itkGetConstMacro(NumberOfSaturatedPixels, unsigned long);
+
+  /** Set/Get wether the threads are pinned to NUMA nodes and initialize the
+   * memory they work on. Default is false.
+   *
+   * The threads are pinned with itk::NumaTopology. The working images are
+   * initialized by the threads that compute the first iteration, on the
+   * same scanlines, so their memory is placed on the nodes where it is
+   * used. The scanlines of the later iterations are ordered with the
+   * outermost dimension varying slowest, so the initial ranges of the
+   * threads stay on their nodes as far as the layout allows. Threads steal
+   * tiles from threads on the same node first. */
+  itkSetMacro(NumaAware, bool);
+  itkGetMacro(NumaAware, bool);
+  itkBooleanMacro(NumaAware);
+
+  /** Set/Get wether the outputs and the working images are allocated with
+   * itk::HugePageImageContainer. The iterations over the later dimensions
+   * jump through the image by whole rows or slices, which causes many TLB
+   * misses with 4 KB pages. Caller-provided buffers are used as they are.
+   * Default is false. */
+  itkSetMacro(UseHugePages, bool);
+  itkGetMacro(UseHugePages, bool);
+  itkBooleanMacro(UseHugePages);
+
+  /** Set/Get wether the buffers are kept for the next update. Default is
+   * false.
+   *
+   * The buffers of the outputs and of the working images, and the pixel
+   * containers of the outputs, are used again in the next update if the
+   * number of pixels is unchanged, so repeated updates on images of the
+   * same size don't allocate image memory. A buffer is only reused if
+   * nothing else refers to it anymore, e.g. a disconnected output of an
+   * earlier update. The envelopes of the threads are kept in any case. */
+  itkSetMacro(ReuseBuffers, bool);
+  itkGetMacro(ReuseBuffers, bool);
+  itkBooleanMacro(ReuseBuffers);
+
+  /** Set/Get the number of consecutive scanlines that are scheduled as one
+   * task. 0, the default, chooses about 8 tiles per thread. */
+  itkSetMacro(LinesPerTile, unsigned long);
+  itkGetMacro(LinesPerTile, unsigned long);
+
+  /** Load balance of the threads during the last update: The time the
+   * threads spent computing scanlines, divided by the number of threads
+   * times the time of the busiest thread, summed over the iterations. 1
+   * means that no thread had to wait for the others at the end of an
+   * iteration. */
+  itkGetConstMacro(LoadBalanceEfficiency, double);
+
+  /** Number of tiles that were stolen from another thread during the last
+   * update. */
+  itkGetConstMacro(NumberOfStolenTiles, unsigned long);
+
+  /** Set/Get wether the last iteration computes statistics of the
+   * distances. Default is false.
+   *
+   * The statistics are the largest and the mean distance, a histogram of
+   * the distances and, with a voronoi map, the count, mean and largest
+   * distance of the voxels closest to each label. They are collected while
+   * the envelopes are sampled, so no pass over the outputs is needed, and
+   * merged from partial results of the threads. They are computed on the
+   * stored distances, i.e. the squared distances for the euclidean distance
+   * transform. Background voxels are not counted. */
+  itkSetMacro(ComputeStatistics, bool);
+  itkGetMacro(ComputeStatistics, bool);
+  itkBooleanMacro(ComputeStatistics);
+
+  /** Set/Get the number of bins of the distance histogram. Default is
+   * 256. */
+  itkSetMacro(NumberOfHistogramBins, unsigned int);
+  itkGetMacro(NumberOfHistogramBins, unsigned int);
+
+  /** Set/Get the width of the bins of the distance histogram. Bin k counts
+   * the distances in [k * width, (k + 1) * width). The first and the last
+   * bin also count the distances below and above the histogram. Default
+   * is 1. */
+  itkSetMacro(HistogramBinWidth, double);
+  itkGetMacro(HistogramBinWidth, double);
+
+  /** Statistics of the last update. */
+  itkGetConstMacro(NumberOfMeasuredPixels, unsigned long);
+  itkGetConstMacro(MaximumDistance, DistancePixelType);
+  itkGetConstMacro(MeanDistance, double);
+  const HistogramType &GetDistanceHistogram() const
+    { return m_DistanceHistogram; }
+  const LabelStatisticsContainerType &GetLabelStatistics() const
+    { return m_LabelStatistics; }
+
+  /** Set/Get wether the update uses the number of threads and the lines
+   * per tile stored by Tune() for the machine. Default is false. */
+  itkSetMacro(AutoTune, bool);
+  itkGetMacro(AutoTune, bool);
+  itkBooleanMacro(AutoTune);
+
+  /** Set/Get the file the tuned configurations are cached in. Empty, the
+   * default, uses TuningFile::GetDefaultFileName(). */
+  itkSetStringMacro(TuningFileName);
+  itkGetStringMacro(TuningFileName);
+
+  /** Look up the number of threads and the lines per tile for the
+   * machine, the pixel types and the options in the tuning file, calibrate
+   * them if the file has none, and turn AutoTune on. Call it after the
+   * options and the number of threads are set; GetNumberOfThreads() is the
+   * largest number of threads tried.
+   *
+   * The calibration times short transforms of a synthetic image of about
+   * 256k voxels and appends the fastest configuration to the file, see
+   * itk::TuningFile. It runs once per machine and type combination, not
+   * once per process, and never during an update. With AutoTune on, the
+   * update uses the tuned configuration instead of SetNumberOfThreads() and
+   * SetLinesPerTile() if the file holds one for the current options. */
+  void Tune();
+
+  /** The tuned configuration if AutoTune is on. 0 threads means that
+   * there is none for the current options. */
+  itkGetConstMacro(TunedNumberOfThreads, int);
+  itkGetConstMacro(TunedLinesPerTile, unsigned long);
 
 protected:
   GeneralizedDistanceTransformImageFilter();
-  virtual ~GeneralizedDistanceTransformImageFilter() {};
+  virtual ~GeneralizedDistanceTransformImageFilter();
   void PrintSelf(std::ostream& os, Indent indent) const;
 
+  /** Keep the pixel containers of the outputs for the next update if
+   * ReuseBuffers is on. */
+  void PrepareOutputs();
+
+  /** Create the output idx: The distance image or the voronoi map. Used
+   * when an output is disconnected from the pipeline. */
+  virtual DataObjectPointer MakeOutput(unsigned int idx);
+
+  /** The outputs are subsampled by the shrink factors. */
+  void GenerateOutputInformation();
+
+  /** The whole inputs are needed. */
+  void GenerateInputRequestedRegion();
+
   /** The whole output will be produced regardless of the region requested. */
   void EnlargeOutputRequestedRegion(DataObject *itkNotUsed(output));
 
@@ -187,24 +645,667 @@ protected:
    * GenerateData() */
   void PrepareData();  
 
+  /** Allocate the buffered region of an image, with huge pages if
+   * UseHugePages is on. If ReuseBuffers is on, keptBuffer is used if it
+   * fits and is updated otherwise. */
+  template < class TImage >
+  void AllocateImage(TImage *image,
+      typename TImage::PixelContainerPointer &keptBuffer);
+
+  /** Convert a function value to a stored distance. Values that are too
+   * large are background. */
+  static DistancePixelType FunctionToDistance(
+      const typename FunctionImageType::PixelType &value)
+    {
+    if (static_cast<double>(value) < static_cast<double>(GetMaximumApexHeight()))
+      return static_cast<DistancePixelType>(value);
+    return GetMaximumApexHeight();
+    }
+
+  /** Initialize the scanlines [firstRow, endRow) in direction 0 of the
+   * working images. Called by each of the threads if NumaAware is on. */
+  void ThreadedInitializeRows(unsigned long firstRow, unsigned long endRow);
+
+  /** Static function used as a "callback" by the MultiThreader. It splits
+   * the scanlines in direction 0 among the threads like the tiles of the
+   * first iteration. */
+  static ITK_THREAD_RETURN_TYPE InitializeThreaderCallback(void *arg);
+
+  /** Collect the scanlines in direction 0 that contain seeds or pass
+   * through allocated bricks. Helper function for PrepareData() */
+  void ComputeSeedLines(const RegionType &workingRegion);
+
+  /** Initialize the working images from the seeds. Helper function for
+   * PrepareData() */
+  void PrepareSeeds();
+
+  /** Initialize the working images from the sparse inputs. Helper function
+   * for PrepareData() */
+  void PrepareBricks();
+
+  /** Concatenate the runs of the tiles of the last iteration. Helper
+   * function for TemplateGenerateData() */
+  void GatherVoronoiRuns(unsigned long numberOfLines);
+
+  /** Merge the statistics of the threads. Helper function for
+   * TemplateGenerateData() */
+  void MergeStatistics();
+
+  /** Copy the bricks of the outputs within the narrow band into the sparse
+   * outputs. */
+  void GenerateSparseOutputs();
+
+  /** Are the inputs seeds or bricks, i.e. does the first iteration only
+   * compute the scanlines in m_SeedLines? */
+  bool HasSparseInput() const
+    { return m_UseSeeds || m_SparseFunction.GetPointer() != 0; }
+
+  /** The number of required inputs depends on the voronoi map and the
+   * seeds. */
+  void UpdateNumberOfRequiredInputs();
+
   /** Compute distance transform and optionally the voronoi map as well. */
   void GenerateData();  
 
+  /** The filter used for the calibration transforms. */
+  typedef GeneralizedDistanceTransformImageFilter<TDistanceImage, TDistanceImage,
+          TLabelImage, MinimalSpacingPrecision, TAccumulator> CalibrationFilterType;
+
+  /** The key of the tuned configuration: the machine, the largest number
+   * of threads, the dimension, the pixel types and the options that select
+   * the kernel. */
+  std::string GetTuningKey() const;
+
+  /** Look up the tuned configuration of key and apply it. Returns false
+   * and clears the configuration if the file has none. */
+  bool ReadTuning(const std::string &key);
+
+  /** GetTuningFileName(), or the default file if it is empty. */
+  std::string GetTuningFileNameOrDefault() const;
+
+  /** Time the calibration transforms and return the fastest
+   * configuration. */
+  void Calibrate(int &numberOfThreads, unsigned long &linesPerTile);
+
+  /** The number of threads of the update: the tuned one if AutoTune is
+   * on, GetNumberOfThreads() otherwise. */
+  int GetUpdateNumberOfThreads() const;
+
   template < bool UseSpacing, bool CreateVoronoiMap >  void TemplateGenerateData();
 
+  /** Copy the samples that are kept from the working images into the
+   * outputs. Only needed if any shrink factor is larger than 1. Helper
+   * function for GenerateData() */
+  void GatherShrunkOutputs();
+
+  /** Number of consecutive scanlines that are scheduled as one unit if
+   * there are numberOfLines scanlines and numberOfThreads threads. */
+  unsigned long ComputeLinesPerTile(unsigned long numberOfLines,
+      unsigned int numberOfThreads) const;
+
+  /** Number of scanlines in direction d. Along the dimensions before d, only
+   * the scanlines through the samples that are kept are counted. If seeds
+   * are used, only the scanlines with seeds are counted in direction 0. */
+  unsigned long GetNumberOfLines(unsigned int d) const;
+
+  /** Index of the first pixel of scanline number line in direction d. The
+   * scanlines are numbered with dimension 0 varying fastest, dimension d
+   * being skipped. If seeds are used, the scanlines with seeds are numbered
+   * in direction 0. */
+  IndexType GetLineStartIndex(unsigned int d, unsigned long line) const;
+
+  typedef typename DistanceImageType::OffsetValueType OffsetValueType;
+
+  /** The numbering of the scanlines in direction d as offsets into the
+   * buffers of the working images: Scanline number line, decomposed into
+   * digits k_i of the radices Size[i] for the dimensions i != d, starts at
+   * Base + sum(k_i * Step[i]). */
+  struct LineGeometry
+  {
+    OffsetValueType Base;
+    unsigned long Size[ImageDimension];
+    OffsetValueType Step[ImageDimension];
+  };
+
+  /** Precompute the numbering of the scanlines in direction d. */
+  void ComputeLineGeometry(unsigned int d, LineGeometry &geometry) const;
+
+  /** Offset of the first pixel of scanline number line in direction d, like
+   * GetLineStartIndex(). Direction is d, or -1 if d is only known at run
+   * time. */
+  template < int Direction >
+  OffsetValueType GetLineOffset(unsigned int d, const LineGeometry &geometry,
+      unsigned long line) const;
+
+  /** Call the kernel of direction d for the scanlines
+   * [firstLine, firstLine + numberOfLines). Called by each of the threads
+   * for each of its tiles. For 2D and 3D images, each direction gets a
+   * kernel of its own, in which the direction is a compile-time constant,
+   * so the line offsets are computed without a loop over the dimensions
+   * and the pixels along direction 0 are known to be adjacent. */
+  template < bool UseSpacing, bool CreateVoronoiMap >
+  void DispatchGenerateLines(unsigned int d, unsigned long firstLine,
+      unsigned long numberOfLines, int threadId);
+
+  /** Call the kernel with the sink of the iteration: MeasuringSink in the
+   * last iteration if it collects runs or statistics, DenseSink
+   * otherwise. */
+  template < bool UseSpacing, bool CreateVoronoiMap, int Direction >
+  void DispatchSink(unsigned int d, unsigned long firstLine,
+      unsigned long numberOfLines, int threadId);
+
+  /** Compute the lower envelope for the scanlines
+   * [firstLine, firstLine + numberOfLines) in direction d and pass its
+   * samples to a TSink. Direction is d for the kernels of 2D and 3D
+   * images, or -1 for the generic one. */
+  template < bool UseSpacing, bool CreateVoronoiMap, int Direction, class TSink >
+  void ThreadedGenerateLines(unsigned int d, unsigned long firstLine,
+      unsigned long numberOfLines, int threadId);
+
+  /** Sample the envelope of a scanline in direction d into the output
+   * iterators. */
+  template < bool CreateVoronoiMap, class TEnvelope, class TValueIterator, class TVoronoiIterator >
+  void SampleLine(TEnvelope &envelope, unsigned int d, long firstSample,
+      long numberOfSamples, long stride, TValueIterator &valueIt,
+      TVoronoiIterator &voronoiIt) const;
+
+  /** An envelope kept by a thread for the scanlines of one direction. The
+   * type of the envelope depends on the kernel. */
+  struct ThreadEnvelopeBase
+  {
+    virtual ~ThreadEnvelopeBase() {}
+  };
+
+  template < class TEnvelope >
+  struct ThreadEnvelope : public ThreadEnvelopeBase
+  {
+    ThreadEnvelope(unsigned long length, const TSpacingType &spacing)
+      : Spacing(spacing), Envelope(length, spacing) {}
+    TSpacingType Spacing;
+    TEnvelope Envelope;
+  };
+
+  /** The envelope of thread threadId for the scanlines in direction d. It
+   * is created on first use and kept for the following tiles and updates.
+   * Its memory grows to the longest scanline it has seen. */
+  template < class TEnvelope >
+  TEnvelope &GetThreadEnvelope(int threadId, unsigned int d,
+      unsigned long length, const TSpacingType &spacing);
+
+  /** Static function used as a "callback" by the MultiThreader. Each thread
+   * computes the tiles of its queue and steals from the others when it is
+   * done. */
+  template < bool UseSpacing, bool CreateVoronoiMap >
+  static ITK_THREAD_RETURN_TYPE LinesThreaderCallback(void *arg);
+
+  /** Convert a stored distance to an apex height. Values from
+   * GetMaximumApexHeight() on are background and become the largest apex
+   * height of the envelope. */
+  static AccumulatorType DistanceToAccumulator(const DistancePixelType &distance)
+    {
+    if (distance >= GetMaximumApexHeight())
+      return LEOPDV::maxApexHeight;
+    return static_cast<AccumulatorType>(distance);
+    }
+
+  /** Convert an envelope sample to a stored distance, saturating it to
+   * GetMaximumApexHeight(). Saturated samples that are not background are
+   * counted in saturated. */
+  static DistancePixelType AccumulatorToDistance(const AccumulatorType &value,
+      unsigned long &saturated)
+    {
+    if (static_cast<double>(value) < static_cast<double>(GetMaximumApexHeight()))
+      {
+      if (static_cast<double>(value) <
+          static_cast<double>(NumericTraits<DistancePixelType>::NonpositiveMin()))
+        {
+        ++saturated;
+        return NumericTraits<DistancePixelType>::NonpositiveMin();
+        }
+      return static_cast<DistancePixelType>(value);
+      }
+    if (value < LEOPDV::maxApexHeight)
+      ++saturated;
+    return GetMaximumApexHeight();
+    }
+
+  /** Output iterator for LowerEnvelopeOfParabolas::uniformSample(). It
+   * stores the envelope samples with AccumulatorToDistance(). */
+  template < class TIterator >
+  class SaturatingIterator
+  {
+    public:
+      SaturatingIterator(TIterator &it, unsigned long &saturated)
+        : m_Iterator(it), m_Saturated(saturated) {}
+
+      void Set(const AccumulatorType &value)
+        { m_Iterator.Set(AccumulatorToDistance(value, m_Saturated)); }
+
+      SaturatingIterator &operator++()
+        { ++m_Iterator; return *this; }
+
+    private:
+      TIterator &m_Iterator;
+      unsigned long &m_Saturated;
+  };
+
+  /** Output iterator on a raw image buffer that advances by a fixed number
+   * of pixels. The pointer can be moved to the next scanline with
+   * SetPointer(). If FixedStep is not 0, it is the step, known at compile
+   * time, and the step given to the constructor is ignored. */
+  template < class TPixel, int FixedStep = 0 >
+  class StridedPointer
+  {
+    public:
+      typedef typename DistanceImageType::OffsetValueType OffsetValueType;
+
+      StridedPointer(TPixel *pointer, OffsetValueType step)
+        : m_Pointer(pointer), m_Step(step) {}
+
+      void SetPointer(TPixel *pointer)
+        { m_Pointer = pointer; }
+
+      template < class TValue >
+      void Set(const TValue &value)
+        { *m_Pointer = value; }
+
+      StridedPointer &operator++()
+        { m_Pointer += FixedStep != 0 ? FixedStep : m_Step; return *this; }
+
+    private:
+      TPixel *m_Pointer;
+      OffsetValueType m_Step;
+  };
+
+  /** The partial statistics of a thread. */
+  struct ThreadStatisticsType
+  {
+    unsigned long Count;
+    double Sum;
+    DistancePixelType Maximum;
+    HistogramType Histogram;
+    LabelStatisticsContainerType Labels;
+  };
+
+  /** Sink of the samples of the kernel that stores them in the working
+   * images. The kernel creates one sink per tile. BeginLine() points the
+   * output iterators to the first kept sample of a scanline, at offset
+   * from the start of the buffers, and EndLine() and EndTile() are called
+   * after the scanline and the tile. FixedStep is the step of the samples
+   * if it is known at compile time, see StridedPointer. */
+  template < bool CreateVoronoiMap, int FixedStep >
+  class DenseSink
+  {
+    public:
+      typedef StridedPointer<DistancePixelType, FixedStep> DistancePointerType;
+      typedef SaturatingIterator<DistancePointerType> DistanceIteratorType;
+      typedef StridedPointer<LabelPixelType, FixedStep> VoronoiIteratorType;
+
+      DenseSink(Self *filter, unsigned int itkNotUsed(d),
+          unsigned long itkNotUsed(firstLine), int threadId, OffsetValueType step)
+        : m_DistanceBuffer(filter->m_WorkingDistance->GetBufferPointer()),
+          m_VoronoiMapBuffer(CreateVoronoiMap ?
+              filter->m_WorkingVoronoiMap->GetBufferPointer() : 0),
+          m_DistancePointer(m_DistanceBuffer, step),
+          m_DistanceIterator(m_DistancePointer,
+              filter->m_ThreadNumberOfSaturatedPixels[threadId]),
+          m_VoronoiIterator(m_VoronoiMapBuffer, step) {}
+
+      void BeginLine(unsigned long itkNotUsed(line), OffsetValueType offset)
+        {
+        m_DistancePointer.SetPointer(m_DistanceBuffer + offset);
+        if (CreateVoronoiMap)
+          m_VoronoiIterator.SetPointer(m_VoronoiMapBuffer + offset);
+        }
+
+      void EndLine(unsigned long itkNotUsed(line)) {}
+      void EndTile() {}
+
+      DistanceIteratorType &GetDistanceIterator()
+        { return m_DistanceIterator; }
+      VoronoiIteratorType &GetVoronoiIterator()
+        { return m_VoronoiIterator; }
+
+    private:
+      DistancePixelType *m_DistanceBuffer;
+      LabelPixelType *m_VoronoiMapBuffer;
+      DistancePointerType m_DistancePointer;
+      DistanceIteratorType m_DistanceIterator;
+      VoronoiIteratorType m_VoronoiIterator;
+  };
+
+  /** Sink of the samples of the last iteration, like DenseSink. The
+   * distances are stored and added to the statistics of the thread if
+   * GetComputeStatistics() is on. The labels are recorded as runs of equal
+   * labels if GetCreateRunLengthVoronoiMap() is on, stored unless only the
+   * runs are written, and their distances are added to the statistics of
+   * the label. The distances of consecutive equal labels are summed up
+   * before they are added. */
+  template < bool CreateVoronoiMap >
+  class MeasuringSink
+  {
+    public:
+      class DistanceIteratorType
+      {
+        public:
+          DistanceIteratorType(MeasuringSink &sink) : m_Sink(sink) {}
+          void Set(const AccumulatorType &value)
+            { m_Sink.SetDistance(value); }
+          DistanceIteratorType &operator++()
+            { m_Sink.m_DistancePointer += m_Sink.m_Step; return *this; }
+        private:
+          MeasuringSink &m_Sink;
+      };
+
+      class VoronoiIteratorType
+      {
+        public:
+          VoronoiIteratorType(MeasuringSink &sink) : m_Sink(sink) {}
+          void Set(const LabelPixelType &label)
+            { m_Sink.SetLabel(label); }
+          VoronoiIteratorType &operator++()
+            {
+            m_Sink.m_VoronoiMapPointer += m_Sink.m_Step;
+            ++m_Sink.m_Position;
+            return *this;
+            }
+        private:
+          MeasuringSink &m_Sink;
+      };
+
+      MeasuringSink(Self *filter, unsigned int d, unsigned long firstLine,
+          int threadId, OffsetValueType step)
+        : m_DistanceBuffer(filter->m_WorkingDistance->GetBufferPointer()),
+          m_VoronoiMapBuffer(CreateVoronoiMap ?
+              filter->m_WorkingVoronoiMap->GetBufferPointer() : 0),
+          m_Step(step), m_DistancePointer(0), m_VoronoiMapPointer(0),
+          m_DistanceIterator(*this), m_VoronoiIterator(*this),
+          m_Saturated(filter->m_ThreadNumberOfSaturatedPixels[threadId]),
+          m_Statistics(filter->m_CollectStatistics ?
+              &filter->m_ThreadStatistics[threadId] : 0),
+          m_HistogramBinWidth(filter->m_HistogramBinWidth),
+          m_Value(), m_Measured(false), m_Label(), m_Runs(0),
+          m_LineRuns(&filter->m_VoronoiRunLineStarts), m_WriteVoronoiMap(true),
+          m_FirstPosition(filter->GetDistance()->GetRequestedRegion().GetIndex()[d]),
+          m_Position(0), m_FirstRun(0)
+        {
+        m_Pending.Count = 0;
+        m_Pending.Sum = 0.0;
+        m_Pending.Maximum = DistancePixelType();
+        if (CreateVoronoiMap && filter->m_CollectVoronoiRuns)
+          {
+          m_Runs = &filter->m_TileVoronoiRuns[firstLine / filter->m_VoronoiRunLinesPerTile];
+          m_WriteVoronoiMap = filter->m_WriteDenseVoronoiMap;
+          }
+        }
+
+      ~MeasuringSink()
+        { this->FlushLabel(); }
+
+      void BeginLine(unsigned long itkNotUsed(line), OffsetValueType offset)
+        {
+        m_DistancePointer = m_DistanceBuffer + offset;
+        if (CreateVoronoiMap)
+          m_VoronoiMapPointer = m_VoronoiMapBuffer + offset;
+        m_Position = m_FirstPosition;
+        m_FirstRun = m_Runs ? m_Runs->size() : 0;
+        }
+
+      void EndLine(unsigned long line)
+        {
+        if (m_Runs)
+          (*m_LineRuns)[line + 1] = m_Runs->size() - m_FirstRun;
+        }
+
+      void EndTile()
+        { this->FlushLabel(); }
+
+      DistanceIteratorType &GetDistanceIterator()
+        { return m_DistanceIterator; }
+      VoronoiIteratorType &GetVoronoiIterator()
+        { return m_VoronoiIterator; }
+
+    private:
+      void SetDistance(const AccumulatorType &sample)
+        {
+        const DistancePixelType value = AccumulatorToDistance(sample, m_Saturated);
+        *m_DistancePointer = value;
+        if (!m_Statistics)
+          return;
+        m_Value = value;
+        m_Measured = value < GetMaximumApexHeight();
+        if (!m_Measured)
+          return;
+        if (m_Statistics->Count == 0 || m_Statistics->Maximum < value)
+          m_Statistics->Maximum = value;
+        ++m_Statistics->Count;
+        m_Statistics->Sum += static_cast<double>(value);
+        const double bin = static_cast<double>(value) / m_HistogramBinWidth;
+        const unsigned long lastBin = m_Statistics->Histogram.size() - 1;
+        if (bin <= 0.0)
+          ++m_Statistics->Histogram[0];
+        else if (bin >= lastBin)
+          ++m_Statistics->Histogram[lastBin];
+        else
+          ++m_Statistics->Histogram[static_cast<unsigned long>(bin)];
+        }
+
+      void SetLabel(const LabelPixelType &label)
+        {
+        if (m_WriteVoronoiMap)
+          *m_VoronoiMapPointer = label;
+
+        if (m_Runs)
+          {
+          if (!m_Runs->empty() && m_Runs->back().Label == label &&
+              m_Runs->back().Start + static_cast<long>(m_Runs->back().Length) == m_Position)
+            ++m_Runs->back().Length;
+          else
+            {
+            VoronoiRunType run;
+            run.Start = m_Position;
+            run.Length = 1;
+            run.Label = label;
+            m_Runs->push_back(run);
+            }
+          }
+
+        if (!m_Statistics || !m_Measured)
+          return;
+        if (m_Pending.Count > 0 && !(m_Label == label))
+          this->FlushLabel();
+        if (m_Pending.Count == 0 || m_Pending.Maximum < m_Value)
+          m_Pending.Maximum = m_Value;
+        ++m_Pending.Count;
+        m_Pending.Sum += static_cast<double>(m_Value);
+        m_Label = label;
+        }
+
+      /** Add the pending distances of m_Label to the statistics. */
+      void FlushLabel()
+        {
+        if (m_Pending.Count == 0)
+          return;
+        typename LabelStatisticsContainerType::iterator labelStatistics =
+          m_Statistics->Labels.find(m_Label);
+        if (labelStatistics == m_Statistics->Labels.end())
+          m_Statistics->Labels.insert(std::make_pair(m_Label, m_Pending));
+        else
+          {
+          labelStatistics->second.Count += m_Pending.Count;
+          labelStatistics->second.Sum += m_Pending.Sum;
+          if (labelStatistics->second.Maximum < m_Pending.Maximum)
+            labelStatistics->second.Maximum = m_Pending.Maximum;
+          }
+        m_Pending.Count = 0;
+        m_Pending.Sum = 0.0;
+        }
+
+      DistancePixelType *m_DistanceBuffer;
+      LabelPixelType *m_VoronoiMapBuffer;
+      OffsetValueType m_Step;
+      DistancePixelType *m_DistancePointer;
+      LabelPixelType *m_VoronoiMapPointer;
+      DistanceIteratorType m_DistanceIterator;
+      VoronoiIteratorType m_VoronoiIterator;
+      unsigned long &m_Saturated;
+
+      /** The statistics of the thread, NULL if none are collected, and the
+       * last distance, for the statistics of its label. */
+      ThreadStatisticsType *m_Statistics;
+      double m_HistogramBinWidth;
+      DistancePixelType m_Value;
+      bool m_Measured;
+      LabelPixelType m_Label;
+      LabelStatisticsType m_Pending;
+
+      /** The runs of the tile, NULL if none are recorded, and the number
+       * of runs of each scanline. */
+      VoronoiRunContainerType *m_Runs;
+      std::vector<unsigned long> *m_LineRuns;
+      bool m_WriteVoronoiMap;
+      long m_FirstPosition;
+      long m_Position;
+      unsigned long m_FirstRun;
+
+      friend class DistanceIteratorType;
+      friend class VoronoiIteratorType;
+  };
+
+  /** The tiles [Begin, End) that are still to be computed by a thread.
+   * The owner takes tiles from the front, thieves from the back. */
+  struct TileQueue
+  {
+    SimpleFastMutexLock Lock;
+    unsigned long Begin;
+    unsigned long End;
+  };
+
+  /** Internal structure used for passing the filter, the current
+   * direction and the tile queues to the threads. The threads count the
+   * scanlines they finished in NumberOfFinishedLines for the progress. */
+  struct LinesThreadStruct
+  {
+    Pointer Filter;
+    unsigned int Dimension;
+    unsigned long NumberOfLines;
+    unsigned long LinesPerTile;
+    TileQueue *Queues;
+    SimpleFastMutexLock ProgressLock;
+    unsigned long NumberOfFinishedLines;
+  };
+
+  /** Take the first tile of a queue. Returns false if it is empty. */
+  static bool PopTile(TileQueue &queue, unsigned long &tile);
+
+  /** Move half of the tiles of another thread into the queue of thief.
+   * Returns the number of stolen tiles, 0 if all queues are empty. */
+  static unsigned long StealTiles(LinesThreadStruct *str, unsigned int thief,
+      unsigned int numberOfThreads);
+
 private:   
   GeneralizedDistanceTransformImageFilter(const Self&); //purposely not implemented
   void operator=(const Self&); //purposely not implemented
 
   bool m_UseSpacing;
   bool m_CreateVoronoiMap;
+  BooleanArrayType m_PeriodicBoundary;
+  BooleanArrayType m_ProcessedDimensions;
+  ShrinkFactorsType m_ShrinkFactors;
+
+  bool m_NumaAware;
+  bool m_UseHugePages;
+
+  /** The buffers kept for the next update if ReuseBuffers is on. */
+  bool m_ReuseBuffers;
+  typename DistanceImageType::PixelContainerPointer m_DistanceBuffer;
+  typename DistanceImageType::PixelContainerPointer m_WorkingDistanceBuffer;
+  typename LabelImageType::PixelContainerPointer m_VoronoiMapBuffer;
+  typename LabelImageType::PixelContainerPointer m_WorkingVoronoiMapBuffer;
+  NumaTopology m_NumaTopology;
+
+  bool m_UseSeeds;
+  SeedContainerType m_Seeds;
+  RegionType m_OutputRegion;
+  SpacingType m_OutputSpacing;
+  PointType m_OutputOrigin;
+  LabelPixelType m_BackgroundLabel;
+
+  typename FunctionBrickImageType::ConstPointer m_SparseFunction;
+  typename LabelBrickImageType::ConstPointer m_SparseLabels;
+  bool m_CreateSparseOutputs;
+  DistancePixelType m_NarrowBand;
+  SizeType m_OutputBrickSize;
+  typename DistanceBrickImageType::Pointer m_SparseDistance;
+  typename LabelBrickImageType::Pointer m_SparseVoronoiMap;
+
+  bool m_CreateRunLengthVoronoiMap;
+  bool m_WriteDenseVoronoiMap;
+  VoronoiRunContainerType m_VoronoiRuns;
+  std::vector<unsigned long> m_VoronoiRunLineStarts;
+  unsigned int m_VoronoiRunDirection;
+  RegionType m_VoronoiRunRegion;
+
+  bool m_ComputeStatistics;
+  unsigned int m_NumberOfHistogramBins;
+  double m_HistogramBinWidth;
+  unsigned long m_NumberOfMeasuredPixels;
+  DistancePixelType m_MaximumDistance;
+  double m_MeanDistance;
+  HistogramType m_DistanceHistogram;
+  LabelStatisticsContainerType m_LabelStatistics;
+
+  /** While the last iteration computes statistics: the partial statistics
+   * of each thread. */
+  bool m_CollectStatistics;
+  std::vector<ThreadStatisticsType> m_ThreadStatistics;
+
+  /** While the last iteration records runs: the runs of each tile and the
+   * tile size. m_VoronoiRunLineStarts holds the number of runs of each
+   * scanline until they are gathered. */
+  bool m_CollectVoronoiRuns;
+  unsigned long m_VoronoiRunLinesPerTile;
+  std::vector<VoronoiRunContainerType> m_TileVoronoiRuns;
+
+  /** Numbers of the scanlines in direction 0 that contain seeds or pass
+   * through allocated bricks. */
+  std::vector<unsigned long> m_SeedLines;
+
+  /** Full resolution images the iterations work on. They are the outputs
+   * themselves unless the outputs are shrunk. */
+  DistanceImagePointer m_WorkingDistance;
+  LabelImagePointer m_WorkingVoronoiMap;
+
+  DistancePixelType *m_DistanceImportPointer;
+  LabelPixelType *m_VoronoiMapImportPointer;
+
+  unsigned long m_NumberOfSaturatedPixels;
+  std::vector<unsigned long> m_ThreadNumberOfSaturatedPixels;
+
+  /** The envelopes of the threads, ImageDimension per thread. */
+  std::vector<ThreadEnvelopeBase *> m_ThreadEnvelopes;
+
+  unsigned long m_LinesPerTile;
+  double m_LoadBalanceEfficiency;
+  unsigned long m_NumberOfStolenTiles;
+  std::vector<double> m_ThreadBusyTime;
+  std::vector<unsigned long> m_ThreadNumberOfStolenTiles;
+
+  bool m_AutoTune;
+  std::string m_TuningFileName;
+
+  /** The applied configuration and its key. */
+  std::string m_TunedKey;
+  int m_TunedNumberOfThreads;
+  unsigned long m_TunedLinesPerTile;
 
 }; // end of GeneralizedDistanceTransformImageFilter class
 
 } //end namespace itk
 
 
-#ifndef ITK_MANUAL_INSTANTIATION
+// See itkGeneralizedDistanceTransformImageFilterInstantiations.cxx
+#if !defined(ITK_MANUAL_INSTANTIATION) && !defined(ITK_USE_PRECOMPILED_GENERALIZED_DISTANCE_TRANSFORM)
 #include "itkGeneralizedDistanceTransformImageFilter.txx"
 #endif
 
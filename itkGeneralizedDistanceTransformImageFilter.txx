@@ -2,12 +2,16 @@
 #define __itkGeneralizedDistanceTransformImageFilter_txx
 
 #include <iostream>
+#include <algorithm>
 
 #include "itkGeneralizedDistanceTransformImageFilter.h"
-#include "itkImageLinearIteratorWithIndex.h"
 #include "itkImageRegionConstIterator.h"
 #include "itkImageRegionIterator.h"
-#include "itkProgressReporter.h"
+#include "itkImageRegionIteratorWithIndex.h"
+#include "itkRealTimeClock.h"
+
+#include <sstream>
+#include <cmath>
 
 namespace itk
 {
@@ -16,38 +20,214 @@ namespace itk
 /**
  *    Constructor
  */
-template < class TFunctionImage,class TDistanceImage, class TLabelImage, unsigned char MinimalSpacingPrecision >
-GeneralizedDistanceTransformImageFilter< TFunctionImage, TDistanceImage, TLabelImage, MinimalSpacingPrecision >
+template < class TFunctionImage,class TDistanceImage, class TLabelImage, unsigned char MinimalSpacingPrecision, class TAccumulator >
+GeneralizedDistanceTransformImageFilter< TFunctionImage, TDistanceImage, TLabelImage, MinimalSpacingPrecision, TAccumulator >
 ::GeneralizedDistanceTransformImageFilter()
 {
+  m_UseSeeds = false;
   SetCreateVoronoiMap( true );
   m_UseSpacing = true;
+  m_PeriodicBoundary.Fill(false);
+  m_ProcessedDimensions.Fill(true);
+  m_ShrinkFactors.Fill(1);
+  m_OutputSpacing.Fill(1.0);
+  m_OutputOrigin.Fill(0.0);
+  m_BackgroundLabel = LabelPixelType();
+  m_DistanceImportPointer = 0;
+  m_VoronoiMapImportPointer = 0;
+  m_NumberOfSaturatedPixels = 0;
+  m_LinesPerTile = 0;
+  m_LoadBalanceEfficiency = 1.0;
+  m_NumberOfStolenTiles = 0;
+  m_NumaAware = false;
+  m_UseHugePages = false;
+  m_ReuseBuffers = false;
+  m_AutoTune = false;
+  m_TunedNumberOfThreads = 0;
+  m_TunedLinesPerTile = 0;
+  m_CreateRunLengthVoronoiMap = false;
+  m_WriteDenseVoronoiMap = true;
+  m_VoronoiRunDirection = 0;
+  m_CollectVoronoiRuns = false;
+  m_ComputeStatistics = false;
+  m_NumberOfHistogramBins = 256;
+  m_HistogramBinWidth = 1.0;
+  m_NumberOfMeasuredPixels = 0;
+  m_MaximumDistance = DistancePixelType();
+  m_MeanDistance = 0.0;
+  m_CollectStatistics = false;
+  m_VoronoiRunLinesPerTile = 1;
+  m_CreateSparseOutputs = false;
+  m_NarrowBand = GetMaximumApexHeight();
+  m_OutputBrickSize.Fill(16);
+  m_SparseDistance = DistanceBrickImageType::New();
+  m_SparseVoronoiMap = LabelBrickImageType::New();
+
+  this->SetNthOutput(0, this->MakeOutput(0));
+  this->SetNthOutput(1, this->MakeOutput(1));
+}
+
+
+/**
+ *    Destructor
+ */
+template < class TFunctionImage,class TDistanceImage, class TLabelImage, unsigned char MinimalSpacingPrecision, class TAccumulator >
+GeneralizedDistanceTransformImageFilter< TFunctionImage, TDistanceImage, TLabelImage, MinimalSpacingPrecision, TAccumulator >
+::~GeneralizedDistanceTransformImageFilter()
+{
+  for (unsigned long i = 0; i < m_ThreadEnvelopes.size(); ++i)
+    delete m_ThreadEnvelopes[i];
+}
 
-  DistanceImagePointer distance = DistanceImageType::New();
-  this->SetNthOutput(0, distance.GetPointer());
 
-  LabelImagePointer voronoiMap = LabelImageType::New();
-  this->SetNthOutput(1, voronoiMap.GetPointer());
+/**
+ * The voronoi map has its own image type
+ */
+template < class TFunctionImage,class TDistanceImage, class TLabelImage, unsigned char MinimalSpacingPrecision, class TAccumulator >
+typename
+GeneralizedDistanceTransformImageFilter< TFunctionImage, TDistanceImage, TLabelImage, MinimalSpacingPrecision, TAccumulator >
+::DataObjectPointer
+GeneralizedDistanceTransformImageFilter< TFunctionImage, TDistanceImage, TLabelImage, MinimalSpacingPrecision, TAccumulator >
+::MakeOutput(unsigned int idx)
+{
+  if (idx == 1)
+    return static_cast<DataObject *>(LabelImageType::New().GetPointer());
+  return static_cast<DataObject *>(DistanceImageType::New().GetPointer());
+}
 
+/**
+ * Keep the pixel containers of the outputs if ReuseBuffers is on
+ */
+template < class TFunctionImage,class TDistanceImage, class TLabelImage, unsigned char MinimalSpacingPrecision, class TAccumulator >
+void
+GeneralizedDistanceTransformImageFilter< TFunctionImage, TDistanceImage, TLabelImage, MinimalSpacingPrecision, TAccumulator >
+::PrepareOutputs()
+{
+  // Preparing the outputs for new data initializes them, which gives them
+  // new, empty pixel containers. AllocateImage() attaches the kept buffers
+  // again, but the containers would be created anew for each update.
+  if (!m_ReuseBuffers)
+    Superclass::PrepareOutputs();
 }
 
 
-template < class TFunctionImage,class TDistanceImage, class TLabelImage, unsigned char MinimalSpacingPrecision >
+template < class TFunctionImage,class TDistanceImage, class TLabelImage, unsigned char MinimalSpacingPrecision, class TAccumulator >
 void
-GeneralizedDistanceTransformImageFilter< TFunctionImage, TDistanceImage, TLabelImage, MinimalSpacingPrecision >
+GeneralizedDistanceTransformImageFilter< TFunctionImage, TDistanceImage, TLabelImage, MinimalSpacingPrecision, TAccumulator >
 ::SetCreateVoronoiMap(bool b)
 {
   m_CreateVoronoiMap = b;
   if (m_CreateVoronoiMap)
-  {
-    this->SetNumberOfRequiredInputs(2);
     this->SetNumberOfRequiredOutputs(2);
-  }
   else
-  {
-    this->SetNumberOfRequiredInputs(1);
     this->SetNumberOfRequiredOutputs(1);
-  }
+  this->UpdateNumberOfRequiredInputs();
+}
+
+/**
+ * No images are required if seeds or bricks are used
+ */
+template < class TFunctionImage,class TDistanceImage, class TLabelImage, unsigned char MinimalSpacingPrecision, class TAccumulator >
+void
+GeneralizedDistanceTransformImageFilter< TFunctionImage, TDistanceImage, TLabelImage, MinimalSpacingPrecision, TAccumulator >
+::UpdateNumberOfRequiredInputs()
+{
+  if (this->HasSparseInput())
+    this->SetNumberOfRequiredInputs(0);
+  else if (m_CreateVoronoiMap)
+    this->SetNumberOfRequiredInputs(2);
+  else
+    this->SetNumberOfRequiredInputs(1);
+}
+
+/**
+ * Set the seeds that replace the input images
+ */
+template < class TFunctionImage,class TDistanceImage, class TLabelImage, unsigned char MinimalSpacingPrecision, class TAccumulator >
+void
+GeneralizedDistanceTransformImageFilter< TFunctionImage, TDistanceImage, TLabelImage, MinimalSpacingPrecision, TAccumulator >
+::SetSeeds(const SeedContainerType &seeds)
+{
+  m_Seeds = seeds;
+  m_UseSeeds = true;
+  m_SparseFunction = 0;
+  m_SparseLabels = 0;
+  this->UpdateNumberOfRequiredInputs();
+  this->Modified();
+}
+
+template < class TFunctionImage,class TDistanceImage, class TLabelImage, unsigned char MinimalSpacingPrecision, class TAccumulator >
+void
+GeneralizedDistanceTransformImageFilter< TFunctionImage, TDistanceImage, TLabelImage, MinimalSpacingPrecision, TAccumulator >
+::AddSeed(const IndexType &index, const DistancePixelType &height,
+    const LabelPixelType &label)
+{
+  SeedType seed;
+  seed.Index = index;
+  seed.Height = height;
+  seed.Label = label;
+  m_Seeds.push_back(seed);
+  m_UseSeeds = true;
+  m_SparseFunction = 0;
+  m_SparseLabels = 0;
+  this->UpdateNumberOfRequiredInputs();
+  this->Modified();
+}
+
+template < class TFunctionImage,class TDistanceImage, class TLabelImage, unsigned char MinimalSpacingPrecision, class TAccumulator >
+void
+GeneralizedDistanceTransformImageFilter< TFunctionImage, TDistanceImage, TLabelImage, MinimalSpacingPrecision, TAccumulator >
+::ClearSeeds()
+{
+  m_Seeds.clear();
+  m_UseSeeds = false;
+  this->UpdateNumberOfRequiredInputs();
+  this->Modified();
+}
+
+/**
+ * Set the bricks that replace the input images
+ */
+template < class TFunctionImage,class TDistanceImage, class TLabelImage, unsigned char MinimalSpacingPrecision, class TAccumulator >
+void
+GeneralizedDistanceTransformImageFilter< TFunctionImage, TDistanceImage, TLabelImage, MinimalSpacingPrecision, TAccumulator >
+::SetSparseInputs(const FunctionBrickImageType *function,
+    const LabelBrickImageType *labels)
+{
+  m_SparseFunction = function;
+  m_SparseLabels = labels;
+  m_Seeds.clear();
+  m_UseSeeds = false;
+  this->UpdateNumberOfRequiredInputs();
+  this->Modified();
+}
+
+template < class TFunctionImage,class TDistanceImage, class TLabelImage, unsigned char MinimalSpacingPrecision, class TAccumulator >
+void
+GeneralizedDistanceTransformImageFilter< TFunctionImage, TDistanceImage, TLabelImage, MinimalSpacingPrecision, TAccumulator >
+::ClearSparseInputs()
+{
+  m_SparseFunction = 0;
+  m_SparseLabels = 0;
+  this->UpdateNumberOfRequiredInputs();
+  this->Modified();
+}
+
+/**
+ * The bricks are not inputs of the pipeline, changes to them must update
+ * the filter anyway
+ */
+template < class TFunctionImage,class TDistanceImage, class TLabelImage, unsigned char MinimalSpacingPrecision, class TAccumulator >
+unsigned long
+GeneralizedDistanceTransformImageFilter< TFunctionImage, TDistanceImage, TLabelImage, MinimalSpacingPrecision, TAccumulator >
+::GetMTime() const
+{
+  unsigned long mtime = Superclass::GetMTime();
+  if (m_SparseFunction)
+    mtime = std::max(mtime, m_SparseFunction->GetMTime());
+  if (m_SparseLabels)
+    mtime = std::max(mtime, m_SparseLabels->GetMTime());
+  return mtime;
 }
 
 
@@ -55,9 +235,9 @@ GeneralizedDistanceTransformImageFilter< TFunctionImage, TDistanceImage, TLabelI
 /**
  * Connect the function image
  */
-template < class TFunctionImage,class TDistanceImage, class TLabelImage, unsigned char MinimalSpacingPrecision >
+template < class TFunctionImage,class TDistanceImage, class TLabelImage, unsigned char MinimalSpacingPrecision, class TAccumulator >
 void
-GeneralizedDistanceTransformImageFilter< TFunctionImage, TDistanceImage, TLabelImage, MinimalSpacingPrecision >
+GeneralizedDistanceTransformImageFilter< TFunctionImage, TDistanceImage, TLabelImage, MinimalSpacingPrecision, TAccumulator >
 ::SetInput1(const FunctionImageType *functionImage)
 {
   // Process object is not const-correct so the const casting is required.
@@ -67,9 +247,9 @@ GeneralizedDistanceTransformImageFilter< TFunctionImage, TDistanceImage, TLabelI
 /**
  * Connect the label image
  */
-template < class TFunctionImage,class TDistanceImage, class TLabelImage, unsigned char MinimalSpacingPrecision >
+template < class TFunctionImage,class TDistanceImage, class TLabelImage, unsigned char MinimalSpacingPrecision, class TAccumulator >
 void
-GeneralizedDistanceTransformImageFilter< TFunctionImage, TDistanceImage, TLabelImage, MinimalSpacingPrecision >
+GeneralizedDistanceTransformImageFilter< TFunctionImage, TDistanceImage, TLabelImage, MinimalSpacingPrecision, TAccumulator >
 ::SetInput2(const LabelImageType *labelImage)
 {
   // Process object is not const-correct so the const casting is required.
@@ -79,11 +259,11 @@ GeneralizedDistanceTransformImageFilter< TFunctionImage, TDistanceImage, TLabelI
 /**
  *  Return the distance map
  */
-template < class TFunctionImage,class TDistanceImage, class TLabelImage, unsigned char MinimalSpacingPrecision >
+template < class TFunctionImage,class TDistanceImage, class TLabelImage, unsigned char MinimalSpacingPrecision, class TAccumulator >
 typename
-GeneralizedDistanceTransformImageFilter< TFunctionImage, TDistanceImage, TLabelImage, MinimalSpacingPrecision >
+GeneralizedDistanceTransformImageFilter< TFunctionImage, TDistanceImage, TLabelImage, MinimalSpacingPrecision, TAccumulator >
 ::DistanceImageType*
-GeneralizedDistanceTransformImageFilter< TFunctionImage, TDistanceImage, TLabelImage, MinimalSpacingPrecision >
+GeneralizedDistanceTransformImageFilter< TFunctionImage, TDistanceImage, TLabelImage, MinimalSpacingPrecision, TAccumulator >
 ::GetDistance(void)
 {
   return  dynamic_cast<DistanceImageType *>(this->ProcessObject::GetOutput(0));
@@ -92,23 +272,120 @@ GeneralizedDistanceTransformImageFilter< TFunctionImage, TDistanceImage, TLabelI
 /**
  *  Return the voronoi map if m_CreateVoronoiMap == true
  */
-template < class TFunctionImage,class TDistanceImage, class TLabelImage, unsigned char MinimalSpacingPrecision >
+template < class TFunctionImage,class TDistanceImage, class TLabelImage, unsigned char MinimalSpacingPrecision, class TAccumulator >
 typename
-GeneralizedDistanceTransformImageFilter< TFunctionImage, TDistanceImage, TLabelImage, MinimalSpacingPrecision >
+GeneralizedDistanceTransformImageFilter< TFunctionImage, TDistanceImage, TLabelImage, MinimalSpacingPrecision, TAccumulator >
 ::LabelImageType*
-GeneralizedDistanceTransformImageFilter< TFunctionImage, TDistanceImage, TLabelImage, MinimalSpacingPrecision >
+GeneralizedDistanceTransformImageFilter< TFunctionImage, TDistanceImage, TLabelImage, MinimalSpacingPrecision, TAccumulator >
 ::GetVoronoiMap()
 {
   assert(m_CreateVoronoiMap);
   return  dynamic_cast<LabelImageType *>(this->ProcessObject::GetOutput(1));
 }
 
+/**
+ * The outputs are subsampled by the shrink factors
+ */
+template < class TFunctionImage,class TDistanceImage, class TLabelImage, unsigned char MinimalSpacingPrecision, class TAccumulator >
+void
+GeneralizedDistanceTransformImageFilter< TFunctionImage, TDistanceImage, TLabelImage, MinimalSpacingPrecision, TAccumulator >
+::GenerateOutputInformation()
+{
+  Superclass::GenerateOutputInformation();
+
+  // The geometry before shrinking is the one of the function image, the
+  // one of the function bricks or the one given for the seeds
+  RegionType inputRegion = m_OutputRegion;
+  SpacingType outputSpacing = m_OutputSpacing;
+  PointType outputOrigin = m_OutputOrigin;
+  if (m_SparseFunction)
+  {
+    inputRegion = m_SparseFunction->GetRegion();
+    outputSpacing = m_SparseFunction->GetSpacing();
+    outputOrigin = m_SparseFunction->GetOrigin();
+  }
+  else if (!m_UseSeeds)
+  {
+    const FunctionImageType *functionImage =
+      dynamic_cast<const FunctionImageType *>(ProcessObject::GetInput(0));
+    if (!functionImage)
+      return;
+
+    inputRegion = functionImage->GetLargestPossibleRegion();
+    outputSpacing = functionImage->GetSpacing();
+    outputOrigin = functionImage->GetOrigin();
+  }
+
+  RegionType outputRegion;
+
+  // Output index j is the sample at input index j * k. The output region
+  // covers all such samples within the input region.
+  for (unsigned int d = 0; d < FunctionImageType::ImageDimension; ++d)
+  {
+    const long k = m_ShrinkFactors[d];
+    if (k == 0)
+      itkExceptionMacro(<< "Shrink factor of dimension " << d << " is 0");
+
+    const long first = inputRegion.GetIndex()[d];
+    const long last = first + static_cast<long>(inputRegion.GetSize()[d]) - 1;
+
+    // Round first up and last down to multiples of k
+    const long outputFirst = first >= 0 ? (first + k - 1) / k : -((-first) / k);
+    const long outputLast = last >= 0 ? last / k : -((-last + k - 1) / k);
+    if (outputLast < outputFirst)
+      itkExceptionMacro(<< "Shrink factor of dimension " << d
+          << " is larger than the image");
+
+    IndexType index = outputRegion.GetIndex();
+    typename RegionType::SizeType size = outputRegion.GetSize();
+    index[d] = outputFirst;
+    size[d] = outputLast - outputFirst + 1;
+    outputRegion.SetIndex(index);
+    outputRegion.SetSize(size);
+
+    outputSpacing[d] *= k;
+  }
+
+  DistanceImagePointer distance = this->GetDistance();
+  distance->SetLargestPossibleRegion(outputRegion);
+  distance->SetSpacing(outputSpacing);
+  distance->SetOrigin(outputOrigin);
+
+  LabelImageType *voronoiMap =
+    dynamic_cast<LabelImageType *>(this->ProcessObject::GetOutput(1));
+  if (voronoiMap)
+  {
+    voronoiMap->SetLargestPossibleRegion(outputRegion);
+    voronoiMap->SetSpacing(outputSpacing);
+    voronoiMap->SetOrigin(outputOrigin);
+  }
+}
+
+/**
+ * The whole inputs are needed. Their requested regions can't be derived
+ * from the one of the outputs if those are shrunk.
+ */
+template < class TFunctionImage,class TDistanceImage, class TLabelImage, unsigned char MinimalSpacingPrecision, class TAccumulator >
+void
+GeneralizedDistanceTransformImageFilter< TFunctionImage, TDistanceImage, TLabelImage, MinimalSpacingPrecision, TAccumulator >
+::GenerateInputRequestedRegion()
+{
+  Superclass::GenerateInputRequestedRegion();
+
+  for (unsigned int i = 0; i < this->GetNumberOfInputs(); ++i)
+  {
+    DataObject *input = this->ProcessObject::GetInput(i);
+    if (input)
+      input->SetRequestedRegionToLargestPossibleRegion();
+  }
+}
+
 /** 
  * The whole output will be produced regardless of the region requested.
  */
-template < class TFunctionImage,class TDistanceImage, class TLabelImage, unsigned char MinimalSpacingPrecision >
+template < class TFunctionImage,class TDistanceImage, class TLabelImage, unsigned char MinimalSpacingPrecision, class TAccumulator >
 void
-GeneralizedDistanceTransformImageFilter< TFunctionImage, TDistanceImage, TLabelImage, MinimalSpacingPrecision >
+GeneralizedDistanceTransformImageFilter< TFunctionImage, TDistanceImage, TLabelImage, MinimalSpacingPrecision, TAccumulator >
 ::EnlargeOutputRequestedRegion(DataObject *)
 {
   this->GetDistance()->SetRequestedRegion(this->GetDistance()->GetLargestPossibleRegion());
@@ -119,31 +396,143 @@ GeneralizedDistanceTransformImageFilter< TFunctionImage, TDistanceImage, TLabelI
 /**
  * Allocate and initialize output images. Helper function for GenerateData()
  */
-template < class TFunctionImage,class TDistanceImage, class TLabelImage, unsigned char MinimalSpacingPrecision >
+template < class TFunctionImage,class TDistanceImage, class TLabelImage, unsigned char MinimalSpacingPrecision, class TAccumulator >
 void 
-GeneralizedDistanceTransformImageFilter< TFunctionImage, TDistanceImage, TLabelImage, MinimalSpacingPrecision >
+GeneralizedDistanceTransformImageFilter< TFunctionImage, TDistanceImage, TLabelImage, MinimalSpacingPrecision, TAccumulator >
 ::PrepareData() 
 {
 
-  // Copy the function image into the distance image
-  FunctionImageConstPointer functionImage  =
-    dynamic_cast<FunctionImageType *>(ProcessObject::GetInput(0));
+  // The iterations need the full resolution. If the outputs are shrunk, they
+  // work on separate images.
+  bool shrink = false;
+  for (unsigned int d = 0; d < FunctionImageType::ImageDimension; ++d)
+    shrink |= m_ShrinkFactors[d] > 1;
+
+  if (!m_ReuseBuffers)
+  {
+    m_DistanceBuffer = 0;
+    m_WorkingDistanceBuffer = 0;
+    m_VoronoiMapBuffer = 0;
+    m_WorkingVoronoiMapBuffer = 0;
+  }
+
+  FunctionImageConstPointer functionImage;
+  RegionType workingRegion = m_OutputRegion;
+  SpacingType workingSpacing = m_OutputSpacing;
+  PointType workingOrigin = m_OutputOrigin;
+  if (m_SparseFunction)
+  {
+    workingRegion = m_SparseFunction->GetRegion();
+    workingSpacing = m_SparseFunction->GetSpacing();
+    workingOrigin = m_SparseFunction->GetOrigin();
+  }
+  else if (!m_UseSeeds)
+  {
+    functionImage = dynamic_cast<FunctionImageType *>(ProcessObject::GetInput(0));
+    workingRegion = functionImage->GetRequestedRegion();
+    workingSpacing = functionImage->GetSpacing();
+    workingOrigin = functionImage->GetOrigin();
+  }
 
   DistanceImagePointer distance = this->GetDistance();
   distance->SetBufferedRegion(distance->GetRequestedRegion());
-  distance->Allocate();
+  if (m_DistanceImportPointer)
+  {
+    // The container of the output may be a kept buffer
+    if (m_ReuseBuffers)
+      distance->SetPixelContainer(DistanceImageType::PixelContainer::New());
+    distance->GetPixelContainer()->SetImportPointer(m_DistanceImportPointer,
+        distance->GetRequestedRegion().GetNumberOfPixels(), false);
+  }
+  else
+    this->AllocateImage(distance.GetPointer(), m_DistanceBuffer);
+
+  if (shrink)
+  {
+    m_WorkingDistance = DistanceImageType::New();
+    m_WorkingDistance->SetRegions(workingRegion);
+    m_WorkingDistance->SetSpacing(workingSpacing);
+    m_WorkingDistance->SetOrigin(workingOrigin);
+    this->AllocateImage(m_WorkingDistance.GetPointer(), m_WorkingDistanceBuffer);
+  }
+  else
+    m_WorkingDistance = distance;
+
+  if (m_CreateVoronoiMap)
+  {
+    LabelImagePointer voronoiMap = this->GetVoronoiMap();
+    voronoiMap->SetBufferedRegion(voronoiMap->GetRequestedRegion());
+    if (m_VoronoiMapImportPointer)
+    {
+      if (m_ReuseBuffers)
+        voronoiMap->SetPixelContainer(LabelImageType::PixelContainer::New());
+      voronoiMap->GetPixelContainer()->SetImportPointer(m_VoronoiMapImportPointer,
+          voronoiMap->GetRequestedRegion().GetNumberOfPixels(), false);
+    }
+    else
+      this->AllocateImage(voronoiMap.GetPointer(), m_VoronoiMapBuffer);
+
+    if (shrink)
+    {
+      m_WorkingVoronoiMap = LabelImageType::New();
+      m_WorkingVoronoiMap->SetRegions(workingRegion);
+      m_WorkingVoronoiMap->SetSpacing(workingSpacing);
+      m_WorkingVoronoiMap->SetOrigin(workingOrigin);
+      this->AllocateImage(m_WorkingVoronoiMap.GetPointer(), m_WorkingVoronoiMapBuffer);
+    }
+    else
+      m_WorkingVoronoiMap = voronoiMap;
+  }
+
+  // With seeds or bricks, the first iteration only computes these scanlines
+  if (this->HasSparseInput())
+    this->ComputeSeedLines(workingRegion);
+
+  if (m_NumaAware)
+  {
+    // The memory of the working images is placed on the node of the thread
+    // that touches it first. Give each thread the scanlines it starts with
+    // in the first iteration.
+    this->GetMultiThreader()->SetNumberOfThreads(this->GetUpdateNumberOfThreads());
+    const unsigned int numberOfThreads = this->GetMultiThreader()->GetNumberOfThreads();
 
+    LinesThreadStruct str;
+    str.Filter = this;
+    str.Dimension = 0;
+    str.NumberOfLines = this->GetNumberOfLines(0);
+    str.LinesPerTile = this->ComputeLinesPerTile(str.NumberOfLines, numberOfThreads);
+    str.Queues = 0;
+
+    this->GetMultiThreader()->SetSingleMethod(&Self::InitializeThreaderCallback, &str);
+    this->GetMultiThreader()->SingleMethodExecute();
+  }
+
+  if (m_UseSeeds)
+  {
+    this->PrepareSeeds();
+    return;
+  }
+
+  if (m_SparseFunction)
+  {
+    this->PrepareBricks();
+    return;
+  }
+
+  if (m_NumaAware)
+    return;
+
+  // Copy the function image into the distance image
   ImageRegionConstIterator<FunctionImageType> 
-    functionIt(functionImage, distance->GetRequestedRegion());
+    functionIt(functionImage, workingRegion);
   ImageRegionIterator<DistanceImageType>
-    distanceIt(distance, distance->GetRequestedRegion());
+    distanceIt(m_WorkingDistance, workingRegion);
 
   functionIt.GoToBegin();
   distanceIt.GoToBegin();
   while(!distanceIt.IsAtEnd())
   {
-    distanceIt.Set(static_cast<typename DistanceImageType::PixelType>(functionIt.Get()));
-
+    distanceIt.Set(FunctionToDistance(functionIt.Get()));
     ++functionIt;
     ++distanceIt;
   }
@@ -154,14 +543,10 @@ GeneralizedDistanceTransformImageFilter< TFunctionImage, TDistanceImage, TLabelI
     LabelImagePointer labelImage  =
       dynamic_cast<LabelImageType *>(ProcessObject::GetInput(1));
 
-    LabelImagePointer voronoiMap = this->GetVoronoiMap();
-    voronoiMap->SetBufferedRegion(voronoiMap->GetRequestedRegion());
-    voronoiMap->Allocate();
-
     ImageRegionConstIterator<LabelImageType> 
-      labelIt(labelImage, distance->GetRequestedRegion());
+      labelIt(labelImage, workingRegion);
     ImageRegionIterator<LabelImageType>
-      voronoiIt(voronoiMap, distance->GetRequestedRegion());
+      voronoiIt(m_WorkingVoronoiMap, workingRegion);
 
     labelIt.GoToBegin();
     voronoiIt.GoToBegin();
@@ -174,142 +559,1386 @@ GeneralizedDistanceTransformImageFilter< TFunctionImage, TDistanceImage, TLabelI
   }
 }
 
-
 /**
- *  Compute Distance and Voronoi maps
- *  \todo Support progress methods/callbacks.
+ * Allocate an image, with huge pages or a kept buffer if requested
  */
-template < class TFunctionImage,class TDistanceImage, class TLabelImage, unsigned char MinimalSpacingPrecision >
-template <bool UseSpacing, bool CreateVoronoiMap >
-void 
-GeneralizedDistanceTransformImageFilter< TFunctionImage, TDistanceImage, TLabelImage, MinimalSpacingPrecision >
-::TemplateGenerateData() 
+template < class TFunctionImage,class TDistanceImage, class TLabelImage, unsigned char MinimalSpacingPrecision, class TAccumulator >
+template < class TImage >
+void
+GeneralizedDistanceTransformImageFilter< TFunctionImage, TDistanceImage, TLabelImage, MinimalSpacingPrecision, TAccumulator >
+::AllocateImage(TImage *image, typename TImage::PixelContainerPointer &keptBuffer)
 {
-  this->PrepareData();
+  const unsigned long numberOfPixels = image->GetBufferedRegion().GetNumberOfPixels();
 
-  // We need the size and probably the spacing of the images.
-  DistanceImagePointer distance = this->GetDistance();
-  typename DistanceImageType::SpacingType spacing = distance->GetSpacing();
-  typename DistanceImageType::SizeType size = distance->GetRequestedRegion().GetSize();
+  if (m_ReuseBuffers && keptBuffer)
+  {
+    // The kept buffer may still be attached to the image, but to nothing
+    // else
+    const int references =
+      image->GetPixelContainer() == keptBuffer.GetPointer() ? 2 : 1;
+    if (keptBuffer->GetReferenceCount() == references &&
+        keptBuffer->Size() == numberOfPixels)
+    {
+      image->SetPixelContainer(keptBuffer);
+      return;
+    }
+  }
 
-  typedef itk::LowerEnvelopeOfParabolas<UseSpacing, TSpacingType, MinimalSpacingPrecision,
-          CreateVoronoiMap, typename TLabelImage::PixelType,
-          typename TFunctionImage::IndexValueType,
-          typename TFunctionImage::PixelType> LEOP;
+  if (m_UseHugePages)
+  {
+    typedef HugePageImageContainer<typename TImage::PixelContainer::ElementIdentifier,
+            typename TImage::PixelType> ContainerType;
+    typename ContainerType::Pointer container = ContainerType::New();
+    container->AllocateHugePages(numberOfPixels);
+    image->SetPixelContainer(container);
+  }
+  else
+  {
+    // Don't grow a kept buffer that is still attached
+    if (m_ReuseBuffers)
+      image->SetPixelContainer(TImage::PixelContainer::New());
+    image->Allocate();
+  }
 
-  // The distance image has been initialized to contain the function values
-  // f(x) at x = (x1 x2 ... xN).
-  // It is transformed into the lower envelope of spherical paraboloids rooted
-  // at (x1 x2 ... xN f(x)) by iteration over the dimensions of the image.
-  // Information on the region covered by a paraboloid is provided optionally
-  // by copying the label at x.
-  //
-  // The iterations visit each scanline in each dimension
-  //
-  // \todo Row-major image layouts can cause a lot of cache misses for each
-  //       iteration but the first. Blocked image layouts might be of
-  //       advantage in that case.
+  if (m_ReuseBuffers)
+    keptBuffer = image->GetPixelContainer();
+}
 
-  typedef itk::ImageLinearIteratorWithIndex<DistanceImageType> DIt;
-  DIt distanceIt(distance, distance->GetRequestedRegion());
+/**
+ * Initialize some scanlines of the working images. Helper function for
+ * PrepareData()
+ */
+template < class TFunctionImage,class TDistanceImage, class TLabelImage, unsigned char MinimalSpacingPrecision, class TAccumulator >
+void
+GeneralizedDistanceTransformImageFilter< TFunctionImage, TDistanceImage, TLabelImage, MinimalSpacingPrecision, TAccumulator >
+::ThreadedInitializeRows(unsigned long firstRow, unsigned long endRow)
+{
+  const RegionType &workingRegion = m_WorkingDistance->GetBufferedRegion();
 
-  // We create an iterator for the voronoi map to make the
-  // following loop compileable. It won't be used, if voronoi maps are
-  // disabled and should be optimized away.
-  //
-  // A cleaner solution would be specializations of GenerateData() on
-  // CreateVoronoiMap and UseSpacing.
-  typedef itk::ImageLinearIteratorWithIndex<LabelImageType> LIt;
-  LIt voronoiMapIt;
-  if (CreateVoronoiMap)
+  FunctionImageConstPointer functionImage;
+  LabelImagePointer labelImage;
+  if (!this->HasSparseInput())
   {
-    LabelImagePointer voronoiMap = 
-      dynamic_cast<LabelImageType *>(this->ProcessObject::GetOutput(1));
-    voronoiMapIt = LIt(voronoiMap, voronoiMap->GetRequestedRegion());
+    functionImage = dynamic_cast<FunctionImageType *>(ProcessObject::GetInput(0));
+    if (m_CreateVoronoiMap)
+      labelImage = dynamic_cast<LabelImageType *>(ProcessObject::GetInput(1));
   }
 
-  // set up the progress reporter
-  ProgressReporter progress(this, 0, distance->GetRequestedRegion().GetNumberOfPixels() * FunctionImageType::ImageDimension);
-
-  // Loop over all dimensions and compute the generalized distance transform
-  // and voronoi map for each scanline.
-  //
-  // \todo The scanlines are be handled independently and thus are a good
-  // opportunity for parallelization/threading.
-  //
-  // \todo non-local memory access for dimensions >= 1 can lead to ineffective
-  // use of the cache. Another layout could improve performance.
-
-  for (unsigned int d = 0; d < FunctionImageType::ImageDimension; ++d)
+  for (unsigned long row = firstRow; row < endRow; ++row)
   {
-    distanceIt.SetDirection(d);
-    distanceIt.GoToBegin();
+    // The scanlines are numbered like in GetLineStartIndex()
+    IndexType index = workingRegion.GetIndex();
+    SizeType size = workingRegion.GetSize();
+    unsigned long remainder = row;
+    for (unsigned int i = 1; i < FunctionImageType::ImageDimension; ++i)
+    {
+      index[i] += remainder % size[i];
+      remainder /= size[i];
+      size[i] = 1;
+    }
+    const RegionType rowRegion(index, size);
 
-    if (CreateVoronoiMap)
+    ImageRegionIterator<DistanceImageType> distanceIt(m_WorkingDistance, rowRegion);
+    if (this->HasSparseInput())
     {
-      voronoiMapIt.SetDirection(d);
-      voronoiMapIt.GoToBegin();
+      // Everything but the seeds or bricks is background
+      for (distanceIt.GoToBegin(); !distanceIt.IsAtEnd(); ++distanceIt)
+        distanceIt.Set(GetMaximumApexHeight());
+    }
+    else
+    {
+      ImageRegionConstIterator<FunctionImageType> functionIt(functionImage, rowRegion);
+      for (functionIt.GoToBegin(), distanceIt.GoToBegin(); !distanceIt.IsAtEnd();
+          ++functionIt, ++distanceIt)
+        distanceIt.Set(FunctionToDistance(functionIt.Get()));
     }
 
-    while (!distanceIt.IsAtEnd())
+    if (m_CreateVoronoiMap)
     {
-      // Compute the generalized distance transform for the current scanline
+      ImageRegionIterator<LabelImageType> voronoiIt(m_WorkingVoronoiMap, rowRegion);
+      if (this->HasSparseInput())
+      {
+        for (voronoiIt.GoToBegin(); !voronoiIt.IsAtEnd(); ++voronoiIt)
+          voronoiIt.Set(m_BackgroundLabel);
+      }
+      else
+      {
+        ImageRegionConstIterator<LabelImageType> labelIt(labelImage, rowRegion);
+        for (labelIt.GoToBegin(), voronoiIt.GoToBegin(); !voronoiIt.IsAtEnd();
+            ++labelIt, ++voronoiIt)
+          voronoiIt.Set(labelIt.Get());
+      }
+    }
+  }
+}
 
-      // First compute the lower envelope of parabolas
-      // The spacing is ignored by LEOP if UseSpacing == false. We provide a
-      // dummy value of 1 anyway.
-      LEOP envelope(size[d], UseSpacing ? static_cast<TSpacingType>(spacing[d]) : 1);
+/**
+ * Initialize the scanlines of the first iteration on the threads that will
+ * compute them
+ */
+template < class TFunctionImage,class TDistanceImage, class TLabelImage, unsigned char MinimalSpacingPrecision, class TAccumulator >
+ITK_THREAD_RETURN_TYPE
+GeneralizedDistanceTransformImageFilter< TFunctionImage, TDistanceImage, TLabelImage, MinimalSpacingPrecision, TAccumulator >
+::InitializeThreaderCallback(void *arg)
+{
+  MultiThreader::ThreadInfoStruct *info =
+    static_cast<MultiThreader::ThreadInfoStruct *>(arg);
+  LinesThreadStruct *str = static_cast<LinesThreadStruct *>(info->UserData);
+  Self *filter = str->Filter;
 
-      while (!distanceIt.IsAtEndOfLine())
-      {
-        typename LEOP::AbscissaIndexType i = distanceIt.GetIndex()[d];
+  const unsigned int threadId = info->ThreadID;
+  const unsigned int threadCount = info->NumberOfThreads;
 
-        if (CreateVoronoiMap)
-        {
-          envelope.addParabola(i, distanceIt.Value(), voronoiMapIt.Value());
-          ++voronoiMapIt;
-          ++distanceIt;
-          progress.CompletedPixel();
-        }
-        else
-        {
-          envelope.addParabola(i, distanceIt.Value());
-          ++distanceIt;
-          progress.CompletedPixel();
-        }
-      }
+  const NumaTopology &topology = filter->m_NumaTopology;
+  NumaTopology::ScopedPin pin(topology, topology.GetNodeOfThread(threadId, threadCount));
 
-      // And now evaluate the lower envelope for the whole scanline
-      distanceIt.GoToBeginOfLine();
-      if (CreateVoronoiMap)
-        voronoiMapIt.GoToBeginOfLine();
+  // The same tiles as the initial queues in TemplateGenerateData()
+  const unsigned long numberOfTiles =
+    (str->NumberOfLines + str->LinesPerTile - 1) / str->LinesPerTile;
+  unsigned long firstRow = std::min(str->NumberOfLines,
+      numberOfTiles * threadId / threadCount * str->LinesPerTile);
+  unsigned long endRow = std::min(str->NumberOfLines,
+      numberOfTiles * (threadId + 1) / threadCount * str->LinesPerTile);
 
-      if (CreateVoronoiMap)
-      {
-        envelope.uniformSample(distanceIt.GetIndex()[d], size[d], distanceIt, voronoiMapIt);
-        voronoiMapIt.NextLine();
-        distanceIt.NextLine();
-      }
-      else
+  // With seeds or bricks, the tiles hold the scanlines of m_SeedLines. The
+  // thread also initializes the rows without seeds up to the first
+  // scanline of the next thread, the last thread up to the end, and the
+  // first thread the rows before all the scanlines.
+  const RegionType &workingRegion = filter->m_WorkingDistance->GetBufferedRegion();
+  const unsigned long numberOfRows = workingRegion.GetNumberOfPixels() / workingRegion.GetSize()[0];
+  if (filter->HasSparseInput())
+  {
+    const std::vector<unsigned long> &seedLines = filter->m_SeedLines;
+    firstRow = firstRow < seedLines.size() ? seedLines[firstRow] : numberOfRows;
+    endRow = endRow < seedLines.size() ? seedLines[endRow] : numberOfRows;
+  }
+  if (threadId == 0)
+    firstRow = 0;
+  filter->ThreadedInitializeRows(firstRow, endRow);
+
+  return ITK_THREAD_RETURN_VALUE;
+}
+
+/**
+ * Collect the scanlines of the first iteration. Helper function for
+ * PrepareData()
+ */
+template < class TFunctionImage,class TDistanceImage, class TLabelImage, unsigned char MinimalSpacingPrecision, class TAccumulator >
+void
+GeneralizedDistanceTransformImageFilter< TFunctionImage, TDistanceImage, TLabelImage, MinimalSpacingPrecision, TAccumulator >
+::ComputeSeedLines(const RegionType &workingRegion)
+{
+  m_SeedLines.clear();
+  if (m_UseSeeds)
+  {
+    m_SeedLines.reserve(m_Seeds.size());
+    for (typename SeedContainerType::const_iterator seed = m_Seeds.begin();
+        seed != m_Seeds.end(); ++seed)
+    {
+      if (!workingRegion.IsInside(seed->Index))
+        itkExceptionMacro(<< "Seed " << seed->Index << " is outside of the output region "
+            << workingRegion);
+
+      // The number of the scanline in direction 0, see GetLineStartIndex()
+      unsigned long line = 0;
+      for (int i = FunctionImageType::ImageDimension - 1; i > 0; --i)
+        line = line * workingRegion.GetSize()[i] +
+          (seed->Index[i] - workingRegion.GetIndex()[i]);
+      m_SeedLines.push_back(line);
+    }
+  }
+  else
+  {
+    typedef typename FunctionBrickImageType::BrickContainerType BrickContainerType;
+    const BrickContainerType &bricks = m_SparseFunction->GetBricks();
+    for (typename BrickContainerType::const_iterator brick = bricks.begin();
+        brick != bricks.end(); ++brick)
+    {
+      const RegionType brickRegion = m_SparseFunction->GetBrickRegion(brick->first);
+
+      // The scanlines in direction 0 through the brick, numbered like in
+      // GetLineStartIndex()
+      unsigned long numberOfRows = 1;
+      for (unsigned int i = 1; i < FunctionImageType::ImageDimension; ++i)
+        numberOfRows *= brickRegion.GetSize()[i];
+      for (unsigned long row = 0; row < numberOfRows; ++row)
       {
-        envelope.uniformSample(distanceIt.GetIndex()[d], size[d], distanceIt);
-        distanceIt.NextLine();
+        IndexType index = brickRegion.GetIndex();
+        unsigned long remainder = row;
+        for (unsigned int i = 1; i < FunctionImageType::ImageDimension; ++i)
+        {
+          index[i] += remainder % brickRegion.GetSize()[i];
+          remainder /= brickRegion.GetSize()[i];
+        }
+
+        unsigned long line = 0;
+        for (int i = FunctionImageType::ImageDimension - 1; i > 0; --i)
+          line = line * workingRegion.GetSize()[i] +
+            (index[i] - workingRegion.GetIndex()[i]);
+        m_SeedLines.push_back(line);
       }
     }
   }
+
+  // The scanlines are computed in memory order and only once. Bricks that
+  // are neighbors along dimension 0 share their scanlines.
+  std::sort(m_SeedLines.begin(), m_SeedLines.end());
+  m_SeedLines.erase(std::unique(m_SeedLines.begin(), m_SeedLines.end()),
+      m_SeedLines.end());
 }
 
+/**
+ * Initialize the working images from the seeds. Helper function for
+ * PrepareData()
+ */
+template < class TFunctionImage,class TDistanceImage, class TLabelImage, unsigned char MinimalSpacingPrecision, class TAccumulator >
+void
+GeneralizedDistanceTransformImageFilter< TFunctionImage, TDistanceImage, TLabelImage, MinimalSpacingPrecision, TAccumulator >
+::PrepareSeeds()
+{
+  // Everything but the seeds is background. The threads have done that
+  // already if NumaAware is on.
+  if (!m_NumaAware)
+  {
+    m_WorkingDistance->FillBuffer(GetMaximumApexHeight());
+    if (m_CreateVoronoiMap)
+      m_WorkingVoronoiMap->FillBuffer(m_BackgroundLabel);
+  }
+
+  // The seeds are inside of the working region, see ComputeSeedLines()
+  const double maximumApexHeight = static_cast<double>(GetMaximumApexHeight());
+  for (typename SeedContainerType::const_iterator seed = m_Seeds.begin();
+      seed != m_Seeds.end(); ++seed)
+  {
+    // Of several seeds at the same index, the lowest one is used
+    if (static_cast<double>(seed->Height) < maximumApexHeight &&
+        seed->Height < m_WorkingDistance->GetPixel(seed->Index))
+    {
+      m_WorkingDistance->SetPixel(seed->Index, seed->Height);
+      if (m_CreateVoronoiMap)
+        m_WorkingVoronoiMap->SetPixel(seed->Index, seed->Label);
+    }
+  }
+}
 
 /**
- * Dispatch the execution to the correct specialized TemplateGenerateData()
- * method
+ * Initialize the working images from the bricks. Helper function for
+ * PrepareData()
  */
-template < class TFunctionImage,class TDistanceImage, class TLabelImage, unsigned char MinimalSpacingPrecision >
-void 
-GeneralizedDistanceTransformImageFilter< TFunctionImage, TDistanceImage, TLabelImage, MinimalSpacingPrecision >
-::GenerateData() 
+template < class TFunctionImage,class TDistanceImage, class TLabelImage, unsigned char MinimalSpacingPrecision, class TAccumulator >
+void
+GeneralizedDistanceTransformImageFilter< TFunctionImage, TDistanceImage, TLabelImage, MinimalSpacingPrecision, TAccumulator >
+::PrepareBricks()
 {
-  
+  const bool useLabels = m_CreateVoronoiMap && m_SparseLabels;
+  if (useLabels && (m_SparseLabels->GetRegion() != m_SparseFunction->GetRegion() ||
+        m_SparseLabels->GetBrickSize() != m_SparseFunction->GetBrickSize()))
+    itkExceptionMacro(<< "The label bricks don't have the geometry of the function bricks");
+
+  // The voxels outside of the bricks are background. The threads have done
+  // that already if NumaAware is on.
+  if (!m_NumaAware)
+  {
+    m_WorkingDistance->FillBuffer(GetMaximumApexHeight());
+    if (m_CreateVoronoiMap)
+      m_WorkingVoronoiMap->FillBuffer(m_BackgroundLabel);
+  }
+
+  typedef typename FunctionBrickImageType::BrickContainerType BrickContainerType;
+  const BrickContainerType &bricks = m_SparseFunction->GetBricks();
+  for (typename BrickContainerType::const_iterator brick = bricks.begin();
+      brick != bricks.end(); ++brick)
+  {
+    const RegionType brickRegion = m_SparseFunction->GetBrickRegion(brick->first);
+
+    // The voxels of a brick are in the order of the region iterators
+    typename FunctionBrickImageType::BrickType::const_iterator function =
+      brick->second.begin();
+    ImageRegionIterator<DistanceImageType> distanceIt(m_WorkingDistance, brickRegion);
+    for (distanceIt.GoToBegin(); !distanceIt.IsAtEnd(); ++distanceIt, ++function)
+      distanceIt.Set(FunctionToDistance(*function));
+
+    if (useLabels)
+    {
+      const typename LabelBrickImageType::BrickType *labels =
+        m_SparseLabels->GetBrick(brick->first);
+      if (labels)
+      {
+        typename LabelBrickImageType::BrickType::const_iterator label = labels->begin();
+        ImageRegionIterator<LabelImageType> voronoiIt(m_WorkingVoronoiMap, brickRegion);
+        for (voronoiIt.GoToBegin(); !voronoiIt.IsAtEnd(); ++voronoiIt, ++label)
+          voronoiIt.Set(*label);
+      }
+    }
+  }
+}
+
+/**
+ * Concatenate the runs of the tiles in the order of the scanlines
+ */
+template < class TFunctionImage,class TDistanceImage, class TLabelImage, unsigned char MinimalSpacingPrecision, class TAccumulator >
+void
+GeneralizedDistanceTransformImageFilter< TFunctionImage, TDistanceImage, TLabelImage, MinimalSpacingPrecision, TAccumulator >
+::GatherVoronoiRuns(unsigned long numberOfLines)
+{
+  // The counts of the scanlines become their first runs
+  for (unsigned long line = 0; line < numberOfLines; ++line)
+    m_VoronoiRunLineStarts[line + 1] += m_VoronoiRunLineStarts[line];
+
+  m_VoronoiRuns.clear();
+  m_VoronoiRuns.reserve(m_VoronoiRunLineStarts[numberOfLines]);
+  for (unsigned long tile = 0; tile < m_TileVoronoiRuns.size(); ++tile)
+  {
+    m_VoronoiRuns.insert(m_VoronoiRuns.end(),
+        m_TileVoronoiRuns[tile].begin(), m_TileVoronoiRuns[tile].end());
+    VoronoiRunContainerType().swap(m_TileVoronoiRuns[tile]);
+  }
+  m_TileVoronoiRuns.clear();
+
+  m_VoronoiRunRegion = this->GetDistance()->GetRequestedRegion();
+
+  // With seeds or bricks, only some of the scanlines in direction 0 have
+  // been computed. The others are a single run of background.
+  if (m_VoronoiRunDirection != 0 || !this->HasSparseInput())
+    return;
+
+  const long start = m_VoronoiRunRegion.GetIndex()[0];
+  const unsigned long length = m_VoronoiRunRegion.GetSize()[0];
+  const unsigned long allLines = m_VoronoiRunRegion.GetNumberOfPixels() / length;
+
+  VoronoiRunType background;
+  background.Start = start;
+  background.Length = length;
+  background.Label = m_BackgroundLabel;
+
+  VoronoiRunContainerType runs;
+  std::vector<unsigned long> lineStarts(1, 0);
+  lineStarts.reserve(allLines + 1);
+  unsigned long computed = 0;
+  for (unsigned long line = 0; line < allLines; ++line)
+  {
+    if (computed < numberOfLines && m_SeedLines[computed] == line)
+    {
+      runs.insert(runs.end(), m_VoronoiRuns.begin() + m_VoronoiRunLineStarts[computed],
+          m_VoronoiRuns.begin() + m_VoronoiRunLineStarts[computed + 1]);
+      ++computed;
+    }
+    else
+      runs.push_back(background);
+    lineStarts.push_back(runs.size());
+  }
+  m_VoronoiRuns.swap(runs);
+  m_VoronoiRunLineStarts.swap(lineStarts);
+}
+
+/**
+ * Merge the partial statistics of the threads
+ */
+template < class TFunctionImage,class TDistanceImage, class TLabelImage, unsigned char MinimalSpacingPrecision, class TAccumulator >
+void
+GeneralizedDistanceTransformImageFilter< TFunctionImage, TDistanceImage, TLabelImage, MinimalSpacingPrecision, TAccumulator >
+::MergeStatistics()
+{
+  double sum = 0.0;
+  m_NumberOfMeasuredPixels = 0;
+  m_MaximumDistance = DistancePixelType();
+  m_DistanceHistogram.assign(m_ThreadStatistics.front().Histogram.size(), 0);
+  m_LabelStatistics.clear();
+  for (unsigned int t = 0; t < m_ThreadStatistics.size(); ++t)
+  {
+    const ThreadStatisticsType &statistics = m_ThreadStatistics[t];
+    if (statistics.Count == 0)
+      continue;
+    if (m_NumberOfMeasuredPixels == 0 || m_MaximumDistance < statistics.Maximum)
+      m_MaximumDistance = statistics.Maximum;
+    m_NumberOfMeasuredPixels += statistics.Count;
+    sum += statistics.Sum;
+    for (unsigned long bin = 0; bin < m_DistanceHistogram.size(); ++bin)
+      m_DistanceHistogram[bin] += statistics.Histogram[bin];
+
+    for (typename LabelStatisticsContainerType::const_iterator it = statistics.Labels.begin();
+        it != statistics.Labels.end(); ++it)
+    {
+      typename LabelStatisticsContainerType::iterator labelStatistics =
+        m_LabelStatistics.find(it->first);
+      if (labelStatistics == m_LabelStatistics.end())
+      {
+        m_LabelStatistics.insert(*it);
+        continue;
+      }
+      labelStatistics->second.Count += it->second.Count;
+      labelStatistics->second.Sum += it->second.Sum;
+      if (labelStatistics->second.Maximum < it->second.Maximum)
+        labelStatistics->second.Maximum = it->second.Maximum;
+    }
+  }
+  m_MeanDistance = m_NumberOfMeasuredPixels > 0 ? sum / m_NumberOfMeasuredPixels : 0.0;
+
+  std::vector<ThreadStatisticsType>().swap(m_ThreadStatistics);
+}
+
+/**
+ * Output index of the first sample of a scanline of the runs
+ */
+template < class TFunctionImage,class TDistanceImage, class TLabelImage, unsigned char MinimalSpacingPrecision, class TAccumulator >
+typename
+GeneralizedDistanceTransformImageFilter< TFunctionImage, TDistanceImage, TLabelImage, MinimalSpacingPrecision, TAccumulator >
+::IndexType
+GeneralizedDistanceTransformImageFilter< TFunctionImage, TDistanceImage, TLabelImage, MinimalSpacingPrecision, TAccumulator >
+::GetVoronoiRunLineIndex(unsigned long line) const
+{
+  IndexType index = m_VoronoiRunRegion.GetIndex();
+  for (unsigned int i = 0; i < FunctionImageType::ImageDimension; ++i)
+  {
+    if (i == m_VoronoiRunDirection)
+      continue;
+    index[i] += line % m_VoronoiRunRegion.GetSize()[i];
+    line /= m_VoronoiRunRegion.GetSize()[i];
+  }
+  return index;
+}
+
+/**
+ * Copy the output bricks within the narrow band
+ */
+template < class TFunctionImage,class TDistanceImage, class TLabelImage, unsigned char MinimalSpacingPrecision, class TAccumulator >
+void
+GeneralizedDistanceTransformImageFilter< TFunctionImage, TDistanceImage, TLabelImage, MinimalSpacingPrecision, TAccumulator >
+::GenerateSparseOutputs()
+{
+  DistanceImagePointer distance = this->GetDistance();
+  const RegionType &region = distance->GetRequestedRegion();
+
+  m_SparseDistance->RemoveAllBricks();
+  m_SparseDistance->SetRegion(region);
+  m_SparseDistance->SetBrickSize(m_OutputBrickSize);
+  m_SparseDistance->SetSpacing(distance->GetSpacing());
+  m_SparseDistance->SetOrigin(distance->GetOrigin());
+  m_SparseDistance->SetBackgroundValue(GetMaximumApexHeight());
+
+  m_SparseVoronoiMap->RemoveAllBricks();
+  if (m_CreateVoronoiMap)
+  {
+    m_SparseVoronoiMap->SetRegion(region);
+    m_SparseVoronoiMap->SetBrickSize(m_OutputBrickSize);
+    m_SparseVoronoiMap->SetSpacing(distance->GetSpacing());
+    m_SparseVoronoiMap->SetOrigin(distance->GetOrigin());
+    m_SparseVoronoiMap->SetBackgroundValue(m_BackgroundLabel);
+  }
+
+  const unsigned long numberOfBricks = m_SparseDistance->GetNumberOfBricks();
+  for (unsigned long brick = 0; brick < numberOfBricks; ++brick)
+  {
+    const RegionType brickRegion = m_SparseDistance->GetBrickRegion(brick);
+
+    ImageRegionConstIterator<DistanceImageType> distanceIt(distance, brickRegion);
+    bool inBand = false;
+    for (distanceIt.GoToBegin(); !distanceIt.IsAtEnd() && !inBand; ++distanceIt)
+      inBand = distanceIt.Get() <= m_NarrowBand && distanceIt.Get() < GetMaximumApexHeight();
+    if (!inBand)
+      continue;
+
+    typename DistanceBrickImageType::BrickType &distances =
+      m_SparseDistance->AllocateBrick(brick);
+    typename DistanceBrickImageType::BrickType::iterator distancePixel = distances.begin();
+    for (distanceIt.GoToBegin(); !distanceIt.IsAtEnd(); ++distanceIt, ++distancePixel)
+      *distancePixel = distanceIt.Get();
+
+    if (m_CreateVoronoiMap)
+    {
+      typename LabelBrickImageType::BrickType &labels =
+        m_SparseVoronoiMap->AllocateBrick(brick);
+      typename LabelBrickImageType::BrickType::iterator label = labels.begin();
+      ImageRegionConstIterator<LabelImageType> voronoiIt(this->GetVoronoiMap(), brickRegion);
+      for (voronoiIt.GoToBegin(); !voronoiIt.IsAtEnd(); ++voronoiIt, ++label)
+        *label = voronoiIt.Get();
+    }
+  }
+}
+
+/**
+ * Copy the samples that are kept into the shrunk outputs
+ */
+template < class TFunctionImage,class TDistanceImage, class TLabelImage, unsigned char MinimalSpacingPrecision, class TAccumulator >
+void
+GeneralizedDistanceTransformImageFilter< TFunctionImage, TDistanceImage, TLabelImage, MinimalSpacingPrecision, TAccumulator >
+::GatherShrunkOutputs()
+{
+  DistanceImagePointer distance = this->GetDistance();
+  ImageRegionIteratorWithIndex<DistanceImageType>
+    distanceIt(distance, distance->GetRequestedRegion());
+
+  for (distanceIt.GoToBegin(); !distanceIt.IsAtEnd(); ++distanceIt)
+  {
+    IndexType index = distanceIt.GetIndex();
+    for (unsigned int d = 0; d < FunctionImageType::ImageDimension; ++d)
+      index[d] *= m_ShrinkFactors[d];
+    distanceIt.Set(m_WorkingDistance->GetPixel(index));
+  }
+
+  // Without the dense voronoi map of the last iteration, there is nothing
+  // to copy
+  if (m_CreateVoronoiMap && (m_VoronoiRunLineStarts.empty() || m_WriteDenseVoronoiMap))
+  {
+    LabelImagePointer voronoiMap = this->GetVoronoiMap();
+    ImageRegionIteratorWithIndex<LabelImageType>
+      voronoiIt(voronoiMap, voronoiMap->GetRequestedRegion());
+
+    for (voronoiIt.GoToBegin(); !voronoiIt.IsAtEnd(); ++voronoiIt)
+    {
+      IndexType index = voronoiIt.GetIndex();
+      for (unsigned int d = 0; d < FunctionImageType::ImageDimension; ++d)
+        index[d] *= m_ShrinkFactors[d];
+      voronoiIt.Set(m_WorkingVoronoiMap->GetPixel(index));
+    }
+  }
+}
+
+
+/**
+ *  Compute Distance and Voronoi maps
+ */
+template < class TFunctionImage,class TDistanceImage, class TLabelImage, unsigned char MinimalSpacingPrecision, class TAccumulator >
+template <bool UseSpacing, bool CreateVoronoiMap >
+void 
+GeneralizedDistanceTransformImageFilter< TFunctionImage, TDistanceImage, TLabelImage, MinimalSpacingPrecision, TAccumulator >
+::TemplateGenerateData() 
+{
+  // The runs and the statistics are recorded by the last iteration
+  int lastDimension = -1;
+  for (unsigned int d = 0; d < FunctionImageType::ImageDimension; ++d)
+    if (m_ProcessedDimensions[d])
+      lastDimension = d;
+  const bool createRuns = CreateVoronoiMap && m_CreateRunLengthVoronoiMap && lastDimension >= 0;
+  const bool computeStatistics = m_ComputeStatistics && lastDimension >= 0;
+
+  m_VoronoiRuns.clear();
+  m_VoronoiRunLineStarts.clear();
+  m_NumberOfMeasuredPixels = 0;
+  m_MaximumDistance = DistancePixelType();
+  m_MeanDistance = 0.0;
+  m_DistanceHistogram.clear();
+  m_LabelStatistics.clear();
+  if (createRuns || computeStatistics)
+  {
+    // The scanlines of the runs are numbered in output indices, and the
+    // statistics count the output samples only. The dimensions after the
+    // last processed one are not sampled.
+    for (unsigned int d = lastDimension + 1; d < FunctionImageType::ImageDimension; ++d)
+      if (m_ShrinkFactors[d] > 1)
+        itkExceptionMacro(<< "Run-length voronoi maps and statistics need a shrink factor of 1 in dimension "
+            << d << ", which is not processed");
+  }
+
+  this->PrepareData();
+
+  // The distance image has been initialized to contain the function values
+  // f(x) at x = (x1 x2 ... xN).
+  // It is transformed into the lower envelope of spherical paraboloids rooted
+  // at (x1 x2 ... xN f(x)) by iteration over the dimensions of the image.
+  // Information on the region covered by a paraboloid is provided optionally
+  // by copying the label at x.
+  //
+  // The iterations visit each scanline in each dimension. The scanlines of
+  // one dimension are independent of each other and are distributed over the
+  // threads in tiles. The next dimension is started when all threads are
+  // done.
+  //
+  // \todo Row-major image layouts can cause a lot of cache misses for each
+  //       iteration but the first. Blocked image layouts might be of
+  //       advantage in that case.
+  this->GetMultiThreader()->SetNumberOfThreads(this->GetUpdateNumberOfThreads());
+  const unsigned int numberOfThreads = this->GetMultiThreader()->GetNumberOfThreads();
+
+  LinesThreadStruct str;
+  str.Filter = this;
+  str.Queues = new TileQueue[numberOfThreads];
+
+  this->GetMultiThreader()->SetSingleMethod(
+      &Self::template LinesThreaderCallback<UseSpacing, CreateVoronoiMap>, &str);
+
+  // Each thread keeps its statistics and envelopes separately
+  m_ThreadNumberOfSaturatedPixels.assign(numberOfThreads, 0);
+  if (m_ThreadEnvelopes.size() < numberOfThreads * FunctionImageType::ImageDimension)
+    m_ThreadEnvelopes.resize(numberOfThreads * FunctionImageType::ImageDimension, 0);
+  m_ThreadNumberOfStolenTiles.assign(numberOfThreads, 0);
+
+  double busyTime = 0.0;
+  double availableTime = 0.0;
+  for (unsigned int d = 0; d < FunctionImageType::ImageDimension; ++d)
+  {
+    if (!m_ProcessedDimensions[d])
+      continue;
+
+    str.Dimension = d;
+    str.NumberOfLines = this->GetNumberOfLines(d);
+    str.LinesPerTile = this->ComputeLinesPerTile(str.NumberOfLines, numberOfThreads);
+
+    // Each thread starts with a contiguous range of tiles, like a static
+    // partition would give it.
+    const unsigned long numberOfTiles =
+      (str.NumberOfLines + str.LinesPerTile - 1) / str.LinesPerTile;
+    for (unsigned int t = 0; t < numberOfThreads; ++t)
+    {
+      str.Queues[t].Begin = numberOfTiles * t / numberOfThreads;
+      str.Queues[t].End = numberOfTiles * (t + 1) / numberOfThreads;
+    }
+
+    m_CollectVoronoiRuns = createRuns && static_cast<int>(d) == lastDimension;
+    if (m_CollectVoronoiRuns)
+    {
+      m_VoronoiRunDirection = d;
+      m_VoronoiRunLinesPerTile = str.LinesPerTile;
+      m_TileVoronoiRuns.assign(numberOfTiles, VoronoiRunContainerType());
+      m_VoronoiRunLineStarts.assign(str.NumberOfLines + 1, 0);
+    }
+
+    m_CollectStatistics = computeStatistics && static_cast<int>(d) == lastDimension;
+    if (m_CollectStatistics)
+    {
+      ThreadStatisticsType empty;
+      empty.Count = 0;
+      empty.Sum = 0.0;
+      empty.Maximum = DistancePixelType();
+      empty.Histogram.assign(std::max(m_NumberOfHistogramBins, 1u), 0);
+      m_ThreadStatistics.assign(numberOfThreads, empty);
+    }
+
+    m_ThreadBusyTime.assign(numberOfThreads, 0.0);
+    str.NumberOfFinishedLines = 0;
+    this->GetMultiThreader()->SingleMethodExecute();
+    this->UpdateProgress(static_cast<float>(d + 1) / FunctionImageType::ImageDimension);
+
+    if (m_CollectVoronoiRuns)
+    {
+      this->GatherVoronoiRuns(str.NumberOfLines);
+      m_CollectVoronoiRuns = false;
+    }
+
+    if (m_CollectStatistics)
+    {
+      this->MergeStatistics();
+      m_CollectStatistics = false;
+    }
+
+    // The threads wait for the busiest one at the end of the iteration
+    const double maximumBusyTime =
+      *std::max_element(m_ThreadBusyTime.begin(), m_ThreadBusyTime.end());
+    for (unsigned int t = 0; t < numberOfThreads; ++t)
+      busyTime += m_ThreadBusyTime[t];
+    availableTime += maximumBusyTime * numberOfThreads;
+  }
+
+  delete [] str.Queues;
+
+  m_LoadBalanceEfficiency = availableTime > 0.0 ? busyTime / availableTime : 1.0;
+
+  m_NumberOfSaturatedPixels = 0;
+  m_NumberOfStolenTiles = 0;
+  for (unsigned int t = 0; t < numberOfThreads; ++t)
+  {
+    m_NumberOfSaturatedPixels += m_ThreadNumberOfSaturatedPixels[t];
+    m_NumberOfStolenTiles += m_ThreadNumberOfStolenTiles[t];
+  }
+
+  if (m_WorkingDistance.GetPointer() != this->GetDistance())
+    this->GatherShrunkOutputs();
+
+  if (m_CreateSparseOutputs)
+    this->GenerateSparseOutputs();
+
+  // Release the working images
+  m_WorkingDistance = 0;
+  m_WorkingVoronoiMap = 0;
+  m_SeedLines.clear();
+}
+
+/**
+ * Compute the tiles of the current direction, stealing from the other
+ * threads when done
+ */
+template < class TFunctionImage,class TDistanceImage, class TLabelImage, unsigned char MinimalSpacingPrecision, class TAccumulator >
+template <bool UseSpacing, bool CreateVoronoiMap >
+ITK_THREAD_RETURN_TYPE
+GeneralizedDistanceTransformImageFilter< TFunctionImage, TDistanceImage, TLabelImage, MinimalSpacingPrecision, TAccumulator >
+::LinesThreaderCallback(void *arg)
+{
+  MultiThreader::ThreadInfoStruct *info =
+    static_cast<MultiThreader::ThreadInfoStruct *>(arg);
+  LinesThreadStruct *str = static_cast<LinesThreadStruct *>(info->UserData);
+  Self *filter = str->Filter;
+
+  const unsigned int threadId = info->ThreadID;
+  const unsigned int threadCount = info->NumberOfThreads;
+
+  // Each of the ImageDimension iterations accounts for the same share of
+  // the progress. A thread can't know how many scanlines it will compute,
+  // so the threads count the finished scanlines together, and thread 0
+  // reports them in steps of 1%.
+  const float progressBase = static_cast<float>(str->Dimension) / FunctionImageType::ImageDimension;
+  const float progressShare = 1.0f / FunctionImageType::ImageDimension;
+  float reportedProgress = 0.0f;
+
+  // Without NumaAware, the node is invalid and the thread is not pinned
+  const NumaTopology &topology = filter->m_NumaTopology;
+  NumaTopology::ScopedPin pin(topology, filter->m_NumaAware ?
+      topology.GetNodeOfThread(threadId, threadCount) : topology.GetNumberOfNodes());
+
+  RealTimeClock::Pointer clock = RealTimeClock::New();
+  double busyTime = 0.0;
+
+  unsigned long tile;
+  for (;;)
+  {
+    if (!PopTile(str->Queues[threadId], tile))
+    {
+      const unsigned long stolen = StealTiles(str, threadId, threadCount);
+      if (stolen == 0)
+        break;
+      filter->m_ThreadNumberOfStolenTiles[threadId] += stolen;
+      continue;
+    }
+
+    const unsigned long firstLine = tile * str->LinesPerTile;
+    const unsigned long numberOfLines =
+      std::min(str->LinesPerTile, str->NumberOfLines - firstLine);
+
+    const RealTimeClock::TimeStampType start = clock->GetTimeStamp();
+    filter->template DispatchGenerateLines<UseSpacing, CreateVoronoiMap>(
+        str->Dimension, firstLine, numberOfLines, threadId);
+    busyTime += clock->GetTimeStamp() - start;
+
+    str->ProgressLock.Lock();
+    str->NumberOfFinishedLines += numberOfLines;
+    const unsigned long finishedLines = str->NumberOfFinishedLines;
+    str->ProgressLock.Unlock();
+
+    const float progress = static_cast<float>(finishedLines) / str->NumberOfLines;
+    if (threadId == 0 && progress - reportedProgress >= 0.01f)
+    {
+      filter->UpdateProgress(progressBase + progress * progressShare);
+      reportedProgress = progress;
+    }
+  }
+
+  filter->m_ThreadBusyTime[threadId] = busyTime;
+
+  return ITK_THREAD_RETURN_VALUE;
+}
+
+/**
+ * Take the first tile of a queue
+ */
+template < class TFunctionImage,class TDistanceImage, class TLabelImage, unsigned char MinimalSpacingPrecision, class TAccumulator >
+bool
+GeneralizedDistanceTransformImageFilter< TFunctionImage, TDistanceImage, TLabelImage, MinimalSpacingPrecision, TAccumulator >
+::PopTile(TileQueue &queue, unsigned long &tile)
+{
+  queue.Lock.Lock();
+  const bool found = queue.Begin < queue.End;
+  if (found)
+    tile = queue.Begin++;
+  queue.Lock.Unlock();
+  return found;
+}
+
+/**
+ * Move half of the tiles of another thread into the queue of thief
+ */
+template < class TFunctionImage,class TDistanceImage, class TLabelImage, unsigned char MinimalSpacingPrecision, class TAccumulator >
+unsigned long
+GeneralizedDistanceTransformImageFilter< TFunctionImage, TDistanceImage, TLabelImage, MinimalSpacingPrecision, TAccumulator >
+::StealTiles(LinesThreadStruct *str, unsigned int thief, unsigned int numberOfThreads)
+{
+  // Try the other threads round robin, starting with the next one. With
+  // NumaAware, the threads on the node of the thief are tried first, because
+  // their scanlines are in local memory in the first iteration.
+  const Self *filter = str->Filter;
+  const NumaTopology &topology = filter->m_NumaTopology;
+  const unsigned int node = topology.GetNodeOfThread(thief, numberOfThreads);
+  for (unsigned int round = 0; round < 2; ++round)
+  {
+    for (unsigned int i = 1; i < numberOfThreads; ++i)
+    {
+      const unsigned int victimId = (thief + i) % numberOfThreads;
+      const bool sameNode = !filter->m_NumaAware ||
+        topology.GetNodeOfThread(victimId, numberOfThreads) == node;
+      if (sameNode != (round == 0))
+        continue;
+
+      TileQueue &victim = str->Queues[victimId];
+
+      victim.Lock.Lock();
+      const unsigned long remaining = victim.End - victim.Begin;
+      const unsigned long end = victim.End;
+      if (remaining > 0)
+        victim.End -= (remaining + 1) / 2;
+      const unsigned long begin = victim.End;
+      victim.Lock.Unlock();
+
+      if (remaining > 0)
+      {
+        // The stolen tiles can be stolen again by others
+        TileQueue &queue = str->Queues[thief];
+        queue.Lock.Lock();
+        queue.Begin = begin;
+        queue.End = end;
+        queue.Lock.Unlock();
+        return end - begin;
+      }
+    }
+  }
+  return 0;
+}
+
+/**
+ * Number of consecutive scanlines scheduled as one unit
+ */
+template < class TFunctionImage,class TDistanceImage, class TLabelImage, unsigned char MinimalSpacingPrecision, class TAccumulator >
+unsigned long
+GeneralizedDistanceTransformImageFilter< TFunctionImage, TDistanceImage, TLabelImage, MinimalSpacingPrecision, TAccumulator >
+::ComputeLinesPerTile(unsigned long numberOfLines, unsigned int numberOfThreads) const
+{
+  const unsigned long linesPerTile = m_AutoTune && m_TunedNumberOfThreads > 0 ?
+    m_TunedLinesPerTile : m_LinesPerTile;
+  if (linesPerTile > 0)
+    return linesPerTile;
+  return std::max(1UL, numberOfLines / (8 * numberOfThreads));
+}
+
+/**
+ * Number of scanlines in direction d
+ */
+template < class TFunctionImage,class TDistanceImage, class TLabelImage, unsigned char MinimalSpacingPrecision, class TAccumulator >
+unsigned long
+GeneralizedDistanceTransformImageFilter< TFunctionImage, TDistanceImage, TLabelImage, MinimalSpacingPrecision, TAccumulator >
+::GetNumberOfLines(unsigned int d) const
+{
+  // With seeds or bricks, only the scanlines in direction 0 that hold a
+  // seed are computed
+  if (d == 0 && this->HasSparseInput())
+    return m_SeedLines.size();
+
+  const RegionType &outputRegion = this->GetDistance()->GetRequestedRegion();
+  const RegionType &workingRegion = m_WorkingDistance->GetBufferedRegion();
+
+  unsigned long numberOfLines = 1;
+  for (unsigned int i = 0; i < FunctionImageType::ImageDimension; ++i)
+  {
+    if (i < d)
+      numberOfLines *= outputRegion.GetSize()[i];
+    else if (i > d)
+      numberOfLines *= workingRegion.GetSize()[i];
+  }
+  return numberOfLines;
+}
+
+/**
+ * Index of the first pixel of a scanline in direction d
+ */
+template < class TFunctionImage,class TDistanceImage, class TLabelImage, unsigned char MinimalSpacingPrecision, class TAccumulator >
+typename
+GeneralizedDistanceTransformImageFilter< TFunctionImage, TDistanceImage, TLabelImage, MinimalSpacingPrecision, TAccumulator >
+::IndexType
+GeneralizedDistanceTransformImageFilter< TFunctionImage, TDistanceImage, TLabelImage, MinimalSpacingPrecision, TAccumulator >
+::GetLineStartIndex(unsigned int d, unsigned long line) const
+{
+  if (d == 0 && this->HasSparseInput())
+    line = m_SeedLines[line];
+
+  const RegionType &outputRegion = this->GetDistance()->GetRequestedRegion();
+  const RegionType &workingRegion = m_WorkingDistance->GetBufferedRegion();
+
+  // The dimensions before d have already been shrunk: Only the scanlines
+  // through the samples that are kept are needed.
+  IndexType index = workingRegion.GetIndex();
+  for (unsigned int i = 0; i < FunctionImageType::ImageDimension; ++i)
+  {
+    if (i < d)
+    {
+      index[i] = (outputRegion.GetIndex()[i] + line % outputRegion.GetSize()[i])
+        * static_cast<long>(m_ShrinkFactors[i]);
+      line /= outputRegion.GetSize()[i];
+    }
+    else if (i > d)
+    {
+      index[i] += line % workingRegion.GetSize()[i];
+      line /= workingRegion.GetSize()[i];
+    }
+  }
+  return index;
+}
+
+/**
+ * Precompute the offsets of the scanlines in direction d
+ */
+template < class TFunctionImage,class TDistanceImage, class TLabelImage, unsigned char MinimalSpacingPrecision, class TAccumulator >
+void
+GeneralizedDistanceTransformImageFilter< TFunctionImage, TDistanceImage, TLabelImage, MinimalSpacingPrecision, TAccumulator >
+::ComputeLineGeometry(unsigned int d, LineGeometry &geometry) const
+{
+  // Like GetLineStartIndex(), relative to the start of the buffers
+  const RegionType &outputRegion = this->GetDistance()->GetRequestedRegion();
+  const RegionType &workingRegion = m_WorkingDistance->GetBufferedRegion();
+  const OffsetValueType *offsetTable = m_WorkingDistance->GetOffsetTable();
+
+  geometry.Base = 0;
+  for (unsigned int i = 0; i < FunctionImageType::ImageDimension; ++i)
+  {
+    if (i < d)
+    {
+      const OffsetValueType factor = m_ShrinkFactors[i];
+      geometry.Base += (outputRegion.GetIndex()[i] * factor - workingRegion.GetIndex()[i])
+        * offsetTable[i];
+      geometry.Size[i] = outputRegion.GetSize()[i];
+      geometry.Step[i] = factor * offsetTable[i];
+    }
+    else
+    {
+      geometry.Size[i] = workingRegion.GetSize()[i];
+      geometry.Step[i] = i > d ? offsetTable[i] : 0;
+    }
+  }
+}
+
+/**
+ * Offset of the first pixel of a scanline in direction d
+ */
+template < class TFunctionImage,class TDistanceImage, class TLabelImage, unsigned char MinimalSpacingPrecision, class TAccumulator >
+template < int Direction >
+typename
+GeneralizedDistanceTransformImageFilter< TFunctionImage, TDistanceImage, TLabelImage, MinimalSpacingPrecision, TAccumulator >
+::OffsetValueType
+GeneralizedDistanceTransformImageFilter< TFunctionImage, TDistanceImage, TLabelImage, MinimalSpacingPrecision, TAccumulator >
+::GetLineOffset(unsigned int d, const LineGeometry &geometry, unsigned long line) const
+{
+  // With Direction known at compile time, the loop is unrolled and the
+  // test for the skipped dimension vanishes
+  const unsigned int direction = Direction < 0 ? d : Direction;
+  if (direction == 0 && this->HasSparseInput())
+    line = m_SeedLines[line];
+
+  OffsetValueType offset = geometry.Base;
+  for (unsigned int i = 0; i < FunctionImageType::ImageDimension; ++i)
+  {
+    if (i == direction)
+      continue;
+    offset += (line % geometry.Size[i]) * geometry.Step[i];
+    line /= geometry.Size[i];
+  }
+  return offset;
+}
+
+/**
+ * Call the kernel of a direction
+ */
+template < class TFunctionImage,class TDistanceImage, class TLabelImage, unsigned char MinimalSpacingPrecision, class TAccumulator >
+template <bool UseSpacing, bool CreateVoronoiMap >
+void
+GeneralizedDistanceTransformImageFilter< TFunctionImage, TDistanceImage, TLabelImage, MinimalSpacingPrecision, TAccumulator >
+::DispatchGenerateLines(unsigned int d, unsigned long firstLine,
+    unsigned long numberOfLines, int threadId)
+{
+  // Only 2D and 3D images get a kernel per direction. The cases for
+  // directions the image doesn't have are never reached, they map to the
+  // generic kernel so that no kernels are instantiated for them.
+  const unsigned int dimension = FunctionImageType::ImageDimension;
+  const bool specialized = dimension == 2 || dimension == 3;
+  switch (specialized ? static_cast<int>(d) : -1)
+  {
+    case 0:
+      this->template DispatchSink<UseSpacing, CreateVoronoiMap, 0>(
+          d, firstLine, numberOfLines, threadId);
+      break;
+    case 1:
+      this->template DispatchSink<UseSpacing, CreateVoronoiMap,
+        (FunctionImageType::ImageDimension > 1 ? 1 : -1)>(
+          d, firstLine, numberOfLines, threadId);
+      break;
+    case 2:
+      this->template DispatchSink<UseSpacing, CreateVoronoiMap,
+        (FunctionImageType::ImageDimension > 2 ? 2 : -1)>(
+          d, firstLine, numberOfLines, threadId);
+      break;
+    default:
+      this->template DispatchSink<UseSpacing, CreateVoronoiMap, -1>(
+          d, firstLine, numberOfLines, threadId);
+  }
+}
+
+/**
+ * Call the kernel with the sink of the iteration
+ */
+template < class TFunctionImage,class TDistanceImage, class TLabelImage, unsigned char MinimalSpacingPrecision, class TAccumulator >
+template <bool UseSpacing, bool CreateVoronoiMap, int Direction >
+void
+GeneralizedDistanceTransformImageFilter< TFunctionImage, TDistanceImage, TLabelImage, MinimalSpacingPrecision, TAccumulator >
+::DispatchSink(unsigned int d, unsigned long firstLine,
+    unsigned long numberOfLines, int threadId)
+{
+  // Without shrinking, the samples along dimension 0 are adjacent. The
+  // contiguous sink is only instantiated for the kernel of direction 0.
+  if (m_CollectStatistics || (CreateVoronoiMap && m_CollectVoronoiRuns))
+    this->template ThreadedGenerateLines<UseSpacing, CreateVoronoiMap, Direction,
+      MeasuringSink<CreateVoronoiMap> >(d, firstLine, numberOfLines, threadId);
+  else if (Direction == 0 && m_ShrinkFactors[0] == 1)
+    this->template ThreadedGenerateLines<UseSpacing, CreateVoronoiMap, Direction,
+      DenseSink<CreateVoronoiMap, (Direction == 0 ? 1 : 0)> >(
+          d, firstLine, numberOfLines, threadId);
+  else
+    this->template ThreadedGenerateLines<UseSpacing, CreateVoronoiMap, Direction,
+      DenseSink<CreateVoronoiMap, 0> >(d, firstLine, numberOfLines, threadId);
+}
+
+/**
+ * Compute the lower envelope for a range of scanlines
+ */
+template < class TFunctionImage,class TDistanceImage, class TLabelImage, unsigned char MinimalSpacingPrecision, class TAccumulator >
+template <bool UseSpacing, bool CreateVoronoiMap, int Direction, class TSink >
+void 
+GeneralizedDistanceTransformImageFilter< TFunctionImage, TDistanceImage, TLabelImage, MinimalSpacingPrecision, TAccumulator >
+::ThreadedGenerateLines(unsigned int d, unsigned long firstLine,
+    unsigned long numberOfLines, int threadId)
+{
+  // We need the size and probably the spacing of the images.
+  DistanceImagePointer distance = m_WorkingDistance;
+  typename DistanceImageType::SpacingType spacing = distance->GetSpacing();
+  typename DistanceImageType::SizeType size = distance->GetBufferedRegion().GetSize();
+
+  // Only the samples at multiples of the shrink factor that lie in the
+  // output are stored
+  const RegionType &outputRegion = this->GetDistance()->GetRequestedRegion();
+  const unsigned int stride = m_ShrinkFactors[d];
+  const long firstSample = outputRegion.GetIndex()[d] * static_cast<long>(stride);
+  const long numberOfSamples = outputRegion.GetSize()[d];
+
+  typedef itk::LowerEnvelopeOfParabolas<UseSpacing, TSpacingType, MinimalSpacingPrecision,
+          CreateVoronoiMap, typename TLabelImage::PixelType,
+          typename TFunctionImage::IndexValueType,
+          AccumulatorType> LEOP;
+
+  // The scanlines are walked on the raw buffers: pixelStep pixels apart
+  // for one step along d, stride * pixelStep pixels apart for one kept
+  // sample. The working images have the same buffered region, so a pixel
+  // has the same offset in both. Along dimension 0 the pixels are adjacent.
+  const OffsetValueType pixelStep = Direction == 0 ? 1 : distance->GetOffsetTable()[d];
+  const long lineLength = size[d];
+  const long firstAbscissa = distance->GetBufferedRegion().GetIndex()[d];
+
+  const DistancePixelType *distanceBuffer = distance->GetBufferPointer();
+  const LabelPixelType *voronoiMapBuffer = 0;
+  if (CreateVoronoiMap)
+    voronoiMapBuffer = m_WorkingVoronoiMap->GetBufferPointer();
+
+  // The sink stores the samples, and in the last iteration may record the
+  // labels as runs and collect statistics on the way
+  TSink sink(this, d, firstLine, threadId, pixelStep * stride);
+
+  LineGeometry geometry;
+  this->ComputeLineGeometry(d, geometry);
+
+  // One envelope for all scanlines of the thread, so its memory is
+  // allocated only once. The spacing is ignored by LEOP if
+  // UseSpacing == false. We provide a dummy value of 1 anyway.
+  LEOP &envelope = this->template GetThreadEnvelope<LEOP>(threadId, d, size[d],
+      UseSpacing ? static_cast<TSpacingType>(spacing[d]) : 1);
+
+  for (unsigned long line = firstLine; line < firstLine + numberOfLines; ++line)
+  {
+    // Compute the generalized distance transform for the current scanline
+    const OffsetValueType lineOffset = this->template GetLineOffset<Direction>(d, geometry, line);
+    const DistancePixelType *distanceIn = distanceBuffer + lineOffset;
+
+    // First compute the lower envelope of parabolas
+    envelope.clear();
+
+    if (CreateVoronoiMap)
+    {
+      const LabelPixelType *voronoiMapIn = voronoiMapBuffer + lineOffset;
+      for (long i = 0; i < lineLength; ++i, distanceIn += pixelStep, voronoiMapIn += pixelStep)
+        envelope.addParabola(firstAbscissa + i, DistanceToAccumulator(*distanceIn), *voronoiMapIn);
+    }
+    else
+    {
+      for (long i = 0; i < lineLength; ++i, distanceIn += pixelStep)
+        envelope.addParabola(firstAbscissa + i, DistanceToAccumulator(*distanceIn));
+    }
+
+    // And now evaluate the lower envelope for the samples of the scanline
+    // that are kept
+    sink.BeginLine(line, lineOffset + (firstSample - firstAbscissa) * pixelStep);
+    this->template SampleLine<CreateVoronoiMap>(envelope, d, firstSample, numberOfSamples, stride,
+        sink.GetDistanceIterator(), sink.GetVoronoiIterator());
+    sink.EndLine(line);
+
+  }
+
+  sink.EndTile();
+}
+
+/**
+ * The kept envelope of a thread for direction d
+ */
+template < class TFunctionImage,class TDistanceImage, class TLabelImage, unsigned char MinimalSpacingPrecision, class TAccumulator >
+template < class TEnvelope >
+TEnvelope &
+GeneralizedDistanceTransformImageFilter< TFunctionImage, TDistanceImage, TLabelImage, MinimalSpacingPrecision, TAccumulator >
+::GetThreadEnvelope(int threadId, unsigned int d, unsigned long length,
+    const TSpacingType &spacing)
+{
+  // The envelope is replaced if the kernel or the spacing have changed
+  ThreadEnvelopeBase *&kept = m_ThreadEnvelopes[threadId * FunctionImageType::ImageDimension + d];
+  ThreadEnvelope<TEnvelope> *envelope = dynamic_cast<ThreadEnvelope<TEnvelope> *>(kept);
+  if (!envelope || envelope->Spacing != spacing)
+  {
+    delete kept;
+    envelope = new ThreadEnvelope<TEnvelope>(length, spacing);
+    kept = envelope;
+  }
+  return envelope->Envelope;
+}
+
+/**
+ * Sample the envelope of a scanline
+ */
+template < class TFunctionImage,class TDistanceImage, class TLabelImage, unsigned char MinimalSpacingPrecision, class TAccumulator >
+template < bool CreateVoronoiMap, class TEnvelope, class TValueIterator, class TVoronoiIterator >
+void
+GeneralizedDistanceTransformImageFilter< TFunctionImage, TDistanceImage, TLabelImage, MinimalSpacingPrecision, TAccumulator >
+::SampleLine(TEnvelope &envelope, unsigned int d, long firstSample,
+    long numberOfSamples, long stride, TValueIterator &valueIt,
+    TVoronoiIterator &voronoiIt) const
+{
+  const long period = m_WorkingDistance->GetBufferedRegion().GetSize()[d];
+  if (CreateVoronoiMap)
+  {
+    if (m_PeriodicBoundary[d])
+      envelope.periodicSample(firstSample, numberOfSamples, stride, period,
+          valueIt, voronoiIt);
+    else
+      envelope.stridedSample(firstSample, numberOfSamples, stride,
+          valueIt, voronoiIt);
+  }
+  else if (m_PeriodicBoundary[d])
+    envelope.periodicSample(firstSample, numberOfSamples, stride, period,
+        valueIt);
+  else
+    envelope.stridedSample(firstSample, numberOfSamples, stride,
+        valueIt);
+}
+
+
+/**
+ * Key of the tuned configuration
+ */
+template < class TFunctionImage,class TDistanceImage, class TLabelImage, unsigned char MinimalSpacingPrecision, class TAccumulator >
+std::string
+GeneralizedDistanceTransformImageFilter< TFunctionImage, TDistanceImage, TLabelImage, MinimalSpacingPrecision, TAccumulator >
+::GetTuningKey() const
+{
+  std::ostringstream stream;
+  stream << TuningFile::GetMachineName()
+    << "/" << this->GetNumberOfThreads() << "threads"
+    << "/" << FunctionImageType::ImageDimension << "d"
+    << "/" << TuningTypeName<DistancePixelType>::Get()
+    << "/" << TuningTypeName<LabelPixelType>::Get()
+    << "/" << TuningTypeName<AccumulatorType>::Get()
+    << "/" << (m_UseSpacing ? "spacing" : "nospacing")
+    << "/" << (m_CreateVoronoiMap ? "voronoi" : "novoronoi");
+  return stream.str();
+}
+
+/**
+ * Look up the configuration of the machine
+ */
+template < class TFunctionImage,class TDistanceImage, class TLabelImage, unsigned char MinimalSpacingPrecision, class TAccumulator >
+bool
+GeneralizedDistanceTransformImageFilter< TFunctionImage, TDistanceImage, TLabelImage, MinimalSpacingPrecision, TAccumulator >
+::ReadTuning(const std::string &key)
+{
+  // A missing entry is remembered as well, so that the file is only read
+  // again when the key changes
+  m_TunedKey = key;
+  m_TunedNumberOfThreads = 0;
+  m_TunedLinesPerTile = 0;
+
+  TuningFile::ValuesType values;
+  if (!TuningFile::Read(this->GetTuningFileNameOrDefault(), key, values) ||
+      values.size() != 2 || values[0] < 1 || values[1] < 0)
+    return false;
+
+  m_TunedNumberOfThreads = static_cast<int>(values[0]);
+  m_TunedLinesPerTile = static_cast<unsigned long>(values[1]);
+  return true;
+}
+
+/**
+ * Look up or calibrate the configuration of the machine
+ */
+template < class TFunctionImage,class TDistanceImage, class TLabelImage, unsigned char MinimalSpacingPrecision, class TAccumulator >
+void
+GeneralizedDistanceTransformImageFilter< TFunctionImage, TDistanceImage, TLabelImage, MinimalSpacingPrecision, TAccumulator >
+::Tune()
+{
+  const std::string key = this->GetTuningKey();
+  if (!this->ReadTuning(key))
+  {
+    int numberOfThreads;
+    unsigned long linesPerTile;
+    this->Calibrate(numberOfThreads, linesPerTile);
+
+    TuningFile::ValuesType values;
+    values.push_back(numberOfThreads);
+    values.push_back(static_cast<long>(linesPerTile));
+    const std::string fileName = this->GetTuningFileNameOrDefault();
+    if (!TuningFile::Append(fileName, key, values))
+      itkWarningMacro(<< "Can't store the tuned configuration in " << fileName);
+
+    m_TunedNumberOfThreads = numberOfThreads;
+    m_TunedLinesPerTile = linesPerTile;
+  }
+
+  if (!m_AutoTune)
+  {
+    m_AutoTune = true;
+    this->Modified();
+  }
+}
+
+/**
+ * File of the tuned configurations
+ */
+template < class TFunctionImage,class TDistanceImage, class TLabelImage, unsigned char MinimalSpacingPrecision, class TAccumulator >
+std::string
+GeneralizedDistanceTransformImageFilter< TFunctionImage, TDistanceImage, TLabelImage, MinimalSpacingPrecision, TAccumulator >
+::GetTuningFileNameOrDefault() const
+{
+  return m_TuningFileName.empty() ?
+    TuningFile::GetDefaultFileName() : m_TuningFileName;
+}
+
+/**
+ * Time the calibration transforms
+ */
+template < class TFunctionImage,class TDistanceImage, class TLabelImage, unsigned char MinimalSpacingPrecision, class TAccumulator >
+void
+GeneralizedDistanceTransformImageFilter< TFunctionImage, TDistanceImage, TLabelImage, MinimalSpacingPrecision, TAccumulator >
+::Calibrate(int &numberOfThreads, unsigned long &linesPerTile)
+{
+  // A synthetic image of about 256k voxels, with about one foreground voxel
+  // in a thousand at reproducible positions
+  const unsigned int dimension = FunctionImageType::ImageDimension;
+  const unsigned long side = std::max(16UL, static_cast<unsigned long>(
+        std::pow(256.0 * 1024.0, 1.0 / dimension) + 0.5));
+  SizeType size;
+  size.Fill(side);
+  const RegionType region(size);
+  const unsigned long numberOfPixels = region.GetNumberOfPixels();
+
+  DistanceImagePointer function = DistanceImageType::New();
+  function->SetRegions(region);
+  function->Allocate();
+  function->FillBuffer(GetMaximumApexHeight());
+  DistancePixelType *pixels = function->GetBufferPointer();
+  unsigned long random = 12345;
+  for (unsigned long i = 0; i < numberOfPixels / 1000 + 1; ++i)
+  {
+    random = random * 1103515245UL + 12345UL;
+    pixels[(random >> 8) % numberOfPixels] = 0;
+  }
+
+  typename CalibrationFilterType::Pointer filter = CalibrationFilterType::New();
+  filter->SetInput1(function);
+  if (m_CreateVoronoiMap)
+  {
+    LabelImagePointer labels = LabelImageType::New();
+    labels->SetRegions(region);
+    labels->Allocate();
+    labels->FillBuffer(LabelPixelType());
+    filter->SetInput2(labels);
+  }
+  filter->SetUseSpacing(m_UseSpacing);
+  filter->SetCreateVoronoiMap(m_CreateVoronoiMap);
+  filter->SetNumaAware(m_NumaAware);
+  filter->SetUseHugePages(m_UseHugePages);
+  filter->ReuseBuffersOn();
+
+  // First the number of threads with the automatic tile size, then the tile
+  // size with the best number of threads. Each configuration is run twice,
+  // the faster run counts.
+  const int maximumNumberOfThreads = std::max(1, this->GetNumberOfThreads());
+  numberOfThreads = maximumNumberOfThreads;
+  linesPerTile = 0;
+  double bestTime = NumericTraits<double>::max();
+  RealTimeClock::Pointer clock = RealTimeClock::New();
+  for (unsigned int stage = 0; stage < 2; ++stage)
+  {
+    std::vector<std::pair<int, unsigned long> > candidates;
+    if (stage == 0)
+    {
+      for (int threads = 1; threads < maximumNumberOfThreads; threads *= 2)
+        candidates.push_back(std::make_pair(threads, 0UL));
+      candidates.push_back(std::make_pair(maximumNumberOfThreads, 0UL));
+    }
+    else
+    {
+      for (unsigned long tile = 1; tile <= 256; tile *= 4)
+        candidates.push_back(std::make_pair(numberOfThreads, tile));
+    }
+
+    for (unsigned int c = 0; c < candidates.size(); ++c)
+    {
+      filter->SetNumberOfThreads(candidates[c].first);
+      filter->SetLinesPerTile(candidates[c].second);
+      double time = NumericTraits<double>::max();
+      for (unsigned int run = 0; run < 2; ++run)
+      {
+        filter->Modified();
+        const RealTimeClock::TimeStampType start = clock->GetTimeStamp();
+        filter->Update();
+        time = std::min(time, static_cast<double>(clock->GetTimeStamp() - start));
+      }
+      if (time < bestTime)
+      {
+        bestTime = time;
+        numberOfThreads = candidates[c].first;
+        linesPerTile = candidates[c].second;
+      }
+    }
+  }
+}
+
+/**
+ * Number of threads of the update
+ */
+template < class TFunctionImage,class TDistanceImage, class TLabelImage, unsigned char MinimalSpacingPrecision, class TAccumulator >
+int
+GeneralizedDistanceTransformImageFilter< TFunctionImage, TDistanceImage, TLabelImage, MinimalSpacingPrecision, TAccumulator >
+::GetUpdateNumberOfThreads() const
+{
+  if (m_AutoTune && m_TunedNumberOfThreads > 0)
+    return m_TunedNumberOfThreads;
+  return this->GetNumberOfThreads();
+}
+
+/**
+ * Dispatch the execution to the correct specialized TemplateGenerateData()
+ * method
+ */
+template < class TFunctionImage,class TDistanceImage, class TLabelImage, unsigned char MinimalSpacingPrecision, class TAccumulator >
+void 
+GeneralizedDistanceTransformImageFilter< TFunctionImage, TDistanceImage, TLabelImage, MinimalSpacingPrecision, TAccumulator >
+::GenerateData() 
+{
+  // Only apply a configuration that Tune() has stored, the calibration
+  // transforms are never run in the update
+  if (m_AutoTune)
+  {
+    const std::string key = this->GetTuningKey();
+    if (key != m_TunedKey)
+      this->ReadTuning(key);
+  }
+
   if( m_UseSpacing && m_CreateVoronoiMap )
     {
     TemplateGenerateData<true, true>(); 
@@ -332,14 +1961,50 @@ GeneralizedDistanceTransformImageFilter< TFunctionImage, TDistanceImage, TLabelI
  *  Print Self
  *  \todo Add information on the constraints on abscissas and apex heights.
  */
-template < class TFunctionImage,class TDistanceImage, class TLabelImage, unsigned char MinimalSpacingPrecision >
+template < class TFunctionImage,class TDistanceImage, class TLabelImage, unsigned char MinimalSpacingPrecision, class TAccumulator >
 void 
-GeneralizedDistanceTransformImageFilter< TFunctionImage, TDistanceImage, TLabelImage, MinimalSpacingPrecision >
+GeneralizedDistanceTransformImageFilter< TFunctionImage, TDistanceImage, TLabelImage, MinimalSpacingPrecision, TAccumulator >
 ::PrintSelf(std::ostream& os, Indent indent) const
 {
   Superclass::PrintSelf(os,indent);
   os << indent << "UseSpacing: " << m_UseSpacing << std::endl;
   os << indent << "CreateVoronoiMap: " << m_CreateVoronoiMap << std::endl;
+  os << indent << "PeriodicBoundary: " << m_PeriodicBoundary << std::endl;
+  os << indent << "ProcessedDimensions: " << m_ProcessedDimensions << std::endl;
+  os << indent << "ShrinkFactors: " << m_ShrinkFactors << std::endl;
+  os << indent << "UseSeeds: " << m_UseSeeds << std::endl;
+  os << indent << "NumberOfSeeds: " << m_Seeds.size() << std::endl;
+  os << indent << "UseSparseInputs: " << this->GetUseSparseInputs() << std::endl;
+  os << indent << "CreateRunLengthVoronoiMap: " << m_CreateRunLengthVoronoiMap << std::endl;
+  os << indent << "WriteDenseVoronoiMap: " << m_WriteDenseVoronoiMap << std::endl;
+  os << indent << "NumberOfVoronoiRuns: " << m_VoronoiRuns.size() << std::endl;
+  os << indent << "ComputeStatistics: " << m_ComputeStatistics << std::endl;
+  os << indent << "NumberOfHistogramBins: " << m_NumberOfHistogramBins << std::endl;
+  os << indent << "HistogramBinWidth: " << m_HistogramBinWidth << std::endl;
+  os << indent << "NumberOfMeasuredPixels: " << m_NumberOfMeasuredPixels << std::endl;
+  os << indent << "MaximumDistance: " << m_MaximumDistance << std::endl;
+  os << indent << "MeanDistance: " << m_MeanDistance << std::endl;
+  os << indent << "CreateSparseOutputs: " << m_CreateSparseOutputs << std::endl;
+  os << indent << "NarrowBand: " << m_NarrowBand << std::endl;
+  os << indent << "OutputBrickSize: " << m_OutputBrickSize << std::endl;
+  os << indent << "OutputRegion: " << m_OutputRegion << std::endl;
+  os << indent << "OutputSpacing: " << m_OutputSpacing << std::endl;
+  os << indent << "OutputOrigin: " << m_OutputOrigin << std::endl;
+  os << indent << "BackgroundLabel: " << m_BackgroundLabel << std::endl;
+  os << indent << "DistanceImportPointer: " << m_DistanceImportPointer << std::endl;
+  os << indent << "VoronoiMapImportPointer: " << m_VoronoiMapImportPointer << std::endl;
+  os << indent << "NumberOfSaturatedPixels: " << m_NumberOfSaturatedPixels << std::endl;
+  os << indent << "LinesPerTile: " << m_LinesPerTile << std::endl;
+  os << indent << "LoadBalanceEfficiency: " << m_LoadBalanceEfficiency << std::endl;
+  os << indent << "NumberOfStolenTiles: " << m_NumberOfStolenTiles << std::endl;
+  os << indent << "NumaAware: " << m_NumaAware << std::endl;
+  os << indent << "UseHugePages: " << m_UseHugePages << std::endl;
+  os << indent << "ReuseBuffers: " << m_ReuseBuffers << std::endl;
+  os << indent << "NumberOfNumaNodes: " << m_NumaTopology.GetNumberOfNodes() << std::endl;
+  os << indent << "AutoTune: " << m_AutoTune << std::endl;
+  os << indent << "TuningFileName: " << m_TuningFileName << std::endl;
+  os << indent << "TunedNumberOfThreads: " << m_TunedNumberOfThreads << std::endl;
+  os << indent << "TunedLinesPerTile: " << m_TunedLinesPerTile << std::endl;
 }
 } // end namespace itk
 #endif
@@ -0,0 +1,34 @@
+/* Explicit instantiations of GeneralizedDistanceTransformImageFilter for the
+ * common pixel types in 2D and 3D.
+ *
+ * The library ITKGeneralizedDistanceTransform holds the filter for images of
+ * short, int, float and double pixels in 2D and 3D, with the same image type
+ * for the function, distance and label images and the default accumulator.
+ * Sources that only use these types can define
+ * ITK_USE_PRECOMPILED_GENERALIZED_DISTANCE_TRANSFORM before including
+ * itkGeneralizedDistanceTransformImageFilter.h and link the library instead
+ * of compiling the filter themselves. The library is built with the flags of
+ * its own build, so a release build of it serves debug builds of the clients
+ * as well.
+ *
+ * The member templates, i.e. the specialized TemplateGenerateData() variants
+ * and the scanline kernels with their envelopes, are instantiated through
+ * the members that call them. */
+
+#include "itkImage.h"
+#include "itkGeneralizedDistanceTransformImageFilter.h"
+#include "itkGeneralizedDistanceTransformImageFilter.txx"
+#include "itkLowerEnvelopeOfParabolas.txx"
+
+#define ITK_INSTANTIATE_GENERALIZED_DISTANCE_TRANSFORM(PixelType, dimension) \
+  template class itk::GeneralizedDistanceTransformImageFilter< \
+    itk::Image<PixelType, dimension>, itk::Image<PixelType, dimension> >;
+
+ITK_INSTANTIATE_GENERALIZED_DISTANCE_TRANSFORM(short, 2)
+ITK_INSTANTIATE_GENERALIZED_DISTANCE_TRANSFORM(short, 3)
+ITK_INSTANTIATE_GENERALIZED_DISTANCE_TRANSFORM(int, 2)
+ITK_INSTANTIATE_GENERALIZED_DISTANCE_TRANSFORM(int, 3)
+ITK_INSTANTIATE_GENERALIZED_DISTANCE_TRANSFORM(float, 2)
+ITK_INSTANTIATE_GENERALIZED_DISTANCE_TRANSFORM(float, 3)
+ITK_INSTANTIATE_GENERALIZED_DISTANCE_TRANSFORM(double, 2)
+ITK_INSTANTIATE_GENERALIZED_DISTANCE_TRANSFORM(double, 3)
@@ -0,0 +1,139 @@
+#ifndef __itkHugePageImageContainer_h
+#define __itkHugePageImageContainer_h
+
+#include "itkImportImageContainer.h"
+
+#include <cstdlib>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <unistd.h>
+#include <sys/mman.h>
+#endif
+
+namespace itk
+{
+
+/** \class HugePageImageContainer
+*
+* A pixel container whose memory is aligned for transparent huge pages.
+*
+* AllocateHugePages() aligns buffers of at least one huge page (2 MB) to
+* huge page boundaries and asks the kernel to back them with huge pages with
+* madvise(MADV_HUGEPAGE). This reduces the TLB misses of scans that jump
+* through a large image, like the iteration over the last dimension of the
+* distance transform. Smaller buffers are aligned to 64 bytes, which is
+* enough for the widest SIMD loads and a cache line.
+*
+* If huge pages are not available, the buffer is still aligned and used
+* normally. If aligned memory can't be allocated at all, the container
+* falls back to the allocation of ImportImageContainer.
+*
+* The memory is not initialized, so the elements should be of a scalar
+* type.
+*
+* \ingroup ImageFeatureExtraction
+*
+*/
+template <typename TElementIdentifier, typename TElement>
+class HugePageImageContainer : public ImportImageContainer<TElementIdentifier, TElement>
+{
+public:
+  /** Standard class typedefs. */
+  typedef HugePageImageContainer Self;
+  typedef ImportImageContainer<TElementIdentifier, TElement> Superclass;
+  typedef SmartPointer<Self> Pointer;
+  typedef SmartPointer<const Self> ConstPointer;
+
+  typedef TElementIdentifier ElementIdentifier;
+  typedef TElement Element;
+
+  /** Method for creation through the object factory */
+  itkNewMacro(Self);
+
+  /** Run-time type information (and related methods). */
+  itkTypeMacro(HugePageImageContainer, ImportImageContainer);
+
+  /** The size of a huge page and the alignment of smaller buffers. */
+  static size_t GetHugePageSize()
+    { return 2 * 1024 * 1024; }
+  static size_t GetMinimalAlignment()
+    { return 64; }
+
+  /** Allocate a buffer of size elements. The previous buffer of the
+   * container is released. */
+  void AllocateHugePages(ElementIdentifier size)
+    {
+    this->ReleaseMemory();
+
+    const size_t bytes = static_cast<size_t>(size) * sizeof(Element);
+    size_t alignment = GetMinimalAlignment();
+    size_t allocatedBytes = bytes;
+    if (bytes >= GetHugePageSize())
+    {
+      // madvise() only covers whole huge pages
+      alignment = GetHugePageSize();
+      allocatedBytes = (bytes + alignment - 1) / alignment * alignment;
+    }
+
+    void *memory = 0;
+#if defined(__unix__) || defined(__APPLE__)
+    if (posix_memalign(&memory, alignment, allocatedBytes) != 0)
+      memory = 0;
+#endif
+    if (!memory)
+    {
+      this->Reserve(size);
+      return;
+    }
+
+#if defined(MADV_HUGEPAGE)
+    if (alignment == GetHugePageSize())
+      m_UsesHugePages = madvise(memory, allocatedBytes, MADV_HUGEPAGE) == 0;
+#endif
+
+    m_Memory = memory;
+    this->SetImportPointer(static_cast<Element *>(memory), size, false);
+    }
+
+  /** Is the current buffer advised to use huge pages? */
+  bool GetUsesHugePages() const
+    { return m_UsesHugePages; }
+
+protected:
+  HugePageImageContainer() : m_Memory(0), m_UsesHugePages(false) {}
+
+  virtual ~HugePageImageContainer()
+    {
+    // The superclass doesn't manage this memory
+    this->ReleaseMemory();
+    }
+
+  void ReleaseMemory()
+    {
+    if (m_Memory)
+    {
+      this->SetImportPointer(0, 0, false);
+      free(m_Memory);
+    }
+    m_Memory = 0;
+    m_UsesHugePages = false;
+    }
+
+  void PrintSelf(std::ostream& os, Indent indent) const
+    {
+    Superclass::PrintSelf(os, indent);
+    os << indent << "UsesHugePages: " << m_UsesHugePages << std::endl;
+    }
+
+private:
+  HugePageImageContainer(const Self&); //purposely not implemented
+  void operator=(const Self&); //purposely not implemented
+
+  void *m_Memory;
+  bool m_UsesHugePages;
+
+}; // end of HugePageImageContainer class
+
+} //end namespace itk
+
+#endif
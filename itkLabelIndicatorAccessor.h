@@ -0,0 +1,45 @@
+#ifndef ITKLABELINDICATORACCESSOR_H
+#define ITKLABELINDICATORACCESSOR_H
+
+namespace itk
+{
+namespace Accessor
+{
+
+/** \class An Accessor that turns a label image into an indicator image
+ *
+ * Label 0 is exchanged with another value, all other labels with 0. With
+ * an itk::ImageAdaptor, a label image can be fed directly into the
+ * itk::GeneralizedDistanceTransformImageFilter, without creating the
+ * indicator image in memory first. */
+template <class TInternalType, class TExternalType >
+class ITK_EXPORT LabelIndicatorAccessor
+{
+  public:
+    typedef TExternalType ExternalType;
+    typedef TInternalType InternalType;
+
+    /** Default constructor. Sets the exchange value to the highest possible
+     * value. */
+    LabelIndicatorAccessor()
+      : m_NotThere(std::numeric_limits<ExternalType>::max())
+    {
+    }
+
+    /** Set another value to set for 0-voxels. */
+    void SetNotThereValue(const ExternalType &notThereValue)
+    {
+      m_NotThere = notThereValue;
+    }
+
+    /** Access the image. */
+    inline TExternalType Get(const TInternalType & input) const
+    { return (TExternalType)(input == 0 ? m_NotThere : 0); }
+
+  private:
+    TExternalType m_NotThere;
+};
+
+}
+}
+#endif
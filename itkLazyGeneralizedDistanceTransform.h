@@ -0,0 +1,247 @@
+#ifndef __itkLazyGeneralizedDistanceTransform_h
+#define __itkLazyGeneralizedDistanceTransform_h
+
+#include "itkObject.h"
+#include "itkGeneralizedDistanceTransformImageFilter.h"
+
+#include <vector>
+
+namespace itk
+{
+
+/** \class LazyGeneralizedDistanceTransform
+*
+* Computes the generalized distance transform and the voronoi map at single
+* voxels on request, see itk::GeneralizedDistanceTransformImageFilter for
+* the transform itself.
+*
+* LAZY EVALUATION
+* Update() runs the iterations over all dimensions but the last one. Then
+* the lower envelopes of the scanlines along the last dimension are
+* computed and kept, instead of being sampled into a dense output. The
+* images of the earlier iterations are released.
+*
+* GetDistance() and GetVoronoiLabel() evaluate the envelope of the scanline
+* through a voxel. The parabola that is minimal at the voxel is found by a
+* binary search over the regions where the parabolas are minimal, so a
+* query takes O(log n) for scanlines of length n. This pays off if only a
+* few voxels are queried per update, e.g. for path planning.
+*
+* The dense outputs can still be generated from the envelopes with
+* GenerateDistanceImage() and GenerateVoronoiMap().
+*
+* FILES
+* WriteEnvelopes() stores the envelopes in a compact file, see
+* itk::EnvelopeFileFormat. If the foreground is sparse, it is much smaller
+* than the dense outputs. itk::EnvelopeFileReader answers the same queries
+* from a memory mapping of the file.
+*
+* BACKGROUND
+* Only the apexes below GetMaximumApexHeight() are kept. Where the distance
+* is saturated to GetMaximumApexHeight(), the voronoi map holds the label
+* of the closest foreground voxel of the scanline, or GetBackgroundLabel()
+* if the scanline has none. The dense filter would use the label of a
+* background voxel in both cases.
+*
+* \ingroup ImageFeatureExtraction
+*
+*/
+
+template <
+  class TFunctionImage,class TDistanceImage, class TLabelImage=TFunctionImage,
+        unsigned char MinimalSpacingPrecision=3,
+        class TAccumulator=typename TDistanceImage::PixelType >
+class ITK_EXPORT LazyGeneralizedDistanceTransform : public Object
+{
+public:
+  /** Standard class typedefs. */
+  typedef LazyGeneralizedDistanceTransform Self;
+  typedef Object Superclass;
+  typedef SmartPointer<Self> Pointer;
+  typedef SmartPointer<const Self> ConstPointer;
+
+  /** Method for creation through the object factory */
+  itkNewMacro(Self);
+
+  /** Run-time type information (and related methods). */
+  itkTypeMacro(LazyGeneralizedDistanceTransform, Object);
+
+  /** Image dimension. */
+  itkStaticConstMacro(ImageDimension, unsigned int, TFunctionImage::ImageDimension);
+
+  /** The filter that computes the iterations before the last one. */
+  typedef GeneralizedDistanceTransformImageFilter<TFunctionImage, TDistanceImage,
+          TLabelImage, MinimalSpacingPrecision, TAccumulator> FilterType;
+
+  /** Types and pointer types for the images. */
+  typedef TFunctionImage FunctionImageType;
+  typedef TDistanceImage DistanceImageType;
+  typedef TLabelImage LabelImageType;
+
+  typedef typename FunctionImageType::ConstPointer FunctionImageConstPointer;
+  typedef typename LabelImageType::ConstPointer LabelImageConstPointer;
+  typedef typename DistanceImageType::Pointer DistanceImagePointer;
+  typedef typename LabelImageType::Pointer LabelImagePointer;
+  typedef typename DistanceImageType::PixelType DistancePixelType;
+  typedef typename LabelImageType::PixelType LabelPixelType;
+  typedef TAccumulator AccumulatorType;
+  typedef typename DistanceImageType::IndexType IndexType;
+  typedef typename DistanceImageType::RegionType RegionType;
+  typedef typename DistanceImageType::SpacingType SpacingType;
+  typedef typename DistanceImageType::PointType PointType;
+  typedef typename DistanceImageType::OffsetValueType OffsetValueType;
+  typedef typename TFunctionImage::IndexValueType AbscissaIndexType;
+  typedef typename FilterType::TSpacingType TSpacingType;
+
+  /** The apex height that marks background voxels. */
+  static DistancePixelType GetMaximumApexHeight()
+    { return FilterType::GetMaximumApexHeight(); }
+
+  /** Connect the function image. */
+  void SetInput1(const FunctionImageType *functionImage);
+
+  /** Connect the label image. Will only be used if a voronoi map is
+   * created. */
+  void SetInput2(const LabelImageType *labelImage);
+
+  /** Set/Get wether spacing should be used or not. */
+  itkGetMacro(UseSpacing, bool);
+  itkSetMacro(UseSpacing, bool);
+  itkBooleanMacro(UseSpacing);
+
+  /** Set/Get wether voronoi labels should be kept or not. */
+  itkGetMacro(CreateVoronoiMap, bool);
+  itkSetMacro(CreateVoronoiMap, bool);
+  itkBooleanMacro(CreateVoronoiMap);
+
+  /** Set/Get the label of the voxels without foreground in their scanline
+   * along the last dimension. Default is LabelPixelType(). */
+  itkSetMacro(BackgroundLabel, LabelPixelType);
+  itkGetConstReferenceMacro(BackgroundLabel, LabelPixelType);
+
+  /** Set/Get the number of threads. */
+  itkSetMacro(NumberOfThreads, int);
+  itkGetMacro(NumberOfThreads, int);
+
+  /** Compute the envelopes of the last dimension. */
+  void Update();
+
+  /** The region that can be queried. */
+  itkGetConstReferenceMacro(Region, RegionType);
+
+  /** The squared euclidean distance at index. index must lie inside
+   * GetRegion(). */
+  DistancePixelType GetDistance(const IndexType &index) const;
+
+  /** The voronoi label at index. Only available if voronoi maps are
+   * created. */
+  LabelPixelType GetVoronoiLabel(const IndexType &index) const;
+
+  /** Number of parabolas kept for all scanlines. */
+  unsigned long GetNumberOfParabolas() const
+    { return m_Abscissa.size(); }
+
+  /** Write the envelopes to fileName, see itk::EnvelopeFileFormat. They
+   * can be read by itk::EnvelopeFileReader. */
+  void WriteEnvelopes(const char *fileName) const;
+
+  /** Sample all envelopes into a new dense distance image. */
+  DistanceImagePointer GenerateDistanceImage() const;
+
+  /** Sample all envelopes into a new dense voronoi map. Only available if
+   * voronoi maps are created. */
+  LabelImagePointer GenerateVoronoiMap() const;
+
+protected:
+  LazyGeneralizedDistanceTransform();
+  virtual ~LazyGeneralizedDistanceTransform() {};
+  void PrintSelf(std::ostream& os, Indent indent) const;
+
+  /** The envelopes of a contiguous range of scanlines, computed by one of
+   * the threads. */
+  struct EnvelopesChunk
+  {
+    std::vector<unsigned long> NumberOfParabolas;
+    std::vector<AbscissaIndexType> DominantFrom;
+    std::vector<AbscissaIndexType> Abscissa;
+    std::vector<AccumulatorType> Height;
+    std::vector<LabelPixelType> Label;
+  };
+
+  /** Compute the envelopes of the scanlines [firstLine, endLine) along the
+   * last dimension of the partially transformed images. */
+  template < bool UseSpacing, bool CreateVoronoiMap >
+  void ThreadedComputeEnvelopes(unsigned long firstLine, unsigned long endLine,
+      const DistanceImageType *distance, const LabelImageType *voronoiMap,
+      EnvelopesChunk &chunk) const;
+
+  template < bool UseSpacing, bool CreateVoronoiMap >
+  void TemplateUpdate(const DistanceImageType *distance,
+      const LabelImageType *voronoiMap);
+
+  /** Internal structure used for passing the images and the chunks to the
+   * threads. */
+  struct EnvelopesThreadStruct
+  {
+    Pointer Transform;
+    const DistanceImageType *Distance;
+    const LabelImageType *VoronoiMap;
+    std::vector<EnvelopesChunk> *Chunks;
+  };
+
+  /** Static function used as a "callback" by the MultiThreader. Each thread
+   * computes the envelopes of an even share of the scanlines. */
+  template < bool UseSpacing, bool CreateVoronoiMap >
+  static ITK_THREAD_RETURN_TYPE EnvelopesThreaderCallback(void *arg);
+
+  /** Number of the scanline through index. */
+  unsigned long GetLine(const IndexType &index) const;
+
+  /** The parabola of a scanline that is minimal at abscissa. The scanline
+   * must have at least one parabola. */
+  unsigned long FindParabola(unsigned long first, unsigned long end,
+      AbscissaIndexType abscissa) const;
+
+  /** Value of parabola p at abscissa, saturated to GetMaximumApexHeight(). */
+  DistancePixelType EvaluateParabola(unsigned long p, AbscissaIndexType abscissa) const;
+
+private:
+  LazyGeneralizedDistanceTransform(const Self&); //purposely not implemented
+  void operator=(const Self&); //purposely not implemented
+
+  FunctionImageConstPointer m_FunctionImage;
+  LabelImageConstPointer m_LabelImage;
+  bool m_UseSpacing;
+  bool m_CreateVoronoiMap;
+  LabelPixelType m_BackgroundLabel;
+  int m_NumberOfThreads;
+
+  /** The geometry of the transform. */
+  RegionType m_Region;
+  SpacingType m_Spacing;
+  PointType m_Origin;
+
+  /** The spacing of the envelopes along the last dimension, 1 if spacing is
+   * not used. */
+  TSpacingType m_EnvelopeSpacing;
+
+  /** The envelopes of all scanlines, one after the other: The parabolas of
+   * scanline n are [m_LineBegin[n], m_LineBegin[n+1]). The binary search
+   * only touches m_DominantFrom. */
+  std::vector<unsigned long> m_LineBegin;
+  std::vector<AbscissaIndexType> m_DominantFrom;
+  std::vector<AbscissaIndexType> m_Abscissa;
+  std::vector<AccumulatorType> m_Height;
+  std::vector<LabelPixelType> m_Label;
+  bool m_HasVoronoiLabels;
+
+}; // end of LazyGeneralizedDistanceTransform class
+
+} //end namespace itk
+
+
+#ifndef ITK_MANUAL_INSTANTIATION
+#include "itkLazyGeneralizedDistanceTransform.txx"
+#endif
+
+#endif
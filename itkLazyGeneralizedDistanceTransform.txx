@@ -0,0 +1,570 @@
+#ifndef __itkLazyGeneralizedDistanceTransform_txx
+#define __itkLazyGeneralizedDistanceTransform_txx
+
+#include <algorithm>
+#include <fstream>
+
+#include "itkLazyGeneralizedDistanceTransform.h"
+#include "itkMultiThreader.h"
+#include "itkEnvelopeFileFormat.h"
+
+namespace itk
+{
+
+
+/**
+ *    Constructor
+ */
+template < class TFunctionImage,class TDistanceImage, class TLabelImage, unsigned char MinimalSpacingPrecision, class TAccumulator >
+LazyGeneralizedDistanceTransform< TFunctionImage, TDistanceImage, TLabelImage, MinimalSpacingPrecision, TAccumulator >
+::LazyGeneralizedDistanceTransform()
+{
+  m_UseSpacing = true;
+  m_CreateVoronoiMap = true;
+  m_BackgroundLabel = LabelPixelType();
+  m_NumberOfThreads = MultiThreader::GetGlobalDefaultNumberOfThreads();
+  m_Spacing.Fill(1.0);
+  m_Origin.Fill(0.0);
+  m_EnvelopeSpacing = 1;
+  m_LineBegin.assign(1, 0);
+  m_HasVoronoiLabels = false;
+}
+
+template < class TFunctionImage,class TDistanceImage, class TLabelImage, unsigned char MinimalSpacingPrecision, class TAccumulator >
+void
+LazyGeneralizedDistanceTransform< TFunctionImage, TDistanceImage, TLabelImage, MinimalSpacingPrecision, TAccumulator >
+::SetInput1(const FunctionImageType *functionImage)
+{
+  m_FunctionImage = functionImage;
+  this->Modified();
+}
+
+template < class TFunctionImage,class TDistanceImage, class TLabelImage, unsigned char MinimalSpacingPrecision, class TAccumulator >
+void
+LazyGeneralizedDistanceTransform< TFunctionImage, TDistanceImage, TLabelImage, MinimalSpacingPrecision, TAccumulator >
+::SetInput2(const LabelImageType *labelImage)
+{
+  m_LabelImage = labelImage;
+  this->Modified();
+}
+
+/**
+ * Transform all dimensions but the last one and keep the envelopes of the
+ * last one
+ */
+template < class TFunctionImage,class TDistanceImage, class TLabelImage, unsigned char MinimalSpacingPrecision, class TAccumulator >
+void
+LazyGeneralizedDistanceTransform< TFunctionImage, TDistanceImage, TLabelImage, MinimalSpacingPrecision, TAccumulator >
+::Update()
+{
+  if (!m_FunctionImage)
+    itkExceptionMacro(<< "The function image is not set");
+  if (m_CreateVoronoiMap && !m_LabelImage)
+    itkExceptionMacro(<< "The label image is not set");
+
+  typename FilterType::BooleanArrayType processedDimensions;
+  processedDimensions.Fill(true);
+  processedDimensions[ImageDimension - 1] = false;
+
+  typename FilterType::Pointer filter = FilterType::New();
+  filter->SetInput1(m_FunctionImage);
+  if (m_CreateVoronoiMap)
+    filter->SetInput2(m_LabelImage);
+  filter->SetUseSpacing(m_UseSpacing);
+  filter->SetCreateVoronoiMap(m_CreateVoronoiMap);
+  filter->SetProcessedDimensions(processedDimensions);
+  filter->SetNumberOfThreads(m_NumberOfThreads);
+  filter->Update();
+
+  // The partially transformed images are released when the envelopes are
+  // computed
+  DistanceImagePointer distance = filter->GetDistance();
+  LabelImagePointer voronoiMap;
+  if (m_CreateVoronoiMap)
+    voronoiMap = filter->GetVoronoiMap();
+  filter = 0;
+
+  m_Region = distance->GetBufferedRegion();
+  m_Spacing = distance->GetSpacing();
+  m_Origin = distance->GetOrigin();
+  m_EnvelopeSpacing = m_UseSpacing ?
+    static_cast<TSpacingType>(m_Spacing[ImageDimension - 1]) : 1;
+
+  if( m_UseSpacing && m_CreateVoronoiMap )
+    {
+    TemplateUpdate<true, true>(distance, voronoiMap);
+    }
+  else if( m_UseSpacing && !m_CreateVoronoiMap )
+    {
+    TemplateUpdate<true, false>(distance, voronoiMap);
+    }
+  else if( !m_UseSpacing && m_CreateVoronoiMap )
+    {
+    TemplateUpdate<false, true>(distance, voronoiMap);
+    }
+  else if( !m_UseSpacing && !m_CreateVoronoiMap )
+    {
+    TemplateUpdate<false, false>(distance, voronoiMap);
+    }
+}
+
+/**
+ * Compute the envelopes in the threads and store them one after the other
+ */
+template < class TFunctionImage,class TDistanceImage, class TLabelImage, unsigned char MinimalSpacingPrecision, class TAccumulator >
+template < bool UseSpacing, bool CreateVoronoiMap >
+void
+LazyGeneralizedDistanceTransform< TFunctionImage, TDistanceImage, TLabelImage, MinimalSpacingPrecision, TAccumulator >
+::TemplateUpdate(const DistanceImageType *distance, const LabelImageType *voronoiMap)
+{
+  MultiThreader::Pointer threader = MultiThreader::New();
+  threader->SetNumberOfThreads(m_NumberOfThreads);
+  std::vector<EnvelopesChunk> chunks(threader->GetNumberOfThreads());
+
+  EnvelopesThreadStruct str;
+  str.Transform = this;
+  str.Distance = distance;
+  str.VoronoiMap = voronoiMap;
+  str.Chunks = &chunks;
+
+  threader->SetSingleMethod(
+      &Self::template EnvelopesThreaderCallback<UseSpacing, CreateVoronoiMap>, &str);
+  threader->SingleMethodExecute();
+
+  unsigned long numberOfLines = 0;
+  unsigned long numberOfParabolas = 0;
+  for (unsigned int t = 0; t < chunks.size(); ++t)
+  {
+    numberOfLines += chunks[t].NumberOfParabolas.size();
+    numberOfParabolas += chunks[t].Abscissa.size();
+  }
+
+  m_LineBegin.assign(1, 0);
+  m_LineBegin.reserve(numberOfLines + 1);
+  m_DominantFrom.clear();
+  m_DominantFrom.reserve(numberOfParabolas);
+  m_Abscissa.clear();
+  m_Abscissa.reserve(numberOfParabolas);
+  m_Height.clear();
+  m_Height.reserve(numberOfParabolas);
+  m_Label.clear();
+  if (CreateVoronoiMap)
+    m_Label.reserve(numberOfParabolas);
+
+  // The chunks hold consecutive ranges of scanlines. Each one is released
+  // after it has been copied.
+  for (unsigned int t = 0; t < chunks.size(); ++t)
+  {
+    EnvelopesChunk &chunk = chunks[t];
+    for (unsigned long n = 0; n < chunk.NumberOfParabolas.size(); ++n)
+      m_LineBegin.push_back(m_LineBegin.back() + chunk.NumberOfParabolas[n]);
+    m_DominantFrom.insert(m_DominantFrom.end(), chunk.DominantFrom.begin(), chunk.DominantFrom.end());
+    m_Abscissa.insert(m_Abscissa.end(), chunk.Abscissa.begin(), chunk.Abscissa.end());
+    m_Height.insert(m_Height.end(), chunk.Height.begin(), chunk.Height.end());
+    m_Label.insert(m_Label.end(), chunk.Label.begin(), chunk.Label.end());
+    chunk = EnvelopesChunk();
+  }
+  m_HasVoronoiLabels = CreateVoronoiMap;
+
+  this->Modified();
+}
+
+/**
+ * Compute the envelopes of an even share of the scanlines
+ */
+template < class TFunctionImage,class TDistanceImage, class TLabelImage, unsigned char MinimalSpacingPrecision, class TAccumulator >
+template < bool UseSpacing, bool CreateVoronoiMap >
+ITK_THREAD_RETURN_TYPE
+LazyGeneralizedDistanceTransform< TFunctionImage, TDistanceImage, TLabelImage, MinimalSpacingPrecision, TAccumulator >
+::EnvelopesThreaderCallback(void *arg)
+{
+  MultiThreader::ThreadInfoStruct *info =
+    static_cast<MultiThreader::ThreadInfoStruct *>(arg);
+  EnvelopesThreadStruct *str = static_cast<EnvelopesThreadStruct *>(info->UserData);
+  const Self *transform = str->Transform;
+
+  const unsigned int threadId = info->ThreadID;
+  const unsigned int threadCount = info->NumberOfThreads;
+
+  const RegionType &region = transform->m_Region;
+  const unsigned long numberOfLines =
+    region.GetNumberOfPixels() / region.GetSize()[ImageDimension - 1];
+
+  transform->template ThreadedComputeEnvelopes<UseSpacing, CreateVoronoiMap>(
+      numberOfLines * threadId / threadCount,
+      numberOfLines * (threadId + 1) / threadCount,
+      str->Distance, str->VoronoiMap, (*str->Chunks)[threadId]);
+
+  return ITK_THREAD_RETURN_VALUE;
+}
+
+/**
+ * Compute the envelopes of a range of scanlines along the last dimension
+ */
+template < class TFunctionImage,class TDistanceImage, class TLabelImage, unsigned char MinimalSpacingPrecision, class TAccumulator >
+template < bool UseSpacing, bool CreateVoronoiMap >
+void
+LazyGeneralizedDistanceTransform< TFunctionImage, TDistanceImage, TLabelImage, MinimalSpacingPrecision, TAccumulator >
+::ThreadedComputeEnvelopes(unsigned long firstLine, unsigned long endLine,
+    const DistanceImageType *distance, const LabelImageType *voronoiMap,
+    EnvelopesChunk &chunk) const
+{
+  typedef itk::LowerEnvelopeOfParabolas<UseSpacing, TSpacingType, MinimalSpacingPrecision,
+          CreateVoronoiMap, LabelPixelType, AbscissaIndexType, AccumulatorType> LEOP;
+
+  // The last dimension varies slowest: Scanline n starts at pixel n of the
+  // buffer, and its pixels are pixelStep = numberOfLines apart.
+  const unsigned int d = ImageDimension - 1;
+  const OffsetValueType pixelStep = distance->GetOffsetTable()[d];
+  const long lineLength = m_Region.GetSize()[d];
+  const AbscissaIndexType firstAbscissa = m_Region.GetIndex()[d];
+  const DistancePixelType background = GetMaximumApexHeight();
+
+  const DistancePixelType *distanceBuffer = distance->GetBufferPointer();
+  const LabelPixelType *voronoiMapBuffer = 0;
+  if (CreateVoronoiMap)
+    voronoiMapBuffer = voronoiMap->GetBufferPointer();
+
+  LEOP envelope(lineLength, m_EnvelopeSpacing);
+  chunk.NumberOfParabolas.reserve(endLine - firstLine);
+
+  for (unsigned long line = firstLine; line < endLine; ++line)
+  {
+    // Only the foreground apexes are kept, see BACKGROUND
+    envelope.clear();
+    const DistancePixelType *distanceIn = distanceBuffer + line;
+    const LabelPixelType *voronoiMapIn = CreateVoronoiMap ? voronoiMapBuffer + line : 0;
+    for (long i = 0; i < lineLength; ++i, distanceIn += pixelStep)
+    {
+      if (*distanceIn < background)
+      {
+        if (CreateVoronoiMap)
+          envelope.addParabola(firstAbscissa + i, static_cast<AccumulatorType>(*distanceIn),
+              voronoiMapIn[i * pixelStep]);
+        else
+          envelope.addParabola(firstAbscissa + i, static_cast<AccumulatorType>(*distanceIn));
+      }
+    }
+
+    const unsigned long numberOfParabolas = envelope.numberOfParabolas();
+    chunk.NumberOfParabolas.push_back(numberOfParabolas);
+    for (unsigned long n = 0; n < numberOfParabolas; ++n)
+    {
+      AbscissaIndexType i;
+      AbscissaIndexType dominantFrom;
+      AccumulatorType y;
+      LabelPixelType l;
+      envelope.getParabola(n, i, y, l, dominantFrom);
+      chunk.DominantFrom.push_back(dominantFrom);
+      chunk.Abscissa.push_back(i);
+      chunk.Height.push_back(y);
+      if (CreateVoronoiMap)
+        chunk.Label.push_back(l);
+    }
+  }
+}
+
+/**
+ * Number of the scanline through index
+ */
+template < class TFunctionImage,class TDistanceImage, class TLabelImage, unsigned char MinimalSpacingPrecision, class TAccumulator >
+unsigned long
+LazyGeneralizedDistanceTransform< TFunctionImage, TDistanceImage, TLabelImage, MinimalSpacingPrecision, TAccumulator >
+::GetLine(const IndexType &index) const
+{
+  if (!m_Region.IsInside(index))
+    itkExceptionMacro(<< "Index " << index << " is outside of " << m_Region);
+
+  // The scanlines are numbered like the pixels of a slice across the last
+  // dimension
+  unsigned long line = 0;
+  unsigned long stride = 1;
+  for (unsigned int i = 0; i + 1 < ImageDimension; ++i)
+  {
+    line += (index[i] - m_Region.GetIndex()[i]) * stride;
+    stride *= m_Region.GetSize()[i];
+  }
+  return line;
+}
+
+/**
+ * The parabola of a scanline that is minimal at abscissa
+ */
+template < class TFunctionImage,class TDistanceImage, class TLabelImage, unsigned char MinimalSpacingPrecision, class TAccumulator >
+unsigned long
+LazyGeneralizedDistanceTransform< TFunctionImage, TDistanceImage, TLabelImage, MinimalSpacingPrecision, TAccumulator >
+::FindParabola(unsigned long first, unsigned long end, AbscissaIndexType abscissa) const
+{
+  // A parabola is minimal after its dominantFrom, up to and including the
+  // dominantFrom of the next one. We need the last one whose dominantFrom
+  // is smaller than abscissa.
+  typename std::vector<AbscissaIndexType>::const_iterator next =
+    std::lower_bound(m_DominantFrom.begin() + first, m_DominantFrom.begin() + end, abscissa);
+  const unsigned long p = next - m_DominantFrom.begin();
+  return p > first ? p - 1 : first;
+}
+
+/**
+ * Value of a parabola at abscissa
+ */
+template < class TFunctionImage,class TDistanceImage, class TLabelImage, unsigned char MinimalSpacingPrecision, class TAccumulator >
+typename
+LazyGeneralizedDistanceTransform< TFunctionImage, TDistanceImage, TLabelImage, MinimalSpacingPrecision, TAccumulator >
+::DistancePixelType
+LazyGeneralizedDistanceTransform< TFunctionImage, TDistanceImage, TLabelImage, MinimalSpacingPrecision, TAccumulator >
+::EvaluateParabola(unsigned long p, AbscissaIndexType abscissa) const
+{
+  // Like LowerEnvelopeOfParabolas::value() with spacing, which is 1 if
+  // spacing is not used
+  const TSpacingType x = static_cast<TSpacingType>(abscissa - m_Abscissa[p]);
+  const AccumulatorType value = static_cast<AccumulatorType>(
+      m_EnvelopeSpacing * m_EnvelopeSpacing * x * x +
+      static_cast<TSpacingType>(m_Height[p]));
+
+  if (static_cast<double>(value) < static_cast<double>(GetMaximumApexHeight()))
+    return static_cast<DistancePixelType>(value);
+  return GetMaximumApexHeight();
+}
+
+/**
+ * The distance at index
+ */
+template < class TFunctionImage,class TDistanceImage, class TLabelImage, unsigned char MinimalSpacingPrecision, class TAccumulator >
+typename
+LazyGeneralizedDistanceTransform< TFunctionImage, TDistanceImage, TLabelImage, MinimalSpacingPrecision, TAccumulator >
+::DistancePixelType
+LazyGeneralizedDistanceTransform< TFunctionImage, TDistanceImage, TLabelImage, MinimalSpacingPrecision, TAccumulator >
+::GetDistance(const IndexType &index) const
+{
+  const unsigned long line = this->GetLine(index);
+  const unsigned long first = m_LineBegin[line];
+  const unsigned long end = m_LineBegin[line + 1];
+  if (first == end)
+    return GetMaximumApexHeight();
+
+  const AbscissaIndexType abscissa = index[ImageDimension - 1];
+  return this->EvaluateParabola(this->FindParabola(first, end, abscissa), abscissa);
+}
+
+/**
+ * The voronoi label at index
+ */
+template < class TFunctionImage,class TDistanceImage, class TLabelImage, unsigned char MinimalSpacingPrecision, class TAccumulator >
+typename
+LazyGeneralizedDistanceTransform< TFunctionImage, TDistanceImage, TLabelImage, MinimalSpacingPrecision, TAccumulator >
+::LabelPixelType
+LazyGeneralizedDistanceTransform< TFunctionImage, TDistanceImage, TLabelImage, MinimalSpacingPrecision, TAccumulator >
+::GetVoronoiLabel(const IndexType &index) const
+{
+  if (!m_HasVoronoiLabels)
+    itkExceptionMacro(<< "No voronoi labels were kept in the last update");
+
+  const unsigned long line = this->GetLine(index);
+  const unsigned long first = m_LineBegin[line];
+  const unsigned long end = m_LineBegin[line + 1];
+  if (first == end)
+    return m_BackgroundLabel;
+
+  return m_Label[this->FindParabola(first, end, index[ImageDimension - 1])];
+}
+
+/**
+ * Write the envelopes to a file
+ */
+template < class TFunctionImage,class TDistanceImage, class TLabelImage, unsigned char MinimalSpacingPrecision, class TAccumulator >
+void
+LazyGeneralizedDistanceTransform< TFunctionImage, TDistanceImage, TLabelImage, MinimalSpacingPrecision, TAccumulator >
+::WriteEnvelopes(const char *fileName) const
+{
+  typedef EnvelopeFileFormat Format;
+
+  const unsigned int d = ImageDimension - 1;
+  const AbscissaIndexType first = m_Region.GetIndex()[d];
+  const AbscissaIndexType last = first + static_cast<AbscissaIndexType>(m_Region.GetSize()[d]) - 1;
+  const unsigned long numberOfLines = m_LineBegin.size() - 1;
+
+  // Only the parabolas that are minimal somewhere in [first, last] are
+  // stored. The abscissas after which they are minimal are clamped to
+  // [first - 1, last], so they grow from first - 1 on like the apex
+  // abscissas.
+  std::vector<unsigned char> data;
+  std::vector<uint64_t> lineStart;
+  lineStart.reserve(numberOfLines + 1);
+  std::vector<unsigned long> kept;
+  uint64_t numberOfParabolas = 0;
+  for (unsigned long line = 0; line < numberOfLines; ++line)
+  {
+    lineStart.push_back(data.size());
+
+    const unsigned long end = m_LineBegin[line + 1];
+    kept.clear();
+    for (unsigned long p = m_LineBegin[line]; p < end; ++p)
+    {
+      const AbscissaIndexType from = std::max(m_DominantFrom[p], first - 1);
+      const AbscissaIndexType to = p + 1 < end ? std::min(m_DominantFrom[p + 1], last) : last;
+      if (from < to)
+        kept.push_back(p);
+    }
+    numberOfParabolas += kept.size();
+
+    Format::WriteVarint(data, kept.size());
+    AbscissaIndexType previousAbscissa = first - 1;
+    AbscissaIndexType previousFrom = first - 1;
+    AccumulatorType previousHeight = AccumulatorType();
+    LabelPixelType previousLabel = LabelPixelType();
+    for (unsigned long k = 0; k < kept.size(); ++k)
+    {
+      const unsigned long p = kept[k];
+      const AbscissaIndexType from = std::max(m_DominantFrom[p], first - 1);
+      Format::WriteVarint(data, m_Abscissa[p] - previousAbscissa - 1);
+      Format::WriteVarint(data, from - previousFrom);
+      previousAbscissa = m_Abscissa[p];
+      previousFrom = from;
+      Format::WriteValue(data, m_Height[p], previousHeight);
+      if (m_HasVoronoiLabels)
+        Format::WriteValue(data, m_Label[p], previousLabel);
+    }
+  }
+  lineStart.push_back(data.size());
+
+  std::vector<unsigned char> header;
+  const char *magic = Format::GetMagic();
+  header.insert(header.end(), magic, magic + 8);
+  Format::WriteRaw<uint32_t>(header, Format::GetByteOrderMark());
+  const uint32_t dimension = ImageDimension;
+  Format::WriteRaw(header, dimension);
+  Format::WriteRaw<uint32_t>(header, Format::GetTypeCode<AccumulatorType>());
+  Format::WriteRaw<uint32_t>(header,
+      m_HasVoronoiLabels ? Format::GetTypeCode<LabelPixelType>() : 0);
+  for (unsigned int i = 0; i < ImageDimension; ++i)
+    Format::WriteRaw<int64_t>(header, m_Region.GetIndex()[i]);
+  for (unsigned int i = 0; i < ImageDimension; ++i)
+    Format::WriteRaw<uint64_t>(header, m_Region.GetSize()[i]);
+  for (unsigned int i = 0; i < ImageDimension; ++i)
+    Format::WriteRaw<double>(header, m_Spacing[i]);
+  for (unsigned int i = 0; i < ImageDimension; ++i)
+    Format::WriteRaw<double>(header, m_Origin[i]);
+  Format::WriteRaw<double>(header, m_EnvelopeSpacing);
+  Format::WriteRaw<double>(header, GetMaximumApexHeight());
+  if (m_HasVoronoiLabels)
+    Format::WriteRaw(header, m_BackgroundLabel);
+  Format::WriteRaw<uint64_t>(header, numberOfLines);
+  Format::WriteRaw<uint64_t>(header, numberOfParabolas);
+
+  std::ofstream file(fileName, std::ios::out | std::ios::binary);
+  file.write(reinterpret_cast<const char *>(&header[0]), header.size());
+  file.write(reinterpret_cast<const char *>(&lineStart[0]), lineStart.size() * sizeof(uint64_t));
+  if (!data.empty())
+    file.write(reinterpret_cast<const char *>(&data[0]), data.size());
+  file.close();
+  if (!file)
+    itkExceptionMacro(<< "Can't write the envelopes to " << fileName);
+}
+
+/**
+ * Sample all envelopes into a dense distance image
+ */
+template < class TFunctionImage,class TDistanceImage, class TLabelImage, unsigned char MinimalSpacingPrecision, class TAccumulator >
+typename
+LazyGeneralizedDistanceTransform< TFunctionImage, TDistanceImage, TLabelImage, MinimalSpacingPrecision, TAccumulator >
+::DistanceImagePointer
+LazyGeneralizedDistanceTransform< TFunctionImage, TDistanceImage, TLabelImage, MinimalSpacingPrecision, TAccumulator >
+::GenerateDistanceImage() const
+{
+  DistanceImagePointer image = DistanceImageType::New();
+  image->SetRegions(m_Region);
+  image->SetSpacing(m_Spacing);
+  image->SetOrigin(m_Origin);
+  image->Allocate();
+
+  // The image is written in memory order: One slice across the last
+  // dimension after the other, with a cursor into the envelope of each
+  // scanline.
+  const unsigned long numberOfLines = m_LineBegin.size() - 1;
+  const long lineLength = m_Region.GetSize()[ImageDimension - 1];
+  std::vector<unsigned long> cursor(m_LineBegin.begin(), m_LineBegin.end() - 1);
+
+  DistancePixelType *distanceOut = image->GetBufferPointer();
+  for (long i = 0; i < lineLength; ++i)
+  {
+    const AbscissaIndexType abscissa = m_Region.GetIndex()[ImageDimension - 1] + i;
+    for (unsigned long line = 0; line < numberOfLines; ++line, ++distanceOut)
+    {
+      const unsigned long end = m_LineBegin[line + 1];
+      unsigned long &p = cursor[line];
+      if (p == end)
+      {
+        *distanceOut = GetMaximumApexHeight();
+        continue;
+      }
+      while (p + 1 < end && m_DominantFrom[p + 1] < abscissa)
+        ++p;
+      *distanceOut = this->EvaluateParabola(p, abscissa);
+    }
+  }
+  return image;
+}
+
+/**
+ * Sample all envelopes into a dense voronoi map
+ */
+template < class TFunctionImage,class TDistanceImage, class TLabelImage, unsigned char MinimalSpacingPrecision, class TAccumulator >
+typename
+LazyGeneralizedDistanceTransform< TFunctionImage, TDistanceImage, TLabelImage, MinimalSpacingPrecision, TAccumulator >
+::LabelImagePointer
+LazyGeneralizedDistanceTransform< TFunctionImage, TDistanceImage, TLabelImage, MinimalSpacingPrecision, TAccumulator >
+::GenerateVoronoiMap() const
+{
+  if (!m_HasVoronoiLabels)
+    itkExceptionMacro(<< "No voronoi labels were kept in the last update");
+
+  LabelImagePointer image = LabelImageType::New();
+  image->SetRegions(m_Region);
+  image->SetSpacing(m_Spacing);
+  image->SetOrigin(m_Origin);
+  image->Allocate();
+
+  // See GenerateDistanceImage()
+  const unsigned long numberOfLines = m_LineBegin.size() - 1;
+  const long lineLength = m_Region.GetSize()[ImageDimension - 1];
+  std::vector<unsigned long> cursor(m_LineBegin.begin(), m_LineBegin.end() - 1);
+
+  LabelPixelType *voronoiMapOut = image->GetBufferPointer();
+  for (long i = 0; i < lineLength; ++i)
+  {
+    const AbscissaIndexType abscissa = m_Region.GetIndex()[ImageDimension - 1] + i;
+    for (unsigned long line = 0; line < numberOfLines; ++line, ++voronoiMapOut)
+    {
+      const unsigned long end = m_LineBegin[line + 1];
+      unsigned long &p = cursor[line];
+      if (p == end)
+      {
+        *voronoiMapOut = m_BackgroundLabel;
+        continue;
+      }
+      while (p + 1 < end && m_DominantFrom[p + 1] < abscissa)
+        ++p;
+      *voronoiMapOut = m_Label[p];
+    }
+  }
+  return image;
+}
+
+/**
+ *  Print Self
+ */
+template < class TFunctionImage,class TDistanceImage, class TLabelImage, unsigned char MinimalSpacingPrecision, class TAccumulator >
+void
+LazyGeneralizedDistanceTransform< TFunctionImage, TDistanceImage, TLabelImage, MinimalSpacingPrecision, TAccumulator >
+::PrintSelf(std::ostream& os, Indent indent) const
+{
+  Superclass::PrintSelf(os,indent);
+  os << indent << "UseSpacing: " << m_UseSpacing << std::endl;
+  os << indent << "CreateVoronoiMap: " << m_CreateVoronoiMap << std::endl;
+  os << indent << "BackgroundLabel: " << m_BackgroundLabel << std::endl;
+  os << indent << "NumberOfThreads: " << m_NumberOfThreads << std::endl;
+  os << indent << "Region: " << m_Region << std::endl;
+  os << indent << "NumberOfParabolas: " << m_Abscissa.size() << std::endl;
+}
+} // end namespace itk
+#endif
@@ -0,0 +1,271 @@
+#ifndef __itkLocalSocketSlabTransport_h
+#define __itkLocalSocketSlabTransport_h
+
+#include "itkSlabTransport.h"
+
+#include <cerrno>
+#include <cstring>
+#include <vector>
+
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+namespace itk
+{
+
+/** \class LocalSocketSlabTransport
+*
+* An itk::SlabTransport for several processes on a single POSIX machine.
+*
+* Fork() starts the processes. Each pair of processes is connected by a unix
+* domain socket pair. AllToAll() sends to and receives from all peers at the
+* same time with poll(), so it can't deadlock on full socket buffers.
+*
+* This is mainly meant for testing distributed code without a cluster, but
+* it may be of use on large shared memory machines as well, because each
+* process only holds its part of the image.
+*
+* \ingroup ImageFeatureExtraction
+*
+*/
+class LocalSocketSlabTransport : public SlabTransport
+{
+public:
+  /** Standard class typedefs. */
+  typedef LocalSocketSlabTransport Self;
+  typedef SlabTransport Superclass;
+  typedef SmartPointer<Self> Pointer;
+  typedef SmartPointer<const Self> ConstPointer;
+
+  /** Method for creation through the object factory */
+  itkNewMacro(Self);
+
+  /** Run-time type information (and related methods). */
+  itkTypeMacro(LocalSocketSlabTransport, SlabTransport);
+
+  /** Fork numberOfProcesses - 1 child processes. Returns the transport of
+   * the calling process, which gets rank 0, and of each of the children.
+   * The children continue right after the call and should leave with
+   * _exit() or by returning from main() when they are done. */
+  static Pointer Fork(int numberOfProcesses)
+    {
+    if (numberOfProcesses < 1)
+      itkGenericExceptionMacro(<< "At least one process is needed");
+
+    // One socket pair for each pair of processes
+    std::vector< std::vector<int> > sockets(numberOfProcesses,
+        std::vector<int>(numberOfProcesses, -1));
+    for (int p = 0; p < numberOfProcesses; ++p)
+      for (int q = p + 1; q < numberOfProcesses; ++q)
+      {
+        int pair[2];
+        if (socketpair(AF_UNIX, SOCK_STREAM, 0, pair) != 0)
+          itkGenericExceptionMacro(<< "socketpair() failed: " << strerror(errno));
+        sockets[p][q] = pair[0];
+        sockets[q][p] = pair[1];
+      }
+
+    Pointer transport = Self::New();
+    transport->m_NumberOfProcesses = numberOfProcesses;
+    transport->m_Rank = 0;
+    for (int r = 1; r < numberOfProcesses; ++r)
+    {
+      const pid_t pid = fork();
+      if (pid < 0)
+        itkGenericExceptionMacro(<< "fork() failed: " << strerror(errno));
+      if (pid == 0)
+      {
+        transport->m_Rank = r;
+        transport->m_Children.clear();
+        break;
+      }
+      transport->m_Children.push_back(pid);
+    }
+
+    // Keep the sockets of this process only
+    for (int p = 0; p < numberOfProcesses; ++p)
+      for (int q = 0; q < numberOfProcesses; ++q)
+        if (p != transport->m_Rank && sockets[p][q] >= 0)
+          close(sockets[p][q]);
+
+    transport->m_Sockets = sockets[transport->m_Rank];
+    for (int q = 0; q < numberOfProcesses; ++q)
+      if (transport->m_Sockets[q] >= 0)
+        fcntl(transport->m_Sockets[q], F_SETFL,
+            fcntl(transport->m_Sockets[q], F_GETFL) | O_NONBLOCK);
+
+    return transport;
+    }
+
+  virtual int GetRank() const
+    { return m_Rank; }
+
+  virtual int GetNumberOfProcesses() const
+    { return m_NumberOfProcesses; }
+
+  virtual void AllToAll(const BufferArrayType &send, BufferArrayType &receive)
+    {
+    if (static_cast<int>(send.size()) != m_NumberOfProcesses)
+      itkExceptionMacro(<< "One send buffer per process is needed");
+
+    receive.assign(m_NumberOfProcesses, BufferType());
+    receive[m_Rank] = send[m_Rank];
+
+    // Each message is preceded by its length. The processes share the
+    // machine, so the native representation is fine.
+    const size_t headerSize = sizeof(unsigned long);
+    std::vector<unsigned long> sendHeader(m_NumberOfProcesses);
+    std::vector<unsigned long> receiveHeader(m_NumberOfProcesses, 0);
+    std::vector<size_t> sent(m_NumberOfProcesses, 0);
+    std::vector<size_t> received(m_NumberOfProcesses, 0);
+    for (int q = 0; q < m_NumberOfProcesses; ++q)
+      sendHeader[q] = send[q].size();
+
+    std::vector<struct pollfd> fds;
+    std::vector<int> peers;
+    for (;;)
+    {
+      fds.clear();
+      peers.clear();
+      for (int q = 0; q < m_NumberOfProcesses; ++q)
+      {
+        if (q == m_Rank)
+          continue;
+
+        struct pollfd fd;
+        fd.fd = m_Sockets[q];
+        fd.events = 0;
+        fd.revents = 0;
+        if (sent[q] < headerSize + send[q].size())
+          fd.events |= POLLOUT;
+        if (received[q] < headerSize || received[q] < headerSize + receiveHeader[q])
+          fd.events |= POLLIN;
+        if (fd.events)
+        {
+          fds.push_back(fd);
+          peers.push_back(q);
+        }
+      }
+      if (fds.empty())
+        break;
+
+      if (poll(&fds[0], fds.size(), -1) < 0)
+      {
+        if (errno == EINTR)
+          continue;
+        itkExceptionMacro(<< "poll() failed: " << strerror(errno));
+      }
+
+      for (unsigned int i = 0; i < fds.size(); ++i)
+      {
+        const int q = peers[i];
+
+        if (fds[i].revents & POLLOUT)
+        {
+          const char *data;
+          size_t length;
+          if (sent[q] < headerSize)
+          {
+            data = reinterpret_cast<const char *>(&sendHeader[q]) + sent[q];
+            length = headerSize - sent[q];
+          }
+          else
+          {
+            data = &send[q][sent[q] - headerSize];
+            length = headerSize + send[q].size() - sent[q];
+          }
+
+          const ssize_t n = ::send(m_Sockets[q], data, length, MSG_NOSIGNAL);
+          if (n < 0 && errno != EAGAIN && errno != EINTR)
+            itkExceptionMacro(<< "Sending to process " << q << " failed: " << strerror(errno));
+          if (n > 0)
+            sent[q] += n;
+        }
+
+        if ((fds[i].events & POLLIN) && (fds[i].revents & (POLLIN | POLLHUP | POLLERR)))
+        {
+          char *data;
+          size_t length;
+          if (received[q] < headerSize)
+          {
+            data = reinterpret_cast<char *>(&receiveHeader[q]) + received[q];
+            length = headerSize - received[q];
+          }
+          else
+          {
+            data = &receive[q][received[q] - headerSize];
+            length = headerSize + receiveHeader[q] - received[q];
+          }
+
+          const ssize_t n = recv(m_Sockets[q], data, length, 0);
+          if (n == 0)
+            itkExceptionMacro(<< "Process " << q << " closed the connection");
+          if (n < 0 && errno != EAGAIN && errno != EINTR)
+            itkExceptionMacro(<< "Receiving from process " << q << " failed: " << strerror(errno));
+          if (n > 0)
+          {
+            received[q] += n;
+            if (received[q] == headerSize)
+              receive[q].resize(receiveHeader[q]);
+          }
+        }
+      }
+    }
+    }
+
+  /** Wait for the child processes to terminate. Only to be called by rank 0.
+   * Returns true if all of them exited with status 0. */
+  bool WaitForChildren()
+    {
+    bool success = true;
+    for (unsigned int i = 0; i < m_Children.size(); ++i)
+    {
+      int status;
+      if (waitpid(m_Children[i], &status, 0) < 0 ||
+          !WIFEXITED(status) || WEXITSTATUS(status) != 0)
+        success = false;
+    }
+    m_Children.clear();
+    return success;
+    }
+
+protected:
+  LocalSocketSlabTransport()
+    : m_Rank(0), m_NumberOfProcesses(1), m_Sockets(1, -1) {}
+
+  virtual ~LocalSocketSlabTransport()
+    {
+    for (unsigned int q = 0; q < m_Sockets.size(); ++q)
+      if (m_Sockets[q] >= 0)
+        close(m_Sockets[q]);
+    }
+
+  void PrintSelf(std::ostream& os, Indent indent) const
+    {
+    Superclass::PrintSelf(os, indent);
+    os << indent << "Rank: " << m_Rank << std::endl;
+    os << indent << "NumberOfProcesses: " << m_NumberOfProcesses << std::endl;
+    }
+
+private:
+  LocalSocketSlabTransport(const Self&); //purposely not implemented
+  void operator=(const Self&); //purposely not implemented
+
+  int m_Rank;
+  int m_NumberOfProcesses;
+
+  /** Socket connected to each of the processes, -1 for this one. */
+  std::vector<int> m_Sockets;
+
+  /** Process ids of the children, only in rank 0. */
+  std::vector<pid_t> m_Children;
+
+}; // end of LocalSocketSlabTransport class
+
+} //end namespace itk
+
+#endif
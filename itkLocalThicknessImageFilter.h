@@ -0,0 +1,208 @@
+#ifndef __itkLocalThicknessImageFilter_h
+#define __itkLocalThicknessImageFilter_h
+
+#include "itkImageToImageFilter.h"
+#include "itkGeneralizedDistanceTransformImageFilter.h"
+
+#include <map>
+#include <set>
+#include <vector>
+
+namespace itk
+{
+
+/** \class LocalThicknessImageFilter
+*
+* Computes the local thickness of the foreground of an image: Each
+* foreground voxel gets the diameter of the largest sphere that fits into
+* the foreground and contains the voxel. Background voxels get 0.
+*
+* The spheres are the ones of the euclidean distance transform: The
+* sphere centered at a voxel c has the squared radius r(c)^2, the squared
+* distance of c to the closest background voxel, and contains the voxels x
+* with |x - c|^2 < r(c)^2. The spheres are painted into the output, where
+* each voxel keeps the largest squared radius of the spheres that contain
+* it. The thickness is twice its square root.
+*
+* RIDGE
+* Most spheres don't matter: If all voxels in the sphere of c are in the
+* sphere of one of the 3^N - 1 neighbors of c as well, the sphere of the
+* neighbor is larger. Only the voxels whose spheres are not contained in
+* the one of a neighbor, the ridge of the distance transform, are painted.
+* The squared radius a neighbor needs to contain a sphere is computed once
+* for each squared radius that occurs. With SetUseRidge(false), the spheres
+* of all foreground voxels are painted, which gives the same thickness.
+*
+* MULTITHREADING
+* Each thread paints a slab of the output along the last dimension, with
+* the spheres that reach into it. The spheres are sorted by the last
+* coordinate of their center, so a thread finds them with two binary
+* searches.
+*
+* MEMORY
+* The distance transform is computed in place in the buffer of the output,
+* the spheres are read from it, and the squared radii and then the
+* thickness are written into it. The list of the spheres is the only other
+* memory.
+*
+* USAGE TIPS
+* Voxels with the value GetBackgroundValue() of the input are background,
+* all others are foreground. The squared distances are stored in the pixel
+* type of TOutputImage. The squared radii are computed in physical units if
+* UseSpacing is on, the default, and the thickness is then in physical
+* units as well. Integer pixel types truncate the squared distances, so
+* they need integer spacings or UseSpacing off, and the thickness is
+* rounded. An image without background has no thickness.
+*
+* \ingroup ImageFeatureExtraction
+*
+*/
+
+template <
+  class TInputImage, class TOutputImage,
+        unsigned char MinimalSpacingPrecision=3,
+        class TAccumulator=typename TOutputImage::PixelType >
+class ITK_EXPORT LocalThicknessImageFilter :
+    public ImageToImageFilter<TInputImage,TOutputImage>
+{
+public:
+  /** Standard class typedefs. */
+  typedef LocalThicknessImageFilter Self;
+  typedef ImageToImageFilter<TInputImage,TOutputImage> Superclass;
+  typedef SmartPointer<Self> Pointer;
+  typedef SmartPointer<const Self> ConstPointer;
+
+  /** Method for creation through the object factory */
+  itkNewMacro(Self);
+
+  /** Run-time type information (and related methods). */
+  itkTypeMacro(LocalThicknessImageFilter, ImageToImageFilter);
+
+  /** Image dimension. */
+  itkStaticConstMacro(ImageDimension, unsigned int, TInputImage::ImageDimension);
+
+  /** Types and pointer types for the images. */
+  typedef TInputImage InputImageType;
+  typedef TOutputImage OutputImageType;
+  typedef typename InputImageType::PixelType InputPixelType;
+  typedef typename OutputImageType::PixelType OutputPixelType;
+  typedef typename OutputImageType::Pointer OutputImagePointer;
+  typedef typename OutputImageType::RegionType RegionType;
+  typedef typename OutputImageType::IndexType IndexType;
+
+  /** The distance transform. It stores the squared distances in the
+   * output pixel type. */
+  typedef GeneralizedDistanceTransformImageFilter<TOutputImage, TOutputImage,
+          TOutputImage, MinimalSpacingPrecision, TAccumulator> DistanceFilterType;
+
+  /** A sphere: the voxels x with |x - Center|^2 < SquaredRadius. */
+  struct SphereType
+  {
+    IndexType Center;
+    OutputPixelType SquaredRadius;
+  };
+  typedef std::vector<SphereType> SphereContainerType;
+
+  /** Set/Get the value of the background voxels of the input. Default is
+   * InputPixelType(). */
+  itkSetMacro(BackgroundValue, InputPixelType);
+  itkGetConstReferenceMacro(BackgroundValue, InputPixelType);
+
+  /** Set/Get wether spacing should be used or not. */
+  itkGetMacro(UseSpacing, bool);
+  itkSetMacro(UseSpacing, bool);
+  itkBooleanMacro(UseSpacing);
+
+  /** Set/Get wether only the ridge of the distance transform is used for
+   * the spheres. Default is true. */
+  itkGetMacro(UseRidge, bool);
+  itkSetMacro(UseRidge, bool);
+  itkBooleanMacro(UseRidge);
+
+  /** Number of spheres painted in the last update. */
+  itkGetConstMacro(NumberOfSpheres, unsigned long);
+
+protected:
+  LocalThicknessImageFilter();
+  virtual ~LocalThicknessImageFilter() {};
+  void PrintSelf(std::ostream& os, Indent indent) const;
+
+  /** The whole input is needed. */
+  void GenerateInputRequestedRegion();
+
+  /** The whole output will be produced regardless of the region requested. */
+  void EnlargeOutputRequestedRegion(DataObject *itkNotUsed(output));
+
+  /** Compute the thickness. */
+  void GenerateData();
+
+  /** Collect the spheres from the squared distances in the buffer of the
+   * output. Helper function for GenerateData() */
+  void ComputeSpheres(SphereContainerType &spheres) const;
+
+  /** The squared radii of the spheres, and for each of them the squared
+   * radius that the sphere of a neighbor must exceed to contain all its
+   * voxels, by class of the neighbor. */
+  typedef std::set<OutputPixelType> SquaredRadiusSetType;
+  typedef std::map<OutputPixelType, std::vector<double> > EnclosingSquaredRadiusMapType;
+
+  /** Compute the squared radii that contain the spheres of squaredRadii.
+   * Helper function for ComputeSpheres() */
+  void ComputeEnclosingSquaredRadii(const SquaredRadiusSetType &squaredRadii,
+      EnclosingSquaredRadiusMapType &enclosingSquaredRadii) const;
+
+  /** Internal structure used for passing the filter, the spheres and the
+   * spacing to the threads. Reach is the largest number of voxels a sphere
+   * reaches from its center along the last dimension. */
+  struct PaintThreadStruct
+  {
+    Pointer Filter;
+    const SphereContainerType *Spheres;
+    FixedArray<double, ImageDimension> Step;
+    long Reach;
+  };
+
+  /** Static function used as a "callback" by the MultiThreader. Each thread
+   * paints a slab of the output. */
+  static ITK_THREAD_RETURN_TYPE PaintThreaderCallback(void *arg);
+
+  /** Paint the spheres into the slab [slabBegin, slabEnd) along the last
+   * dimension: Each voxel gets the largest squared radius of the spheres
+   * that contain it. */
+  void ThreadedPaintSpheres(const PaintThreadStruct &str, long slabBegin,
+      long slabEnd);
+
+  /** Order of the spheres by the last coordinate of their centers. */
+  struct SphereLess
+  {
+    bool operator()(const SphereType &a, const SphereType &b) const
+      { return a.Center[ImageDimension - 1] < b.Center[ImageDimension - 1]; }
+  };
+
+  /** Order of the voxels by distance, for ComputeEnclosingSquaredRadii(). */
+  struct VoxelDistanceLess
+  {
+    template < class TVoxel >
+    bool operator()(const TVoxel &a, const TVoxel &b) const
+      { return a.first < b.first; }
+  };
+
+private:
+  LocalThicknessImageFilter(const Self&); //purposely not implemented
+  void operator=(const Self&); //purposely not implemented
+
+  InputPixelType m_BackgroundValue;
+  bool m_UseSpacing;
+  bool m_UseRidge;
+  unsigned long m_NumberOfSpheres;
+
+}; // end of LocalThicknessImageFilter class
+
+} //end namespace itk
+
+
+#ifndef ITK_MANUAL_INSTANTIATION
+#include "itkLocalThicknessImageFilter.txx"
+#endif
+
+#endif
@@ -0,0 +1,461 @@
+#ifndef __itkLocalThicknessImageFilter_txx
+#define __itkLocalThicknessImageFilter_txx
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <vector>
+
+#include "itkLocalThicknessImageFilter.h"
+#include "itkImageRegionConstIterator.h"
+#include "itkImageRegionConstIteratorWithIndex.h"
+#include "itkImageRegionIterator.h"
+
+namespace itk
+{
+
+
+/**
+ *    Constructor
+ */
+template < class TInputImage, class TOutputImage, unsigned char MinimalSpacingPrecision, class TAccumulator >
+LocalThicknessImageFilter< TInputImage, TOutputImage, MinimalSpacingPrecision, TAccumulator >
+::LocalThicknessImageFilter()
+{
+  m_BackgroundValue = InputPixelType();
+  m_UseSpacing = true;
+  m_UseRidge = true;
+  m_NumberOfSpheres = 0;
+}
+
+/**
+ * The whole input is needed
+ */
+template < class TInputImage, class TOutputImage, unsigned char MinimalSpacingPrecision, class TAccumulator >
+void
+LocalThicknessImageFilter< TInputImage, TOutputImage, MinimalSpacingPrecision, TAccumulator >
+::GenerateInputRequestedRegion()
+{
+  Superclass::GenerateInputRequestedRegion();
+
+  DataObject *input = this->ProcessObject::GetInput(0);
+  if (input)
+    input->SetRequestedRegionToLargestPossibleRegion();
+}
+
+/**
+ * The whole output will be produced regardless of the region requested.
+ */
+template < class TInputImage, class TOutputImage, unsigned char MinimalSpacingPrecision, class TAccumulator >
+void
+LocalThicknessImageFilter< TInputImage, TOutputImage, MinimalSpacingPrecision, TAccumulator >
+::EnlargeOutputRequestedRegion(DataObject *)
+{
+  this->GetOutput()->SetRequestedRegion(this->GetOutput()->GetLargestPossibleRegion());
+}
+
+/**
+ *  Compute the thickness
+ */
+template < class TInputImage, class TOutputImage, unsigned char MinimalSpacingPrecision, class TAccumulator >
+void
+LocalThicknessImageFilter< TInputImage, TOutputImage, MinimalSpacingPrecision, TAccumulator >
+::GenerateData()
+{
+  const InputImageType *input = this->GetInput();
+  OutputImageType *output = this->GetOutput();
+  output->SetBufferedRegion(output->GetRequestedRegion());
+  output->Allocate();
+
+  const RegionType region = output->GetBufferedRegion();
+  const unsigned long numberOfPixels = region.GetNumberOfPixels();
+  OutputPixelType *buffer = output->GetBufferPointer();
+
+  // The indicator of the background: The foreground voxels are at distance
+  // 0 of the background voxels.
+  ImageRegionConstIterator<InputImageType> inputIt(input, region);
+  ImageRegionIterator<OutputImageType> outputIt(output, region);
+  for (inputIt.GoToBegin(), outputIt.GoToBegin(); !inputIt.IsAtEnd(); ++inputIt, ++outputIt)
+    outputIt.Set(inputIt.Get() == m_BackgroundValue ?
+        OutputPixelType() : DistanceFilterType::GetMaximumApexHeight());
+
+  // The transforms see the output buffer as an image of their own, so that
+  // they don't update this filter
+  OutputImagePointer distance = OutputImageType::New();
+  distance->CopyInformation(output);
+  distance->SetRegions(region);
+  distance->GetPixelContainer()->SetImportPointer(buffer, numberOfPixels, false);
+
+  // The squared distances to the background, in place
+  {
+    typename DistanceFilterType::Pointer filter = DistanceFilterType::New();
+    filter->SetInput1(distance);
+    filter->SetCreateVoronoiMap(false);
+    filter->SetUseSpacing(m_UseSpacing);
+    filter->SetNumberOfThreads(this->GetNumberOfThreads());
+    filter->SetDistanceImportPointer(buffer);
+    filter->Update();
+  }
+
+  // The spheres, sorted for the threads
+  SphereContainerType spheres;
+  this->ComputeSpheres(spheres);
+  m_NumberOfSpheres = spheres.size();
+  std::sort(spheres.begin(), spheres.end(), SphereLess());
+
+  const unsigned int last = ImageDimension - 1;
+  PaintThreadStruct str;
+  str.Filter = this;
+  str.Spheres = &spheres;
+  for (unsigned int d = 0; d < ImageDimension; ++d)
+    str.Step[d] = m_UseSpacing ? static_cast<double>(output->GetSpacing()[d]) : 1.0;
+  OutputPixelType largestSquaredRadius = OutputPixelType();
+  for (typename SphereContainerType::const_iterator it = spheres.begin(); it != spheres.end(); ++it)
+    if (largestSquaredRadius < it->SquaredRadius)
+      largestSquaredRadius = it->SquaredRadius;
+  str.Reach = static_cast<long>(
+      std::sqrt(static_cast<double>(largestSquaredRadius)) / str.Step[last]) + 1;
+
+  // The squared radii are painted over zeros
+  std::fill(buffer, buffer + numberOfPixels, OutputPixelType());
+  const int numberOfThreads = std::max(1, std::min(this->GetNumberOfThreads(),
+        static_cast<int>(region.GetSize()[last])));
+  this->GetMultiThreader()->SetNumberOfThreads(numberOfThreads);
+  this->GetMultiThreader()->SetSingleMethod(&Self::PaintThreaderCallback, &str);
+  this->GetMultiThreader()->SingleMethodExecute();
+
+  // Voxels inside a sphere get its diameter. Integer thicknesses are
+  // rounded.
+  const double rounding = std::numeric_limits<OutputPixelType>::is_integer ? 0.5 : 0.0;
+  for (unsigned long i = 0; i < numberOfPixels; ++i)
+  {
+    if (OutputPixelType() < buffer[i])
+      buffer[i] = static_cast<OutputPixelType>(
+          2.0 * std::sqrt(static_cast<double>(buffer[i])) + rounding);
+  }
+}
+
+/**
+ * Paint the slab of a thread
+ */
+template < class TInputImage, class TOutputImage, unsigned char MinimalSpacingPrecision, class TAccumulator >
+ITK_THREAD_RETURN_TYPE
+LocalThicknessImageFilter< TInputImage, TOutputImage, MinimalSpacingPrecision, TAccumulator >
+::PaintThreaderCallback(void *arg)
+{
+  MultiThreader::ThreadInfoStruct *info =
+    static_cast<MultiThreader::ThreadInfoStruct *>(arg);
+  PaintThreadStruct *str = static_cast<PaintThreadStruct *>(info->UserData);
+
+  const unsigned int threadId = info->ThreadID;
+  const unsigned int threadCount = info->NumberOfThreads;
+
+  const RegionType &region = str->Filter->GetOutput()->GetBufferedRegion();
+  const long first = region.GetIndex()[ImageDimension - 1];
+  const unsigned long size = region.GetSize()[ImageDimension - 1];
+  str->Filter->ThreadedPaintSpheres(*str,
+      first + static_cast<long>(size * threadId / threadCount),
+      first + static_cast<long>(size * (threadId + 1) / threadCount));
+
+  return ITK_THREAD_RETURN_VALUE;
+}
+
+/**
+ * Paint the spheres into a slab
+ */
+template < class TInputImage, class TOutputImage, unsigned char MinimalSpacingPrecision, class TAccumulator >
+void
+LocalThicknessImageFilter< TInputImage, TOutputImage, MinimalSpacingPrecision, TAccumulator >
+::ThreadedPaintSpheres(const PaintThreadStruct &str, long slabBegin, long slabEnd)
+{
+  OutputImageType *output = this->GetOutput();
+  const RegionType &region = output->GetBufferedRegion();
+  OutputPixelType *buffer = output->GetBufferPointer();
+  const typename OutputImageType::OffsetValueType *offsetTable = output->GetOffsetTable();
+  const unsigned int last = ImageDimension - 1;
+  const FixedArray<double, ImageDimension> &step = str.Step;
+
+  // The part of the image the thread writes to, the upper bounds included
+  const IndexType &first = region.GetIndex();
+  IndexType begin = first;
+  IndexType end;
+  for (unsigned int d = 0; d < ImageDimension; ++d)
+    end[d] = first[d] + static_cast<long>(region.GetSize()[d]) - 1;
+  begin[last] = slabBegin;
+  end[last] = slabEnd - 1;
+
+  // The spheres whose centers are close enough to reach into the slab
+  SphereType bound;
+  bound.Center[last] = slabBegin - str.Reach;
+  typename SphereContainerType::const_iterator sphere =
+    std::lower_bound(str.Spheres->begin(), str.Spheres->end(), bound, SphereLess());
+  bound.Center[last] = slabEnd + str.Reach;
+  const typename SphereContainerType::const_iterator lastSphere =
+    std::lower_bound(sphere, str.Spheres->end(), bound, SphereLess());
+
+  IndexType low;
+  IndexType high;
+  IndexType row;
+  for (; sphere != lastSphere; ++sphere)
+  {
+    // The scanlines along dimension 0 that may cross the sphere
+    const IndexType &center = sphere->Center;
+    const double squaredRadius = static_cast<double>(sphere->SquaredRadius);
+    bool empty = false;
+    for (unsigned int d = 1; d < ImageDimension; ++d)
+    {
+      const long reach = static_cast<long>(std::sqrt(squaredRadius) / step[d]) + 1;
+      low[d] = std::max(begin[d], center[d] - reach);
+      high[d] = std::min(end[d], center[d] + reach);
+      empty = empty || low[d] > high[d];
+    }
+    if (empty)
+      continue;
+
+    row = low;
+    for (;;)
+    {
+      // The voxels of the scanline in the sphere are the ones closer than
+      // k steps to the center along dimension 0
+      double residual = squaredRadius;
+      typename OutputImageType::OffsetValueType offset = 0;
+      for (unsigned int d = 1; d < ImageDimension; ++d)
+      {
+        const double distance = (row[d] - center[d]) * step[d];
+        residual -= distance * distance;
+        offset += (row[d] - first[d]) * offsetTable[d];
+      }
+      if (residual > 0.0)
+      {
+        long k = static_cast<long>(std::sqrt(residual) / step[0]);
+        while (k >= 0 && (k * step[0]) * (k * step[0]) >= residual)
+          --k;
+        while (((k + 1) * step[0]) * ((k + 1) * step[0]) < residual)
+          ++k;
+        const long from = std::max(begin[0], center[0] - k);
+        const long to = std::min(end[0], center[0] + k);
+        if (from <= to)
+        {
+          OutputPixelType *pixel = buffer + offset + (from - first[0]);
+          for (long i = from; i <= to; ++i, ++pixel)
+            if (*pixel < sphere->SquaredRadius)
+              *pixel = sphere->SquaredRadius;
+        }
+      }
+
+      // Next scanline, dimension 1 varying fastest
+      unsigned int d = 1;
+      for (; d < ImageDimension; ++d)
+      {
+        if (row[d] < high[d])
+        {
+          ++row[d];
+          break;
+        }
+        row[d] = low[d];
+      }
+      if (d >= ImageDimension)
+        break;
+    }
+  }
+}
+
+/**
+ * Squared radii of the smallest spheres of the neighbors that contain the
+ * voxels of a sphere
+ */
+template < class TInputImage, class TOutputImage, unsigned char MinimalSpacingPrecision, class TAccumulator >
+void
+LocalThicknessImageFilter< TInputImage, TOutputImage, MinimalSpacingPrecision, TAccumulator >
+::ComputeEnclosingSquaredRadii(const SquaredRadiusSetType &squaredRadii,
+    EnclosingSquaredRadiusMapType &enclosingSquaredRadii) const
+{
+  enclosingSquaredRadii.clear();
+  if (squaredRadii.empty())
+    return;
+
+  double step[ImageDimension];
+  for (unsigned int d = 0; d < ImageDimension; ++d)
+    step[d] = m_UseSpacing ? static_cast<double>(this->GetOutput()->GetSpacing()[d]) : 1.0;
+
+  // The grid is symmetric to each axis, so the voxel of a sphere farthest
+  // from a neighbor can be found among the voxels with nonnegative
+  // coordinates, the neighbor being mirrored to nonpositive ones. The
+  // voxels are sorted by their distance to the center.
+  const double largestSquaredRadius = static_cast<double>(*squaredRadii.rbegin());
+  std::vector< std::pair<double, FixedArray<double, ImageDimension> > > voxels;
+  FixedArray<double, ImageDimension> voxel;
+  voxel.Fill(0.0);
+  for (;;)
+  {
+    double squaredDistance = 0.0;
+    for (unsigned int d = 0; d < ImageDimension; ++d)
+      squaredDistance += voxel[d] * voxel[d];
+    if (squaredDistance < largestSquaredRadius)
+      voxels.push_back(std::make_pair(squaredDistance, voxel));
+
+    // Next voxel, dimension 0 varying fastest, up to the largest radius
+    unsigned int d = 0;
+    for (; d < ImageDimension; ++d)
+    {
+      voxel[d] += step[d];
+      if (voxel[d] * voxel[d] < largestSquaredRadius)
+        break;
+      voxel[d] = 0.0;
+    }
+    if (d == ImageDimension)
+      break;
+  }
+  std::sort(voxels.begin(), voxels.end(), VoxelDistanceLess());
+
+  // Neighbors are classified by the dimensions along which they are
+  // displaced, bit d of the class being set for dimension d. For a neighbor
+  // displaced by -step[d] along these dimensions, the squared distance of a
+  // voxel is its squared distance to the center plus
+  // sum_d 2 * voxel[d] * step[d] + step[d]^2.
+  const unsigned int numberOfClasses = 1u << ImageDimension;
+  std::vector<double> farthest(numberOfClasses, 0.0);
+  typename std::vector< std::pair<double, FixedArray<double, ImageDimension> > >::const_iterator
+    voxelIt = voxels.begin();
+  for (typename SquaredRadiusSetType::const_iterator radiusIt = squaredRadii.begin();
+      radiusIt != squaredRadii.end(); ++radiusIt)
+  {
+    const double squaredRadius = static_cast<double>(*radiusIt);
+    for (; voxelIt != voxels.end() && voxelIt->first < squaredRadius; ++voxelIt)
+    {
+      for (unsigned int c = 1; c < numberOfClasses; ++c)
+      {
+        double squaredDistance = voxelIt->first;
+        for (unsigned int d = 0; d < ImageDimension; ++d)
+          if (c & (1u << d))
+            squaredDistance += 2.0 * voxelIt->second[d] * step[d] + step[d] * step[d];
+        farthest[c] = std::max(farthest[c], squaredDistance);
+      }
+    }
+    enclosingSquaredRadii[*radiusIt] = farthest;
+  }
+}
+
+/**
+ * Collect the spheres of the ridge, or of all foreground voxels
+ */
+template < class TInputImage, class TOutputImage, unsigned char MinimalSpacingPrecision, class TAccumulator >
+void
+LocalThicknessImageFilter< TInputImage, TOutputImage, MinimalSpacingPrecision, TAccumulator >
+::ComputeSpheres(SphereContainerType &spheres) const
+{
+  const OutputImageType *output = this->GetOutput();
+  const RegionType &region = output->GetBufferedRegion();
+  const OutputPixelType *buffer = output->GetBufferPointer();
+  const unsigned long numberOfPixels = region.GetNumberOfPixels();
+  const OutputPixelType background = DistanceFilterType::GetMaximumApexHeight();
+
+  // The squared radii that occur, and what a neighbor needs to contain
+  // their spheres
+  EnclosingSquaredRadiusMapType enclosingSquaredRadii;
+  if (m_UseRidge)
+  {
+    SquaredRadiusSetType squaredRadii;
+    for (unsigned long i = 0; i < numberOfPixels; ++i)
+      if (OutputPixelType() < buffer[i] && buffer[i] < background)
+        squaredRadii.insert(buffer[i]);
+    this->ComputeEnclosingSquaredRadii(squaredRadii, enclosingSquaredRadii);
+  }
+
+  // The neighbors of a voxel: their index relative to the voxel, their
+  // offset in the buffer and their class, see
+  // ComputeEnclosingSquaredRadii()
+  typedef typename OutputImageType::OffsetType OffsetType;
+  std::vector<OffsetType> neighbors;
+  std::vector<typename OutputImageType::OffsetValueType> neighborOffsets;
+  std::vector<unsigned int> neighborClasses;
+  OffsetType neighbor;
+  neighbor.Fill(-1);
+  for (;;)
+  {
+    typename OutputImageType::OffsetValueType offset = 0;
+    unsigned int neighborClass = 0;
+    for (unsigned int d = 0; d < ImageDimension; ++d)
+    {
+      offset += neighbor[d] * output->GetOffsetTable()[d];
+      if (neighbor[d] != 0)
+        neighborClass |= 1u << d;
+    }
+    if (neighborClass != 0)
+    {
+      neighbors.push_back(neighbor);
+      neighborOffsets.push_back(offset);
+      neighborClasses.push_back(neighborClass);
+    }
+
+    unsigned int d = 0;
+    while (d < ImageDimension && neighbor[d] == 1)
+      neighbor[d++] = -1;
+    if (d == ImageDimension)
+      break;
+    ++neighbor[d];
+  }
+
+  const IndexType &first = region.GetIndex();
+  IndexType last;
+  for (unsigned int d = 0; d < ImageDimension; ++d)
+    last[d] = first[d] + static_cast<long>(region.GetSize()[d]) - 1;
+
+  SphereType sphere;
+  ImageRegionConstIteratorWithIndex<OutputImageType> it(output, region);
+  const OutputPixelType *center = buffer;
+  for (it.GoToBegin(); !it.IsAtEnd(); ++it, ++center)
+  {
+    // Background voxels and voxels without a distance are no spheres
+    const OutputPixelType squaredRadius = *center;
+    if (!(OutputPixelType() < squaredRadius) || !(squaredRadius < background))
+      continue;
+
+    if (m_UseRidge)
+    {
+      // Are all voxels of the sphere inside the sphere of a neighbor?
+      const IndexType &index = it.GetIndex();
+      bool border = false;
+      for (unsigned int d = 0; d < ImageDimension; ++d)
+        border = border || index[d] == first[d] || index[d] == last[d];
+
+      const std::vector<double> &enclosing = enclosingSquaredRadii.find(squaredRadius)->second;
+      bool contained = false;
+      for (unsigned int n = 0; n < neighbors.size() && !contained; ++n)
+      {
+        bool inside = true;
+        for (unsigned int d = 0; d < ImageDimension && border; ++d)
+          inside = inside && index[d] + neighbors[n][d] >= first[d] &&
+            index[d] + neighbors[n][d] <= last[d];
+        if (!inside)
+          continue;
+        const OutputPixelType value = center[neighborOffsets[n]];
+        contained = value < background &&
+          static_cast<double>(value) > enclosing[neighborClasses[n]];
+      }
+      if (contained)
+        continue;
+    }
+
+    sphere.Center = it.GetIndex();
+    sphere.SquaredRadius = squaredRadius;
+    spheres.push_back(sphere);
+  }
+}
+
+/**
+ *  Print Self
+ */
+template < class TInputImage, class TOutputImage, unsigned char MinimalSpacingPrecision, class TAccumulator >
+void
+LocalThicknessImageFilter< TInputImage, TOutputImage, MinimalSpacingPrecision, TAccumulator >
+::PrintSelf(std::ostream& os, Indent indent) const
+{
+  Superclass::PrintSelf(os,indent);
+  os << indent << "BackgroundValue: " << m_BackgroundValue << std::endl;
+  os << indent << "UseSpacing: " << m_UseSpacing << std::endl;
+  os << indent << "UseRidge: " << m_UseRidge << std::endl;
+  os << indent << "NumberOfSpheres: " << m_NumberOfSpheres << std::endl;
+}
+} // end namespace itk
+#endif
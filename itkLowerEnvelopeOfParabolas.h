@@ -21,6 +21,17 @@ namespace itk
  * 
  * The lower envelope of the parabolas can be sampled uniformly at consecutive
  * index positions.
+ *
+ * PERIODIC LINES
+ * If the parabolas describe one period of a periodic line, the envelope can
+ * be sampled as if the parabolas were repeated to both sides with
+ * periodicSample(). The copies are not stored: For a line of length n, the
+ * closest copy of a parabola is at most n away, so the periodic envelope at
+ * x is the minimum of the envelope at x-n, x, and x+n.
+ *
+ * STRIDED SAMPLING
+ * The envelope is exact at every abscissa index, so it can be sampled at
+ * every k-th index only, with stridedSample() or periodicSample().
  * 
  * CONSTRAINTS
  * Signed integer types are required for the abscissa index and apex height.
@@ -110,8 +121,10 @@ class LowerEnvelopeOfParabolas
     class Iterator
     {
       public:
-        /** Create an iterator that walks [from, to). */
-        Iterator(const Parabolas& envelope, const AbscissaIndexType& from, const AbscissaIndexType &to);
+        /** Create an iterator that walks the indices from + k * stride for
+         * k in [0, steps). */
+        Iterator(const Parabolas& envelope, const AbscissaIndexType& from,
+            const long &steps, const long &stride = 1);
 
         /** Get the current abscissa index. */
         const AbscissaIndexType& currentAbscissaIndex();
@@ -128,10 +141,89 @@ class LowerEnvelopeOfParabolas
       private:
         const Parabolas &envelope;
         AbscissaIndexType currentIndex;
-        AbscissaIndexType end;
+        AbscissaIndexType stride;
+        long remainingSteps;
         typename Parabolas::size_type currentParabolaNumber;
     };
 
+    /** An output iterator that discards everything. Used for the Voronoi map
+     * if only the envelope values are sampled. */
+    struct NullIterator
+    {
+      void Set(const LabelType &) {}
+      NullIterator& operator++() { return *this; }
+    };
+
+    /** Evaluate the lower envelope at the indices from + k * stride for k in
+     * [0, steps). If period is not 0, the parabolas are repeated with that
+     * period to both sides. This is exact as long as the parabolas and the
+     * sampled indices lie within the same period: The closest copy of a
+     * parabola is then at most one period away, so the periodic envelope at
+     * x is the minimum of the envelope at x - period, x and x + period. */
+    template <bool WriteVoronoiMap, class ValueIt, class VoronoiIt>
+    void sample(const AbscissaIndexType &from, const long &steps,
+        const long &stride, const long &period,
+        ValueIt &valueIt, VoronoiIt &voronoiIt)
+    {
+      // Insert a sentinel parabola to define the right end of the dominance
+      // region of the last parabola in the envelope
+      envelope.push_back(
+          ParabolaRegion(Parabola(maxAbscissa, maxApexHeight), maxAbscissa)
+          );
+
+      if (period == 0)
+      {
+        for (Iterator it(envelope, from, steps, stride); !it.IsAtEnd(); ++it)
+        {
+          valueIt.Set(value(it.currentParabola(), it.currentAbscissaIndex()));
+          if (WriteVoronoiMap)
+          {
+            voronoiIt.Set(it.currentParabola().l);
+            ++voronoiIt;
+          }
+          ++valueIt;
+        }
+      }
+      else
+      {
+        // The envelope of the copies shifted by one period to the right is
+        // the envelope sampled one period to the left and vice versa.
+        Iterator it(envelope, from, steps, stride);
+        Iterator leftIt(envelope, from - period, steps, stride);
+        Iterator rightIt(envelope, from + period, steps, stride);
+        for (; !it.IsAtEnd(); ++it, ++leftIt, ++rightIt)
+        {
+          const Parabola *p = &it.currentParabola();
+          ApexHeightType y = value(*p, it.currentAbscissaIndex());
+
+          const ApexHeightType leftY = value(leftIt.currentParabola(), leftIt.currentAbscissaIndex());
+          if (leftY < y)
+          {
+            y = leftY;
+            p = &leftIt.currentParabola();
+          }
+
+          const ApexHeightType rightY = value(rightIt.currentParabola(), rightIt.currentAbscissaIndex());
+          if (rightY < y)
+          {
+            y = rightY;
+            p = &rightIt.currentParabola();
+          }
+
+          valueIt.Set(y);
+          if (WriteVoronoiMap)
+          {
+            voronoiIt.Set(p->l);
+            ++voronoiIt;
+          }
+          ++valueIt;
+        }
+      }
+
+      // Remove the back sentinel again
+      envelope.pop_back();
+    }
+
     /** Member variables. */
     const SpacingType s;
     Parabolas envelope;
@@ -151,6 +243,32 @@ class LowerEnvelopeOfParabolas
     LowerEnvelopeOfParabolas(const typename Parabolas::size_type &expectedNumberOfParabolas,
         const SpacingType &s=1);
 
+    /** Remove all parabolas. The memory is kept, so an envelope can be
+     * reused for several scanlines without allocations. */
+    void clear();
+
+    /** Number of parabolas in the envelope. */
+    typename Parabolas::size_type numberOfParabolas() const
+    {
+      // The front sentinel is not counted
+      return envelope.size() - 1;
+    }
+
+    /** Get the n-th parabola of the envelope from the left and the abscissa
+     * index after which it is minimal. It is minimal up to and including the
+     * index after which the next one is. This allows to store an envelope
+     * and evaluate it at single indices later. */
+    void getParabola(const typename Parabolas::size_type &n,
+        AbscissaIndexType &i, ApexHeightType &y, LabelType &l,
+        AbscissaIndexType &dominantFrom) const
+    {
+      const ParabolaRegion &region = envelope[n + 1];
+      i = region.p.i;
+      y = region.p.y;
+      l = region.p.l;
+      dominantFrom = region.dominantFrom;
+    }
+
     /** Add a new parabola.
      * The apex abscissa has to be larger than those already in the envelope.
      */
@@ -169,23 +287,7 @@ class LowerEnvelopeOfParabolas
       // Voronoi maps was enabled.
       assert(CreateVoronoiMap == true);
 
-      // Insert a sentinel parabola to define the right end of the dominance
-      // region of the last parabola in the envelope
-      envelope.push_back(
-          ParabolaRegion(Parabola(maxAbscissa, maxApexHeight), maxAbscissa)
-          );
-
-      for (Iterator it(envelope, from, from + steps); !it.IsAtEnd(); ++it)
-      {
-        valueIt.Set(value(it.currentParabola(), it.currentAbscissaIndex()));
-        voronoiIt.Set(it.currentParabola().l);
-
-        ++valueIt;
-        ++voronoiIt;
-      }
-
-      // Remove the back sentinel again
-      envelope.pop_back();
+      sample<true>(from, steps, 1, 0, valueIt, voronoiIt);
     }
 
     /** Evaluate the lower envelope of parabolas at consecutive indices
@@ -195,21 +297,64 @@ class LowerEnvelopeOfParabolas
     void uniformSample(const AbscissaIndexType &from, const long &steps,
         ValueIt &valueIt)
     {
-      // Insert a sentinel parabola to define the right end of the dominance
-      // region of the last parabola in the envelope
-      envelope.push_back(
-          ParabolaRegion(Parabola(maxAbscissa, maxApexHeight), maxAbscissa)
-          );
+      NullIterator voronoiIt;
+      sample<false>(from, steps, 1, 0, valueIt, voronoiIt);
+    }
 
-      for (Iterator it(envelope, from, from + steps); !it.IsAtEnd(); ++it)
-      {
-        valueIt.Set(value(it.currentParabola(), it.currentAbscissaIndex()));
+    /** Evaluate the lower envelope of parabolas at every stride-th index
+     * from + k * stride, k in [0, steps).
+     * The output iterators are incremented once per sample.
+     * Writes to the Voronoi map, too. */
+    template <class ValueIt, class VoronoiIt>
+    void stridedSample(const AbscissaIndexType &from, const long &steps,
+        const long &stride, ValueIt &valueIt, VoronoiIt &voronoiIt)
+    {
+      assert(CreateVoronoiMap == true);
 
-        ++valueIt;
-      }
+      sample<true>(from, steps, stride, 0, valueIt, voronoiIt);
+    }
 
-      // Remove the back sentinel again
-      envelope.pop_back();
+    /** Evaluate the lower envelope of parabolas at every stride-th index
+     * from + k * stride, k in [0, steps).
+     * The output iterator is incremented once per sample. */
+    template <class ValueIt>
+    void stridedSample(const AbscissaIndexType &from, const long &steps,
+        const long &stride, ValueIt &valueIt)
+    {
+      NullIterator voronoiIt;
+      sample<false>(from, steps, stride, 0, valueIt, voronoiIt);
+    }
+
+    /** Evaluate the lower envelope of parabolas at the indices
+     * from + k * stride, k in [0, steps), of a periodic line. The parabolas
+     * added to the envelope and the sampled indices must lie in the same
+     * period of length period.
+     * The output iterators are incremented once per sample.
+     * Writes to the Voronoi map, too. */
+    template <class ValueIt, class VoronoiIt>
+    void periodicSample(const AbscissaIndexType &from, const long &steps,
+        const long &stride, const long &period,
+        ValueIt &valueIt, VoronoiIt &voronoiIt)
+    {
+      assert(CreateVoronoiMap == true);
+      assert(period > 0);
+
+      sample<true>(from, steps, stride, period, valueIt, voronoiIt);
+    }
+
+    /** Evaluate the lower envelope of parabolas at the indices
+     * from + k * stride, k in [0, steps), of a periodic line. The parabolas
+     * added to the envelope and the sampled indices must lie in the same
+     * period of length period.
+     * The output iterator is incremented once per sample. */
+    template <class ValueIt>
+    void periodicSample(const AbscissaIndexType &from, const long &steps,
+        const long &stride, const long &period, ValueIt &valueIt)
+    {
+      assert(period > 0);
+
+      NullIterator voronoiIt;
+      sample<false>(from, steps, stride, period, valueIt, voronoiIt);
     }
 }; // end of LowerEnvelopeOfParabolas class
 
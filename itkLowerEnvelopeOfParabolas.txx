@@ -124,13 +124,17 @@ LowerEnvelopeOfParabolas< UseSpacing, SpacingType, MinimalSpacingPrecision,
                           CreateVoronoiMap, LabelType,
                           AbscissaIndexType, ApexHeightType >
 ::Iterator
-::Iterator(const Parabolas &_envelope, const AbscissaIndexType &_from, const AbscissaIndexType &_to)
-  : envelope(_envelope), currentIndex(_from), end(_to), currentParabolaNumber(0)
+::Iterator(const Parabolas &_envelope, const AbscissaIndexType &_from,
+    const long &_steps, const long &_stride)
+  : envelope(_envelope), currentIndex(_from), stride(_stride),
+    remainingSteps(_steps), currentParabolaNumber(0)
 {
   // The sampling interval has to be well-formed
+  assert(stride > 0);
+  assert(remainingSteps >= 0);
   assert(-maxAbscissa <= currentIndex);
-  assert(currentIndex <= end);
-  assert(end <= maxAbscissa);
+  assert(remainingSteps == 0 ||
+      currentIndex + (remainingSteps - 1) * stride <= maxAbscissa);
 
   // The envelope should contain a front and a back sentinel parabola. The
   // latter must dominate from maxAbscissa
@@ -193,7 +197,13 @@ LowerEnvelopeOfParabolas< UseSpacing, SpacingType, MinimalSpacingPrecision,
 ::Iterator
 ::operator++()
 {
-  ++currentIndex;
+  currentIndex += stride;
+  --remainingSteps;
+
+  // With a stride, the index behind the last sample may lie beyond the
+  // sentinel
+  if (remainingSteps == 0)
+    return *this;
 
   // Skip to the correct parabola.
   while (envelope[currentParabolaNumber + 1].dominantFrom < currentIndex)
@@ -220,7 +230,7 @@ LowerEnvelopeOfParabolas< UseSpacing, SpacingType, MinimalSpacingPrecision,
 ::Iterator
 ::IsAtEnd()
 {
-  return currentIndex == end;
+  return remainingSteps == 0;
 }
 
 //
@@ -273,8 +283,8 @@ LowerEnvelopeOfParabolas< UseSpacing, SpacingType, MinimalSpacingPrecision,
   else
     // If the user chose SpacingType = ApexHeightType = AbscissaIndexType,
     // there will be no casting involved.
-    // If an integer type is used, the computation can be off by at most -1.
-    i = ((q.i + p.i) + (q.y - p.y) / (q.i - p.i)) / 2;
+    i = (static_cast<SpacingType>(q.i + p.i) +
+        static_cast<SpacingType>(q.y - p.y) / static_cast<SpacingType>(q.i - p.i)) / 2;
 
   return clampToAbscissaIndices(i);
 }
@@ -296,9 +306,21 @@ LowerEnvelopeOfParabolas< UseSpacing, SpacingType, MinimalSpacingPrecision,
 ::clampToAbscissaIndices(const SpacingType &x)
 {
   // To compare without warnings, we need maxAbscissa in the type
-  // SpacingType.
+  // SpacingType. The conversion may round o up, e.g. for a 64 bit
+  // AbscissaIndexType and a double SpacingType. We therefore return
+  // maxAbscissa itself instead of a cast of o.
   const SpacingType o(maxAbscissa);
-  return static_cast<AbscissaIndexType>(x < -o ? -o : (x > o ? o : x));
+  if (!(x > -o))
+    return -maxAbscissa;
+  if (!(x < o))
+    return maxAbscissa;
+
+  // The cast rounds towards zero, but we need the largest index that is not
+  // larger than x.
+  AbscissaIndexType i = static_cast<AbscissaIndexType>(x);
+  if (static_cast<SpacingType>(i) > x)
+    --i;
+  return i;
 }
 
 
@@ -350,6 +372,23 @@ LowerEnvelopeOfParabolas< UseSpacing, SpacingType, MinimalSpacingPrecision,
         -maxAbscissa));
 }
 
+//
+// Remove all parabolas but the front sentinel
+//
+template < bool UseSpacing, class SpacingType, unsigned char MinimalSpacingPrecision,
+           bool CreateVoronoiMap, class LabelType,
+           class AbscissaIndexType, class ApexHeightType >
+void
+LowerEnvelopeOfParabolas< UseSpacing, SpacingType, MinimalSpacingPrecision,
+                          CreateVoronoiMap, LabelType,
+                          AbscissaIndexType, ApexHeightType >
+::clear()
+{
+  // The front sentinel is never removed by addParabola(). erase() doesn't
+  // release the capacity.
+  envelope.erase(envelope.begin() + 1, envelope.end());
+}
+
 //
 // Add a new parabola.
 //
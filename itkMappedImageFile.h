@@ -0,0 +1,167 @@
+#ifndef __itkMappedImageFile_h
+#define __itkMappedImageFile_h
+
+#include "itkObject.h"
+#include "itkImage.h"
+
+#include <string>
+#include <vector>
+
+namespace itk
+{
+
+/** \class AnalyzePixelTraits
+*
+* The Analyze 7.5 data type of a pixel type. The codes above 128 are the
+* unsigned types ITK's Analyze reader and writer use.
+*/
+template <class TPixel> struct AnalyzePixelTraits;
+template <> struct AnalyzePixelTraits<unsigned char> { enum { DataType = 2, IsInteger = 1 }; };
+template <> struct AnalyzePixelTraits<char> { enum { DataType = 130, IsInteger = 1 }; };
+template <> struct AnalyzePixelTraits<short> { enum { DataType = 4, IsInteger = 1 }; };
+template <> struct AnalyzePixelTraits<unsigned short> { enum { DataType = 132, IsInteger = 1 }; };
+template <> struct AnalyzePixelTraits<int> { enum { DataType = 8, IsInteger = 1 }; };
+template <> struct AnalyzePixelTraits<unsigned int> { enum { DataType = 136, IsInteger = 1 }; };
+template <> struct AnalyzePixelTraits<float> { enum { DataType = 16, IsInteger = 0 }; };
+template <> struct AnalyzePixelTraits<double> { enum { DataType = 64, IsInteger = 0 }; };
+
+/** \class MappedImageFile
+*
+* An image whose buffer is a memory mapped raw or Analyze 7.5 file.
+*
+* Reading a volume with itk::ImageFileReader copies the whole file into a
+* new buffer. MapForReading() maps the file instead and GetImage() returns
+* an image that uses the mapping as its buffer, so the pages are only read
+* when they are accessed, and only once. MapForWriting() creates a file of
+* the size of the image and maps it, so a filter can write its output
+* directly into the file, e.g. with
+* itk::GeneralizedDistanceTransformImageFilter::SetDistanceImportPointer().
+* Together, a transform goes from file to file without copies of the
+* volumes on the heap.
+*
+* FILE FORMATS
+* Files ending in .hdr or .img are Analyze 7.5 pairs, where the header is
+* stored in the .hdr file and the voxels in the .img file. Only headers in
+* the byte order of the machine can be mapped, since the voxels are used as
+* they are stored. Integer pixels are accepted if the data type of the file
+* has the size of the pixel type, like the unsigned short images of ITK's
+* Analyze writer for short pixels. All other files are raw voxels, see
+* MapRawForReading().
+*
+* LIFETIME
+* The image returned by GetImage() doesn't own its buffer. The
+* MappedImageFile must stay alive as long as the image is used. Close()
+* writes the voxels of a file mapped for writing back to the file and
+* releases the mapping and the buffer of the image.
+*
+* Input files are mapped copy-on-write. Writing to the image of an input
+* file doesn't change the file, the written pages are copied on the heap.
+*
+* On systems without mmap(), the files are read into memory and the output
+* files are written by Close().
+*
+* \ingroup ImageFeatureExtraction
+*
+*/
+
+template < class TImage >
+class ITK_EXPORT MappedImageFile : public Object
+{
+public:
+  /** Standard class typedefs. */
+  typedef MappedImageFile Self;
+  typedef Object Superclass;
+  typedef SmartPointer<Self> Pointer;
+  typedef SmartPointer<const Self> ConstPointer;
+
+  /** Method for creation through the object factory */
+  itkNewMacro(Self);
+
+  /** Run-time type information (and related methods). */
+  itkTypeMacro(MappedImageFile, Object);
+
+  /** Image dimension. */
+  itkStaticConstMacro(ImageDimension, unsigned int, TImage::ImageDimension);
+
+  /** Types and pointer types for the image. */
+  typedef TImage ImageType;
+  typedef typename ImageType::Pointer ImagePointer;
+  typedef typename ImageType::PixelType PixelType;
+  typedef typename ImageType::SizeType SizeType;
+  typedef typename ImageType::RegionType RegionType;
+  typedef typename ImageType::SpacingType SpacingType;
+
+  /** Map an Analyze 7.5 image for reading. */
+  void MapForReading(const char *fileName);
+
+  /** Map a raw image for reading. The voxels start after headerSize
+   * bytes. */
+  void MapRawForReading(const char *fileName, const SizeType &size,
+      const SpacingType &spacing, unsigned long headerSize = 0);
+
+  /** Create an image file and map it for writing. An Analyze 7.5 header is
+   * written if the file name ends in .hdr or .img. The voxels are not
+   * initialized. */
+  void MapForWriting(const char *fileName, const SizeType &size,
+      const SpacingType &spacing);
+
+  /** Write back and release the mapping. */
+  void Close();
+
+  /** The image that uses the mapping as its buffer. */
+  ImageType *GetImage() const
+    { return m_Image; }
+
+  /** The mapped voxels. */
+  PixelType *GetBufferPointer() const
+    { return m_Pixels; }
+
+  /** Set/Get the orientation code of the Analyze header. It is read by
+   * MapForReading() and written by MapForWriting(). Default is 0. */
+  itkSetMacro(Orientation, unsigned char);
+  itkGetConstMacro(Orientation, unsigned char);
+
+  /** The name of the file that holds the voxels. */
+  itkGetStringMacro(FileName);
+
+protected:
+  MappedImageFile();
+  virtual ~MappedImageFile();
+  void PrintSelf(std::ostream& os, Indent indent) const;
+
+  /** Wether fileName names an Analyze 7.5 pair. Sets headerName and
+   * imageName to the names of the two files. */
+  static bool IsAnalyzeFileName(const std::string &fileName,
+      std::string &headerName, std::string &imageName);
+
+  /** Map the voxel file, which must hold at least offset bytes before the
+   * voxels of size. */
+  void Map(const std::string &fileName, const SizeType &size,
+      const SpacingType &spacing, unsigned long offset, bool forWriting);
+
+private:
+  MappedImageFile(const Self&); //purposely not implemented
+  void operator=(const Self&); //purposely not implemented
+
+  std::string m_FileName;
+  unsigned char m_Orientation;
+  bool m_ForWriting;
+
+  /** The mapped file, or the file read into m_Buffer. */
+  void *m_Mapping;
+  unsigned long m_MappingSize;
+  std::vector<char> m_Buffer;
+  PixelType *m_Pixels;
+
+  ImagePointer m_Image;
+
+}; // end of MappedImageFile class
+
+} //end namespace itk
+
+
+#ifndef ITK_MANUAL_INSTANTIATION
+#include "itkMappedImageFile.txx"
+#endif
+
+#endif
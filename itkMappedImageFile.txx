@@ -0,0 +1,344 @@
+#ifndef __itkMappedImageFile_txx
+#define __itkMappedImageFile_txx
+
+#include <fstream>
+#include <cstring>
+
+#include "itkMappedImageFile.h"
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#define ITK_MAPPED_IMAGE_FILE_MMAP
+#endif
+
+namespace itk
+{
+
+/** The fields of the Analyze 7.5 header that are read and written. */
+namespace AnalyzeHeader
+{
+  const unsigned int Size = 348;
+  const unsigned int SizeOfHeaderOffset = 0;
+  const unsigned int ExtentsOffset = 32;
+  const unsigned int RegularOffset = 38;
+  const unsigned int DimensionsOffset = 40;
+  const unsigned int DataTypeOffset = 70;
+  const unsigned int BitsPerPixelOffset = 72;
+  const unsigned int PixelDimensionsOffset = 76;
+  const unsigned int VoxelOffsetOffset = 108;
+  const unsigned int OrientationOffset = 252;
+  const unsigned int MaximumDimension = 7;
+}
+
+
+/**
+ *    Constructor
+ */
+template < class TImage >
+MappedImageFile< TImage >
+::MappedImageFile()
+{
+  m_Orientation = 0;
+  m_ForWriting = false;
+  m_Mapping = 0;
+  m_MappingSize = 0;
+  m_Pixels = 0;
+}
+
+template < class TImage >
+MappedImageFile< TImage >
+::~MappedImageFile()
+{
+  try
+  {
+    this->Close();
+  }
+  catch (ExceptionObject &)
+  {
+    // Destructors must not throw
+  }
+}
+
+template < class TImage >
+bool
+MappedImageFile< TImage >
+::IsAnalyzeFileName(const std::string &fileName,
+    std::string &headerName, std::string &imageName)
+{
+  const std::string::size_type length = fileName.size();
+  if (length < 4)
+    return false;
+  const std::string extension = fileName.substr(length - 4);
+  if (extension != ".hdr" && extension != ".img")
+    return false;
+  const std::string base = fileName.substr(0, length - 4);
+  headerName = base + ".hdr";
+  imageName = base + ".img";
+  return true;
+}
+
+/**
+ * Map an Analyze 7.5 image for reading
+ */
+template < class TImage >
+void
+MappedImageFile< TImage >
+::MapForReading(const char *fileName)
+{
+  std::string headerName;
+  std::string imageName;
+  if (!IsAnalyzeFileName(fileName, headerName, imageName))
+    itkExceptionMacro(<< fileName << " is not an Analyze image");
+
+  char header[AnalyzeHeader::Size];
+  std::ifstream file(headerName.c_str(), std::ios::in | std::ios::binary);
+  if (!file || !file.read(header, AnalyzeHeader::Size))
+    itkExceptionMacro(<< "Can't read " << headerName);
+
+  int headerSize;
+  short dimensions[AnalyzeHeader::MaximumDimension + 1];
+  short dataType;
+  short bitsPerPixel;
+  float pixelDimensions[AnalyzeHeader::MaximumDimension + 1];
+  float voxelOffset;
+  memcpy(&headerSize, header + AnalyzeHeader::SizeOfHeaderOffset, sizeof(headerSize));
+  memcpy(dimensions, header + AnalyzeHeader::DimensionsOffset, sizeof(dimensions));
+  memcpy(&dataType, header + AnalyzeHeader::DataTypeOffset, sizeof(dataType));
+  memcpy(&bitsPerPixel, header + AnalyzeHeader::BitsPerPixelOffset, sizeof(bitsPerPixel));
+  memcpy(pixelDimensions, header + AnalyzeHeader::PixelDimensionsOffset, sizeof(pixelDimensions));
+  memcpy(&voxelOffset, header + AnalyzeHeader::VoxelOffsetOffset, sizeof(voxelOffset));
+
+  // The voxels are used as they are stored, so they can't be swapped
+  if (headerSize != static_cast<int>(AnalyzeHeader::Size))
+    itkExceptionMacro(<< headerName << " is not an Analyze header in the byte order of this machine");
+
+  typedef AnalyzePixelTraits<PixelType> Traits;
+  const bool integerDataType = dataType == 2 || dataType == 4 || dataType == 8 ||
+    dataType == 130 || dataType == 132 || dataType == 136;
+  if (bitsPerPixel != static_cast<short>(8 * sizeof(PixelType)) ||
+      (dataType != Traits::DataType && !(Traits::IsInteger && integerDataType)))
+    itkExceptionMacro(<< imageName << " has data type " << dataType
+        << ", which can't be mapped to the pixel type");
+
+  const int numberOfDimensions = dimensions[0];
+  if (numberOfDimensions < 1 || numberOfDimensions > static_cast<int>(AnalyzeHeader::MaximumDimension))
+    itkExceptionMacro(<< headerName << " has " << numberOfDimensions << " dimensions");
+  for (int i = ImageDimension; i < numberOfDimensions; ++i)
+    if (dimensions[i + 1] > 1)
+      itkExceptionMacro(<< imageName << " has more than " << ImageDimension << " dimensions");
+
+  SizeType size;
+  SpacingType spacing;
+  for (unsigned int i = 0; i < ImageDimension; ++i)
+  {
+    const bool stored = static_cast<int>(i) < numberOfDimensions;
+    size[i] = stored ? dimensions[i + 1] : 1;
+    spacing[i] = stored && pixelDimensions[i + 1] > 0 ? pixelDimensions[i + 1] : 1.0;
+  }
+  if (voxelOffset < 0)
+    itkExceptionMacro(<< headerName << " has a negative voxel offset");
+
+  this->Map(imageName, size, spacing, static_cast<unsigned long>(voxelOffset), false);
+  m_Orientation = static_cast<unsigned char>(header[AnalyzeHeader::OrientationOffset]);
+}
+
+/**
+ * Map a raw image for reading
+ */
+template < class TImage >
+void
+MappedImageFile< TImage >
+::MapRawForReading(const char *fileName, const SizeType &size,
+    const SpacingType &spacing, unsigned long headerSize)
+{
+  this->Map(fileName, size, spacing, headerSize, false);
+}
+
+/**
+ * Create an image file and map it for writing
+ */
+template < class TImage >
+void
+MappedImageFile< TImage >
+::MapForWriting(const char *fileName, const SizeType &size,
+    const SpacingType &spacing)
+{
+  std::string headerName;
+  std::string imageName = fileName;
+  if (IsAnalyzeFileName(fileName, headerName, imageName))
+  {
+    if (ImageDimension > AnalyzeHeader::MaximumDimension)
+      itkExceptionMacro(<< "Analyze images have at most " << AnalyzeHeader::MaximumDimension << " dimensions");
+
+    // Like ITK's writer, store at least 4 dimensions
+    char header[AnalyzeHeader::Size];
+    memset(header, 0, AnalyzeHeader::Size);
+    const int headerSize = AnalyzeHeader::Size;
+    const int extents = 16384;
+    short dimensions[AnalyzeHeader::MaximumDimension + 1];
+    float pixelDimensions[AnalyzeHeader::MaximumDimension + 1];
+    dimensions[0] = ImageDimension < 4 ? 4 : ImageDimension;
+    pixelDimensions[0] = 0;
+    for (unsigned int i = 1; i <= AnalyzeHeader::MaximumDimension; ++i)
+    {
+      dimensions[i] = i <= ImageDimension ? static_cast<short>(size[i - 1]) : 1;
+      pixelDimensions[i] = i <= ImageDimension ? static_cast<float>(spacing[i - 1]) : 1;
+      if (i <= ImageDimension && static_cast<unsigned long>(dimensions[i]) != size[i - 1])
+        itkExceptionMacro(<< "The size " << size << " doesn't fit into an Analyze header");
+    }
+    const short dataType = AnalyzePixelTraits<PixelType>::DataType;
+    const short bitsPerPixel = 8 * sizeof(PixelType);
+    memcpy(header + AnalyzeHeader::SizeOfHeaderOffset, &headerSize, sizeof(headerSize));
+    memcpy(header + AnalyzeHeader::ExtentsOffset, &extents, sizeof(extents));
+    header[AnalyzeHeader::RegularOffset] = 'r';
+    memcpy(header + AnalyzeHeader::DimensionsOffset, dimensions, sizeof(dimensions));
+    memcpy(header + AnalyzeHeader::DataTypeOffset, &dataType, sizeof(dataType));
+    memcpy(header + AnalyzeHeader::BitsPerPixelOffset, &bitsPerPixel, sizeof(bitsPerPixel));
+    memcpy(header + AnalyzeHeader::PixelDimensionsOffset, pixelDimensions, sizeof(pixelDimensions));
+    header[AnalyzeHeader::OrientationOffset] = m_Orientation;
+
+    std::ofstream file(headerName.c_str(), std::ios::out | std::ios::binary);
+    if (!file || !file.write(header, AnalyzeHeader::Size))
+      itkExceptionMacro(<< "Can't write " << headerName);
+  }
+
+  this->Map(imageName, size, spacing, 0, true);
+}
+
+/**
+ * Map the voxel file
+ */
+template < class TImage >
+void
+MappedImageFile< TImage >
+::Map(const std::string &fileName, const SizeType &size,
+    const SpacingType &spacing, unsigned long offset, bool forWriting)
+{
+  this->Close();
+
+  // The voxels are accessed in place, so they must be aligned
+  if (offset % sizeof(PixelType) != 0)
+    itkExceptionMacro(<< "The voxels of " << fileName << " are not aligned");
+
+  RegionType region;
+  region.SetSize(size);
+  const unsigned long numberOfPixels = region.GetNumberOfPixels();
+  const unsigned long fileSize = offset + numberOfPixels * sizeof(PixelType);
+  if (numberOfPixels == 0)
+    itkExceptionMacro(<< fileName << " has no voxels");
+
+  char *begin;
+#ifdef ITK_MAPPED_IMAGE_FILE_MMAP
+  const int file = forWriting ?
+    open(fileName.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0666) :
+    open(fileName.c_str(), O_RDONLY);
+  if (file < 0)
+    itkExceptionMacro(<< "Can't open " << fileName);
+  if (forWriting)
+  {
+    if (ftruncate(file, fileSize) != 0)
+    {
+      close(file);
+      itkExceptionMacro(<< "Can't write " << fileName);
+    }
+  }
+  else
+  {
+    struct stat status;
+    if (fstat(file, &status) != 0 || static_cast<unsigned long>(status.st_size) < fileSize)
+    {
+      close(file);
+      itkExceptionMacro(<< fileName << " is truncated");
+    }
+  }
+  // Input files are mapped copy-on-write. The mapping stays valid after the
+  // file is closed.
+  void *mapping = mmap(0, fileSize, PROT_READ | PROT_WRITE,
+      forWriting ? MAP_SHARED : MAP_PRIVATE, file, 0);
+  close(file);
+  if (mapping == MAP_FAILED)
+    itkExceptionMacro(<< "Can't map " << fileName);
+  m_Mapping = mapping;
+  m_MappingSize = fileSize;
+  begin = static_cast<char *>(mapping);
+#else
+  m_Buffer.resize(fileSize);
+  if (!forWriting)
+  {
+    std::ifstream file(fileName.c_str(), std::ios::in | std::ios::binary);
+    if (!file)
+      itkExceptionMacro(<< "Can't open " << fileName);
+    if (!file.read(&m_Buffer[0], fileSize))
+    {
+      std::vector<char>().swap(m_Buffer);
+      itkExceptionMacro(<< fileName << " is truncated");
+    }
+  }
+  begin = &m_Buffer[0];
+#endif
+
+  m_FileName = fileName;
+  m_ForWriting = forWriting;
+  m_Pixels = reinterpret_cast<PixelType *>(begin + offset);
+
+  // The image doesn't own its buffer
+  m_Image = ImageType::New();
+  m_Image->SetRegions(region);
+  m_Image->SetSpacing(spacing);
+  m_Image->GetPixelContainer()->SetImportPointer(m_Pixels, numberOfPixels, false);
+
+  this->Modified();
+}
+
+/**
+ * Write back and release the mapping
+ */
+template < class TImage >
+void
+MappedImageFile< TImage >
+::Close()
+{
+  if (m_Image)
+  {
+    // The image must not refer to the released buffer anymore
+    m_Image->Initialize();
+    m_Image = 0;
+  }
+  m_Pixels = 0;
+
+#ifdef ITK_MAPPED_IMAGE_FILE_MMAP
+  // The changes of a shared mapping go to the file
+  if (m_Mapping)
+    munmap(m_Mapping, m_MappingSize);
+#else
+  if (m_ForWriting && !m_Buffer.empty())
+  {
+    std::ofstream file(m_FileName.c_str(), std::ios::out | std::ios::binary);
+    const bool written = file && file.write(&m_Buffer[0], m_Buffer.size());
+    std::vector<char>().swap(m_Buffer);
+    if (!written)
+      itkExceptionMacro(<< "Can't write " << m_FileName);
+  }
+#endif
+  m_Mapping = 0;
+  m_MappingSize = 0;
+  std::vector<char>().swap(m_Buffer);
+  m_ForWriting = false;
+}
+
+template < class TImage >
+void
+MappedImageFile< TImage >
+::PrintSelf(std::ostream& os, Indent indent) const
+{
+  Superclass::PrintSelf(os,indent);
+  os << indent << "FileName: " << m_FileName << std::endl;
+  os << indent << "ForWriting: " << m_ForWriting << std::endl;
+  os << indent << "Orientation: " << static_cast<int>(m_Orientation) << std::endl;
+  os << indent << "MappingSize: " << m_MappingSize << std::endl;
+}
+} // end namespace itk
+#endif
@@ -0,0 +1,264 @@
+#ifndef __itkMultiLabelDistanceTransformImageFilter_h
+#define __itkMultiLabelDistanceTransformImageFilter_h
+
+#include "itkImageToImageFilter.h"
+#include "itkVectorImage.h"
+#include "itkMultiThreader.h"
+#include "itkNumericTraits.h"
+#include "itkLowerEnvelopeOfParabolas.h"
+
+#include <vector>
+
+namespace itk
+{
+
+class ProgressReporter;
+
+/** \class MultiLabelDistanceTransformImageFilter
+*
+* Computes the squared euclidean distance to several labels of a label image
+* at once, see itk::GeneralizedDistanceTransformImageFilter for the
+* transform itself.
+*
+* PER-LABEL DISTANCES
+* With SetLabels(), component c of the distance output is the distance to
+* the closest voxel with label GetLabels()[c]. The result is the same as K
+* runs of the distance transform with K indicator images, but each scanline
+* is read once per iteration for all K labels: The values of a pixel are
+* stored next to each other in the itk::VectorImage, and the K envelopes of
+* a scanline are built in one traversal.
+*
+* NEAREST LABELS
+* With SetNumberOfNearestLabels(k), the output holds the k closest labels
+* instead, ordered by distance: Component c of the distance output is the
+* distance to the c-th closest label, which is stored in component c of
+* GetNearestLabels(). All labels but GetBackgroundLabel() take part.
+* Missing labels have the background label and the distance
+* GetMaximumApexHeight(). This needs memory for k instead of K components
+* if there are many labels.
+*
+* It is enough to keep the k closest labels in between the iterations: If
+* a label is not among the k closest ones at a voxel, the k closer labels
+* are closer at all the voxels whose distance is derived from that voxel
+* as well.
+*
+* USAGE TIPS
+* TDistanceImage must be an itk::VectorImage. Its InternalPixelType stores
+* the distances, and the envelopes are computed in TAccumulator. As in
+* itk::GeneralizedDistanceTransformImageFilter, distances that don't fit
+* are saturated to GetMaximumApexHeight(), which also marks labels that
+* don't occur in the image.
+*
+* MULTITHREADING
+* The scanlines of each iteration are split into even ranges among the
+* threads of the filter's itk::MultiThreader.
+*
+* \ingroup ImageFeatureExtraction
+*
+*/
+
+template <
+  class TLabelImage, class TDistanceImage,
+        unsigned char MinimalSpacingPrecision=3,
+        class TAccumulator=typename TDistanceImage::InternalPixelType >
+class ITK_EXPORT MultiLabelDistanceTransformImageFilter :
+    public ImageToImageFilter<TLabelImage,TDistanceImage>
+{
+public:
+  /** Standard class typedefs. */
+  typedef MultiLabelDistanceTransformImageFilter Self;
+  typedef ImageToImageFilter<TLabelImage,TDistanceImage> Superclass;
+  typedef SmartPointer<Self> Pointer;
+  typedef SmartPointer<const Self> ConstPointer;
+
+  /** Method for creation through the object factory */
+  itkNewMacro(Self);
+
+  /** Run-time type information (and related methods). */
+  itkTypeMacro(MultiLabelDistanceTransformImageFilter, ImageToImageFilter);
+
+  /** Image dimension. */
+  itkStaticConstMacro(ImageDimension, unsigned int, TLabelImage::ImageDimension);
+
+  /** Types and pointer types for the images. */
+  typedef TLabelImage LabelImageType;
+  typedef TDistanceImage DistanceImageType;
+  typedef typename LabelImageType::PixelType LabelPixelType;
+  typedef VectorImage<LabelPixelType, itkGetStaticConstMacro(ImageDimension)>
+    NearestLabelsImageType;
+
+  typedef typename DistanceImageType::Pointer DistanceImagePointer;
+  typedef typename NearestLabelsImageType::Pointer NearestLabelsImagePointer;
+  typedef typename DistanceImageType::InternalPixelType DistanceValueType;
+  typedef TAccumulator AccumulatorType;
+  typedef typename DistanceImageType::IndexType IndexType;
+  typedef typename DistanceImageType::RegionType RegionType;
+  typedef typename DistanceImageType::SizeType SizeType;
+  typedef typename DistanceImageType::OffsetValueType OffsetValueType;
+  typedef typename TLabelImage::SpacingType::ValueType TSpacingType;
+
+  typedef std::vector<LabelPixelType> LabelArrayType;
+
+  /** The envelopes of the scanlines. No voronoi map is needed, each
+   * envelope belongs to one label. */
+  typedef itk::LowerEnvelopeOfParabolas<true, TSpacingType, MinimalSpacingPrecision, false,
+          LabelPixelType,
+          typename TLabelImage::IndexValueType,
+          AccumulatorType> LEOPD;
+
+  /** The apex height that marks background voxels. It is the smaller one of
+   * the largest apex height of the envelope and the largest value of
+   * DistanceValueType. Larger distances are saturated to this value. */
+  static DistanceValueType GetMaximumApexHeight()
+    {
+    if (static_cast<double>(LEOPD::maxApexHeight) <
+        static_cast<double>(NumericTraits<DistanceValueType>::max()))
+      return static_cast<DistanceValueType>(LEOPD::maxApexHeight);
+    return NumericTraits<DistanceValueType>::max();
+    }
+
+  /** Get the distances, one component per label or nearest label. This is
+   * equivalent to the standard GetOutput() method. */
+  DistanceImageType* GetDistance(void);
+
+  /** Get the nearest labels. Only computed if GetNumberOfNearestLabels() is
+   * larger than 0. */
+  NearestLabelsImageType* GetNearestLabels(void);
+
+  /** Set/Get the labels that get a component of the distance output each.
+   * Ignored if GetNumberOfNearestLabels() is larger than 0. */
+  void SetLabels(const LabelArrayType &labels);
+  itkGetConstReferenceMacro(Labels, LabelArrayType);
+
+  /** Set/Get the number of nearest labels that are computed instead of the
+   * distances to GetLabels(). Default is 0. */
+  void SetNumberOfNearestLabels(unsigned int);
+  itkGetMacro(NumberOfNearestLabels, unsigned int);
+
+  /** Set/Get the label of background voxels for the nearest labels.
+   * Default is LabelPixelType(). */
+  itkSetMacro(BackgroundLabel, LabelPixelType);
+  itkGetConstReferenceMacro(BackgroundLabel, LabelPixelType);
+
+  /** Set/Get wether spacing should be used or not. */
+  itkGetMacro(UseSpacing, bool);
+  itkSetMacro(UseSpacing, bool);
+  itkBooleanMacro(UseSpacing);
+
+  /** Number of components of the outputs: The number of labels or nearest
+   * labels. */
+  unsigned int GetNumberOfComponents() const;
+
+protected:
+  MultiLabelDistanceTransformImageFilter();
+  virtual ~MultiLabelDistanceTransformImageFilter() {};
+  void PrintSelf(std::ostream& os, Indent indent) const;
+
+  /** The outputs have one component per label or nearest label. */
+  void GenerateOutputInformation();
+
+  /** The whole input is needed. */
+  void GenerateInputRequestedRegion();
+
+  /** The whole output will be produced regardless of the region requested. */
+  void EnlargeOutputRequestedRegion(DataObject *itkNotUsed(output));
+
+  /** Allocate the outputs and initialize them from the label image. Helper
+   * function for GenerateData() */
+  void PrepareData();
+
+  /** Compute the distances. */
+  void GenerateData();
+
+  template < bool UseSpacing > void TemplateGenerateData();
+
+  /** Number of scanlines in direction d. */
+  unsigned long GetNumberOfLines(unsigned int d) const;
+
+  /** Index of the first pixel of scanline number line in direction d. The
+   * scanlines are numbered with dimension 0 varying fastest, dimension d
+   * being skipped. */
+  IndexType GetLineStartIndex(unsigned int d, unsigned long line) const;
+
+  /** Compute the envelopes of the labels for the scanlines
+   * [firstLine, firstLine + numberOfLines) in direction d. */
+  template < bool UseSpacing >
+  void ThreadedGenerateLabelLines(unsigned int d, unsigned long firstLine,
+      unsigned long numberOfLines, ProgressReporter &progress);
+
+  /** Compute the envelopes of the nearest labels for the scanlines
+   * [firstLine, firstLine + numberOfLines) in direction d. */
+  template < bool UseSpacing >
+  void ThreadedGenerateNearestLines(unsigned int d, unsigned long firstLine,
+      unsigned long numberOfLines, ProgressReporter &progress);
+
+  /** Static function used as a "callback" by the MultiThreader. Each thread
+   * computes an even share of the scanlines. */
+  template < bool UseSpacing >
+  static ITK_THREAD_RETURN_TYPE LinesThreaderCallback(void *arg);
+
+  /** Convert a stored distance to an apex height, see
+   * GeneralizedDistanceTransformImageFilter::DistanceToAccumulator(). */
+  static AccumulatorType DistanceToAccumulator(const DistanceValueType &distance)
+    {
+    if (distance >= GetMaximumApexHeight())
+      return LEOPD::maxApexHeight;
+    return static_cast<AccumulatorType>(distance);
+    }
+
+  /** Convert an envelope sample to a stored distance, saturating it to
+   * GetMaximumApexHeight(). */
+  static DistanceValueType AccumulatorToDistance(const AccumulatorType &value)
+    {
+    if (static_cast<double>(value) < static_cast<double>(GetMaximumApexHeight()))
+      return static_cast<DistanceValueType>(value);
+    return GetMaximumApexHeight();
+    }
+
+  /** Output iterator on a raw buffer that advances by a fixed number of
+   * values and stores the envelope samples with AccumulatorToDistance(). */
+  class StridedDistancePointer
+  {
+    public:
+      StridedDistancePointer(DistanceValueType *pointer, OffsetValueType step)
+        : m_Pointer(pointer), m_Step(step) {}
+
+      void Set(const AccumulatorType &value)
+        { *m_Pointer = AccumulatorToDistance(value); }
+
+      StridedDistancePointer &operator++()
+        { m_Pointer += m_Step; return *this; }
+
+    private:
+      DistanceValueType *m_Pointer;
+      OffsetValueType m_Step;
+  };
+
+  /** Internal structure used for passing the filter and the current
+   * direction to the threads. */
+  struct LinesThreadStruct
+  {
+    Pointer Filter;
+    unsigned int Dimension;
+    unsigned long NumberOfLines;
+  };
+
+private:
+  MultiLabelDistanceTransformImageFilter(const Self&); //purposely not implemented
+  void operator=(const Self&); //purposely not implemented
+
+  LabelArrayType m_Labels;
+  unsigned int m_NumberOfNearestLabels;
+  LabelPixelType m_BackgroundLabel;
+  bool m_UseSpacing;
+
+}; // end of MultiLabelDistanceTransformImageFilter class
+
+} //end namespace itk
+
+
+#ifndef ITK_MANUAL_INSTANTIATION
+#include "itkMultiLabelDistanceTransformImageFilter.txx"
+#endif
+
+#endif
@@ -0,0 +1,552 @@
+#ifndef __itkMultiLabelDistanceTransformImageFilter_txx
+#define __itkMultiLabelDistanceTransformImageFilter_txx
+
+#include <iostream>
+#include <map>
+
+#include "itkMultiLabelDistanceTransformImageFilter.h"
+#include "itkImageRegionConstIterator.h"
+#include "itkProgressReporter.h"
+
+namespace itk
+{
+
+
+/**
+ *    Constructor
+ */
+template < class TLabelImage, class TDistanceImage, unsigned char MinimalSpacingPrecision, class TAccumulator >
+MultiLabelDistanceTransformImageFilter< TLabelImage, TDistanceImage, MinimalSpacingPrecision, TAccumulator >
+::MultiLabelDistanceTransformImageFilter()
+{
+  m_NumberOfNearestLabels = 0;
+  m_BackgroundLabel = LabelPixelType();
+  m_UseSpacing = true;
+
+  this->SetNumberOfRequiredInputs(1);
+  this->SetNumberOfRequiredOutputs(1);
+
+  DistanceImagePointer distance = DistanceImageType::New();
+  this->SetNthOutput(0, distance.GetPointer());
+
+  NearestLabelsImagePointer nearestLabels = NearestLabelsImageType::New();
+  this->SetNthOutput(1, nearestLabels.GetPointer());
+}
+
+template < class TLabelImage, class TDistanceImage, unsigned char MinimalSpacingPrecision, class TAccumulator >
+void
+MultiLabelDistanceTransformImageFilter< TLabelImage, TDistanceImage, MinimalSpacingPrecision, TAccumulator >
+::SetLabels(const LabelArrayType &labels)
+{
+  m_Labels = labels;
+  this->Modified();
+}
+
+/**
+ * The nearest labels are an output of their own
+ */
+template < class TLabelImage, class TDistanceImage, unsigned char MinimalSpacingPrecision, class TAccumulator >
+void
+MultiLabelDistanceTransformImageFilter< TLabelImage, TDistanceImage, MinimalSpacingPrecision, TAccumulator >
+::SetNumberOfNearestLabels(unsigned int k)
+{
+  if (m_NumberOfNearestLabels == k)
+    return;
+  m_NumberOfNearestLabels = k;
+  if (m_NumberOfNearestLabels > 0)
+    this->SetNumberOfRequiredOutputs(2);
+  else
+    this->SetNumberOfRequiredOutputs(1);
+  this->Modified();
+}
+
+template < class TLabelImage, class TDistanceImage, unsigned char MinimalSpacingPrecision, class TAccumulator >
+unsigned int
+MultiLabelDistanceTransformImageFilter< TLabelImage, TDistanceImage, MinimalSpacingPrecision, TAccumulator >
+::GetNumberOfComponents() const
+{
+  if (m_NumberOfNearestLabels > 0)
+    return m_NumberOfNearestLabels;
+  return m_Labels.size();
+}
+
+/**
+ * Get the distances
+ */
+template < class TLabelImage, class TDistanceImage, unsigned char MinimalSpacingPrecision, class TAccumulator >
+typename
+MultiLabelDistanceTransformImageFilter< TLabelImage, TDistanceImage, MinimalSpacingPrecision, TAccumulator >
+::DistanceImageType*
+MultiLabelDistanceTransformImageFilter< TLabelImage, TDistanceImage, MinimalSpacingPrecision, TAccumulator >
+::GetDistance(void)
+{
+  return dynamic_cast<DistanceImageType *>(this->ProcessObject::GetOutput(0));
+}
+
+/**
+ * Get the nearest labels
+ */
+template < class TLabelImage, class TDistanceImage, unsigned char MinimalSpacingPrecision, class TAccumulator >
+typename
+MultiLabelDistanceTransformImageFilter< TLabelImage, TDistanceImage, MinimalSpacingPrecision, TAccumulator >
+::NearestLabelsImageType*
+MultiLabelDistanceTransformImageFilter< TLabelImage, TDistanceImage, MinimalSpacingPrecision, TAccumulator >
+::GetNearestLabels(void)
+{
+  return dynamic_cast<NearestLabelsImageType *>(this->ProcessObject::GetOutput(1));
+}
+
+/**
+ * The outputs have one component per label or nearest label
+ */
+template < class TLabelImage, class TDistanceImage, unsigned char MinimalSpacingPrecision, class TAccumulator >
+void
+MultiLabelDistanceTransformImageFilter< TLabelImage, TDistanceImage, MinimalSpacingPrecision, TAccumulator >
+::GenerateOutputInformation()
+{
+  Superclass::GenerateOutputInformation();
+
+  const unsigned int numberOfComponents = this->GetNumberOfComponents();
+  if (numberOfComponents == 0)
+    itkExceptionMacro(<< "Neither labels nor a number of nearest labels are given");
+
+  this->GetDistance()->SetVectorLength(numberOfComponents);
+
+  NearestLabelsImageType *nearestLabels = this->GetNearestLabels();
+  if (nearestLabels)
+    nearestLabels->SetVectorLength(numberOfComponents);
+}
+
+/**
+ * The whole input is needed
+ */
+template < class TLabelImage, class TDistanceImage, unsigned char MinimalSpacingPrecision, class TAccumulator >
+void
+MultiLabelDistanceTransformImageFilter< TLabelImage, TDistanceImage, MinimalSpacingPrecision, TAccumulator >
+::GenerateInputRequestedRegion()
+{
+  Superclass::GenerateInputRequestedRegion();
+
+  DataObject *input = this->ProcessObject::GetInput(0);
+  if (input)
+    input->SetRequestedRegionToLargestPossibleRegion();
+}
+
+/**
+ * The whole output will be produced regardless of the region requested.
+ */
+template < class TLabelImage, class TDistanceImage, unsigned char MinimalSpacingPrecision, class TAccumulator >
+void
+MultiLabelDistanceTransformImageFilter< TLabelImage, TDistanceImage, MinimalSpacingPrecision, TAccumulator >
+::EnlargeOutputRequestedRegion(DataObject *)
+{
+  this->GetDistance()->SetRequestedRegion(this->GetDistance()->GetLargestPossibleRegion());
+  if (m_NumberOfNearestLabels > 0)
+    this->GetNearestLabels()->SetRequestedRegion(
+        this->GetNearestLabels()->GetLargestPossibleRegion());
+}
+
+/**
+ * Allocate the outputs and initialize them from the label image
+ */
+template < class TLabelImage, class TDistanceImage, unsigned char MinimalSpacingPrecision, class TAccumulator >
+void
+MultiLabelDistanceTransformImageFilter< TLabelImage, TDistanceImage, MinimalSpacingPrecision, TAccumulator >
+::PrepareData()
+{
+  const unsigned int numberOfComponents = this->GetNumberOfComponents();
+  const DistanceValueType background = GetMaximumApexHeight();
+
+  DistanceImageType *distance = this->GetDistance();
+  distance->SetBufferedRegion(distance->GetRequestedRegion());
+  distance->Allocate();
+  DistanceValueType *distanceOut = distance->GetBufferPointer();
+
+  LabelPixelType *nearestLabelsOut = 0;
+  if (m_NumberOfNearestLabels > 0)
+  {
+    NearestLabelsImageType *nearestLabels = this->GetNearestLabels();
+    nearestLabels->SetBufferedRegion(distance->GetBufferedRegion());
+    nearestLabels->Allocate();
+    nearestLabelsOut = nearestLabels->GetBufferPointer();
+  }
+
+  // The components of a pixel are stored next to each other. A voxel is at
+  // distance 0 of its own label.
+  typedef ImageRegionConstIterator<LabelImageType> LabelIterator;
+  LabelIterator labelIt(this->GetInput(), distance->GetBufferedRegion());
+  for (labelIt.GoToBegin(); !labelIt.IsAtEnd(); ++labelIt)
+  {
+    const LabelPixelType label = labelIt.Get();
+    if (m_NumberOfNearestLabels > 0)
+    {
+      const bool isBackground = label == m_BackgroundLabel;
+      *distanceOut++ = isBackground ? background : 0;
+      *nearestLabelsOut++ = isBackground ? m_BackgroundLabel : label;
+      for (unsigned int c = 1; c < numberOfComponents; ++c)
+      {
+        *distanceOut++ = background;
+        *nearestLabelsOut++ = m_BackgroundLabel;
+      }
+    }
+    else
+    {
+      for (unsigned int c = 0; c < numberOfComponents; ++c)
+        *distanceOut++ = label == m_Labels[c] ? 0 : background;
+    }
+  }
+}
+
+/**
+ *  Compute the distances
+ */
+template < class TLabelImage, class TDistanceImage, unsigned char MinimalSpacingPrecision, class TAccumulator >
+template < bool UseSpacing >
+void
+MultiLabelDistanceTransformImageFilter< TLabelImage, TDistanceImage, MinimalSpacingPrecision, TAccumulator >
+::TemplateGenerateData()
+{
+  this->PrepareData();
+
+  // Like in GeneralizedDistanceTransformImageFilter, the distances are
+  // transformed by iteration over the dimensions, with the scanlines of a
+  // dimension distributed over the threads. All components of a scanline
+  // are computed together.
+  this->GetMultiThreader()->SetNumberOfThreads(this->GetNumberOfThreads());
+
+  LinesThreadStruct str;
+  str.Filter = this;
+
+  this->GetMultiThreader()->SetSingleMethod(
+      &Self::template LinesThreaderCallback<UseSpacing>, &str);
+
+  for (unsigned int d = 0; d < LabelImageType::ImageDimension; ++d)
+  {
+    str.Dimension = d;
+    str.NumberOfLines = this->GetNumberOfLines(d);
+    this->GetMultiThreader()->SingleMethodExecute();
+  }
+}
+
+/**
+ * Compute an even share of the scanlines of the current direction
+ */
+template < class TLabelImage, class TDistanceImage, unsigned char MinimalSpacingPrecision, class TAccumulator >
+template < bool UseSpacing >
+ITK_THREAD_RETURN_TYPE
+MultiLabelDistanceTransformImageFilter< TLabelImage, TDistanceImage, MinimalSpacingPrecision, TAccumulator >
+::LinesThreaderCallback(void *arg)
+{
+  MultiThreader::ThreadInfoStruct *info =
+    static_cast<MultiThreader::ThreadInfoStruct *>(arg);
+  LinesThreadStruct *str = static_cast<LinesThreadStruct *>(info->UserData);
+  Self *filter = str->Filter;
+
+  const unsigned int threadId = info->ThreadID;
+  const unsigned int threadCount = info->NumberOfThreads;
+
+  const unsigned long firstLine = str->NumberOfLines * threadId / threadCount;
+  const unsigned long endLine = str->NumberOfLines * (threadId + 1) / threadCount;
+
+  // Each of the ImageDimension iterations accounts for the same share of
+  // the progress
+  ProgressReporter progress(filter, threadId, endLine - firstLine, 100,
+      static_cast<float>(str->Dimension) / LabelImageType::ImageDimension,
+      1.0f / LabelImageType::ImageDimension);
+
+  if (filter->m_NumberOfNearestLabels > 0)
+    filter->template ThreadedGenerateNearestLines<UseSpacing>(
+        str->Dimension, firstLine, endLine - firstLine, progress);
+  else
+    filter->template ThreadedGenerateLabelLines<UseSpacing>(
+        str->Dimension, firstLine, endLine - firstLine, progress);
+
+  return ITK_THREAD_RETURN_VALUE;
+}
+
+/**
+ * Number of scanlines in direction d
+ */
+template < class TLabelImage, class TDistanceImage, unsigned char MinimalSpacingPrecision, class TAccumulator >
+unsigned long
+MultiLabelDistanceTransformImageFilter< TLabelImage, TDistanceImage, MinimalSpacingPrecision, TAccumulator >
+::GetNumberOfLines(unsigned int d) const
+{
+  const SizeType &size =
+    static_cast<const DistanceImageType *>(this->ProcessObject::GetOutput(0))
+      ->GetBufferedRegion().GetSize();
+
+  unsigned long numberOfLines = 1;
+  for (unsigned int i = 0; i < LabelImageType::ImageDimension; ++i)
+  {
+    if (i != d)
+      numberOfLines *= size[i];
+  }
+  return numberOfLines;
+}
+
+/**
+ * Index of the first pixel of a scanline in direction d
+ */
+template < class TLabelImage, class TDistanceImage, unsigned char MinimalSpacingPrecision, class TAccumulator >
+typename
+MultiLabelDistanceTransformImageFilter< TLabelImage, TDistanceImage, MinimalSpacingPrecision, TAccumulator >
+::IndexType
+MultiLabelDistanceTransformImageFilter< TLabelImage, TDistanceImage, MinimalSpacingPrecision, TAccumulator >
+::GetLineStartIndex(unsigned int d, unsigned long line) const
+{
+  const RegionType &region =
+    static_cast<const DistanceImageType *>(this->ProcessObject::GetOutput(0))
+      ->GetBufferedRegion();
+
+  IndexType index = region.GetIndex();
+  for (unsigned int i = 0; i < LabelImageType::ImageDimension; ++i)
+  {
+    if (i != d)
+    {
+      index[i] += line % region.GetSize()[i];
+      line /= region.GetSize()[i];
+    }
+  }
+  return index;
+}
+
+/**
+ * Compute the envelopes of the labels for a range of scanlines
+ */
+template < class TLabelImage, class TDistanceImage, unsigned char MinimalSpacingPrecision, class TAccumulator >
+template < bool UseSpacing >
+void
+MultiLabelDistanceTransformImageFilter< TLabelImage, TDistanceImage, MinimalSpacingPrecision, TAccumulator >
+::ThreadedGenerateLabelLines(unsigned int d, unsigned long firstLine,
+    unsigned long numberOfLines, ProgressReporter &progress)
+{
+  DistanceImageType *distance = this->GetDistance();
+  const typename DistanceImageType::SpacingType spacing = distance->GetSpacing();
+  const RegionType &region = distance->GetBufferedRegion();
+  const unsigned int numberOfComponents = this->GetNumberOfComponents();
+
+  typedef itk::LowerEnvelopeOfParabolas<UseSpacing, TSpacingType, MinimalSpacingPrecision,
+          false, LabelPixelType,
+          typename TLabelImage::IndexValueType,
+          AccumulatorType> LEOP;
+
+  // The scanlines are walked on the raw buffer: One step along d is
+  // pixelStep pixels with numberOfComponents values each.
+  const OffsetValueType valueStep = distance->GetOffsetTable()[d] * numberOfComponents;
+  const long lineLength = region.GetSize()[d];
+  const long firstAbscissa = region.GetIndex()[d];
+  const DistanceValueType background = GetMaximumApexHeight();
+
+  DistanceValueType *distanceBuffer = distance->GetBufferPointer();
+
+  // One envelope per component for all scanlines, so their memory is
+  // allocated only once. The spacing is ignored by LEOP if
+  // UseSpacing == false.
+  std::vector<LEOP> envelopes(numberOfComponents,
+      LEOP(lineLength, UseSpacing ? static_cast<TSpacingType>(spacing[d]) : 1));
+  std::vector<unsigned long> numberOfParabolas(numberOfComponents);
+
+  for (unsigned long line = firstLine; line < firstLine + numberOfLines; ++line)
+  {
+    const OffsetValueType lineOffset =
+      distance->ComputeOffset(this->GetLineStartIndex(d, line)) * numberOfComponents;
+
+    for (unsigned int c = 0; c < numberOfComponents; ++c)
+    {
+      envelopes[c].clear();
+      numberOfParabolas[c] = 0;
+    }
+
+    // Feed all envelopes in one traversal of the scanline. Background
+    // apexes are left out: Wherever they would be minimal, the envelope is
+    // saturated to the background anyway.
+    const DistanceValueType *distanceIn = distanceBuffer + lineOffset;
+    for (long i = 0; i < lineLength; ++i, distanceIn += valueStep)
+    {
+      for (unsigned int c = 0; c < numberOfComponents; ++c)
+      {
+        if (distanceIn[c] < background)
+        {
+          envelopes[c].addParabola(firstAbscissa + i, DistanceToAccumulator(distanceIn[c]));
+          ++numberOfParabolas[c];
+        }
+      }
+    }
+
+    // A component without apexes is background along the whole scanline
+    // already
+    for (unsigned int c = 0; c < numberOfComponents; ++c)
+    {
+      if (numberOfParabolas[c] == 0)
+        continue;
+      StridedDistancePointer distanceOut(distanceBuffer + lineOffset + c, valueStep);
+      envelopes[c].uniformSample(firstAbscissa, lineLength, distanceOut);
+    }
+
+    progress.CompletedPixel();
+  }
+}
+
+/**
+ * Compute the envelopes of the nearest labels for a range of scanlines
+ */
+template < class TLabelImage, class TDistanceImage, unsigned char MinimalSpacingPrecision, class TAccumulator >
+template < bool UseSpacing >
+void
+MultiLabelDistanceTransformImageFilter< TLabelImage, TDistanceImage, MinimalSpacingPrecision, TAccumulator >
+::ThreadedGenerateNearestLines(unsigned int d, unsigned long firstLine,
+    unsigned long numberOfLines, ProgressReporter &progress)
+{
+  DistanceImageType *distance = this->GetDistance();
+  const typename DistanceImageType::SpacingType spacing = distance->GetSpacing();
+  const RegionType &region = distance->GetBufferedRegion();
+  const unsigned int k = m_NumberOfNearestLabels;
+
+  typedef itk::LowerEnvelopeOfParabolas<UseSpacing, TSpacingType, MinimalSpacingPrecision,
+          false, LabelPixelType,
+          typename TLabelImage::IndexValueType,
+          AccumulatorType> LEOP;
+
+  const OffsetValueType valueStep = distance->GetOffsetTable()[d] * k;
+  const long lineLength = region.GetSize()[d];
+  const long firstAbscissa = region.GetIndex()[d];
+  const DistanceValueType background = GetMaximumApexHeight();
+  const TSpacingType envelopeSpacing = UseSpacing ? static_cast<TSpacingType>(spacing[d]) : 1;
+
+  DistanceValueType *distanceBuffer = distance->GetBufferPointer();
+  LabelPixelType *nearestLabelsBuffer = this->GetNearestLabels()->GetBufferPointer();
+
+  // The envelopes of the labels on a scanline. They are kept for the
+  // following scanlines, so their memory is allocated only once.
+  std::vector<LEOP> envelopes;
+  std::vector<LabelPixelType> envelopeLabels;
+  std::map<LabelPixelType, unsigned int> envelopeOfLabel;
+  std::vector<DistanceValueType> samples(lineLength);
+
+  for (unsigned long line = firstLine; line < firstLine + numberOfLines; ++line)
+  {
+    const OffsetValueType lineOffset =
+      distance->ComputeOffset(this->GetLineStartIndex(d, line)) * k;
+
+    // Feed the envelope of each label in one traversal of the scanline. A
+    // label occurs at most once per pixel, so the apexes of an envelope are
+    // added with increasing abscissas. The components of a pixel are
+    // ordered by distance, the background ones come last.
+    envelopeOfLabel.clear();
+    unsigned int numberOfEnvelopes = 0;
+    const DistanceValueType *distanceIn = distanceBuffer + lineOffset;
+    const LabelPixelType *labelIn = nearestLabelsBuffer + lineOffset;
+    for (long i = 0; i < lineLength; ++i, distanceIn += valueStep, labelIn += valueStep)
+    {
+      for (unsigned int c = 0; c < k && distanceIn[c] < background; ++c)
+      {
+        typename std::map<LabelPixelType, unsigned int>::iterator found =
+          envelopeOfLabel.find(labelIn[c]);
+        unsigned int e;
+        if (found != envelopeOfLabel.end())
+          e = found->second;
+        else
+        {
+          e = numberOfEnvelopes++;
+          envelopeOfLabel[labelIn[c]] = e;
+          if (e == envelopes.size())
+          {
+            envelopes.push_back(LEOP(lineLength, envelopeSpacing));
+            envelopeLabels.push_back(labelIn[c]);
+          }
+          else
+          {
+            envelopes[e].clear();
+            envelopeLabels[e] = labelIn[c];
+          }
+        }
+        envelopes[e].addParabola(firstAbscissa + i, DistanceToAccumulator(distanceIn[c]));
+      }
+    }
+
+    if (numberOfEnvelopes == 0)
+    {
+      progress.CompletedPixel();
+      continue;
+    }
+
+    // The scanline is rebuilt from the envelopes
+    DistanceValueType *distanceOut = distanceBuffer + lineOffset;
+    LabelPixelType *labelOut = nearestLabelsBuffer + lineOffset;
+    for (long i = 0; i < lineLength; ++i, distanceOut += valueStep, labelOut += valueStep)
+    {
+      for (unsigned int c = 0; c < k; ++c)
+      {
+        distanceOut[c] = background;
+        labelOut[c] = m_BackgroundLabel;
+      }
+    }
+
+    // Sample each envelope and insert its samples into the k nearest
+    // labels of each pixel
+    for (unsigned int e = 0; e < numberOfEnvelopes; ++e)
+    {
+      StridedDistancePointer sampleOut(&samples[0], 1);
+      envelopes[e].uniformSample(firstAbscissa, lineLength, sampleOut);
+
+      const LabelPixelType label = envelopeLabels[e];
+      distanceOut = distanceBuffer + lineOffset;
+      labelOut = nearestLabelsBuffer + lineOffset;
+      for (long i = 0; i < lineLength; ++i, distanceOut += valueStep, labelOut += valueStep)
+      {
+        const DistanceValueType sample = samples[i];
+        if (!(sample < distanceOut[k - 1]))
+          continue;
+
+        unsigned int c = k - 1;
+        for (; c > 0 && sample < distanceOut[c - 1]; --c)
+        {
+          distanceOut[c] = distanceOut[c - 1];
+          labelOut[c] = labelOut[c - 1];
+        }
+        distanceOut[c] = sample;
+        labelOut[c] = label;
+      }
+    }
+
+    progress.CompletedPixel();
+  }
+}
+
+
+/**
+ * Dispatch the execution to the correct specialized TemplateGenerateData()
+ * method
+ */
+template < class TLabelImage, class TDistanceImage, unsigned char MinimalSpacingPrecision, class TAccumulator >
+void
+MultiLabelDistanceTransformImageFilter< TLabelImage, TDistanceImage, MinimalSpacingPrecision, TAccumulator >
+::GenerateData()
+{
+  if( m_UseSpacing )
+    {
+    TemplateGenerateData<true>();
+    }
+  else
+    {
+    TemplateGenerateData<false>();
+    }
+} // end GenerateData()
+
+/**
+ *  Print Self
+ */
+template < class TLabelImage, class TDistanceImage, unsigned char MinimalSpacingPrecision, class TAccumulator >
+void
+MultiLabelDistanceTransformImageFilter< TLabelImage, TDistanceImage, MinimalSpacingPrecision, TAccumulator >
+::PrintSelf(std::ostream& os, Indent indent) const
+{
+  Superclass::PrintSelf(os,indent);
+  os << indent << "UseSpacing: " << m_UseSpacing << std::endl;
+  os << indent << "NumberOfLabels: " << m_Labels.size() << std::endl;
+  os << indent << "NumberOfNearestLabels: " << m_NumberOfNearestLabels << std::endl;
+  os << indent << "BackgroundLabel: " << m_BackgroundLabel << std::endl;
+}
+} // end namespace itk
+#endif
@@ -0,0 +1,136 @@
+#ifndef __itkNumaTopology_h
+#define __itkNumaTopology_h
+
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#ifdef __linux__
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+namespace itk
+{
+
+/** \class NumaTopology
+*
+* The NUMA nodes of the machine and the CPUs that belong to them.
+*
+* On Linux, the nodes are read from /sys/devices/system/node. Elsewhere, or
+* if that information is not available, there is a single node and pinning
+* threads does nothing.
+*
+* Threads are assigned to nodes in blocks: Out of n threads, thread t runs
+* on node t * GetNumberOfNodes() / n. Data that is partitioned the same way
+* among the threads ends up on the node of the thread that first touches it.
+*
+* \ingroup ImageFeatureExtraction
+*
+*/
+class NumaTopology
+{
+public:
+  NumaTopology()
+    {
+#ifdef __linux__
+    for (unsigned int node = 0; ; ++node)
+    {
+      std::ostringstream fileName;
+      fileName << "/sys/devices/system/node/node" << node << "/cpulist";
+      std::ifstream file(fileName.str().c_str());
+      if (!file)
+        break;
+
+      std::string cpuList;
+      std::getline(file, cpuList);
+      m_NodeCpus.push_back(ParseCpuList(cpuList));
+    }
+#endif
+    }
+
+  /** Number of NUMA nodes, at least 1. */
+  unsigned int GetNumberOfNodes() const
+    { return m_NodeCpus.empty() ? 1 : m_NodeCpus.size(); }
+
+  /** Node of thread threadId out of numberOfThreads. */
+  unsigned int GetNodeOfThread(unsigned int threadId, unsigned int numberOfThreads) const
+    { return threadId * GetNumberOfNodes() / numberOfThreads; }
+
+  /** Pins the calling thread to the CPUs of a node while it exists and
+   * restores the previous affinity afterwards. Does nothing if there is
+   * only one node or if node is not a valid node number. */
+  class ScopedPin
+  {
+    public:
+      ScopedPin(const NumaTopology &topology, unsigned int node)
+        : m_Pinned(false)
+        {
+#ifdef __linux__
+        if (topology.GetNumberOfNodes() < 2 || node >= topology.m_NodeCpus.size())
+          return;
+
+        cpu_set_t cpus;
+        CPU_ZERO(&cpus);
+        const std::vector<int> &nodeCpus = topology.m_NodeCpus[node];
+        for (unsigned int i = 0; i < nodeCpus.size(); ++i)
+          if (nodeCpus[i] < CPU_SETSIZE)
+            CPU_SET(nodeCpus[i], &cpus);
+
+        if (pthread_getaffinity_np(pthread_self(), sizeof(m_PreviousCpus), &m_PreviousCpus) == 0 &&
+            pthread_setaffinity_np(pthread_self(), sizeof(cpus), &cpus) == 0)
+          m_Pinned = true;
+#else
+        (void)topology;
+        (void)node;
+#endif
+        }
+
+      ~ScopedPin()
+        {
+#ifdef __linux__
+        if (m_Pinned)
+          pthread_setaffinity_np(pthread_self(), sizeof(m_PreviousCpus), &m_PreviousCpus);
+#endif
+        }
+
+    private:
+      ScopedPin(const ScopedPin&); //purposely not implemented
+      void operator=(const ScopedPin&); //purposely not implemented
+
+      bool m_Pinned;
+#ifdef __linux__
+      cpu_set_t m_PreviousCpus;
+#endif
+  };
+
+private:
+  /** Parse lists like "0-7,16-23". */
+  static std::vector<int> ParseCpuList(const std::string &cpuList)
+    {
+    std::vector<int> cpus;
+    std::istringstream stream(cpuList);
+    std::string range;
+    while (std::getline(stream, range, ','))
+    {
+      int first, last;
+      char dash;
+      std::istringstream rangeStream(range);
+      if (!(rangeStream >> first))
+        continue;
+      if (!(rangeStream >> dash >> last))
+        last = first;
+      for (int cpu = first; cpu <= last; ++cpu)
+        cpus.push_back(cpu);
+    }
+    return cpus;
+    }
+
+  std::vector< std::vector<int> > m_NodeCpus;
+
+}; // end of NumaTopology class
+
+} //end namespace itk
+
+#endif
@@ -0,0 +1,224 @@
+#ifndef __itkSlabStreamingGeneralizedDistanceTransform_h
+#define __itkSlabStreamingGeneralizedDistanceTransform_h
+
+#include "itkObject.h"
+#include "itkBoundedQueue.h"
+#include "itkGeneralizedDistanceTransformImageFilter.h"
+
+namespace itk
+{
+
+/** \class SlabStreamingGeneralizedDistanceTransform
+*
+* Computes the generalized distance transform of an image that is read in
+* slabs along the last dimension, see
+* itk::GeneralizedDistanceTransformImageFilter for the transform itself.
+*
+* PIPELINE
+* The iterations over all dimensions but the last one only need the voxels
+* of one slab. Reading and transforming the slabs run in two threads that
+* are connected by a queue of GetQueueLength() slabs: While slab k is
+* transformed, slab k+1 is read. Each slab is transformed directly into its
+* part of the outputs. The iteration over the last dimension starts when
+* the last slab is done. If reading and computing take about the same time,
+* e.g. on a network filesystem, the wall time is almost halved.
+*
+* Subclasses provide the input by overriding ReadSlab(). It is called in
+* the order of the slabs, in the thread of the read stage.
+*
+* OUTPUTS
+* The geometry of the whole image is set with SetRegion(), SetSpacing()
+* and SetOrigin(). The outputs cover the whole image, see GetDistance() and
+* GetVoronoiMap(). Like with the filter, they can be computed into memory of
+* the caller, e.g. an itk::MappedImageFile, see SetDistanceImportPointer().
+*
+* Errors in any of the stages stop both of them, and Update() throws the
+* first error.
+*
+* \ingroup ImageFeatureExtraction
+*
+*/
+
+template <
+  class TFunctionImage,class TDistanceImage, class TLabelImage=TFunctionImage,
+        unsigned char MinimalSpacingPrecision=3,
+        class TAccumulator=typename TDistanceImage::PixelType >
+class ITK_EXPORT SlabStreamingGeneralizedDistanceTransform : public Object
+{
+public:
+  /** Standard class typedefs. */
+  typedef SlabStreamingGeneralizedDistanceTransform Self;
+  typedef Object Superclass;
+  typedef SmartPointer<Self> Pointer;
+  typedef SmartPointer<const Self> ConstPointer;
+
+  /** Run-time type information (and related methods). */
+  itkTypeMacro(SlabStreamingGeneralizedDistanceTransform, Object);
+
+  /** Image dimension. */
+  itkStaticConstMacro(ImageDimension, unsigned int, TFunctionImage::ImageDimension);
+
+  /** Types and pointer types for the images. */
+  typedef TFunctionImage FunctionImageType;
+  typedef TDistanceImage DistanceImageType;
+  typedef TLabelImage LabelImageType;
+
+  typedef typename FunctionImageType::ConstPointer FunctionImageConstPointer;
+  typedef typename LabelImageType::ConstPointer LabelImageConstPointer;
+  typedef typename DistanceImageType::Pointer DistanceImagePointer;
+  typedef typename LabelImageType::Pointer LabelImagePointer;
+  typedef typename DistanceImageType::PixelType DistancePixelType;
+  typedef typename LabelImageType::PixelType LabelPixelType;
+  typedef typename DistanceImageType::RegionType RegionType;
+  typedef typename DistanceImageType::SpacingType SpacingType;
+  typedef typename DistanceImageType::PointType PointType;
+
+  /** The filter that transforms a slab. */
+  typedef GeneralizedDistanceTransformImageFilter<TFunctionImage, TDistanceImage,
+          TLabelImage, MinimalSpacingPrecision, TAccumulator> SlabFilterType;
+
+  /** The filter that iterates over the last dimension. */
+  typedef GeneralizedDistanceTransformImageFilter<TDistanceImage, TDistanceImage,
+          TLabelImage, MinimalSpacingPrecision, TAccumulator> LastDimensionFilterType;
+
+  /** The apex height that marks background voxels. */
+  static DistancePixelType GetMaximumApexHeight()
+    { return SlabFilterType::GetMaximumApexHeight(); }
+
+  /** Set/Get the region of the whole image. */
+  itkSetMacro(Region, RegionType);
+  itkGetConstReferenceMacro(Region, RegionType);
+
+  /** Set/Get the spacing of the whole image. */
+  itkSetMacro(Spacing, SpacingType);
+  itkGetConstReferenceMacro(Spacing, SpacingType);
+
+  /** Set/Get the origin of the whole image. */
+  itkSetMacro(Origin, PointType);
+  itkGetConstReferenceMacro(Origin, PointType);
+
+  /** Set/Get the number of slices along the last dimension per slab.
+   * Default is 16. */
+  itkSetMacro(SlabThickness, unsigned long);
+  itkGetMacro(SlabThickness, unsigned long);
+
+  /** Set/Get the number of slabs that may wait for the transform. Default
+   * is 2. */
+  itkSetMacro(QueueLength, unsigned int);
+  itkGetMacro(QueueLength, unsigned int);
+
+  /** Set/Get wether spacing should be used or not. */
+  itkGetMacro(UseSpacing, bool);
+  itkSetMacro(UseSpacing, bool);
+  itkBooleanMacro(UseSpacing);
+
+  /** Set/Get wether voronoi maps should be created or not. */
+  itkGetMacro(CreateVoronoiMap, bool);
+  itkSetMacro(CreateVoronoiMap, bool);
+  itkBooleanMacro(CreateVoronoiMap);
+
+  /** Set/Get the number of threads of the transform stage. */
+  itkSetMacro(NumberOfThreads, int);
+  itkGetMacro(NumberOfThreads, int);
+
+  /** Set/Get a caller-provided buffer for the distance image. It must hold
+   * the pixels of GetRegion(). NULL, the default, lets the transform
+   * allocate the outputs. */
+  itkSetMacro(DistanceImportPointer, DistancePixelType *);
+  itkGetMacro(DistanceImportPointer, DistancePixelType *);
+
+  /** Set/Get a caller-provided buffer for the voronoi map.
+   * See SetDistanceImportPointer(). */
+  itkSetMacro(VoronoiMapImportPointer, LabelPixelType *);
+  itkGetMacro(VoronoiMapImportPointer, LabelPixelType *);
+
+  /** Number of slabs GetRegion() is split into. */
+  unsigned long GetNumberOfSlabs() const;
+
+  /** Region of slab number slab. */
+  RegionType GetSlabRegion(unsigned long slab) const;
+
+  /** Read and transform all slabs, then iterate over the last dimension. */
+  void Update();
+
+  /** The outputs of the last update. */
+  DistanceImageType *GetDistance()
+    { return m_Distance; }
+  LabelImageType *GetVoronoiMap()
+    { return m_VoronoiMap; }
+
+protected:
+  SlabStreamingGeneralizedDistanceTransform();
+  virtual ~SlabStreamingGeneralizedDistanceTransform() {};
+  void PrintSelf(std::ostream& os, Indent indent) const;
+
+  /** Provide the function image and, if voronoi maps are created, the
+   * label image of a slab. Their largest possible region must be
+   * slabRegion, and their spacing the one of the whole image. The images
+   * must be up to date, so that the reading is done in the thread of the
+   * read stage. */
+  virtual void ReadSlab(unsigned long slab, const RegionType &slabRegion,
+      FunctionImageConstPointer &functionImage, LabelImageConstPointer &labelImage) = 0;
+
+  /** A slab on its way through the pipeline. */
+  struct SlabType
+  {
+    unsigned long Number;
+    FunctionImageConstPointer Function;
+    LabelImageConstPointer Label;
+  };
+
+  /** The stages. TransformSlabs() runs in the thread of Update(). */
+  void ReadSlabs();
+  void TransformSlabs();
+
+  /** Iterate over the last dimension of the whole image in place. */
+  void TransformLastDimension();
+
+  /** Allocate the outputs or wrap the caller-provided buffers. */
+  void AllocateOutputs();
+
+  /** Static function used as a "callback" by the MultiThreader. */
+  static ITK_THREAD_RETURN_TYPE ReadSlabsThreaderCallback(void *arg);
+
+  /** Record the first error and stop all stages. */
+  void Abort(const ExceptionObject &error);
+
+  /** Has any of the stages failed? */
+  bool HasFailed();
+
+private:
+  SlabStreamingGeneralizedDistanceTransform(const Self&); //purposely not implemented
+  void operator=(const Self&); //purposely not implemented
+
+  RegionType m_Region;
+  SpacingType m_Spacing;
+  PointType m_Origin;
+  unsigned long m_SlabThickness;
+  unsigned int m_QueueLength;
+  bool m_UseSpacing;
+  bool m_CreateVoronoiMap;
+  int m_NumberOfThreads;
+
+  DistancePixelType *m_DistanceImportPointer;
+  LabelPixelType *m_VoronoiMapImportPointer;
+
+  BoundedQueue<SlabType> m_ReadQueue;
+
+  SimpleFastMutexLock m_ErrorLock;
+  bool m_Failed;
+  ExceptionObject m_Error;
+
+  DistanceImagePointer m_Distance;
+  LabelImagePointer m_VoronoiMap;
+
+}; // end of SlabStreamingGeneralizedDistanceTransform class
+
+} //end namespace itk
+
+
+#ifndef ITK_MANUAL_INSTANTIATION
+#include "itkSlabStreamingGeneralizedDistanceTransform.txx"
+#endif
+
+#endif
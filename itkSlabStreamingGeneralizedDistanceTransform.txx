@@ -0,0 +1,316 @@
+#ifndef __itkSlabStreamingGeneralizedDistanceTransform_txx
+#define __itkSlabStreamingGeneralizedDistanceTransform_txx
+
+#include <exception>
+
+#include "itkSlabStreamingGeneralizedDistanceTransform.h"
+#include "itkMultiThreader.h"
+
+namespace itk
+{
+
+
+/**
+ *    Constructor
+ */
+template < class TFunctionImage,class TDistanceImage, class TLabelImage, unsigned char MinimalSpacingPrecision, class TAccumulator >
+SlabStreamingGeneralizedDistanceTransform< TFunctionImage, TDistanceImage, TLabelImage, MinimalSpacingPrecision, TAccumulator >
+::SlabStreamingGeneralizedDistanceTransform()
+{
+  m_Spacing.Fill(1.0);
+  m_Origin.Fill(0.0);
+  m_SlabThickness = 16;
+  m_QueueLength = 2;
+  m_UseSpacing = true;
+  m_CreateVoronoiMap = true;
+  m_NumberOfThreads = MultiThreader::GetGlobalDefaultNumberOfThreads();
+  m_DistanceImportPointer = 0;
+  m_VoronoiMapImportPointer = 0;
+  m_Failed = false;
+}
+
+/**
+ * Number of slabs along the last dimension
+ */
+template < class TFunctionImage,class TDistanceImage, class TLabelImage, unsigned char MinimalSpacingPrecision, class TAccumulator >
+unsigned long
+SlabStreamingGeneralizedDistanceTransform< TFunctionImage, TDistanceImage, TLabelImage, MinimalSpacingPrecision, TAccumulator >
+::GetNumberOfSlabs() const
+{
+  const unsigned long thickness = std::max(1UL, m_SlabThickness);
+  return (m_Region.GetSize()[ImageDimension - 1] + thickness - 1) / thickness;
+}
+
+/**
+ * Region of a slab
+ */
+template < class TFunctionImage,class TDistanceImage, class TLabelImage, unsigned char MinimalSpacingPrecision, class TAccumulator >
+typename
+SlabStreamingGeneralizedDistanceTransform< TFunctionImage, TDistanceImage, TLabelImage, MinimalSpacingPrecision, TAccumulator >
+::RegionType
+SlabStreamingGeneralizedDistanceTransform< TFunctionImage, TDistanceImage, TLabelImage, MinimalSpacingPrecision, TAccumulator >
+::GetSlabRegion(unsigned long slab) const
+{
+  const unsigned long thickness = std::max(1UL, m_SlabThickness);
+  const unsigned long length = m_Region.GetSize()[ImageDimension - 1];
+  const unsigned long first = std::min(length, slab * thickness);
+
+  RegionType region = m_Region;
+  typename RegionType::IndexType index = region.GetIndex();
+  typename RegionType::SizeType size = region.GetSize();
+  index[ImageDimension - 1] += first;
+  size[ImageDimension - 1] = std::min(thickness, length - first);
+  region.SetIndex(index);
+  region.SetSize(size);
+  return region;
+}
+
+/**
+ * Run the stages until all slabs are transformed or one of them fails
+ */
+template < class TFunctionImage,class TDistanceImage, class TLabelImage, unsigned char MinimalSpacingPrecision, class TAccumulator >
+void
+SlabStreamingGeneralizedDistanceTransform< TFunctionImage, TDistanceImage, TLabelImage, MinimalSpacingPrecision, TAccumulator >
+::Update()
+{
+  if (m_Region.GetNumberOfPixels() == 0)
+    itkExceptionMacro(<< "The region of the image is empty");
+
+  this->AllocateOutputs();
+
+  m_ReadQueue.Reset(m_QueueLength);
+  m_Failed = false;
+
+  MultiThreader::Pointer threader = MultiThreader::New();
+  const int readerId = threader->SpawnThread(&Self::ReadSlabsThreaderCallback, this);
+
+  try
+  {
+    this->TransformSlabs();
+  }
+  catch (ExceptionObject &e)
+  {
+    this->Abort(e);
+  }
+  catch (std::exception &e)
+  {
+    this->Abort(ExceptionObject(__FILE__, __LINE__, e.what()));
+  }
+
+  threader->TerminateThread(readerId);
+
+  if (m_Failed)
+    throw m_Error;
+
+  this->TransformLastDimension();
+}
+
+/**
+ * Allocate the outputs
+ */
+template < class TFunctionImage,class TDistanceImage, class TLabelImage, unsigned char MinimalSpacingPrecision, class TAccumulator >
+void
+SlabStreamingGeneralizedDistanceTransform< TFunctionImage, TDistanceImage, TLabelImage, MinimalSpacingPrecision, TAccumulator >
+::AllocateOutputs()
+{
+  const unsigned long numberOfPixels = m_Region.GetNumberOfPixels();
+
+  m_Distance = DistanceImageType::New();
+  m_Distance->SetRegions(m_Region);
+  m_Distance->SetSpacing(m_Spacing);
+  m_Distance->SetOrigin(m_Origin);
+  if (m_DistanceImportPointer)
+    m_Distance->GetPixelContainer()->SetImportPointer(m_DistanceImportPointer,
+        numberOfPixels, false);
+  else
+    m_Distance->Allocate();
+
+  m_VoronoiMap = 0;
+  if (m_CreateVoronoiMap)
+  {
+    m_VoronoiMap = LabelImageType::New();
+    m_VoronoiMap->SetRegions(m_Region);
+    m_VoronoiMap->SetSpacing(m_Spacing);
+    m_VoronoiMap->SetOrigin(m_Origin);
+    if (m_VoronoiMapImportPointer)
+      m_VoronoiMap->GetPixelContainer()->SetImportPointer(m_VoronoiMapImportPointer,
+          numberOfPixels, false);
+    else
+      m_VoronoiMap->Allocate();
+  }
+}
+
+/**
+ * Read stage
+ */
+template < class TFunctionImage,class TDistanceImage, class TLabelImage, unsigned char MinimalSpacingPrecision, class TAccumulator >
+void
+SlabStreamingGeneralizedDistanceTransform< TFunctionImage, TDistanceImage, TLabelImage, MinimalSpacingPrecision, TAccumulator >
+::ReadSlabs()
+{
+  try
+  {
+    const unsigned long numberOfSlabs = this->GetNumberOfSlabs();
+    for (unsigned long k = 0; k < numberOfSlabs; ++k)
+    {
+      SlabType slab;
+      slab.Number = k;
+      this->ReadSlab(k, this->GetSlabRegion(k), slab.Function, slab.Label);
+      if (!slab.Function || (m_CreateVoronoiMap && !slab.Label))
+        itkExceptionMacro(<< "No input for slab " << k);
+
+      if (!m_ReadQueue.Push(slab))
+        return;
+    }
+  }
+  catch (ExceptionObject &e)
+  {
+    this->Abort(e);
+    return;
+  }
+  catch (std::exception &e)
+  {
+    this->Abort(ExceptionObject(__FILE__, __LINE__, e.what()));
+    return;
+  }
+
+  m_ReadQueue.Close();
+}
+
+/**
+ * Transform stage: all dimensions but the last one, within the slabs
+ */
+template < class TFunctionImage,class TDistanceImage, class TLabelImage, unsigned char MinimalSpacingPrecision, class TAccumulator >
+void
+SlabStreamingGeneralizedDistanceTransform< TFunctionImage, TDistanceImage, TLabelImage, MinimalSpacingPrecision, TAccumulator >
+::TransformSlabs()
+{
+  typename SlabFilterType::BooleanArrayType processedDimensions;
+  processedDimensions.Fill(true);
+  processedDimensions[ImageDimension - 1] = false;
+
+  const unsigned long slicePixels =
+    m_Region.GetNumberOfPixels() / m_Region.GetSize()[ImageDimension - 1];
+
+  unsigned long numberOfTransformedSlabs = 0;
+  SlabType slab;
+  while (m_ReadQueue.Pop(slab))
+  {
+    const RegionType slabRegion = this->GetSlabRegion(slab.Number);
+    const RegionType &region = slab.Function->GetLargestPossibleRegion();
+    if (region != slabRegion)
+      itkExceptionMacro(<< "Slab " << slab.Number << " has region " << region
+          << " instead of " << slabRegion);
+
+    typename SlabFilterType::Pointer filter = SlabFilterType::New();
+    filter->SetInput1(slab.Function);
+    if (m_CreateVoronoiMap)
+      filter->SetInput2(slab.Label);
+    filter->SetUseSpacing(m_UseSpacing);
+    filter->SetCreateVoronoiMap(m_CreateVoronoiMap);
+    filter->SetNumberOfThreads(m_NumberOfThreads);
+    filter->SetProcessedDimensions(processedDimensions);
+
+    // Transform directly into the slab of the outputs
+    const unsigned long offset = slicePixels *
+      (slabRegion.GetIndex()[ImageDimension - 1] - m_Region.GetIndex()[ImageDimension - 1]);
+    filter->SetDistanceImportPointer(m_Distance->GetBufferPointer() + offset);
+    if (m_CreateVoronoiMap)
+      filter->SetVoronoiMapImportPointer(m_VoronoiMap->GetBufferPointer() + offset);
+    filter->Update();
+    ++numberOfTransformedSlabs;
+  }
+
+  if (!this->HasFailed() && numberOfTransformedSlabs != this->GetNumberOfSlabs())
+    itkExceptionMacro(<< "Only " << numberOfTransformedSlabs << " of "
+        << this->GetNumberOfSlabs() << " slabs were transformed");
+}
+
+/**
+ * Iterate over the last dimension in place
+ */
+template < class TFunctionImage,class TDistanceImage, class TLabelImage, unsigned char MinimalSpacingPrecision, class TAccumulator >
+void
+SlabStreamingGeneralizedDistanceTransform< TFunctionImage, TDistanceImage, TLabelImage, MinimalSpacingPrecision, TAccumulator >
+::TransformLastDimension()
+{
+  typename LastDimensionFilterType::Pointer filter = LastDimensionFilterType::New();
+  filter->SetInput1(m_Distance);
+  if (m_CreateVoronoiMap)
+    filter->SetInput2(m_VoronoiMap);
+  filter->SetUseSpacing(m_UseSpacing);
+  filter->SetCreateVoronoiMap(m_CreateVoronoiMap);
+  filter->SetNumberOfThreads(m_NumberOfThreads);
+
+  typename LastDimensionFilterType::BooleanArrayType processedDimensions;
+  processedDimensions.Fill(false);
+  processedDimensions[ImageDimension - 1] = true;
+  filter->SetProcessedDimensions(processedDimensions);
+
+  filter->SetDistanceImportPointer(m_Distance->GetBufferPointer());
+  if (m_CreateVoronoiMap)
+    filter->SetVoronoiMapImportPointer(m_VoronoiMap->GetBufferPointer());
+  filter->Update();
+}
+
+template < class TFunctionImage,class TDistanceImage, class TLabelImage, unsigned char MinimalSpacingPrecision, class TAccumulator >
+ITK_THREAD_RETURN_TYPE
+SlabStreamingGeneralizedDistanceTransform< TFunctionImage, TDistanceImage, TLabelImage, MinimalSpacingPrecision, TAccumulator >
+::ReadSlabsThreaderCallback(void *arg)
+{
+  MultiThreader::ThreadInfoStruct *info =
+    static_cast<MultiThreader::ThreadInfoStruct *>(arg);
+  static_cast<Self *>(info->UserData)->ReadSlabs();
+  return ITK_THREAD_RETURN_VALUE;
+}
+
+/**
+ * Stop all stages after an error
+ */
+template < class TFunctionImage,class TDistanceImage, class TLabelImage, unsigned char MinimalSpacingPrecision, class TAccumulator >
+void
+SlabStreamingGeneralizedDistanceTransform< TFunctionImage, TDistanceImage, TLabelImage, MinimalSpacingPrecision, TAccumulator >
+::Abort(const ExceptionObject &error)
+{
+  m_ErrorLock.Lock();
+  if (!m_Failed)
+  {
+    m_Failed = true;
+    m_Error = error;
+  }
+  m_ErrorLock.Unlock();
+
+  m_ReadQueue.Abort();
+}
+
+template < class TFunctionImage,class TDistanceImage, class TLabelImage, unsigned char MinimalSpacingPrecision, class TAccumulator >
+bool
+SlabStreamingGeneralizedDistanceTransform< TFunctionImage, TDistanceImage, TLabelImage, MinimalSpacingPrecision, TAccumulator >
+::HasFailed()
+{
+  m_ErrorLock.Lock();
+  const bool failed = m_Failed;
+  m_ErrorLock.Unlock();
+  return failed;
+}
+
+/**
+ *  Print Self
+ */
+template < class TFunctionImage,class TDistanceImage, class TLabelImage, unsigned char MinimalSpacingPrecision, class TAccumulator >
+void
+SlabStreamingGeneralizedDistanceTransform< TFunctionImage, TDistanceImage, TLabelImage, MinimalSpacingPrecision, TAccumulator >
+::PrintSelf(std::ostream& os, Indent indent) const
+{
+  Superclass::PrintSelf(os,indent);
+  os << indent << "Region: " << m_Region << std::endl;
+  os << indent << "Spacing: " << m_Spacing << std::endl;
+  os << indent << "Origin: " << m_Origin << std::endl;
+  os << indent << "SlabThickness: " << m_SlabThickness << std::endl;
+  os << indent << "QueueLength: " << m_QueueLength << std::endl;
+  os << indent << "UseSpacing: " << m_UseSpacing << std::endl;
+  os << indent << "CreateVoronoiMap: " << m_CreateVoronoiMap << std::endl;
+  os << indent << "NumberOfThreads: " << m_NumberOfThreads << std::endl;
+}
+} // end namespace itk
+#endif
@@ -0,0 +1,67 @@
+#ifndef __itkSlabTransport_h
+#define __itkSlabTransport_h
+
+#include "itkObject.h"
+
+#include <vector>
+
+namespace itk
+{
+
+/** \class SlabTransport
+*
+* Abstract communication layer for itk::DistributedGeneralizedDistanceTransform.
+*
+* A transport connects a fixed group of processes. Each process has a rank in
+* [0, GetNumberOfProcesses()). The only collective operation that is needed
+* to redistribute slabs of an image is an all-to-all exchange of byte
+* buffers.
+*
+* Implementations may use MPI, sockets, shared memory or anything else. See
+* itk::LocalSocketSlabTransport for one that runs several processes on a
+* single machine.
+*
+* \ingroup ImageFeatureExtraction
+*
+*/
+class SlabTransport : public Object
+{
+public:
+  /** Standard class typedefs. */
+  typedef SlabTransport Self;
+  typedef Object Superclass;
+  typedef SmartPointer<Self> Pointer;
+  typedef SmartPointer<const Self> ConstPointer;
+
+  /** Run-time type information (and related methods). */
+  itkTypeMacro(SlabTransport, Object);
+
+  /** A byte buffer for each of the processes, indexed by rank. */
+  typedef std::vector<char> BufferType;
+  typedef std::vector<BufferType> BufferArrayType;
+
+  /** Rank of this process. */
+  virtual int GetRank() const = 0;
+
+  /** Number of processes connected by the transport. */
+  virtual int GetNumberOfProcesses() const = 0;
+
+  /** Send send[q] to the process with rank q and receive the buffer that
+   * process p sent to this one in receive[p], for all ranks. Must be called
+   * by all processes. send[GetRank()] is copied to receive[GetRank()].
+   * Errors are reported with exceptions. */
+  virtual void AllToAll(const BufferArrayType &send, BufferArrayType &receive) = 0;
+
+protected:
+  SlabTransport() {}
+  virtual ~SlabTransport() {}
+
+private:
+  SlabTransport(const Self&); //purposely not implemented
+  void operator=(const Self&); //purposely not implemented
+
+}; // end of SlabTransport class
+
+} //end namespace itk
+
+#endif
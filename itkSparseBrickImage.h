@@ -0,0 +1,159 @@
+#ifndef __itkSparseBrickImage_h
+#define __itkSparseBrickImage_h
+
+#include "itkObject.h"
+#include "itkImage.h"
+
+#include <map>
+#include <vector>
+
+namespace itk
+{
+
+/** \class SparseBrickImage
+*
+* An image that is split into bricks of GetBrickSize() voxels, of which only
+* the bricks with voxels other than GetBackgroundValue() are allocated. A
+* label volume that is mostly background needs memory for its foreground
+* bricks only.
+*
+* BRICKS
+* The bricks tile GetRegion(), starting at its index. The bricks at the
+* upper borders are clipped to the region. Bricks are numbered with the
+* first dimension varying fastest, see GetBrickRegion(). Each allocated brick
+* holds the voxels of its region in ITK's memory layout.
+*
+* The geometry must be set before the first brick is allocated. Changing it
+* removes all bricks.
+*
+* See itk::GeneralizedDistanceTransformImageFilter::SetSparseInputs() and
+* SetCreateSparseOutputs().
+*
+* \ingroup ImageFeatureExtraction
+*
+*/
+
+template < class TPixel, unsigned int VImageDimension >
+class ITK_EXPORT SparseBrickImage : public Object
+{
+public:
+  /** Standard class typedefs. */
+  typedef SparseBrickImage Self;
+  typedef Object Superclass;
+  typedef SmartPointer<Self> Pointer;
+  typedef SmartPointer<const Self> ConstPointer;
+
+  /** Method for creation through the object factory */
+  itkNewMacro(Self);
+
+  /** Run-time type information (and related methods). */
+  itkTypeMacro(SparseBrickImage, Object);
+
+  /** Image dimension. */
+  itkStaticConstMacro(ImageDimension, unsigned int, VImageDimension);
+
+  /** The dense image type with the same geometry. */
+  typedef Image<TPixel, VImageDimension> ImageType;
+  typedef TPixel PixelType;
+  typedef typename ImageType::IndexType IndexType;
+  typedef typename ImageType::SizeType SizeType;
+  typedef typename ImageType::RegionType RegionType;
+  typedef typename ImageType::SpacingType SpacingType;
+  typedef typename ImageType::PointType PointType;
+
+  /** The voxels of a brick, and the allocated bricks by number. */
+  typedef std::vector<PixelType> BrickType;
+  typedef std::map<unsigned long, BrickType> BrickContainerType;
+
+  /** Set/Get the region covered by the bricks. */
+  void SetRegion(const RegionType &region);
+  itkGetConstReferenceMacro(Region, RegionType);
+
+  /** Set/Get the size of the bricks. Default is 16 voxels along each
+   * dimension. */
+  void SetBrickSize(const SizeType &brickSize);
+  itkGetConstReferenceMacro(BrickSize, SizeType);
+
+  /** Set/Get the spacing and origin, as for a dense image. */
+  itkSetMacro(Spacing, SpacingType);
+  itkGetConstReferenceMacro(Spacing, SpacingType);
+  itkSetMacro(Origin, PointType);
+  itkGetConstReferenceMacro(Origin, PointType);
+
+  /** Set/Get the value of the voxels outside of the allocated bricks.
+   * Default is PixelType(). */
+  itkSetMacro(BackgroundValue, PixelType);
+  itkGetConstReferenceMacro(BackgroundValue, PixelType);
+
+  /** Number of bricks along each dimension. */
+  SizeType GetBrickGridSize() const;
+
+  /** Number of bricks that tile the region, allocated or not. */
+  unsigned long GetNumberOfBricks() const;
+
+  /** Number of allocated bricks. */
+  unsigned long GetNumberOfAllocatedBricks() const
+    { return m_Bricks.size(); }
+
+  /** Region of a brick, clipped to GetRegion(). */
+  RegionType GetBrickRegion(unsigned long brick) const;
+
+  /** Number of the brick that contains index. */
+  unsigned long ComputeBrickNumber(const IndexType &index) const;
+
+  /** The voxels of a brick, or NULL if the brick is not allocated. */
+  BrickType *GetBrick(unsigned long brick);
+  const BrickType *GetBrick(unsigned long brick) const;
+
+  /** Allocate a brick, filled with the background value. A brick that is
+   * already allocated is returned as it is. */
+  BrickType &AllocateBrick(unsigned long brick);
+
+  /** Free a brick. Its voxels are background again. */
+  void RemoveBrick(unsigned long brick);
+
+  /** Free all bricks. */
+  void RemoveAllBricks();
+
+  /** The allocated bricks, in the order of their numbers. */
+  const BrickContainerType &GetBricks() const
+    { return m_Bricks; }
+
+  /** The value at index. Outside of GetRegion(), it is the background
+   * value. */
+  PixelType GetPixel(const IndexType &index) const;
+
+  /** Set the value at index. The brick is allocated unless value is the
+   * background value. */
+  void SetPixel(const IndexType &index, const PixelType &value);
+
+protected:
+  SparseBrickImage();
+  virtual ~SparseBrickImage() {};
+  void PrintSelf(std::ostream& os, Indent indent) const;
+
+  /** Offset of index in the voxels of its brick. */
+  unsigned long ComputeOffsetInBrick(unsigned long brick, const IndexType &index) const;
+
+private:
+  SparseBrickImage(const Self&); //purposely not implemented
+  void operator=(const Self&); //purposely not implemented
+
+  RegionType m_Region;
+  SizeType m_BrickSize;
+  SpacingType m_Spacing;
+  PointType m_Origin;
+  PixelType m_BackgroundValue;
+
+  BrickContainerType m_Bricks;
+
+}; // end of SparseBrickImage class
+
+} //end namespace itk
+
+
+#ifndef ITK_MANUAL_INSTANTIATION
+#include "itkSparseBrickImage.txx"
+#endif
+
+#endif
@@ -0,0 +1,228 @@
+#ifndef __itkSparseBrickImage_txx
+#define __itkSparseBrickImage_txx
+
+#include <algorithm>
+
+#include "itkSparseBrickImage.h"
+
+namespace itk
+{
+
+/**
+ *    Constructor
+ */
+template < class TPixel, unsigned int VImageDimension >
+SparseBrickImage< TPixel, VImageDimension >
+::SparseBrickImage()
+{
+  m_BrickSize.Fill(16);
+  m_Spacing.Fill(1.0);
+  m_Origin.Fill(0.0);
+  m_BackgroundValue = PixelType();
+}
+
+/**
+ * A new geometry invalidates the bricks
+ */
+template < class TPixel, unsigned int VImageDimension >
+void
+SparseBrickImage< TPixel, VImageDimension >
+::SetRegion(const RegionType &region)
+{
+  if (region == m_Region)
+    return;
+  m_Region = region;
+  m_Bricks.clear();
+  this->Modified();
+}
+
+template < class TPixel, unsigned int VImageDimension >
+void
+SparseBrickImage< TPixel, VImageDimension >
+::SetBrickSize(const SizeType &brickSize)
+{
+  for (unsigned int d = 0; d < ImageDimension; ++d)
+    if (brickSize[d] == 0)
+      itkExceptionMacro(<< "Brick size of dimension " << d << " is 0");
+
+  if (brickSize == m_BrickSize)
+    return;
+  m_BrickSize = brickSize;
+  m_Bricks.clear();
+  this->Modified();
+}
+
+template < class TPixel, unsigned int VImageDimension >
+typename SparseBrickImage< TPixel, VImageDimension >::SizeType
+SparseBrickImage< TPixel, VImageDimension >
+::GetBrickGridSize() const
+{
+  SizeType gridSize;
+  for (unsigned int d = 0; d < ImageDimension; ++d)
+    gridSize[d] = (m_Region.GetSize()[d] + m_BrickSize[d] - 1) / m_BrickSize[d];
+  return gridSize;
+}
+
+template < class TPixel, unsigned int VImageDimension >
+unsigned long
+SparseBrickImage< TPixel, VImageDimension >
+::GetNumberOfBricks() const
+{
+  const SizeType gridSize = this->GetBrickGridSize();
+  unsigned long numberOfBricks = 1;
+  for (unsigned int d = 0; d < ImageDimension; ++d)
+    numberOfBricks *= gridSize[d];
+  return numberOfBricks;
+}
+
+template < class TPixel, unsigned int VImageDimension >
+typename SparseBrickImage< TPixel, VImageDimension >::RegionType
+SparseBrickImage< TPixel, VImageDimension >
+::GetBrickRegion(unsigned long brick) const
+{
+  const SizeType gridSize = this->GetBrickGridSize();
+  IndexType index;
+  SizeType size;
+  for (unsigned int d = 0; d < ImageDimension; ++d)
+  {
+    const unsigned long position = (brick % gridSize[d]) * m_BrickSize[d];
+    brick /= gridSize[d];
+    index[d] = m_Region.GetIndex()[d] + static_cast<long>(position);
+    size[d] = std::min(static_cast<unsigned long>(m_BrickSize[d]),
+        static_cast<unsigned long>(m_Region.GetSize()[d]) - position);
+  }
+  return RegionType(index, size);
+}
+
+template < class TPixel, unsigned int VImageDimension >
+unsigned long
+SparseBrickImage< TPixel, VImageDimension >
+::ComputeBrickNumber(const IndexType &index) const
+{
+  const SizeType gridSize = this->GetBrickGridSize();
+  unsigned long brick = 0;
+  for (int d = ImageDimension - 1; d >= 0; --d)
+    brick = brick * gridSize[d] +
+      (index[d] - m_Region.GetIndex()[d]) / m_BrickSize[d];
+  return brick;
+}
+
+template < class TPixel, unsigned int VImageDimension >
+unsigned long
+SparseBrickImage< TPixel, VImageDimension >
+::ComputeOffsetInBrick(unsigned long brick, const IndexType &index) const
+{
+  const RegionType brickRegion = this->GetBrickRegion(brick);
+  unsigned long offset = 0;
+  for (int d = ImageDimension - 1; d >= 0; --d)
+    offset = offset * brickRegion.GetSize()[d] + (index[d] - brickRegion.GetIndex()[d]);
+  return offset;
+}
+
+template < class TPixel, unsigned int VImageDimension >
+typename SparseBrickImage< TPixel, VImageDimension >::BrickType *
+SparseBrickImage< TPixel, VImageDimension >
+::GetBrick(unsigned long brick)
+{
+  typename BrickContainerType::iterator it = m_Bricks.find(brick);
+  return it == m_Bricks.end() ? 0 : &it->second;
+}
+
+template < class TPixel, unsigned int VImageDimension >
+const typename SparseBrickImage< TPixel, VImageDimension >::BrickType *
+SparseBrickImage< TPixel, VImageDimension >
+::GetBrick(unsigned long brick) const
+{
+  typename BrickContainerType::const_iterator it = m_Bricks.find(brick);
+  return it == m_Bricks.end() ? 0 : &it->second;
+}
+
+template < class TPixel, unsigned int VImageDimension >
+typename SparseBrickImage< TPixel, VImageDimension >::BrickType &
+SparseBrickImage< TPixel, VImageDimension >
+::AllocateBrick(unsigned long brick)
+{
+  if (brick >= this->GetNumberOfBricks())
+    itkExceptionMacro(<< "Brick " << brick << " is outside of the region " << m_Region);
+
+  BrickType &voxels = m_Bricks[brick];
+  if (voxels.empty())
+    voxels.assign(this->GetBrickRegion(brick).GetNumberOfPixels(), m_BackgroundValue);
+  this->Modified();
+  return voxels;
+}
+
+template < class TPixel, unsigned int VImageDimension >
+void
+SparseBrickImage< TPixel, VImageDimension >
+::RemoveBrick(unsigned long brick)
+{
+  if (m_Bricks.erase(brick))
+    this->Modified();
+}
+
+template < class TPixel, unsigned int VImageDimension >
+void
+SparseBrickImage< TPixel, VImageDimension >
+::RemoveAllBricks()
+{
+  m_Bricks.clear();
+  this->Modified();
+}
+
+template < class TPixel, unsigned int VImageDimension >
+typename SparseBrickImage< TPixel, VImageDimension >::PixelType
+SparseBrickImage< TPixel, VImageDimension >
+::GetPixel(const IndexType &index) const
+{
+  if (!m_Region.IsInside(index))
+    return m_BackgroundValue;
+
+  const unsigned long brick = this->ComputeBrickNumber(index);
+  const BrickType *voxels = this->GetBrick(brick);
+  if (!voxels)
+    return m_BackgroundValue;
+  return (*voxels)[this->ComputeOffsetInBrick(brick, index)];
+}
+
+template < class TPixel, unsigned int VImageDimension >
+void
+SparseBrickImage< TPixel, VImageDimension >
+::SetPixel(const IndexType &index, const PixelType &value)
+{
+  if (!m_Region.IsInside(index))
+    itkExceptionMacro(<< "Index " << index << " is outside of the region " << m_Region);
+
+  const unsigned long brick = this->ComputeBrickNumber(index);
+  BrickType *voxels = this->GetBrick(brick);
+  if (!voxels)
+  {
+    // Background in an unallocated brick is there already
+    if (value == m_BackgroundValue)
+      return;
+    voxels = &this->AllocateBrick(brick);
+  }
+  (*voxels)[this->ComputeOffsetInBrick(brick, index)] = value;
+  this->Modified();
+}
+
+/**
+ *  Print Self
+ */
+template < class TPixel, unsigned int VImageDimension >
+void
+SparseBrickImage< TPixel, VImageDimension >
+::PrintSelf(std::ostream& os, Indent indent) const
+{
+  Superclass::PrintSelf(os,indent);
+  os << indent << "Region: " << m_Region << std::endl;
+  os << indent << "BrickSize: " << m_BrickSize << std::endl;
+  os << indent << "Spacing: " << m_Spacing << std::endl;
+  os << indent << "Origin: " << m_Origin << std::endl;
+  os << indent << "BackgroundValue: " << m_BackgroundValue << std::endl;
+  os << indent << "NumberOfBricks: " << this->GetNumberOfBricks() << std::endl;
+  os << indent << "NumberOfAllocatedBricks: " << m_Bricks.size() << std::endl;
+}
+
+} // end namespace itk
+#endif
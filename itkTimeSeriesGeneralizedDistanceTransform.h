@@ -0,0 +1,212 @@
+#ifndef __itkTimeSeriesGeneralizedDistanceTransform_h
+#define __itkTimeSeriesGeneralizedDistanceTransform_h
+
+#include "itkObject.h"
+#include "itkBoundedQueue.h"
+#include "itkGeneralizedDistanceTransformImageFilter.h"
+
+namespace itk
+{
+
+/** \class TimeSeriesGeneralizedDistanceTransform
+*
+* Computes the generalized distance transform of a series of frames, see
+* itk::GeneralizedDistanceTransformImageFilter for the transform itself.
+*
+* PIPELINE
+* Reading, transforming and writing the frames run in three threads that are
+* connected by queues of GetQueueLength() frames. While frame n is
+* transformed, frame n+1 is read and frame n-1 is written, so the time per
+* frame approaches the slowest of the three stages instead of their sum.
+*
+* Subclasses provide the input and output of the frames by overriding
+* ReadFrame() and WriteFrame(). They are called in the order of the frames,
+* each in its own thread.
+*
+* TIME AS A DIMENSION
+* By default the frames are independent. With SetTimeIsDimension(), time is
+* an additional dimension with spacing GetTimeSpacing(): The distances are
+* minimal over space and time. The frames are still read and transformed
+* along the spatial dimensions in the pipeline, directly into one image of
+* the whole series. The iteration over time follows when the last frame is
+* done, then the frames are written. Memory for the whole series is needed
+* in that case.
+*
+* Errors in any of the stages stop all of them, and Update() throws the
+* first error.
+*
+* \ingroup ImageFeatureExtraction
+*
+*/
+
+template <
+  class TFunctionImage,class TDistanceImage, class TLabelImage=TFunctionImage,
+        unsigned char MinimalSpacingPrecision=3,
+        class TAccumulator=typename TDistanceImage::PixelType >
+class ITK_EXPORT TimeSeriesGeneralizedDistanceTransform : public Object
+{
+public:
+  /** Standard class typedefs. */
+  typedef TimeSeriesGeneralizedDistanceTransform Self;
+  typedef Object Superclass;
+  typedef SmartPointer<Self> Pointer;
+  typedef SmartPointer<const Self> ConstPointer;
+
+  /** Run-time type information (and related methods). */
+  itkTypeMacro(TimeSeriesGeneralizedDistanceTransform, Object);
+
+  /** Dimension of the frames. */
+  itkStaticConstMacro(ImageDimension, unsigned int, TFunctionImage::ImageDimension);
+
+  /** Types and pointer types for the frames. */
+  typedef TFunctionImage FunctionImageType;
+  typedef TDistanceImage DistanceImageType;
+  typedef TLabelImage LabelImageType;
+
+  typedef typename FunctionImageType::ConstPointer FunctionImageConstPointer;
+  typedef typename LabelImageType::ConstPointer LabelImageConstPointer;
+  typedef typename DistanceImageType::Pointer DistanceImagePointer;
+  typedef typename LabelImageType::Pointer LabelImagePointer;
+  typedef typename DistanceImageType::PixelType DistancePixelType;
+  typedef typename LabelImageType::PixelType LabelPixelType;
+  typedef typename DistanceImageType::RegionType RegionType;
+  typedef typename DistanceImageType::SpacingType SpacingType;
+  typedef typename DistanceImageType::PointType PointType;
+
+  /** The filter that transforms a frame. */
+  typedef GeneralizedDistanceTransformImageFilter<TFunctionImage, TDistanceImage,
+          TLabelImage, MinimalSpacingPrecision, TAccumulator> FrameFilterType;
+
+  /** Images of the whole series if time is a dimension. */
+  typedef Image<DistancePixelType, ImageDimension + 1> SeriesDistanceImageType;
+  typedef Image<LabelPixelType, ImageDimension + 1> SeriesLabelImageType;
+
+  /** The filter that iterates over time if time is a dimension. */
+  typedef GeneralizedDistanceTransformImageFilter<SeriesDistanceImageType,
+          SeriesDistanceImageType, SeriesLabelImageType, MinimalSpacingPrecision,
+          TAccumulator> SeriesFilterType;
+
+  /** The apex height that marks background voxels. */
+  static DistancePixelType GetMaximumApexHeight()
+    { return FrameFilterType::GetMaximumApexHeight(); }
+
+  /** Set/Get the number of frames. */
+  itkSetMacro(NumberOfFrames, unsigned int);
+  itkGetMacro(NumberOfFrames, unsigned int);
+
+  /** Set/Get the number of frames that may wait between two stages.
+   * Default is 2. */
+  itkSetMacro(QueueLength, unsigned int);
+  itkGetMacro(QueueLength, unsigned int);
+
+  /** Set/Get wether time is a dimension of the transform. Default is
+   * false. */
+  itkGetMacro(TimeIsDimension, bool);
+  itkSetMacro(TimeIsDimension, bool);
+  itkBooleanMacro(TimeIsDimension);
+
+  /** Set/Get the spacing along time if time is a dimension and spacing is
+   * used. Default is 1. */
+  itkSetMacro(TimeSpacing, double);
+  itkGetMacro(TimeSpacing, double);
+
+  /** Set/Get wether spacing should be used or not. */
+  itkGetMacro(UseSpacing, bool);
+  itkSetMacro(UseSpacing, bool);
+  itkBooleanMacro(UseSpacing);
+
+  /** Set/Get wether voronoi maps should be created or not. */
+  itkGetMacro(CreateVoronoiMap, bool);
+  itkSetMacro(CreateVoronoiMap, bool);
+  itkBooleanMacro(CreateVoronoiMap);
+
+  /** Set/Get the number of threads of the transform stage. */
+  itkSetMacro(NumberOfThreads, int);
+  itkGetMacro(NumberOfThreads, int);
+
+  /** Process all frames. */
+  void Update();
+
+protected:
+  TimeSeriesGeneralizedDistanceTransform();
+  virtual ~TimeSeriesGeneralizedDistanceTransform() {};
+  void PrintSelf(std::ostream& os, Indent indent) const;
+
+  /** Provide the function image and, if voronoi maps are created, the
+   * label image of a frame. The images must be up to date, e.g. by calling
+   * Update() on their source, so that the reading is done in the thread of
+   * the read stage. All frames must have the same largest possible
+   * region. */
+  virtual void ReadFrame(unsigned int frame, FunctionImageConstPointer &functionImage,
+      LabelImageConstPointer &labelImage) = 0;
+
+  /** Store the result of a frame. voronoiMap is NULL if no voronoi maps are
+   * created. */
+  virtual void WriteFrame(unsigned int frame, DistanceImageType *distance,
+      LabelImageType *voronoiMap) = 0;
+
+  /** A frame on its way through the pipeline. */
+  struct FrameType
+  {
+    unsigned int Number;
+    FunctionImageConstPointer Function;
+    LabelImageConstPointer Label;
+    DistanceImagePointer Distance;
+    LabelImagePointer VoronoiMap;
+  };
+
+  /** The stages. TransformFrames() runs in the thread of Update(). */
+  void ReadFrames();
+  void TransformFrames();
+  void WriteFrames();
+
+  /** Iterate over time and queue the frames of the series for writing. */
+  void TransformSeries();
+
+  /** Static functions used as a "callback" by the MultiThreader. */
+  static ITK_THREAD_RETURN_TYPE ReadFramesThreaderCallback(void *arg);
+  static ITK_THREAD_RETURN_TYPE WriteFramesThreaderCallback(void *arg);
+
+  /** Record the first error and stop all stages. */
+  void Abort(const ExceptionObject &error);
+
+  /** Has any of the stages failed? */
+  bool HasFailed();
+
+private:
+  TimeSeriesGeneralizedDistanceTransform(const Self&); //purposely not implemented
+  void operator=(const Self&); //purposely not implemented
+
+  unsigned int m_NumberOfFrames;
+  unsigned int m_QueueLength;
+  bool m_TimeIsDimension;
+  double m_TimeSpacing;
+  bool m_UseSpacing;
+  bool m_CreateVoronoiMap;
+  int m_NumberOfThreads;
+
+  BoundedQueue<FrameType> m_ReadQueue;
+  BoundedQueue<FrameType> m_WriteQueue;
+
+  SimpleFastMutexLock m_ErrorLock;
+  bool m_Failed;
+  ExceptionObject m_Error;
+
+  /** The geometry of the frames and, if time is a dimension, the
+   * series. */
+  RegionType m_FrameRegion;
+  SpacingType m_FrameSpacing;
+  PointType m_FrameOrigin;
+  typename SeriesDistanceImageType::Pointer m_SeriesDistance;
+  typename SeriesLabelImageType::Pointer m_SeriesVoronoiMap;
+
+}; // end of TimeSeriesGeneralizedDistanceTransform class
+
+} //end namespace itk
+
+
+#ifndef ITK_MANUAL_INSTANTIATION
+#include "itkTimeSeriesGeneralizedDistanceTransform.txx"
+#endif
+
+#endif
@@ -0,0 +1,360 @@
+#ifndef __itkTimeSeriesGeneralizedDistanceTransform_txx
+#define __itkTimeSeriesGeneralizedDistanceTransform_txx
+
+#include <exception>
+
+#include "itkTimeSeriesGeneralizedDistanceTransform.h"
+#include "itkMultiThreader.h"
+
+namespace itk
+{
+
+
+/**
+ *    Constructor
+ */
+template < class TFunctionImage,class TDistanceImage, class TLabelImage, unsigned char MinimalSpacingPrecision, class TAccumulator >
+TimeSeriesGeneralizedDistanceTransform< TFunctionImage, TDistanceImage, TLabelImage, MinimalSpacingPrecision, TAccumulator >
+::TimeSeriesGeneralizedDistanceTransform()
+{
+  m_NumberOfFrames = 0;
+  m_QueueLength = 2;
+  m_TimeIsDimension = false;
+  m_TimeSpacing = 1.0;
+  m_UseSpacing = true;
+  m_CreateVoronoiMap = true;
+  m_NumberOfThreads = MultiThreader::GetGlobalDefaultNumberOfThreads();
+  m_Failed = false;
+}
+
+/**
+ * Run the stages until all frames are written or one of them fails
+ */
+template < class TFunctionImage,class TDistanceImage, class TLabelImage, unsigned char MinimalSpacingPrecision, class TAccumulator >
+void
+TimeSeriesGeneralizedDistanceTransform< TFunctionImage, TDistanceImage, TLabelImage, MinimalSpacingPrecision, TAccumulator >
+::Update()
+{
+  m_ReadQueue.Reset(m_QueueLength);
+  m_WriteQueue.Reset(m_QueueLength);
+  m_Failed = false;
+
+  MultiThreader::Pointer threader = MultiThreader::New();
+  const int readerId = threader->SpawnThread(&Self::ReadFramesThreaderCallback, this);
+  const int writerId = threader->SpawnThread(&Self::WriteFramesThreaderCallback, this);
+
+  try
+  {
+    this->TransformFrames();
+  }
+  catch (ExceptionObject &e)
+  {
+    this->Abort(e);
+  }
+  catch (std::exception &e)
+  {
+    this->Abort(ExceptionObject(__FILE__, __LINE__, e.what()));
+  }
+
+  // The writer stops after the last frame
+  m_WriteQueue.Close();
+  threader->TerminateThread(writerId);
+  threader->TerminateThread(readerId);
+
+  m_SeriesDistance = 0;
+  m_SeriesVoronoiMap = 0;
+
+  if (m_Failed)
+    throw m_Error;
+}
+
+/**
+ * Read stage
+ */
+template < class TFunctionImage,class TDistanceImage, class TLabelImage, unsigned char MinimalSpacingPrecision, class TAccumulator >
+void
+TimeSeriesGeneralizedDistanceTransform< TFunctionImage, TDistanceImage, TLabelImage, MinimalSpacingPrecision, TAccumulator >
+::ReadFrames()
+{
+  try
+  {
+    for (unsigned int t = 0; t < m_NumberOfFrames; ++t)
+    {
+      FrameType frame;
+      frame.Number = t;
+      this->ReadFrame(t, frame.Function, frame.Label);
+      if (!frame.Function || (m_CreateVoronoiMap && !frame.Label))
+        itkExceptionMacro(<< "No input for frame " << t);
+
+      if (!m_ReadQueue.Push(frame))
+        return;
+    }
+  }
+  catch (ExceptionObject &e)
+  {
+    this->Abort(e);
+    return;
+  }
+  catch (std::exception &e)
+  {
+    this->Abort(ExceptionObject(__FILE__, __LINE__, e.what()));
+    return;
+  }
+
+  m_ReadQueue.Close();
+}
+
+/**
+ * Transform stage
+ */
+template < class TFunctionImage,class TDistanceImage, class TLabelImage, unsigned char MinimalSpacingPrecision, class TAccumulator >
+void
+TimeSeriesGeneralizedDistanceTransform< TFunctionImage, TDistanceImage, TLabelImage, MinimalSpacingPrecision, TAccumulator >
+::TransformFrames()
+{
+  unsigned int numberOfTransformedFrames = 0;
+  unsigned long framePixels = 0;
+
+  FrameType frame;
+  while (m_ReadQueue.Pop(frame))
+  {
+    const RegionType &region = frame.Function->GetLargestPossibleRegion();
+    if (numberOfTransformedFrames == 0)
+    {
+      m_FrameRegion = region;
+      m_FrameSpacing = frame.Function->GetSpacing();
+      m_FrameOrigin = frame.Function->GetOrigin();
+      framePixels = region.GetNumberOfPixels();
+    }
+    else if (region != m_FrameRegion)
+      itkExceptionMacro(<< "Frame " << frame.Number << " has region " << region
+          << " instead of " << m_FrameRegion);
+
+    typename FrameFilterType::Pointer filter = FrameFilterType::New();
+    filter->SetInput1(frame.Function);
+    if (m_CreateVoronoiMap)
+      filter->SetInput2(frame.Label);
+    filter->SetUseSpacing(m_UseSpacing);
+    filter->SetCreateVoronoiMap(m_CreateVoronoiMap);
+    filter->SetNumberOfThreads(m_NumberOfThreads);
+
+    if (m_TimeIsDimension)
+    {
+      if (!m_SeriesDistance)
+      {
+        // The frames follow each other along the last dimension of the
+        // series
+        typename SeriesDistanceImageType::IndexType seriesIndex;
+        typename SeriesDistanceImageType::SizeType seriesSize;
+        typename SeriesDistanceImageType::SpacingType seriesSpacing;
+        typename SeriesDistanceImageType::PointType seriesOrigin;
+        for (unsigned int d = 0; d < ImageDimension; ++d)
+        {
+          seriesIndex[d] = m_FrameRegion.GetIndex()[d];
+          seriesSize[d] = m_FrameRegion.GetSize()[d];
+          seriesSpacing[d] = m_FrameSpacing[d];
+          seriesOrigin[d] = m_FrameOrigin[d];
+        }
+        seriesIndex[ImageDimension] = 0;
+        seriesSize[ImageDimension] = m_NumberOfFrames;
+        seriesSpacing[ImageDimension] = m_TimeSpacing;
+        seriesOrigin[ImageDimension] = 0.0;
+        const typename SeriesDistanceImageType::RegionType seriesRegion(seriesIndex, seriesSize);
+
+        m_SeriesDistance = SeriesDistanceImageType::New();
+        m_SeriesDistance->SetRegions(seriesRegion);
+        m_SeriesDistance->SetSpacing(seriesSpacing);
+        m_SeriesDistance->SetOrigin(seriesOrigin);
+        m_SeriesDistance->Allocate();
+
+        if (m_CreateVoronoiMap)
+        {
+          m_SeriesVoronoiMap = SeriesLabelImageType::New();
+          m_SeriesVoronoiMap->SetRegions(seriesRegion);
+          m_SeriesVoronoiMap->SetSpacing(seriesSpacing);
+          m_SeriesVoronoiMap->SetOrigin(seriesOrigin);
+          m_SeriesVoronoiMap->Allocate();
+        }
+      }
+
+      // Transform directly into the frame of the series
+      const unsigned long offset = frame.Number * framePixels;
+      filter->SetDistanceImportPointer(m_SeriesDistance->GetBufferPointer() + offset);
+      if (m_CreateVoronoiMap)
+        filter->SetVoronoiMapImportPointer(m_SeriesVoronoiMap->GetBufferPointer() + offset);
+      filter->Update();
+      ++numberOfTransformedFrames;
+      continue;
+    }
+
+    filter->Update();
+    ++numberOfTransformedFrames;
+
+    // Release the input before waiting for the writer
+    frame.Function = 0;
+    frame.Label = 0;
+    frame.Distance = filter->GetDistance();
+    if (m_CreateVoronoiMap)
+      frame.VoronoiMap = filter->GetVoronoiMap();
+    if (!m_WriteQueue.Push(frame))
+      return;
+  }
+
+  if (m_TimeIsDimension && !this->HasFailed() &&
+      numberOfTransformedFrames == m_NumberOfFrames && m_NumberOfFrames > 0)
+    this->TransformSeries();
+}
+
+/**
+ * Iterate over time and queue the frames for writing
+ */
+template < class TFunctionImage,class TDistanceImage, class TLabelImage, unsigned char MinimalSpacingPrecision, class TAccumulator >
+void
+TimeSeriesGeneralizedDistanceTransform< TFunctionImage, TDistanceImage, TLabelImage, MinimalSpacingPrecision, TAccumulator >
+::TransformSeries()
+{
+  // The series is transformed in place along time only
+  typename SeriesFilterType::Pointer filter = SeriesFilterType::New();
+  filter->SetInput1(m_SeriesDistance);
+  if (m_CreateVoronoiMap)
+    filter->SetInput2(m_SeriesVoronoiMap);
+  filter->SetUseSpacing(m_UseSpacing);
+  filter->SetCreateVoronoiMap(m_CreateVoronoiMap);
+  filter->SetNumberOfThreads(m_NumberOfThreads);
+
+  typename SeriesFilterType::BooleanArrayType processedDimensions;
+  processedDimensions.Fill(false);
+  processedDimensions[ImageDimension] = true;
+  filter->SetProcessedDimensions(processedDimensions);
+
+  filter->SetDistanceImportPointer(m_SeriesDistance->GetBufferPointer());
+  if (m_CreateVoronoiMap)
+    filter->SetVoronoiMapImportPointer(m_SeriesVoronoiMap->GetBufferPointer());
+  filter->Update();
+
+  // The frames to write refer to the memory of the series, which is kept
+  // until the writer is done
+  const unsigned long framePixels = m_FrameRegion.GetNumberOfPixels();
+  for (unsigned int t = 0; t < m_NumberOfFrames; ++t)
+  {
+    FrameType frame;
+    frame.Number = t;
+
+    frame.Distance = DistanceImageType::New();
+    frame.Distance->SetRegions(m_FrameRegion);
+    frame.Distance->SetSpacing(m_FrameSpacing);
+    frame.Distance->SetOrigin(m_FrameOrigin);
+    frame.Distance->GetPixelContainer()->SetImportPointer(
+        m_SeriesDistance->GetBufferPointer() + t * framePixels, framePixels, false);
+
+    if (m_CreateVoronoiMap)
+    {
+      frame.VoronoiMap = LabelImageType::New();
+      frame.VoronoiMap->SetRegions(m_FrameRegion);
+      frame.VoronoiMap->SetSpacing(m_FrameSpacing);
+      frame.VoronoiMap->SetOrigin(m_FrameOrigin);
+      frame.VoronoiMap->GetPixelContainer()->SetImportPointer(
+          m_SeriesVoronoiMap->GetBufferPointer() + t * framePixels, framePixels, false);
+    }
+
+    if (!m_WriteQueue.Push(frame))
+      return;
+  }
+}
+
+/**
+ * Write stage
+ */
+template < class TFunctionImage,class TDistanceImage, class TLabelImage, unsigned char MinimalSpacingPrecision, class TAccumulator >
+void
+TimeSeriesGeneralizedDistanceTransform< TFunctionImage, TDistanceImage, TLabelImage, MinimalSpacingPrecision, TAccumulator >
+::WriteFrames()
+{
+  try
+  {
+    FrameType frame;
+    while (m_WriteQueue.Pop(frame))
+      this->WriteFrame(frame.Number, frame.Distance, frame.VoronoiMap);
+  }
+  catch (ExceptionObject &e)
+  {
+    this->Abort(e);
+  }
+  catch (std::exception &e)
+  {
+    this->Abort(ExceptionObject(__FILE__, __LINE__, e.what()));
+  }
+}
+
+template < class TFunctionImage,class TDistanceImage, class TLabelImage, unsigned char MinimalSpacingPrecision, class TAccumulator >
+ITK_THREAD_RETURN_TYPE
+TimeSeriesGeneralizedDistanceTransform< TFunctionImage, TDistanceImage, TLabelImage, MinimalSpacingPrecision, TAccumulator >
+::ReadFramesThreaderCallback(void *arg)
+{
+  MultiThreader::ThreadInfoStruct *info =
+    static_cast<MultiThreader::ThreadInfoStruct *>(arg);
+  static_cast<Self *>(info->UserData)->ReadFrames();
+  return ITK_THREAD_RETURN_VALUE;
+}
+
+template < class TFunctionImage,class TDistanceImage, class TLabelImage, unsigned char MinimalSpacingPrecision, class TAccumulator >
+ITK_THREAD_RETURN_TYPE
+TimeSeriesGeneralizedDistanceTransform< TFunctionImage, TDistanceImage, TLabelImage, MinimalSpacingPrecision, TAccumulator >
+::WriteFramesThreaderCallback(void *arg)
+{
+  MultiThreader::ThreadInfoStruct *info =
+    static_cast<MultiThreader::ThreadInfoStruct *>(arg);
+  static_cast<Self *>(info->UserData)->WriteFrames();
+  return ITK_THREAD_RETURN_VALUE;
+}
+
+/**
+ * Stop all stages after an error
+ */
+template < class TFunctionImage,class TDistanceImage, class TLabelImage, unsigned char MinimalSpacingPrecision, class TAccumulator >
+void
+TimeSeriesGeneralizedDistanceTransform< TFunctionImage, TDistanceImage, TLabelImage, MinimalSpacingPrecision, TAccumulator >
+::Abort(const ExceptionObject &error)
+{
+  m_ErrorLock.Lock();
+  if (!m_Failed)
+  {
+    m_Failed = true;
+    m_Error = error;
+  }
+  m_ErrorLock.Unlock();
+
+  m_ReadQueue.Abort();
+  m_WriteQueue.Abort();
+}
+
+template < class TFunctionImage,class TDistanceImage, class TLabelImage, unsigned char MinimalSpacingPrecision, class TAccumulator >
+bool
+TimeSeriesGeneralizedDistanceTransform< TFunctionImage, TDistanceImage, TLabelImage, MinimalSpacingPrecision, TAccumulator >
+::HasFailed()
+{
+  m_ErrorLock.Lock();
+  const bool failed = m_Failed;
+  m_ErrorLock.Unlock();
+  return failed;
+}
+
+/**
+ *  Print Self
+ */
+template < class TFunctionImage,class TDistanceImage, class TLabelImage, unsigned char MinimalSpacingPrecision, class TAccumulator >
+void
+TimeSeriesGeneralizedDistanceTransform< TFunctionImage, TDistanceImage, TLabelImage, MinimalSpacingPrecision, TAccumulator >
+::PrintSelf(std::ostream& os, Indent indent) const
+{
+  Superclass::PrintSelf(os,indent);
+  os << indent << "NumberOfFrames: " << m_NumberOfFrames << std::endl;
+  os << indent << "QueueLength: " << m_QueueLength << std::endl;
+  os << indent << "TimeIsDimension: " << m_TimeIsDimension << std::endl;
+  os << indent << "TimeSpacing: " << m_TimeSpacing << std::endl;
+  os << indent << "UseSpacing: " << m_UseSpacing << std::endl;
+  os << indent << "CreateVoronoiMap: " << m_CreateVoronoiMap << std::endl;
+  os << indent << "NumberOfThreads: " << m_NumberOfThreads << std::endl;
+}
+} // end namespace itk
+#endif
@@ -0,0 +1,191 @@
+#ifndef __itkTuningFile_h
+#define __itkTuningFile_h
+
+#include <cstdlib>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <unistd.h>
+#endif
+
+namespace itk
+{
+
+template < class T, unsigned int NVectorDimension > class Vector;
+template < class T, unsigned int NVectorDimension > class CovariantVector;
+template < class T, unsigned int NVectorDimension > class FixedArray;
+
+/** \class TuningTypeName
+*
+* The name of a pixel type in the keys of the TuningFile. The names must be
+* the same for all compilers and runs, so they are spelled out here for the
+* scalar types and the ITK vectors of them. Other types get the name
+* "type" followed by their size in bytes; specialize this class for them if
+* two such types of the same size must be tuned apart.
+*
+* \ingroup ImageFeatureExtraction
+*
+*/
+template < class T >
+struct TuningTypeName
+{
+  static std::string Get()
+    {
+    std::ostringstream name;
+    name << "type" << sizeof(T);
+    return name.str();
+    }
+};
+
+#define itkTuningTypeNameMacro(type, name) \
+  template <> struct TuningTypeName< type > \
+  { static std::string Get() { return name; } };
+
+itkTuningTypeNameMacro(char, "char")
+itkTuningTypeNameMacro(signed char, "schar")
+itkTuningTypeNameMacro(unsigned char, "uchar")
+itkTuningTypeNameMacro(short, "short")
+itkTuningTypeNameMacro(unsigned short, "ushort")
+itkTuningTypeNameMacro(int, "int")
+itkTuningTypeNameMacro(unsigned int, "uint")
+itkTuningTypeNameMacro(long, "long")
+itkTuningTypeNameMacro(unsigned long, "ulong")
+itkTuningTypeNameMacro(float, "float")
+itkTuningTypeNameMacro(double, "double")
+itkTuningTypeNameMacro(long double, "ldouble")
+
+#undef itkTuningTypeNameMacro
+
+template < class T, unsigned int NVectorDimension >
+struct TuningTypeName< Vector< T, NVectorDimension > >
+{
+  static std::string Get()
+    {
+    std::ostringstream name;
+    name << "vector" << NVectorDimension << TuningTypeName< T >::Get();
+    return name.str();
+    }
+};
+
+template < class T, unsigned int NVectorDimension >
+struct TuningTypeName< CovariantVector< T, NVectorDimension > >
+{
+  static std::string Get()
+    {
+    std::ostringstream name;
+    name << "covariantvector" << NVectorDimension << TuningTypeName< T >::Get();
+    return name.str();
+    }
+};
+
+template < class T, unsigned int NVectorDimension >
+struct TuningTypeName< FixedArray< T, NVectorDimension > >
+{
+  static std::string Get()
+    {
+    std::ostringstream name;
+    name << "array" << NVectorDimension << TuningTypeName< T >::Get();
+    return name.str();
+    }
+};
+
+/** \class TuningFile
+*
+* A local text file that caches the results of calibration runs, see
+* GeneralizedDistanceTransformImageFilter::Tune().
+*
+* Each line holds a key without blanks, followed by integer values. Lines
+* starting with # are comments. New entries are appended, and of several
+* entries with the same key the last one counts, so an entry can be
+* replaced by appending a new one or by editing the file by hand.
+*
+* \ingroup ImageFeatureExtraction
+*
+*/
+class TuningFile
+{
+public:
+  typedef std::vector<long> ValuesType;
+
+  /** The file used if no other is given: .itkGeneralizedDistanceTransformTuning
+   * in the home directory, or in the working directory if there is no
+   * home directory. */
+  static std::string GetDefaultFileName()
+    {
+    const char *home = getenv("HOME");
+    const std::string name = ".itkGeneralizedDistanceTransformTuning";
+    if (!home || !*home)
+      return name;
+    return std::string(home) + "/" + name;
+    }
+
+  /** Name of the machine, used as part of the keys. */
+  static std::string GetMachineName()
+    {
+#if defined(__unix__) || defined(__APPLE__)
+    char name[256];
+    if (gethostname(name, sizeof(name)) == 0)
+    {
+      name[sizeof(name) - 1] = 0;
+      std::string machine = name;
+      for (std::string::size_type i = 0; i < machine.size(); ++i)
+        if (machine[i] == ' ' || machine[i] == '\t')
+          machine[i] = '_';
+      if (!machine.empty())
+        return machine;
+    }
+#endif
+    return "localhost";
+    }
+
+  /** Look up the values of key. Returns false if the file or the key
+   * doesn't exist. */
+  static bool Read(const std::string &fileName, const std::string &key,
+      ValuesType &values)
+    {
+    std::ifstream file(fileName.c_str());
+    if (!file)
+      return false;
+
+    bool found = false;
+    std::string line;
+    while (std::getline(file, line))
+    {
+      if (line.empty() || line[0] == '#')
+        continue;
+      std::istringstream fields(line);
+      std::string lineKey;
+      if (!(fields >> lineKey) || lineKey != key)
+        continue;
+      ValuesType lineValues;
+      long value;
+      while (fields >> value)
+        lineValues.push_back(value);
+      values = lineValues;
+      found = true;
+    }
+    return found;
+    }
+
+  /** Append an entry for key. Returns false if the file can't be
+   * written. */
+  static bool Append(const std::string &fileName, const std::string &key,
+      const ValuesType &values)
+    {
+    std::ofstream file(fileName.c_str(), std::ios::out | std::ios::app);
+    if (!file)
+      return false;
+    file << key;
+    for (ValuesType::const_iterator value = values.begin(); value != values.end(); ++value)
+      file << " " << *value;
+    file << "\n";
+    return !file.fail();
+    }
+};
+
+} //end namespace itk
+
+#endif
@@ -0,0 +1,90 @@
+#include <cstdlib>
+
+#include "itkImageFileReader.h"
+#include "itkBinaryThresholdImageFilter.h"
+#include "itkLazyGeneralizedDistanceTransform.h"
+#include "itkSqrtImageFilter.h"
+#include "itkImageFileWriter.h"
+
+int main(int argc, char *argv[])
+{
+  const unsigned int dimension=3;
+  if (argc < 4 || (argc - 4) % dimension != 0)
+  {
+    std::cerr <<
+      "Compute the euclidean distance transform and Voronoi map of an image\n"
+      "lazily: The distance and label of the given voxels are printed, then\n"
+      "the dense images are generated from the same envelopes.\n"
+      "\n"
+      "USAGE: " << argv[0] << " <label image> <distance output> <label output> [<x> <y> <z> ...]\n"
+      "  <label image>: An image where background voxels have label 0.\n"
+      "  <distance output>: An image that denotes the euclidean distance to\n"
+      "     the closest foreground voxel.\n"
+      "  <label output>: An image that denotes the label of the closest\n"
+      "     foreground voxel.\n"
+      "  <x> <y> <z>: The index of a voxel to query.\n";
+    return 1;
+  }
+
+  typedef short PixelType;
+  typedef itk::Image<PixelType, dimension> ImageType;
+
+  // Read the label image
+  typedef itk::ImageFileReader<ImageType> ReaderType;
+  ReaderType::Pointer input = ReaderType::New();
+  input->SetFileName(argv[1]);
+
+  typedef itk::LazyGeneralizedDistanceTransform<ImageType, ImageType> Distance;
+
+  // For the label image l, create an indicator image i with
+  // i(x) = (l(x) == 0 ?  infinity : 0).
+  typedef itk::BinaryThresholdImageFilter<ImageType, ImageType> Indicator;
+  Indicator::Pointer indicator = Indicator::New();
+  indicator->SetLowerThreshold(0);
+  indicator->SetUpperThreshold(0);
+  indicator->SetOutsideValue(0);
+  indicator->SetInsideValue(Distance::GetMaximumApexHeight());
+  indicator->SetInput(input->GetOutput());
+
+  try
+  {
+    indicator->Update();
+
+    // Only the envelopes of the last dimension are computed...
+    Distance::Pointer distance = Distance::New();
+    distance->SetInput1(indicator->GetOutput());
+    distance->SetInput2(input->GetOutput());
+    distance->Update();
+
+    // ...and evaluated at the voxels that are queried
+    for (int i = 4; i < argc; i += dimension)
+    {
+      Distance::IndexType index;
+      for (unsigned int d = 0; d < dimension; ++d)
+        index[d] = atol(argv[i + d]);
+      std::cout << index << ": distance " << sqrt(static_cast<double>(distance->GetDistance(index)))
+        << ", label " << distance->GetVoronoiLabel(index) << std::endl;
+    }
+
+    // The squared euclidean distance is converted to the regular euclidean
+    // distance
+    typedef itk::SqrtImageFilter<ImageType, ImageType> Sqrt;
+    Sqrt::Pointer sqrt = Sqrt::New();
+    sqrt->SetInput(distance->GenerateDistanceImage());
+
+    typedef itk::ImageFileWriter<ImageType> Writer;
+    Writer::Pointer writer = Writer::New();
+    writer->SetInput(sqrt->GetOutput());
+    writer->SetFileName(argv[2]);
+    writer->Update();
+
+    writer->SetInput(distance->GenerateVoronoiMap());
+    writer->SetFileName(argv[3]);
+    writer->Update();
+  }
+  catch (itk::ExceptionObject &e)
+  {
+    std::cerr << e << std::endl;
+    return 1;
+  }
+}
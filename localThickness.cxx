@@ -0,0 +1,46 @@
+#include "itkImageFileReader.h"
+#include "itkLocalThicknessImageFilter.h"
+#include "itkImageFileWriter.h"
+
+int main(int argc, char *argv[])
+{
+  if (argc != 3)
+  {
+    std::cerr <<
+      "Compute the local thickness of the foreground of an image, i.e. the\n"
+      "diameter of the largest sphere inside the foreground that contains\n"
+      "the voxel.\n"
+      "\n"
+      "USAGE: " << argv[0] << " <label image> <thickness output>\n"
+      "  <label image>: An image where background voxels have label 0.\n"
+      "  <thickness output>: An image that holds the local thickness of the\n"
+      "     foreground voxels, and 0 for the background voxels.\n";
+    return 1;
+  }
+
+  const unsigned int dimension=3;
+  typedef short LabelPixelType;
+  typedef float ThicknessPixelType;
+  typedef itk::Image<LabelPixelType, dimension> LabelImageType;
+  typedef itk::Image<ThicknessPixelType, dimension> ThicknessImageType;
+
+  // Read the label image
+  typedef itk::ImageFileReader<LabelImageType> ReaderType;
+  ReaderType::Pointer input = ReaderType::New();
+  input->SetFileName(argv[1]);
+
+  // The distance transform, its ridge and the painting of the spheres in
+  // one filter
+  typedef itk::LocalThicknessImageFilter<LabelImageType, ThicknessImageType> Thickness;
+  Thickness::Pointer thickness = Thickness::New();
+  thickness->SetInput(input->GetOutput());
+
+  // Write the thickness image
+  typedef itk::ImageFileWriter<ThicknessImageType> Writer;
+  Writer::Pointer writer = Writer::New();
+  writer->SetInput(thickness->GetOutput());
+  writer->SetFileName(argv[2]);
+  writer->Update();
+
+  std::cout << "Spheres of the ridge: " << thickness->GetNumberOfSpheres() << "\n";
+}
@@ -0,0 +1,166 @@
+// Compare itk::LocalThicknessImageFilter to a brute force computation
+//
+// The foreground is a union of random overlapping balls. The brute force
+// computes the squared distance of each foreground voxel c to the closest
+// background voxel, r(c)^2, and gives each voxel x the largest 2 r(c) of the
+// voxels c with |x - c|^2 < r(c)^2. The filter must give the same
+// thickness with and without the ridge, with several threads whose slabs
+// don't divide the image. The spacings are exact in binary, so that the
+// squared distances are exact as well.
+//
+// Returns 1 if any voxel differs.
+
+#include <iostream>
+#include <vector>
+#include <cstdlib>
+#include <cmath>
+#include <limits>
+
+#include "itkImage.h"
+#include "itkImageRegionConstIteratorWithIndex.h"
+#include "itkLocalThicknessImageFilter.h"
+
+
+template <class TOutputPixel, unsigned int Dimension>
+unsigned long compare(const char *typeName, const double *spacing,
+    unsigned int numberOfBalls)
+{
+  typedef itk::Image<unsigned char, Dimension> LabelImageType;
+  typedef itk::Image<TOutputPixel, Dimension> ThicknessImageType;
+  typedef typename LabelImageType::IndexType IndexType;
+
+  // The balls
+  typename LabelImageType::SizeType size;
+  for (unsigned int d = 0; d < Dimension; ++d)
+    size[d] = 22 - 3 * d;
+  typename LabelImageType::Pointer labels = LabelImageType::New();
+  labels->SetRegions(size);
+  labels->SetSpacing(spacing);
+  labels->Allocate();
+  labels->FillBuffer(0);
+
+  srand(7);
+  std::vector<IndexType> centers(numberOfBalls);
+  std::vector<double> radii(numberOfBalls);
+  for (unsigned int b = 0; b < numberOfBalls; ++b)
+  {
+    for (unsigned int d = 0; d < Dimension; ++d)
+      centers[b][d] = 3 + rand() % (size[d] - 6);
+    radii[b] = 1.5 + (rand() % 100) / 20.0;
+  }
+
+  typedef itk::ImageRegionConstIteratorWithIndex<LabelImageType> IteratorType;
+  std::vector<IndexType> voxels;
+  for (IteratorType it(labels, labels->GetBufferedRegion()); !it.IsAtEnd(); ++it)
+  {
+    voxels.push_back(it.GetIndex());
+    for (unsigned int b = 0; b < numberOfBalls; ++b)
+    {
+      double squaredDistance = 0.0;
+      for (unsigned int d = 0; d < Dimension; ++d)
+      {
+        const double distance = (it.GetIndex()[d] - centers[b][d]) * spacing[d];
+        squaredDistance += distance * distance;
+      }
+      if (squaredDistance <= radii[b] * radii[b])
+        labels->SetPixel(it.GetIndex(), 1);
+    }
+  }
+
+  // Brute force: the squared radii of the foreground voxels, then the
+  // largest one of the spheres that contain a voxel
+  const unsigned long numberOfPixels = voxels.size();
+  std::vector<double> squaredRadius(numberOfPixels, 0.0);
+  for (unsigned long c = 0; c < numberOfPixels; ++c)
+  {
+    if (!labels->GetPixel(voxels[c]))
+      continue;
+    double smallest = std::numeric_limits<double>::max();
+    for (unsigned long b = 0; b < numberOfPixels; ++b)
+    {
+      if (labels->GetPixel(voxels[b]))
+        continue;
+      double squaredDistance = 0.0;
+      for (unsigned int d = 0; d < Dimension; ++d)
+      {
+        const double distance = (voxels[b][d] - voxels[c][d]) * spacing[d];
+        squaredDistance += distance * distance;
+      }
+      smallest = std::min(smallest, squaredDistance);
+    }
+    squaredRadius[c] = smallest;
+  }
+
+  std::vector<double> largest(numberOfPixels, 0.0);
+  for (unsigned long c = 0; c < numberOfPixels; ++c)
+  {
+    if (squaredRadius[c] == 0.0)
+      continue;
+    for (unsigned long x = 0; x < numberOfPixels; ++x)
+    {
+      double squaredDistance = 0.0;
+      for (unsigned int d = 0; d < Dimension; ++d)
+      {
+        const double distance = (voxels[x][d] - voxels[c][d]) * spacing[d];
+        squaredDistance += distance * distance;
+      }
+      if (squaredDistance < squaredRadius[c])
+        largest[x] = std::max(largest[x], squaredRadius[c]);
+    }
+  }
+
+  // The filter, with and without the ridge
+  const double rounding = std::numeric_limits<TOutputPixel>::is_integer ? 0.5 : 0.0;
+  unsigned long errors = 0;
+  for (unsigned int useRidge = 0; useRidge < 2; ++useRidge)
+  {
+    typedef itk::LocalThicknessImageFilter<LabelImageType, ThicknessImageType> Thickness;
+    typename Thickness::Pointer thickness = Thickness::New();
+    thickness->SetInput(labels);
+    thickness->SetUseRidge(useRidge);
+    thickness->SetNumberOfThreads(3);
+    thickness->Update();
+
+    for (unsigned long x = 0; x < numberOfPixels; ++x)
+    {
+      const double expected = largest[x] > 0.0 ?
+        static_cast<TOutputPixel>(2.0 * std::sqrt(largest[x]) + rounding) : 0.0;
+      const double value = thickness->GetOutput()->GetPixel(voxels[x]);
+      if (std::fabs(value - expected) > 1e-5 * (1.0 + expected))
+      {
+        if (errors < 10)
+          std::cerr << Dimension << "D " << typeName << (useRidge ? " with ridge" : "")
+            << ": thickness at " << voxels[x] << " is " << value
+            << ", expected " << expected << std::endl;
+        ++errors;
+      }
+    }
+  }
+  return errors;
+}
+
+int main(int argc, char **argv)
+{
+  if (argc > 1)
+  {
+    std::cerr <<
+      "Compare itk::LocalThicknessImageFilter to a brute force computation\n"
+      "of the largest sphere that contains each voxel, on overlapping balls.\n"
+      "Produces no output files.\n"
+      "\n"
+      "USAGE: " << argv[0] << "\n";
+    return 1;
+  }
+
+  const double unitSpacing[3] = { 1.0, 1.0, 1.0 };
+  const double spacing[3] = { 1.0, 1.5, 0.75 };
+  const double planeSpacing[2] = { 0.75, 1.5 };
+
+  unsigned long errors = 0;
+  errors += compare<short, 3>("short", unitSpacing, 6);
+  errors += compare<double, 3>("double", spacing, 6);
+  errors += compare<float, 2>("float", planeSpacing, 4);
+
+  std::cout << "Wrong voxels: " << errors << std::endl;
+  return errors ? 1 : 0;
+}
@@ -0,0 +1,196 @@
+// Compare itk::LowerEnvelopeOfParabolas to a brute force minimum
+//
+// The envelope is fed with short random scanlines. Each sample must be the
+// minimum of all parabolas at that index, and the label must be the one of
+// a parabola that takes the minimum. The intersections of the parabolas
+// often lie left of the first index, where rounding them towards zero
+// instead of down would give the wrong parabola. Floating point apex heights
+// use the front sentinel, which a too large maxAbscissa pops.
+//
+// The periodic samples must be the minimum of all parabolas at x-n, x and
+// x+n, for a line of length n. The lines have parabolas near both ends, so
+// that the copies on both sides take the minimum. They are sampled with and
+// without a stride.
+//
+// Returns 1 if any sample differs.
+
+#include <iostream>
+#include <vector>
+#include <cstdlib>
+#include <cmath>
+#include <cassert>
+#include "itkLowerEnvelopeOfParabolas.h"
+
+
+// An output iterator like the ones of ITK that writes to a buffer
+template <class T>
+class BufferIterator
+{
+public:
+  BufferIterator(T *p) : m_Pointer(p) {}
+  void Set(const T &value) { *m_Pointer = value; }
+  BufferIterator& operator++() { ++m_Pointer; return *this; }
+private:
+  T *m_Pointer;
+};
+
+template <bool UseSpacing, class ApexHeightType>
+unsigned long compare(const char *typeName, const double &spacing)
+{
+  typedef itk::LowerEnvelopeOfParabolas<UseSpacing, double, 3, true,
+          long, long, ApexHeightType> LEOP;
+  const long length = 12;
+  const double s = UseSpacing ? spacing : 1.0;
+
+  unsigned long errors = 0;
+  LEOP envelope(length, spacing);
+  std::vector<ApexHeightType> heights(length);
+  std::vector<ApexHeightType> values(length);
+  std::vector<long> labels(length);
+
+  srand(42);
+  for (unsigned int line = 0; line < 10000; ++line)
+  {
+    // Few parabolas with heights in the range of the squared distances
+    // along the line, the others are infinite
+    envelope.clear();
+    for (long i = 0; i < length; ++i)
+    {
+      heights[i] = rand() % 3 ? LEOP::maxApexHeight :
+        static_cast<ApexHeightType>(rand() % (length * length));
+      if (heights[i] != LEOP::maxApexHeight)
+        envelope.addParabola(i, heights[i], i);
+    }
+
+    BufferIterator<ApexHeightType> valueIt(&values[0]);
+    BufferIterator<long> labelIt(&labels[0]);
+    envelope.uniformSample(0, length, valueIt, labelIt);
+
+    for (long x = 0; x < length; ++x)
+    {
+      double minimum = static_cast<double>(LEOP::maxApexHeight);
+      for (long i = 0; i < length; ++i)
+        if (heights[i] != LEOP::maxApexHeight)
+          minimum = std::min(minimum, (x - i) * (x - i) * s * s + heights[i]);
+      if (minimum == static_cast<double>(LEOP::maxApexHeight))
+        continue;
+
+      // Floating point types may round the values, but the label must be
+      // the one of a parabola that takes the minimum
+      const long l = labels[x];
+      const double atLabel = (x - l) * (x - l) * s * s + heights[l];
+      const double tolerance = 1e-5 * (1 + minimum);
+      if (std::fabs(static_cast<double>(values[x]) - minimum) > tolerance ||
+          std::fabs(atLabel - minimum) > tolerance)
+      {
+        if (errors < 10)
+          std::cerr << typeName << (UseSpacing ? " with spacing" : "")
+            << ": sample " << x << " is " << values[x] << " of parabola "
+            << l << ", minimum is " << minimum << std::endl;
+        ++errors;
+      }
+    }
+  }
+  return errors;
+}
+
+template <bool UseSpacing, class ApexHeightType>
+unsigned long comparePeriodic(const char *typeName, const double &spacing)
+{
+  typedef itk::LowerEnvelopeOfParabolas<UseSpacing, double, 3, true,
+          long, long, ApexHeightType> LEOP;
+  const long length = 13;
+  const double s = UseSpacing ? spacing : 1.0;
+
+  unsigned long errors = 0;
+  LEOP envelope(length, spacing);
+  std::vector<ApexHeightType> heights(length);
+  std::vector<ApexHeightType> values(length);
+  std::vector<long> labels(length);
+
+  srand(43);
+  for (unsigned int line = 0; line < 10000; ++line)
+  {
+    // The middle of the line is mostly infinite, so that the parabolas
+    // near one end are the closest ones to the other end
+    envelope.clear();
+    for (long i = 0; i < length; ++i)
+    {
+      const bool nearEnd = i < 3 || i >= length - 3;
+      heights[i] = rand() % (nearEnd ? 2 : 6) ? LEOP::maxApexHeight :
+        static_cast<ApexHeightType>(rand() % (length * length / 2));
+      if (heights[i] != LEOP::maxApexHeight)
+        envelope.addParabola(i, heights[i], i);
+    }
+
+    // All indices, or every third one from the second
+    const long stride = line % 2 ? 3 : 1;
+    const long from = line % 2 ? 1 : 0;
+    const long steps = (length - from + stride - 1) / stride;
+
+    BufferIterator<ApexHeightType> valueIt(&values[0]);
+    BufferIterator<long> labelIt(&labels[0]);
+    envelope.periodicSample(from, steps, stride, length, valueIt, labelIt);
+
+    for (long k = 0; k < steps; ++k)
+    {
+      const long x = from + k * stride;
+      double minimum = static_cast<double>(LEOP::maxApexHeight);
+      for (long i = 0; i < length; ++i)
+        if (heights[i] != LEOP::maxApexHeight)
+          for (long shift = -length; shift <= length; shift += length)
+            minimum = std::min(minimum,
+                (x - i - shift) * (x - i - shift) * s * s + heights[i]);
+      if (minimum == static_cast<double>(LEOP::maxApexHeight))
+        continue;
+
+      const long l = labels[k];
+      double atLabel = static_cast<double>(LEOP::maxApexHeight);
+      for (long shift = -length; shift <= length; shift += length)
+        atLabel = std::min(atLabel,
+            (x - l - shift) * (x - l - shift) * s * s + heights[l]);
+      const double tolerance = 1e-5 * (1 + minimum);
+      if (std::fabs(static_cast<double>(values[k]) - minimum) > tolerance ||
+          std::fabs(atLabel - minimum) > tolerance)
+      {
+        if (errors < 10)
+          std::cerr << typeName << (UseSpacing ? " with spacing" : "")
+            << ": periodic sample " << x << " is " << values[k]
+            << " of parabola " << l << ", minimum is " << minimum << std::endl;
+        ++errors;
+      }
+    }
+  }
+  return errors;
+}
+
+int main(int argc, char **argv)
+{
+  if (argc > 1)
+  {
+    std::cerr <<
+      "Compare itk::LowerEnvelopeOfParabolas to a brute force minimum on\n"
+      "random scanlines, with and without periodic boundaries. Produces no\n"
+      "output files.\n"
+      "\n"
+      "USAGE: " << argv[0] << "\n";
+    return 1;
+  }
+
+  unsigned long errors = 0;
+  errors += compare<false, short>("short", 1);
+  errors += compare<false, int>("int", 1);
+  errors += compare<false, float>("float", 1);
+  errors += compare<false, double>("double", 1);
+  errors += compare<true, float>("float", 0.7);
+  errors += compare<true, double>("double", 0.7);
+  errors += compare<true, double>("double", 3.1);
+  errors += comparePeriodic<false, short>("short", 1);
+  errors += comparePeriodic<false, int>("int", 1);
+  errors += comparePeriodic<false, double>("double", 1);
+  errors += comparePeriodic<true, float>("float", 0.7);
+  errors += comparePeriodic<true, double>("double", 3.1);
+
+  std::cout << "Wrong samples: " << errors << std::endl;
+  return errors ? 1 : 0;
+}
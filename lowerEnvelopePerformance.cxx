@@ -0,0 +1,255 @@
+// Measure the performance of itk::LowerEnvelopeOfParabolas on its own
+//
+// The envelope is fed with synthetic scanlines, without images in the loop,
+// so changes to the kernel can be measured in isolation. All combinations
+// of UseSpacing and CreateVoronoiMap are run for the accumulator types the
+// filter is usually instantiated with.
+//
+// For each case, the time per added parabola and per sample are reported,
+// as well as the number of parabolas that are popped from the envelope per
+// added parabola and the number of heap allocations per scanline after the
+// first one.
+//
+// The assertions of itk::LowerEnvelopeOfParabolas are only disabled if the
+// program is built with NDEBUG, e.g. as a Release build. Build it that way
+// for meaningful timings.
+
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <algorithm>
+#include <new>
+#include <cstdlib>
+#include <cassert>
+#include "itkLowerEnvelopeOfParabolas.h"
+#include "itkTimeProbe.h"
+
+
+// Count the heap allocations of the whole program. All forms of new and
+// delete are replaced, so that none of them mixes with the ones of the
+// library.
+static unsigned long numberOfAllocations = 0;
+
+void *operator new(std::size_t size)
+{
+  ++numberOfAllocations;
+  void *p = malloc(size ? size : 1);
+  if (!p)
+    throw std::bad_alloc();
+  return p;
+}
+
+void *operator new[](std::size_t size)
+{
+  return operator new(size);
+}
+
+void operator delete(void *p)
+{
+  free(p);
+}
+
+void operator delete[](void *p)
+{
+  free(p);
+}
+
+// The sized forms are used by C++14 compilers
+void operator delete(void *p, std::size_t)
+{
+  free(p);
+}
+
+void operator delete[](void *p, std::size_t)
+{
+  free(p);
+}
+
+// The samples are added up here, so they are not optimized away
+volatile double checksum = 0;
+
+// The number of samples each case is run for, spread over as many
+// scanlines as needed
+const unsigned long samplesPerCase = 1 << 22;
+
+// An output iterator like the ones of ITK that writes to a buffer
+template <class T>
+class BufferIterator
+{
+public:
+  BufferIterator(T *p) : m_Pointer(p) {}
+  void Set(const T &value) { *m_Pointer = value; }
+  BufferIterator& operator++() { ++m_Pointer; return *this; }
+private:
+  T *m_Pointer;
+};
+
+enum Pattern { AllInfinite, SingleSeed, DenseRandom, MonotoneHeights };
+const char *patternNames[] = { "all-infinite", "single-seed", "dense-random", "monotone" };
+
+// Fill the apex heights of a scanline
+template <class ApexHeightType>
+void createLine(Pattern pattern, std::vector<ApexHeightType> &heights,
+    const ApexHeightType &maxApexHeight)
+{
+  const long length = heights.size();
+  switch (pattern)
+  {
+    case AllInfinite:
+      std::fill(heights.begin(), heights.end(), maxApexHeight);
+      break;
+    case SingleSeed:
+      std::fill(heights.begin(), heights.end(), maxApexHeight);
+      heights[length / 2] = 0;
+      break;
+    case DenseRandom:
+    {
+      // Heights in the range of squared distances along the scanline
+      const double range = std::min(static_cast<double>(length) * length,
+          static_cast<double>(maxApexHeight) - 1);
+      srand(42);
+      for (long i = 0; i < length; ++i)
+        heights[i] = static_cast<ApexHeightType>(range * rand() / (RAND_MAX + 1.0));
+      break;
+    }
+    case MonotoneHeights:
+    {
+      // With falling heights y(i) = 2 * (n^2 - i^2), the intersection of a
+      // parabola with its predecessor moves to the left with every
+      // parabola, so each one pops its predecessor from the envelope. For
+      // narrow types the heights are clipped to the largest apex height.
+      for (long i = 0; i < length; ++i)
+        heights[i] = static_cast<ApexHeightType>(std::min(
+              2.0 * (static_cast<double>(length) * length - static_cast<double>(i) * i),
+              static_cast<double>(maxApexHeight)));
+      break;
+    }
+  }
+}
+
+template <bool UseSpacing, bool CreateVoronoiMap, class ApexHeightType>
+void benchmark(const char *typeName, const std::vector<long> &lengths)
+{
+  typedef itk::LowerEnvelopeOfParabolas<UseSpacing, double, 3, CreateVoronoiMap,
+          short, long, ApexHeightType> LEOP;
+  const double spacing = 0.7;
+
+  for (unsigned int pattern = AllInfinite; pattern <= MonotoneHeights; ++pattern)
+  {
+    for (unsigned int l = 0; l < lengths.size(); ++l)
+    {
+      const long length = lengths[l];
+      const unsigned long numberOfLines = std::max(1ul, samplesPerCase / length);
+
+      std::vector<ApexHeightType> heights(length);
+      createLine(static_cast<Pattern>(pattern), heights, LEOP::maxApexHeight);
+      std::vector<short> labels(length);
+      for (long i = 0; i < length; ++i)
+        labels[i] = static_cast<short>(i);
+      std::vector<ApexHeightType> values(length);
+      std::vector<short> voronoiMap(length);
+
+      LEOP envelope(length, spacing);
+
+      // The first scanline may allocate, the others should reuse the memory
+      envelope.clear();
+      for (long i = 0; i < length; ++i)
+        envelope.addParabola(i, heights[i], labels[i]);
+      const unsigned long pops = length - envelope.numberOfParabolas();
+      const unsigned long allocationsBefore = numberOfAllocations;
+
+      itk::TimeProbe addTimer;
+      addTimer.Start();
+      for (unsigned long line = 0; line < numberOfLines; ++line)
+      {
+        envelope.clear();
+        if (CreateVoronoiMap)
+          for (long i = 0; i < length; ++i)
+            envelope.addParabola(i, heights[i], labels[i]);
+        else
+          for (long i = 0; i < length; ++i)
+            envelope.addParabola(i, heights[i]);
+      }
+      addTimer.Stop();
+
+      itk::TimeProbe sampleTimer;
+      sampleTimer.Start();
+      for (unsigned long line = 0; line < numberOfLines; ++line)
+      {
+        BufferIterator<ApexHeightType> valueIt(&values[0]);
+        if (CreateVoronoiMap)
+        {
+          BufferIterator<short> voronoiIt(&voronoiMap[0]);
+          envelope.uniformSample(0, length, valueIt, voronoiIt);
+        }
+        else
+          envelope.uniformSample(0, length, valueIt);
+      }
+      sampleTimer.Stop();
+
+      const double allocationsPerLine =
+        static_cast<double>(numberOfAllocations - allocationsBefore) / numberOfLines;
+      const double parabolas = static_cast<double>(numberOfLines) * length;
+
+      for (long i = 0; i < length; ++i)
+        checksum += static_cast<double>(values[i]) + voronoiMap[i];
+
+      std::cout << std::setw(8) << (UseSpacing ? "spacing" : "-")
+        << std::setw(9) << (CreateVoronoiMap ? "voronoi" : "-")
+        << std::setw(8) << typeName
+        << std::setw(14) << patternNames[pattern]
+        << std::setw(8) << length
+        << std::fixed << std::setprecision(2)
+        << std::setw(12) << addTimer.GetMeanTime() * 1e9 / parabolas
+        << std::setw(12) << sampleTimer.GetMeanTime() * 1e9 / parabolas
+        << std::setw(10) << static_cast<double>(pops) / length
+        << std::setw(12) << allocationsPerLine << "\n";
+    }
+  }
+}
+
+template <class ApexHeightType>
+void benchmarkAllCombinations(const char *typeName, const std::vector<long> &lengths)
+{
+  benchmark<false, false, ApexHeightType>(typeName, lengths);
+  benchmark<false, true, ApexHeightType>(typeName, lengths);
+  benchmark<true, false, ApexHeightType>(typeName, lengths);
+  benchmark<true, true, ApexHeightType>(typeName, lengths);
+}
+
+int main(int argc, char **argv)
+{
+  if (argc == 2 && argv[1][0] == '-')
+  {
+    std::cerr <<
+      "Measure the performance of itk::LowerEnvelopeOfParabolas on synthetic\n"
+      "scanlines. Produces no output files.\n"
+      "\n"
+      "USAGE: " << argv[0] << " [<length> ...]\n"
+      "  <length>: Length of the scanlines. Default is 16 256 4096.\n";
+    return 1;
+  }
+
+  std::vector<long> lengths;
+  for (int i = 1; i < argc; ++i)
+    lengths.push_back(atol(argv[i]));
+  if (lengths.empty())
+  {
+    lengths.push_back(16);
+    lengths.push_back(256);
+    lengths.push_back(4096);
+  }
+
+  std::cout << std::setw(8) << "spacing" << std::setw(9) << "voronoi"
+    << std::setw(8) << "height" << std::setw(14) << "pattern"
+    << std::setw(8) << "length" << std::setw(12) << "ns/add"
+    << std::setw(12) << "ns/sample" << std::setw(10) << "pops/add"
+    << std::setw(12) << "allocs/line" << "\n";
+
+  benchmarkAllCombinations<short>("short", lengths);
+  benchmarkAllCombinations<int>("int", lengths);
+  benchmarkAllCombinations<float>("float", lengths);
+  benchmarkAllCombinations<double>("double", lengths);
+
+  return 0;
+}
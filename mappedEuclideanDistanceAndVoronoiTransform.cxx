@@ -0,0 +1,79 @@
+#include <cmath>
+
+#include "itkMappedImageFile.h"
+#include "itkImageAdaptor.h"
+#include "itkLabelIndicatorAccessor.h"
+#include "itkGeneralizedDistanceTransformImageFilter.h"
+
+int main(int argc, char *argv[])
+{
+  if (argc != 4)
+  {
+    std::cerr <<
+      "Compute the euclidean distance transform and Voronoi map of an image,\n"
+      "from memory mapped Analyze files to memory mapped Analyze files.\n"
+      "\n"
+      "USAGE: " << argv[0] << " <label image> <distance output> <label output>\n"
+      "  <label image>: An Analyze image where background voxels have label 0.\n"
+      "  <distance output>: An Analyze image that denotes the euclidean\n"
+      "     distance to the closest foreground voxel.\n"
+      "  <label output>: An Analyze image that denotes the label of the\n"
+      "     closest foreground voxel.\n";
+    return 1;
+  }
+
+  const unsigned int dimension=3;
+  typedef short PixelType;
+  typedef itk::Image<PixelType, dimension> ImageType;
+  typedef itk::MappedImageFile<ImageType> MappedFile;
+
+  // For the label image l, the indicator image i with
+  // i(x) = (l(x) == 0 ?  infinity : 0)
+  // is computed on the fly by an adaptor, so it needs no memory.
+  typedef itk::Accessor::LabelIndicatorAccessor<PixelType, PixelType> IndicatorAccessor;
+  typedef itk::ImageAdaptor<ImageType, IndicatorAccessor> IndicatorImageType;
+  typedef itk::GeneralizedDistanceTransformImageFilter<IndicatorImageType, ImageType, ImageType> Distance;
+
+  try
+  {
+    // Map the label image
+    MappedFile::Pointer input = MappedFile::New();
+    input->MapForReading(argv[1]);
+    ImageType *labels = input->GetImage();
+
+    IndicatorImageType::Pointer indicator = IndicatorImageType::New();
+    indicator->SetImage(labels);
+    indicator->GetPixelAccessor().SetNotThereValue(Distance::GetMaximumApexHeight());
+
+    // Create the output files, the filter computes the outputs in place
+    const ImageType::SizeType &size = labels->GetLargestPossibleRegion().GetSize();
+    MappedFile::Pointer distanceOutput = MappedFile::New();
+    distanceOutput->SetOrientation(input->GetOrientation());
+    distanceOutput->MapForWriting(argv[2], size, labels->GetSpacing());
+    MappedFile::Pointer labelOutput = MappedFile::New();
+    labelOutput->SetOrientation(input->GetOrientation());
+    labelOutput->MapForWriting(argv[3], size, labels->GetSpacing());
+
+    Distance::Pointer distance = Distance::New();
+    distance->SetInput1(indicator);
+    distance->SetInput2(labels);
+    distance->SetDistanceImportPointer(distanceOutput->GetBufferPointer());
+    distance->SetVoronoiMapImportPointer(labelOutput->GetBufferPointer());
+    distance->Update();
+
+    // The squared euclidean distance is converted to the regular euclidean
+    // distance in place
+    PixelType *pixel = distanceOutput->GetBufferPointer();
+    const unsigned long numberOfPixels = labels->GetLargestPossibleRegion().GetNumberOfPixels();
+    for (unsigned long i = 0; i < numberOfPixels; ++i)
+      pixel[i] = static_cast<PixelType>(std::sqrt(static_cast<double>(pixel[i])));
+
+    distanceOutput->Close();
+    labelOutput->Close();
+  }
+  catch (itk::ExceptionObject &e)
+  {
+    std::cerr << e << std::endl;
+    return 1;
+  }
+}
@@ -0,0 +1,109 @@
+#include <cstdlib>
+#include <cstring>
+
+#include "itkImageFileReader.h"
+#include "itkMultiLabelDistanceTransformImageFilter.h"
+#include "itkVectorIndexSelectionCastImageFilter.h"
+#include "itkSqrtImageFilter.h"
+#include "itkImageFileWriter.h"
+#include "itkNumericSeriesFileNames.h"
+
+const unsigned int dimension=3;
+typedef short PixelType;
+typedef itk::Image<PixelType, dimension> ImageType;
+typedef itk::VectorImage<PixelType, dimension> VectorImageType;
+
+std::vector<std::string> fileNames(const char *format, unsigned int count)
+{
+  itk::NumericSeriesFileNames::Pointer names = itk::NumericSeriesFileNames::New();
+  names->SetSeriesFormat(format);
+  names->SetStartIndex(0);
+  names->SetEndIndex(count - 1);
+  return names->GetFileNames();
+}
+
+// Write each component of image to a file of its own
+void writeComponents(VectorImageType *image, const char *format, bool sqrt)
+{
+  const unsigned int count = image->GetNumberOfComponentsPerPixel();
+  const std::vector<std::string> names = fileNames(format, count);
+
+  typedef itk::VectorIndexSelectionCastImageFilter<VectorImageType, ImageType> Component;
+  Component::Pointer component = Component::New();
+  component->SetInput(image);
+
+  typedef itk::SqrtImageFilter<ImageType, ImageType> Sqrt;
+  Sqrt::Pointer sqrtFilter = Sqrt::New();
+  sqrtFilter->SetInput(component->GetOutput());
+
+  typedef itk::ImageFileWriter<ImageType> Writer;
+  Writer::Pointer writer = Writer::New();
+  if (sqrt)
+    writer->SetInput(sqrtFilter->GetOutput());
+  else
+    writer->SetInput(component->GetOutput());
+
+  for (unsigned int c = 0; c < count; ++c)
+  {
+    component->SetIndex(c);
+    writer->SetFileName(names[c].c_str());
+    writer->Update();
+  }
+}
+
+int main(int argc, char *argv[])
+{
+  const bool nearest = argc == 6 && strcmp(argv[3], "-nearest") == 0;
+  if (argc < 4 || (strcmp(argv[3], "-nearest") == 0 && !nearest))
+  {
+    std::cerr <<
+      "Compute the euclidean distance to several labels of an image at once.\n"
+      "\n"
+      "USAGE: " << argv[0] << " <label image> <distance outputs> <label> [<label> ...]\n"
+      "       " << argv[0] << " <label image> <distance outputs> -nearest <k> <label outputs>\n"
+      "  <label image>: An image where background voxels have label 0.\n"
+      "  <distance outputs>: printf-like pattern of the file names of the\n"
+      "     distance images, e.g. distance%d.img. Image c denotes the\n"
+      "     euclidean distance to the c-th label, counting from 0.\n"
+      "  <label>: A label to compute the distance to.\n"
+      "  <k>: The number of nearest labels to compute the distance to.\n"
+      "  <label outputs>: Pattern of the images that denote the c-th nearest\n"
+      "     label.\n";
+    return 1;
+  }
+
+  // Read the label image
+  typedef itk::ImageFileReader<ImageType> ReaderType;
+  ReaderType::Pointer input = ReaderType::New();
+  input->SetFileName(argv[1]);
+
+  // Compute the squared distances to all labels in one go
+  typedef itk::MultiLabelDistanceTransformImageFilter<ImageType, VectorImageType> Distance;
+  Distance::Pointer distance = Distance::New();
+  distance->SetInput(input->GetOutput());
+  if (nearest)
+    distance->SetNumberOfNearestLabels(atoi(argv[4]));
+  else
+  {
+    Distance::LabelArrayType labels;
+    for (int i = 3; i < argc; ++i)
+      labels.push_back(atoi(argv[i]));
+    distance->SetLabels(labels);
+  }
+
+  try
+  {
+    distance->Update();
+
+    // The squared euclidean distances are converted to the regular
+    // euclidean distances
+    writeComponents(distance->GetDistance(), argv[2], true);
+    if (nearest)
+      writeComponents(distance->GetNearestLabels(), argv[5], false);
+  }
+  catch (itk::ExceptionObject &e)
+  {
+    std::cerr << e << std::endl;
+    return 1;
+  }
+}
@@ -0,0 +1,168 @@
+// Compare periodic boundaries to a tiled image
+//
+// The periodic transform of a small volume must be the one of the volume
+// tiled three times along the periodic dimensions, cropped to the middle
+// tile: The closest copy of a parabola is at most one period away. The
+// seeds have random heights and labels, and the spacings are exact in
+// binary, so that both transforms give the same distances. Voronoi labels
+// may differ on ties, so a label is accepted if its closest copy is at the
+// same distance.
+//
+// Returns 1 if any voxel differs.
+
+#include <iostream>
+#include <vector>
+#include <cstdlib>
+#include <cmath>
+
+#include "itkImage.h"
+#include "itkImageRegionConstIteratorWithIndex.h"
+#include "itkGeneralizedDistanceTransformImageFilter.h"
+
+
+typedef itk::Image<double, 3> FunctionImageType;
+typedef itk::Image<short, 3> LabelImageType;
+typedef itk::GeneralizedDistanceTransformImageFilter<FunctionImageType,
+        FunctionImageType, LabelImageType> Distance;
+typedef FunctionImageType::IndexType IndexType;
+
+unsigned long compare(const Distance::BooleanArrayType &periodic)
+{
+  const double spacing[3] = { 1.0, 0.5, 1.5 };
+  FunctionImageType::SizeType size;
+  size[0] = 11;
+  size[1] = 8;
+  size[2] = 6;
+  FunctionImageType::SizeType tiledSize = size;
+  for (unsigned int d = 0; d < 3; ++d)
+    if (periodic[d])
+      tiledSize[d] *= 3;
+
+  FunctionImageType::Pointer function = FunctionImageType::New();
+  function->SetRegions(size);
+  function->SetSpacing(spacing);
+  function->Allocate();
+  function->FillBuffer(Distance::GetMaximumApexHeight());
+  LabelImageType::Pointer labels = LabelImageType::New();
+  labels->SetRegions(size);
+  labels->Allocate();
+  labels->FillBuffer(0);
+
+  FunctionImageType::Pointer tiledFunction = FunctionImageType::New();
+  tiledFunction->SetRegions(tiledSize);
+  tiledFunction->SetSpacing(spacing);
+  tiledFunction->Allocate();
+  tiledFunction->FillBuffer(Distance::GetMaximumApexHeight());
+  LabelImageType::Pointer tiledLabels = LabelImageType::New();
+  tiledLabels->SetRegions(tiledSize);
+  tiledLabels->Allocate();
+  tiledLabels->FillBuffer(0);
+
+  // A few seeds, some of them near the borders
+  srand(11);
+  std::vector<IndexType> seeds;
+  std::vector<double> heights;
+  for (short l = 1; l <= 5; ++l)
+  {
+    IndexType seed;
+    for (unsigned int d = 0; d < 3; ++d)
+      seed[d] = rand() % 2 ? rand() % 2 * (size[d] - 1) : rand() % size[d];
+    seeds.push_back(seed);
+    heights.push_back(rand() % 4);
+    function->SetPixel(seed, heights.back());
+    labels->SetPixel(seed, l);
+
+    // The copies in the tiles
+    for (int t = 0; t < 27; ++t)
+    {
+      IndexType copy = seed;
+      bool inside = true;
+      for (unsigned int d = 0, r = t; d < 3; ++d, r /= 3)
+      {
+        if (!periodic[d] && r % 3 != 0)
+          inside = false;
+        copy[d] += (r % 3) * size[d];
+      }
+      if (!inside)
+        continue;
+      tiledFunction->SetPixel(copy, heights.back());
+      tiledLabels->SetPixel(copy, l);
+    }
+  }
+
+  Distance::Pointer distance = Distance::New();
+  distance->SetInput1(function);
+  distance->SetInput2(labels);
+  distance->SetUseSpacing(true);
+  distance->SetPeriodicBoundary(periodic);
+  distance->SetNumberOfThreads(3);
+  distance->Update();
+
+  Distance::Pointer tiled = Distance::New();
+  tiled->SetInput1(tiledFunction);
+  tiled->SetInput2(tiledLabels);
+  tiled->SetUseSpacing(true);
+  tiled->Update();
+
+  unsigned long errors = 0;
+  typedef itk::ImageRegionConstIteratorWithIndex<FunctionImageType> IteratorType;
+  for (IteratorType it(distance->GetDistance(), distance->GetDistance()->GetBufferedRegion());
+       !it.IsAtEnd(); ++it)
+  {
+    const IndexType index = it.GetIndex();
+    IndexType middle = index;
+    for (unsigned int d = 0; d < 3; ++d)
+      if (periodic[d])
+        middle[d] += size[d];
+
+    const double expected = tiled->GetDistance()->GetPixel(middle);
+    const short label = distance->GetVoronoiMap()->GetPixel(index);
+
+    // The distance to the closest copy of the seed of the label
+    double atLabel = heights[label - 1];
+    for (unsigned int d = 0; d < 3; ++d)
+    {
+      long offset = std::labs(index[d] - seeds[label - 1][d]);
+      if (periodic[d])
+        offset = std::min<long>(offset, size[d] - offset);
+      atLabel += offset * offset * spacing[d] * spacing[d];
+    }
+
+    if (it.Get() != expected || atLabel != expected)
+    {
+      if (errors < 10)
+        std::cerr << "Periodic " << periodic << ": distance at " << index
+          << " is " << it.Get() << " of label " << label << ", expected "
+          << expected << " of label "
+          << tiled->GetVoronoiMap()->GetPixel(middle) << std::endl;
+      ++errors;
+    }
+  }
+  return errors;
+}
+
+int main(int argc, char **argv)
+{
+  if (argc > 1)
+  {
+    std::cerr <<
+      "Compare the distance transform with periodic boundaries to the one of\n"
+      "the image tiled three times along the periodic dimensions.\n"
+      "Produces no output files.\n"
+      "\n"
+      "USAGE: " << argv[0] << "\n";
+    return 1;
+  }
+
+  unsigned long errors = 0;
+  for (unsigned int p = 1; p < 8; ++p)
+  {
+    Distance::BooleanArrayType periodic;
+    for (unsigned int d = 0; d < 3; ++d)
+      periodic[d] = (p >> d) & 1;
+    errors += compare(periodic);
+  }
+
+  std::cout << "Wrong voxels: " << errors << std::endl;
+  return errors ? 1 : 0;
+}
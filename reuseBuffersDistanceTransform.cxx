@@ -0,0 +1,138 @@
+// Update a transform twice with ReuseBuffers on
+//
+// The outputs of the first update are disconnected from the pipeline and
+// held while the input is changed and the filter updated again. The kept
+// buffers are still referred to by the held outputs, so the second update
+// must not write into them: Both results must be those of a fresh filter.
+// A third update, after the held outputs are released, reuses the buffers
+// of the second one and must be right as well.
+//
+// The voronoi map has another pixel type than the distance, so that the
+// outputs that replace the disconnected ones must have the right types.
+//
+// Returns 1 if any voxel differs.
+
+#include <iostream>
+#include <cstdlib>
+
+#include "itkImage.h"
+#include "itkImageRegionConstIteratorWithIndex.h"
+#include "itkGeneralizedDistanceTransformImageFilter.h"
+
+
+typedef itk::Image<float, 3> FunctionImageType;
+typedef itk::Image<unsigned char, 3> LabelImageType;
+typedef itk::GeneralizedDistanceTransformImageFilter<FunctionImageType,
+        FunctionImageType, LabelImageType> Distance;
+
+// Put new random seeds into the images
+void randomize(FunctionImageType *function, LabelImageType *labels)
+{
+  typedef itk::ImageRegionConstIteratorWithIndex<FunctionImageType> IteratorType;
+  for (IteratorType it(function, function->GetBufferedRegion()); !it.IsAtEnd(); ++it)
+  {
+    const bool isSeed = rand() % 61 == 0;
+    function->SetPixel(it.GetIndex(), isSeed ? rand() % 3 : Distance::GetMaximumApexHeight());
+    labels->SetPixel(it.GetIndex(), isSeed ? 1 + rand() % 200 : 0);
+  }
+  function->Modified();
+  labels->Modified();
+}
+
+// The transform of a fresh filter
+Distance::Pointer transform(FunctionImageType *function, LabelImageType *labels)
+{
+  Distance::Pointer distance = Distance::New();
+  distance->SetInput1(function);
+  distance->SetInput2(labels);
+  distance->Update();
+  return distance;
+}
+
+unsigned long compare(Distance *reference, const FunctionImageType *distance,
+    const LabelImageType *voronoiMap, const char *name)
+{
+  if (!distance || !voronoiMap)
+  {
+    std::cerr << name << ": missing output" << std::endl;
+    return 1;
+  }
+
+  unsigned long errors = 0;
+  typedef itk::ImageRegionConstIteratorWithIndex<FunctionImageType> IteratorType;
+  const FunctionImageType *output = reference->GetDistance();
+  for (IteratorType it(output, output->GetBufferedRegion()); !it.IsAtEnd(); ++it)
+  {
+    const FunctionImageType::IndexType index = it.GetIndex();
+    if (distance->GetPixel(index) != it.Get()
+        || voronoiMap->GetPixel(index) != reference->GetVoronoiMap()->GetPixel(index))
+    {
+      if (errors < 10)
+        std::cerr << name << ": voxel " << index << " differs" << std::endl;
+      ++errors;
+    }
+  }
+  return errors;
+}
+
+int main(int argc, char **argv)
+{
+  if (argc > 1)
+  {
+    std::cerr <<
+      "Update a distance transform three times with ReuseBuffers on, while\n"
+      "the outputs of the first update are held, and compare the results to\n"
+      "fresh transforms. Produces no output files.\n"
+      "\n"
+      "USAGE: " << argv[0] << "\n";
+    return 1;
+  }
+
+  FunctionImageType::SizeType size;
+  size[0] = 29;
+  size[1] = 17;
+  size[2] = 13;
+  FunctionImageType::Pointer function = FunctionImageType::New();
+  function->SetRegions(size);
+  function->Allocate();
+  LabelImageType::Pointer labels = LabelImageType::New();
+  labels->SetRegions(size);
+  labels->Allocate();
+
+  Distance::Pointer distance = Distance::New();
+  distance->SetInput1(function);
+  distance->SetInput2(labels);
+  distance->ReuseBuffersOn();
+
+  // First update, whose outputs are held
+  srand(17);
+  randomize(function, labels);
+  Distance::Pointer first = transform(function, labels);
+  distance->Update();
+  FunctionImageType::Pointer firstDistance = distance->GetDistance();
+  LabelImageType::Pointer firstVoronoiMap = distance->GetVoronoiMap();
+  firstDistance->DisconnectPipeline();
+  firstVoronoiMap->DisconnectPipeline();
+
+  // Second update with another input
+  randomize(function, labels);
+  Distance::Pointer second = transform(function, labels);
+  distance->Update();
+
+  unsigned long errors = 0;
+  errors += compare(first, firstDistance, firstVoronoiMap, "First update");
+  errors += compare(second, distance->GetDistance(), distance->GetVoronoiMap(),
+      "Second update");
+
+  // Third update, in the buffers of the second one
+  firstDistance = 0;
+  firstVoronoiMap = 0;
+  randomize(function, labels);
+  Distance::Pointer third = transform(function, labels);
+  distance->Update();
+  errors += compare(third, distance->GetDistance(), distance->GetVoronoiMap(),
+      "Third update");
+
+  std::cout << "Wrong voxels: " << errors << std::endl;
+  return errors ? 1 : 0;
+}
@@ -0,0 +1,94 @@
+#include "itkImageFileReader.h"
+#include "itkBinaryThresholdImageFilter.h"
+#include "itkGeneralizedDistanceTransformImageFilter.h"
+#include "itkSqrtImageFilter.h"
+#include "itkImageFileWriter.h"
+
+int main(int argc, char *argv[])
+{
+  if (argc != 4)
+  {
+    std::cerr <<
+      "Compute the euclidean distance transform and a run-length encoded\n"
+      "Voronoi map of an image. The runs are decoded for the label output.\n"
+      "\n"
+      "USAGE: " << argv[0] << " <label image> <distance output> <label output>\n"
+      "  <label image>: An image where background voxels have label 0.\n"
+      "  <distance output>: An image that denotes the euclidean distance to\n"
+      "     the closest foreground voxel.\n"
+      "  <label output>: An image that denotes the label of the closest\n"
+      "     foreground voxel.\n";
+    return 1;
+  }
+
+  const unsigned int dimension=3;
+  typedef short PixelType;
+  typedef itk::Image<PixelType, dimension> ImageType;
+
+  // Read the label image
+  typedef itk::ImageFileReader<ImageType> ReaderType;
+  ReaderType::Pointer input = ReaderType::New();
+  input->SetFileName(argv[1]);
+
+  typedef itk::GeneralizedDistanceTransformImageFilter<ImageType, ImageType> Distance;
+
+  // For the label image l, create an indicator image i with
+  // i(x) = (l(x) == 0 ?  infinity : 0).
+  typedef itk::BinaryThresholdImageFilter<ImageType, ImageType> Indicator;
+  Indicator::Pointer indicator = Indicator::New();
+  indicator->SetLowerThreshold(0);
+  indicator->SetUpperThreshold(0);
+  indicator->SetOutsideValue(0);
+  indicator->SetInsideValue(Distance::GetMaximumApexHeight());
+  indicator->SetInput(input->GetOutput());
+
+  // The last iteration records the Voronoi map as runs only
+  Distance::Pointer distance = Distance::New();
+  distance->SetInput1(indicator->GetOutput());
+  distance->SetInput2(input->GetOutput());
+  distance->CreateRunLengthVoronoiMapOn();
+  distance->WriteDenseVoronoiMapOff();
+
+  // The squared euclidean distance is converted to the regular euclidean
+  // distance
+  typedef itk::SqrtImageFilter<ImageType, ImageType> Sqrt;
+  Sqrt::Pointer sqrt = Sqrt::New();
+  sqrt->SetInput(distance->GetOutput());
+
+  // Write the distance image
+  typedef itk::ImageFileWriter<ImageType> Writer;
+  Writer::Pointer writer = Writer::New();
+  writer->SetInput(sqrt->GetOutput());
+  writer->SetFileName(argv[2]);
+  writer->Update();
+
+  // Decode the runs, scanline after scanline
+  ImageType::Pointer labels = ImageType::New();
+  labels->SetRegions(distance->GetOutput()->GetLargestPossibleRegion());
+  labels->CopyInformation(distance->GetOutput());
+  labels->Allocate();
+
+  const Distance::VoronoiRunContainerType &runs = distance->GetVoronoiRuns();
+  const std::vector<unsigned long> &lineStarts = distance->GetVoronoiRunLineStarts();
+  const unsigned int direction = distance->GetVoronoiRunDirection();
+  for (unsigned long line = 0; line < distance->GetNumberOfVoronoiRunLines(); ++line)
+  {
+    ImageType::IndexType index = distance->GetVoronoiRunLineIndex(line);
+    for (unsigned long run = lineStarts[line]; run < lineStarts[line + 1]; ++run)
+    {
+      for (unsigned long i = 0; i < runs[run].Length; ++i)
+      {
+        index[direction] = runs[run].Start + i;
+        labels->SetPixel(index, runs[run].Label);
+      }
+    }
+  }
+
+  std::cout << "Voronoi map: " << runs.size() << " runs for "
+            << labels->GetLargestPossibleRegion().GetNumberOfPixels() << " voxels\n";
+
+  // Write the label image
+  writer->SetInput(labels);
+  writer->SetFileName(argv[3]);
+  writer->Update();
+}
@@ -0,0 +1,181 @@
+// Compare the run-length encoded voronoi map to the dense one
+//
+// Random 2D and 3D images are transformed twice, once with the dense
+// voronoi map only and once with the runs, which are decoded and compared
+// to the dense map. The runs of a scanline must be adjacent and cover the
+// output exactly. The trials vary the start index and the size of the
+// images, the shrink factors, the processed dimensions, periodic
+// boundaries, seeds instead of images, the tile size and whether the dense
+// map is written as well.
+//
+// Returns 1 if any voxel differs.
+
+#include <iostream>
+#include <vector>
+#include <cstdlib>
+
+#include "itkImage.h"
+#include "itkImageRegionConstIteratorWithIndex.h"
+#include "itkGeneralizedDistanceTransformImageFilter.h"
+
+
+template <unsigned int Dimension>
+unsigned long compare(unsigned int trial)
+{
+  typedef itk::Image<short, Dimension> ImageType;
+  typedef itk::GeneralizedDistanceTransformImageFilter<ImageType, ImageType> Distance;
+  typedef typename ImageType::IndexType IndexType;
+
+  srand(7 * trial + Dimension);
+  typename ImageType::RegionType region;
+  IndexType start;
+  typename ImageType::SizeType size;
+  for (unsigned int d = 0; d < Dimension; ++d)
+  {
+    start[d] = rand() % 5 - 2;
+    size[d] = 3 + rand() % 15;
+  }
+  region.SetIndex(start);
+  region.SetSize(size);
+
+  // A few seeds with random labels
+  typename ImageType::Pointer function = ImageType::New();
+  function->SetRegions(region);
+  function->Allocate();
+  typename ImageType::Pointer labels = ImageType::New();
+  labels->SetRegions(region);
+  labels->Allocate();
+  typename Distance::SeedContainerType seeds;
+  typedef itk::ImageRegionConstIteratorWithIndex<ImageType> IteratorType;
+  for (IteratorType it(function, region); !it.IsAtEnd(); ++it)
+  {
+    const bool isSeed = rand() % 23 == 0;
+    const short label = isSeed ? 1 + rand() % 4 : 0;
+    function->SetPixel(it.GetIndex(), isSeed ? 0 : Distance::GetMaximumApexHeight());
+    labels->SetPixel(it.GetIndex(), label);
+    if (isSeed)
+    {
+      typename Distance::SeedType seed;
+      seed.Index = it.GetIndex();
+      seed.Height = 0;
+      seed.Label = label;
+      seeds.push_back(seed);
+    }
+  }
+
+  typename Distance::ShrinkFactorsType shrinkFactors;
+  shrinkFactors.Fill(1);
+  if (trial % 3 == 1)
+    shrinkFactors[0] = 2;
+  typename Distance::BooleanArrayType processed;
+  processed.Fill(true);
+  if (trial % 4 == 2)
+    processed[Dimension - 1] = false;
+  if (trial % 10 == 4)
+  {
+    processed.Fill(false);
+    processed[0] = true;
+  }
+  typename Distance::BooleanArrayType periodic;
+  periodic.Fill(false);
+  if (trial % 6 == 5)
+    periodic[Dimension - 1] = true;
+  const bool useSeeds = trial % 5 == 4;
+  const bool writeDense = trial % 2 == 0;
+
+  typename Distance::Pointer dense = Distance::New();
+  typename Distance::Pointer runs = Distance::New();
+  for (unsigned int k = 0; k < 2; ++k)
+  {
+    Distance *distance = k ? runs.GetPointer() : dense.GetPointer();
+    if (useSeeds)
+    {
+      distance->SetSeeds(seeds);
+      distance->SetOutputRegion(region);
+    }
+    else
+    {
+      distance->SetInput1(function);
+      distance->SetInput2(labels);
+    }
+    distance->SetShrinkFactors(shrinkFactors);
+    distance->SetProcessedDimensions(processed);
+    distance->SetPeriodicBoundary(periodic);
+  }
+  runs->CreateRunLengthVoronoiMapOn();
+  runs->SetWriteDenseVoronoiMap(writeDense);
+  runs->SetLinesPerTile(1 + trial % 3);
+  runs->SetNumberOfThreads(3);
+  dense->Update();
+  runs->Update();
+
+  // Decode the runs, scanline after scanline
+  unsigned long errors = 0;
+  unsigned long decoded = 0;
+  const ImageType *voronoiMap = dense->GetVoronoiMap();
+  const typename ImageType::RegionType &output = voronoiMap->GetBufferedRegion();
+  const unsigned int direction = runs->GetVoronoiRunDirection();
+  const std::vector<unsigned long> &lineStarts = runs->GetVoronoiRunLineStarts();
+  for (unsigned long line = 0; line < runs->GetNumberOfVoronoiRunLines(); ++line)
+  {
+    IndexType index = runs->GetVoronoiRunLineIndex(line);
+    long position = index[direction];
+    for (unsigned long r = lineStarts[line]; r < lineStarts[line + 1]; ++r)
+    {
+      const typename Distance::VoronoiRunType &run = runs->GetVoronoiRuns()[r];
+      if (run.Start != position)
+        ++errors;
+      for (unsigned long i = 0; i < run.Length; ++i, ++decoded)
+      {
+        index[direction] = run.Start + i;
+        if (!output.IsInside(index) || voronoiMap->GetPixel(index) != run.Label)
+        {
+          if (errors < 10)
+            std::cerr << Dimension << "D trial " << trial << ": run label at "
+              << index << " is " << run.Label << std::endl;
+          ++errors;
+        }
+      }
+      position += run.Length;
+    }
+    if (position != output.GetIndex()[direction] + static_cast<long>(output.GetSize()[direction]))
+      ++errors;
+  }
+  if (decoded != output.GetNumberOfPixels())
+  {
+    std::cerr << Dimension << "D trial " << trial << ": the runs cover "
+      << decoded << " of " << output.GetNumberOfPixels() << " voxels" << std::endl;
+    ++errors;
+  }
+
+  // The dense map is the same if it is written
+  if (writeDense)
+    for (IteratorType it(voronoiMap, output); !it.IsAtEnd(); ++it)
+      if (runs->GetVoronoiMap()->GetPixel(it.GetIndex()) != it.Get())
+        ++errors;
+
+  return errors;
+}
+
+int main(int argc, char **argv)
+{
+  if (argc > 1)
+  {
+    std::cerr <<
+      "Compare the run-length encoded voronoi map to the dense one on random\n"
+      "2D and 3D images. Produces no output files.\n"
+      "\n"
+      "USAGE: " << argv[0] << "\n";
+    return 1;
+  }
+
+  unsigned long errors = 0;
+  for (unsigned int trial = 0; trial < 30; ++trial)
+  {
+    errors += compare<2>(trial);
+    errors += compare<3>(trial);
+  }
+
+  std::cout << "Wrong voxels: " << errors << std::endl;
+  return errors ? 1 : 0;
+}
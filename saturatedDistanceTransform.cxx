@@ -0,0 +1,151 @@
+// Saturate a narrow distance pixel type with a wide accumulator
+//
+// The distance is stored as unsigned short and computed in long long. The
+// spacing is large enough that the squared distances of many voxels exceed
+// the range of unsigned short. Those voxels must be clamped to
+// GetMaximumApexHeight(), the others must be exact.
+//
+// The samples are counted in every iteration over the dimensions: A voxel
+// of the first iteration is saturated if its row has a seed and its
+// distance along the row doesn't fit, a voxel of the second iteration if
+// its column has a voxel that fit and its distance doesn't. The rows
+// without seeds are background and aren't counted.
+//
+// Returns 1 if any voxel or the count differs.
+
+#include <iostream>
+#include <vector>
+#include <cstdlib>
+#include <algorithm>
+
+#include "itkImage.h"
+#include "itkGeneralizedDistanceTransformImageFilter.h"
+
+
+int main(int argc, char **argv)
+{
+  if (argc > 1)
+  {
+    std::cerr <<
+      "Compute a distance transform with unsigned short distances and a\n"
+      "long long accumulator, and check the saturated voxels and their count.\n"
+      "Produces no output files.\n"
+      "\n"
+      "USAGE: " << argv[0] << "\n";
+    return 1;
+  }
+
+  typedef itk::Image<unsigned short, 2> ImageType;
+  typedef itk::GeneralizedDistanceTransformImageFilter<ImageType, ImageType,
+          ImageType, 3, long long> Distance;
+  const unsigned short infinity = Distance::GetMaximumApexHeight();
+
+  // A seed near the start of every other row
+  const long width = 90;
+  const long height = 9;
+  const double spacing[2] = { 5.0, 2.0 };
+  ImageType::SizeType size;
+  size[0] = width;
+  size[1] = height;
+  ImageType::Pointer function = ImageType::New();
+  function->SetRegions(size);
+  function->SetSpacing(spacing);
+  function->Allocate();
+  function->FillBuffer(infinity);
+
+  srand(3);
+  for (long y = 0; y < height; y += 2)
+  {
+    ImageType::IndexType index;
+    index[0] = rand() % 30;
+    index[1] = y;
+    function->SetPixel(index, 0);
+  }
+
+  // Brute force, one dimension after the other
+  std::vector<long long> rows(width * height, -1);
+  unsigned long saturated = 0;
+  for (long y = 0; y < height; ++y)
+    for (long x = 0; x < width; ++x)
+    {
+      long long smallest = -1;
+      for (long i = 0; i < width; ++i)
+      {
+        ImageType::IndexType index;
+        index[0] = i;
+        index[1] = y;
+        if (function->GetPixel(index) != 0)
+          continue;
+        const long long d = static_cast<long long>((x - i) * spacing[0]);
+        if (smallest < 0 || d * d < smallest)
+          smallest = d * d;
+      }
+      rows[y * width + x] = smallest;
+      if (smallest >= infinity)
+        ++saturated;
+    }
+
+  std::vector<long long> expected(width * height, -1);
+  for (long x = 0; x < width; ++x)
+    for (long y = 0; y < height; ++y)
+    {
+      long long smallest = -1;
+      for (long j = 0; j < height; ++j)
+      {
+        const long long row = rows[j * width + x];
+        if (row < 0 || row >= infinity)
+          continue;
+        const long long d = static_cast<long long>((y - j) * spacing[1]);
+        if (smallest < 0 || row + d * d < smallest)
+          smallest = row + d * d;
+      }
+      expected[y * width + x] = smallest < 0 ? infinity :
+        std::min<long long>(smallest, infinity);
+      if (smallest >= infinity)
+        ++saturated;
+    }
+
+  Distance::Pointer distance = Distance::New();
+  distance->SetInput1(function);
+  distance->SetUseSpacing(true);
+  distance->SetCreateVoronoiMap(false);
+  distance->SetNumberOfThreads(2);
+  distance->Update();
+
+  unsigned long errors = 0;
+  unsigned long clamped = 0;
+  for (long y = 0; y < height; ++y)
+    for (long x = 0; x < width; ++x)
+    {
+      ImageType::IndexType index;
+      index[0] = x;
+      index[1] = y;
+      const unsigned short value = distance->GetOutput()->GetPixel(index);
+      if (value == infinity)
+        ++clamped;
+      if (value != expected[y * width + x])
+      {
+        if (errors < 10)
+          std::cerr << "Distance at " << index << " is " << value
+            << ", expected " << expected[y * width + x] << std::endl;
+        ++errors;
+      }
+    }
+
+  // The test is pointless if nothing saturates
+  if (clamped == 0)
+  {
+    std::cerr << "No voxel was saturated" << std::endl;
+    ++errors;
+  }
+
+  if (distance->GetNumberOfSaturatedPixels() != saturated)
+  {
+    std::cerr << "Counted " << distance->GetNumberOfSaturatedPixels()
+      << " saturated samples, expected " << saturated << std::endl;
+    ++errors;
+  }
+
+  std::cout << "Wrong voxels: " << errors << std::endl;
+  return errors ? 1 : 0;
+}
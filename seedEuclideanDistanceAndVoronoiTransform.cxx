@@ -0,0 +1,69 @@
+#include "itkImageFileReader.h"
+#include "itkImageRegionConstIteratorWithIndex.h"
+#include "itkGeneralizedDistanceTransformImageFilter.h"
+#include "itkSqrtImageFilter.h"
+#include "itkImageFileWriter.h"
+
+int main(int argc, char *argv[])
+{
+  if (argc != 4)
+  {
+    std::cerr <<
+      "Compute the euclidean distance transform and Voronoi map of a list of\n"
+      "seed points.\n"
+      "\n"
+      "USAGE: " << argv[0] << " <label image> <distance output> <label output>\n"
+      "  <label image>: An image where background voxels have label 0. The\n"
+      "     foreground voxels are passed to the filter as a list of seeds,\n"
+      "     the image only defines the geometry of the outputs.\n"
+      "  <distance output>: An image that denotes the euclidean distance to\n"
+      "     the closest seed.\n"
+      "  <label output>: An image that denotes the label of the closest\n"
+      "     seed.\n";
+    return 1;
+  }
+
+  const unsigned int dimension=3;
+  typedef short PixelType;
+  typedef itk::Image<PixelType, dimension> ImageType;
+
+  // Read the label image
+  typedef itk::ImageFileReader<ImageType> ReaderType;
+  ReaderType::Pointer input = ReaderType::New();
+  input->SetFileName(argv[1]);
+  input->Update();
+
+  typedef itk::GeneralizedDistanceTransformImageFilter<ImageType, ImageType> Distance;
+  Distance::Pointer distance = Distance::New();
+
+  // Seeds have a function value of 0, i.e. the standard euclidean distance
+  // transform is computed. No indicator image is needed.
+  typedef itk::ImageRegionConstIteratorWithIndex<ImageType> Iterator;
+  Iterator it(input->GetOutput(), input->GetOutput()->GetLargestPossibleRegion());
+  for (it.GoToBegin(); !it.IsAtEnd(); ++it)
+    if (it.Get() != 0)
+      distance->AddSeed(it.GetIndex(), 0, it.Get());
+
+  // The geometry of the outputs is not defined by an input image
+  distance->SetOutputRegion(input->GetOutput()->GetLargestPossibleRegion());
+  distance->SetOutputSpacing(input->GetOutput()->GetSpacing());
+  distance->SetOutputOrigin(input->GetOutput()->GetOrigin());
+
+  // The squared euclidean distance is converted to the regular euclidean
+  // distance
+  typedef itk::SqrtImageFilter<ImageType, ImageType> Sqrt;
+  Sqrt::Pointer sqrt = Sqrt::New();
+  sqrt->SetInput(distance->GetOutput());
+
+  // Write the distance image
+  typedef itk::ImageFileWriter<ImageType> Writer;
+  Writer::Pointer writer = Writer::New();
+  writer->SetInput(sqrt->GetOutput());
+  writer->SetFileName(argv[2]);
+  writer->Update();
+
+  // Write the label image
+  writer->SetInput(distance->GetVoronoiMap());
+  writer->SetFileName(argv[3]);
+  writer->Update();
+}
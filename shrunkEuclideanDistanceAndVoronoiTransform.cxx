@@ -0,0 +1,135 @@
+#include <cstdlib>
+
+#include "itkImageFileReader.h"
+#include "itkBinaryThresholdImageFilter.h"
+#include "itkGeneralizedDistanceTransformImageFilter.h"
+#include "itkSqrtImageFilter.h"
+#include "itkImageFileWriter.h"
+#include "itkImageRegionConstIteratorWithIndex.h"
+
+int main(int argc, char *argv[])
+{
+  if (argc != 7)
+  {
+    std::cerr <<
+      "Compute the euclidean distance transform and Voronoi map of an image\n"
+      "at every k-th voxel only. The outputs are checked against the\n"
+      "transform at full resolution, the program returns 1 if they differ.\n"
+      "\n"
+      "USAGE: " << argv[0] << " <label image> <kx> <ky> <kz> <distance output> <label output>\n"
+      "  <label image>: An image where background voxels have label 0.\n"
+      "  <kx> <ky> <kz>: The shrink factors along each dimension.\n"
+      "  <distance output>: An image that denotes the euclidean distance to\n"
+      "     the closest foreground voxel.\n"
+      "  <label output>: An image that denotes the label of the closest\n"
+      "     foreground voxel.\n";
+    return 1;
+  }
+
+  const unsigned int dimension=3;
+  typedef short PixelType;
+  typedef itk::Image<PixelType, dimension> ImageType;
+
+  // Read the label image
+  typedef itk::ImageFileReader<ImageType> ReaderType;
+  ReaderType::Pointer input = ReaderType::New();
+  input->SetFileName(argv[1]);
+
+  typedef itk::GeneralizedDistanceTransformImageFilter<ImageType, ImageType> Distance;
+
+  // For the label image l, create an indicator image i with
+  // i(x) = (l(x) == 0 ?  infinity : 0).
+  typedef itk::BinaryThresholdImageFilter<ImageType, ImageType> Indicator;
+  Indicator::Pointer indicator = Indicator::New();
+  indicator->SetLowerThreshold(0);
+  indicator->SetUpperThreshold(0);
+  indicator->SetOutsideValue(0);
+  indicator->SetInsideValue(Distance::GetMaximumApexHeight());
+  indicator->SetInput(input->GetOutput());
+
+  // Output index j is the transform at input index j*k
+  Distance::ShrinkFactorsType shrinkFactors;
+  for (unsigned int d = 0; d < dimension; ++d)
+    shrinkFactors[d] = atoi(argv[2 + d]);
+
+  Distance::Pointer distance = Distance::New();
+  distance->SetInput1(indicator->GetOutput());
+  distance->SetInput2(input->GetOutput());
+  distance->SetShrinkFactors(shrinkFactors);
+
+  // The squared euclidean distance is converted to the regular euclidean
+  // distance
+  typedef itk::SqrtImageFilter<ImageType, ImageType> Sqrt;
+  Sqrt::Pointer sqrt = Sqrt::New();
+  sqrt->SetInput(distance->GetOutput());
+
+  // Write the distance image
+  typedef itk::ImageFileWriter<ImageType> Writer;
+  Writer::Pointer writer = Writer::New();
+  writer->SetInput(sqrt->GetOutput());
+  writer->SetFileName(argv[5]);
+  writer->Update();
+
+  // Write the label image
+  writer->SetInput(distance->GetVoronoiMap());
+  writer->SetFileName(argv[6]);
+  writer->Update();
+
+  // The transform at full resolution
+  Distance::Pointer full = Distance::New();
+  full->SetInput1(indicator->GetOutput());
+  full->SetInput2(input->GetOutput());
+  full->Update();
+
+  // The samples are at the same physical points
+  const ImageType *shrunk = distance->GetDistance();
+  const ImageType *reference = full->GetDistance();
+  bool ok = shrunk->GetOrigin() == reference->GetOrigin();
+  for (unsigned int d = 0; d < dimension; ++d)
+    ok = ok && shrunk->GetSpacing()[d] == shrinkFactors[d] * reference->GetSpacing()[d];
+  if (!ok)
+  {
+    std::cerr << "Wrong geometry: origin " << shrunk->GetOrigin()
+      << ", spacing " << shrunk->GetSpacing() << "\n";
+    return 1;
+  }
+
+  unsigned long errors = 0;
+  typedef itk::ImageRegionConstIteratorWithIndex<ImageType> Iterator;
+  Iterator distanceIt(shrunk, shrunk->GetBufferedRegion());
+  Iterator labelIt(distance->GetVoronoiMap(), shrunk->GetBufferedRegion());
+  for (; !distanceIt.IsAtEnd(); ++distanceIt, ++labelIt)
+  {
+    ImageType::IndexType index = distanceIt.GetIndex();
+    for (unsigned int d = 0; d < dimension; ++d)
+      index[d] *= shrinkFactors[d];
+
+    if (!reference->GetBufferedRegion().IsInside(index)
+        || distanceIt.Get() != reference->GetPixel(index)
+        || labelIt.Get() != full->GetVoronoiMap()->GetPixel(index))
+    {
+      if (errors < 10)
+        std::cerr << "Sample " << distanceIt.GetIndex() << " differs from voxel "
+          << index << "\n";
+      ++errors;
+    }
+  }
+
+  // Every sampled voxel is in the output
+  unsigned long expected = 1;
+  for (unsigned int d = 0; d < dimension; ++d)
+    expected *= (reference->GetBufferedRegion().GetSize()[d] + shrinkFactors[d] - 1)
+      / shrinkFactors[d];
+  if (shrunk->GetBufferedRegion().GetNumberOfPixels() != expected)
+  {
+    std::cerr << "Wrong output region: " << shrunk->GetBufferedRegion() << "\n";
+    ++errors;
+  }
+
+  if (errors)
+  {
+    std::cerr << errors << " wrong samples\n";
+    return 1;
+  }
+  return 0;
+}
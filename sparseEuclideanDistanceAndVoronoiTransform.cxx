@@ -0,0 +1,100 @@
+#include <cstdlib>
+
+#include "itkImageFileReader.h"
+#include "itkImageRegionConstIteratorWithIndex.h"
+#include "itkGeneralizedDistanceTransformImageFilter.h"
+#include "itkSqrtImageFilter.h"
+#include "itkImageFileWriter.h"
+
+int main(int argc, char *argv[])
+{
+  if (argc != 5 && argc != 6)
+  {
+    std::cerr <<
+      "Compute the euclidean distance transform and Voronoi map of an image\n"
+      "that is stored in bricks, of which only the foreground is allocated.\n"
+      "\n"
+      "USAGE: " << argv[0] << " <label image> <brick size> <distance output> <label output> [<narrow band>]\n"
+      "  <label image>: An image where background voxels have label 0.\n"
+      "  <brick size>: The number of voxels along each dimension of a brick.\n"
+      "  <distance output>: An image that denotes the euclidean distance to\n"
+      "     the closest foreground voxel.\n"
+      "  <label output>: An image that denotes the label of the closest\n"
+      "     foreground voxel.\n"
+      "  <narrow band>: The largest squared distance of the bricks that are\n"
+      "     counted in the sparse outputs.\n";
+    return 1;
+  }
+
+  const unsigned int dimension=3;
+  typedef short PixelType;
+  typedef itk::Image<PixelType, dimension> ImageType;
+  typedef itk::GeneralizedDistanceTransformImageFilter<ImageType, ImageType> Distance;
+  typedef Distance::FunctionBrickImageType FunctionBricks;
+  typedef Distance::LabelBrickImageType LabelBricks;
+
+  // Read the label image
+  typedef itk::ImageFileReader<ImageType> ReaderType;
+  ReaderType::Pointer input = ReaderType::New();
+  input->SetFileName(argv[1]);
+  input->Update();
+  const ImageType *labelImage = input->GetOutput();
+
+  FunctionBricks::SizeType brickSize;
+  brickSize.Fill(atoi(argv[2]));
+
+  // Usually, the bricks come from a sparse store. Here, the foreground of
+  // the label image l is copied into label bricks, and into function bricks
+  // of the indicator i with i(x) = (l(x) == 0 ?  infinity : 0).
+  FunctionBricks::Pointer indicator = FunctionBricks::New();
+  indicator->SetRegion(labelImage->GetLargestPossibleRegion());
+  indicator->SetBrickSize(brickSize);
+  indicator->SetSpacing(labelImage->GetSpacing());
+  indicator->SetOrigin(labelImage->GetOrigin());
+  indicator->SetBackgroundValue(Distance::GetMaximumApexHeight());
+
+  LabelBricks::Pointer labels = LabelBricks::New();
+  labels->SetRegion(labelImage->GetLargestPossibleRegion());
+  labels->SetBrickSize(brickSize);
+
+  itk::ImageRegionConstIteratorWithIndex<ImageType>
+    labelIt(labelImage, labelImage->GetLargestPossibleRegion());
+  for (labelIt.GoToBegin(); !labelIt.IsAtEnd(); ++labelIt)
+  {
+    if (labelIt.Get() == 0)
+      continue;
+    indicator->SetPixel(labelIt.GetIndex(), 0);
+    labels->SetPixel(labelIt.GetIndex(), labelIt.Get());
+  }
+
+  Distance::Pointer distance = Distance::New();
+  distance->SetSparseInputs(indicator, labels);
+  distance->SetOutputBrickSize(brickSize);
+  distance->CreateSparseOutputsOn();
+  if (argc == 6)
+    distance->SetNarrowBand(atoi(argv[5]));
+
+  // The squared euclidean distance is converted to the regular euclidean
+  // distance
+  typedef itk::SqrtImageFilter<ImageType, ImageType> Sqrt;
+  Sqrt::Pointer sqrt = Sqrt::New();
+  sqrt->SetInput(distance->GetOutput());
+
+  // Write the distance image
+  typedef itk::ImageFileWriter<ImageType> Writer;
+  Writer::Pointer writer = Writer::New();
+  writer->SetInput(sqrt->GetOutput());
+  writer->SetFileName(argv[3]);
+  writer->Update();
+
+  // Write the label image
+  writer->SetInput(distance->GetVoronoiMap());
+  writer->SetFileName(argv[4]);
+  writer->Update();
+
+  std::cout << "Input bricks: " << indicator->GetNumberOfAllocatedBricks()
+            << " of " << indicator->GetNumberOfBricks() << "\n";
+  std::cout << "Output bricks in the narrow band: "
+            << distance->GetSparseDistance()->GetNumberOfAllocatedBricks()
+            << " of " << distance->GetSparseDistance()->GetNumberOfBricks() << "\n";
+}
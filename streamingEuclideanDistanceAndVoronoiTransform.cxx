@@ -0,0 +1,116 @@
+#include <cstdlib>
+#include <cmath>
+
+#include "itkMappedImageFile.h"
+#include "itkSlabStreamingGeneralizedDistanceTransform.h"
+
+const unsigned int dimension=3;
+typedef short PixelType;
+typedef itk::Image<PixelType, dimension> ImageType;
+typedef itk::MappedImageFile<ImageType> MappedFile;
+
+// The slabs are read from a mapped file, so the pages of a slab are
+// read from disk in the read stage
+class EuclideanSlabStreaming :
+  public itk::SlabStreamingGeneralizedDistanceTransform<ImageType, ImageType>
+{
+public:
+  typedef EuclideanSlabStreaming Self;
+  typedef itk::SlabStreamingGeneralizedDistanceTransform<ImageType, ImageType> Superclass;
+  typedef itk::SmartPointer<Self> Pointer;
+
+  itkNewMacro(Self);
+
+  MappedFile::Pointer Input;
+
+protected:
+  void ReadSlab(unsigned long, const RegionType &slabRegion,
+      FunctionImageConstPointer &functionImage, LabelImageConstPointer &labelImage)
+  {
+    ImageType::Pointer indicator = ImageType::New();
+    indicator->SetRegions(slabRegion);
+    indicator->SetSpacing(GetSpacing());
+    indicator->Allocate();
+
+    ImageType::Pointer labels = ImageType::New();
+    labels->SetRegions(slabRegion);
+    labels->SetSpacing(GetSpacing());
+    labels->Allocate();
+
+    // For the label image l, create an indicator image i with
+    // i(x) = (l(x) == 0 ?  infinity : 0).
+    const unsigned long slicePixels = GetRegion().GetNumberOfPixels() / GetRegion().GetSize()[dimension - 1];
+    const PixelType *label = Input->GetBufferPointer() +
+      slicePixels * (slabRegion.GetIndex()[dimension - 1] - GetRegion().GetIndex()[dimension - 1]);
+    PixelType *indicatorPixel = indicator->GetBufferPointer();
+    PixelType *labelPixel = labels->GetBufferPointer();
+    const unsigned long numberOfPixels = slabRegion.GetNumberOfPixels();
+    for (unsigned long i = 0; i < numberOfPixels; ++i)
+    {
+      labelPixel[i] = label[i];
+      indicatorPixel[i] = label[i] == 0 ? GetMaximumApexHeight() : 0;
+    }
+
+    functionImage = indicator.GetPointer();
+    labelImage = labels.GetPointer();
+  }
+};
+
+int main(int argc, char *argv[])
+{
+  if (argc != 5)
+  {
+    std::cerr <<
+      "Compute the euclidean distance transform and Voronoi map of an image\n"
+      "that is read in slabs. Reading and computing overlap.\n"
+      "\n"
+      "USAGE: " << argv[0] << " <label image> <slab thickness> <distance output> <label output>\n"
+      "  <label image>: An Analyze image where background voxels have label 0.\n"
+      "  <slab thickness>: The number of slices that are read at once.\n"
+      "  <distance output>: An Analyze image that denotes the euclidean\n"
+      "     distance to the closest foreground voxel.\n"
+      "  <label output>: An Analyze image that denotes the label of the\n"
+      "     closest foreground voxel.\n";
+    return 1;
+  }
+
+  try
+  {
+    MappedFile::Pointer input = MappedFile::New();
+    input->MapForReading(argv[1]);
+    const ImageType *labels = input->GetImage();
+    const ImageType::RegionType &region = labels->GetLargestPossibleRegion();
+
+    // The outputs are computed into mapped files
+    MappedFile::Pointer distanceOutput = MappedFile::New();
+    distanceOutput->SetOrientation(input->GetOrientation());
+    distanceOutput->MapForWriting(argv[3], region.GetSize(), labels->GetSpacing());
+    MappedFile::Pointer labelOutput = MappedFile::New();
+    labelOutput->SetOrientation(input->GetOrientation());
+    labelOutput->MapForWriting(argv[4], region.GetSize(), labels->GetSpacing());
+
+    EuclideanSlabStreaming::Pointer streaming = EuclideanSlabStreaming::New();
+    streaming->Input = input;
+    streaming->SetRegion(region);
+    streaming->SetSpacing(labels->GetSpacing());
+    streaming->SetSlabThickness(atoi(argv[2]));
+    streaming->SetDistanceImportPointer(distanceOutput->GetBufferPointer());
+    streaming->SetVoronoiMapImportPointer(labelOutput->GetBufferPointer());
+    streaming->Update();
+
+    // The squared euclidean distance is converted to the regular euclidean
+    // distance in place
+    PixelType *pixel = distanceOutput->GetBufferPointer();
+    const unsigned long numberOfPixels = region.GetNumberOfPixels();
+    for (unsigned long i = 0; i < numberOfPixels; ++i)
+      pixel[i] = static_cast<PixelType>(std::sqrt(static_cast<double>(pixel[i])));
+
+    distanceOutput->Close();
+    labelOutput->Close();
+  }
+  catch (itk::ExceptionObject &e)
+  {
+    std::cerr << e << std::endl;
+    return 1;
+  }
+}
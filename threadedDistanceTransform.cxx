@@ -0,0 +1,222 @@
+// Compare the threaded options of itk::GeneralizedDistanceTransformImageFilter
+// to a transform with one thread
+//
+// A random 3D image is transformed once with one thread and the default
+// options, and then with several threads and options that only change how
+// the work is scheduled. The outputs must be the same voxel for voxel.
+//
+// Small tiles make the threads steal many tiles from each other. The load
+// balance efficiency must then be in (0, 1], and the progress must grow
+// from 0 to 1 although no thread knows in advance how many scanlines it
+// will compute.
+//
+// NumaAware and UseHugePages only change where the memory is placed. They
+// are tried with the image, with seeds and with bricks as input: With
+// seeds and bricks, the threads initialize the rows of the scanlines they
+// compute first.
+//
+// Returns 1 if any voxel, the efficiency or the progress is wrong.
+
+#include <iostream>
+#include <vector>
+#include <algorithm>
+#include <cstdlib>
+
+#include "itkImage.h"
+#include "itkCommand.h"
+#include "itkImageRegionConstIteratorWithIndex.h"
+#include "itkGeneralizedDistanceTransformImageFilter.h"
+
+
+typedef itk::Image<float, 3> FunctionImageType;
+typedef itk::Image<short, 3> LabelImageType;
+typedef itk::GeneralizedDistanceTransformImageFilter<FunctionImageType,
+        FunctionImageType, LabelImageType> Distance;
+
+// Record whether the progress ever decreases or leaves [0, 1]
+class ProgressObserver : public itk::Command
+{
+public:
+  typedef ProgressObserver Self;
+  typedef itk::SmartPointer<Self> Pointer;
+  itkNewMacro(Self);
+
+  void Execute(itk::Object *caller, const itk::EventObject &event)
+  {
+    Execute(static_cast<const itk::Object *>(caller), event);
+  }
+
+  void Execute(const itk::Object *caller, const itk::EventObject &)
+  {
+    const float progress =
+      static_cast<const itk::ProcessObject *>(caller)->GetProgress();
+    if (progress < m_Progress || progress < 0.0f || progress > 1.0f)
+      m_Wrong = true;
+    m_Progress = progress;
+  }
+
+  float m_Progress;
+  bool m_Wrong;
+
+protected:
+  ProgressObserver() : m_Progress(0.0f), m_Wrong(false) {}
+};
+
+unsigned long compare(const Distance *reference, const Distance *distance,
+    const char *name)
+{
+  unsigned long errors = 0;
+  typedef itk::ImageRegionConstIteratorWithIndex<FunctionImageType> IteratorType;
+  const FunctionImageType *output = reference->GetDistance();
+  for (IteratorType it(output, output->GetBufferedRegion()); !it.IsAtEnd(); ++it)
+  {
+    const FunctionImageType::IndexType index = it.GetIndex();
+    if (distance->GetDistance()->GetPixel(index) != it.Get()
+        || distance->GetVoronoiMap()->GetPixel(index)
+        != reference->GetVoronoiMap()->GetPixel(index))
+    {
+      if (errors < 10)
+        std::cerr << name << ": voxel " << index << " differs" << std::endl;
+      ++errors;
+    }
+  }
+  return errors;
+}
+
+int main(int argc, char **argv)
+{
+  if (argc > 1)
+  {
+    std::cerr <<
+      "Compare the distance transform with several threads, small tiles, NUMA\n"
+      "placement and huge pages to the one with a single thread.\n"
+      "Produces no output files.\n"
+      "\n"
+      "USAGE: " << argv[0] << "\n";
+    return 1;
+  }
+
+  FunctionImageType::SizeType size;
+  size[0] = 37;
+  size[1] = 23;
+  size[2] = 19;
+  FunctionImageType::Pointer function = FunctionImageType::New();
+  function->SetRegions(size);
+  function->Allocate();
+  LabelImageType::Pointer labels = LabelImageType::New();
+  labels->SetRegions(size);
+  labels->Allocate();
+
+  // The same seeds as an image, a list and bricks. The first and last
+  // slices have no seed, so that the rows before the first scanline with a
+  // seed and after the last one are initialized on their own.
+  FunctionImageType::SizeType brickSize;
+  brickSize.Fill(4);
+  Distance::FunctionBrickImageType::Pointer functionBricks =
+    Distance::FunctionBrickImageType::New();
+  functionBricks->SetRegion(function->GetBufferedRegion());
+  functionBricks->SetBrickSize(brickSize);
+  functionBricks->SetBackgroundValue(Distance::GetMaximumApexHeight());
+  Distance::LabelBrickImageType::Pointer labelBricks =
+    Distance::LabelBrickImageType::New();
+  labelBricks->SetRegion(function->GetBufferedRegion());
+  labelBricks->SetBrickSize(brickSize);
+  Distance::SeedContainerType seeds;
+
+  srand(5);
+  typedef itk::ImageRegionConstIteratorWithIndex<FunctionImageType> IteratorType;
+  for (IteratorType it(function, function->GetBufferedRegion()); !it.IsAtEnd(); ++it)
+  {
+    const long z = it.GetIndex()[2];
+    const bool isSeed = rand() % 97 == 0 && z > 0 && z + 1 < static_cast<long>(size[2]);
+    function->SetPixel(it.GetIndex(), isSeed ? rand() % 3 : Distance::GetMaximumApexHeight());
+    labels->SetPixel(it.GetIndex(), isSeed ? 1 + rand() % 50 : 0);
+    if (isSeed)
+    {
+      Distance::SeedType seed;
+      seed.Index = it.GetIndex();
+      seed.Height = it.Get();
+      seed.Label = labels->GetPixel(it.GetIndex());
+      seeds.push_back(seed);
+      functionBricks->SetPixel(seed.Index, seed.Height);
+      labelBricks->SetPixel(seed.Index, seed.Label);
+    }
+  }
+
+  Distance::Pointer reference = Distance::New();
+  reference->SetInput1(function);
+  reference->SetInput2(labels);
+  reference->SetNumberOfThreads(1);
+  reference->Update();
+
+  // With NumaAware, the outputs are written to buffers full of garbage, so
+  // that rows which no thread initializes are found
+  const unsigned long numberOfPixels = function->GetBufferedRegion().GetNumberOfPixels();
+  std::vector<float> distanceBuffer(numberOfPixels);
+  std::vector<short> voronoiBuffer(numberOfPixels);
+
+  unsigned long errors = 0;
+  const char *inputs[] = { "Image", "Seeds", "Bricks" };
+  for (unsigned int input = 0; input < 3; ++input)
+  {
+    for (unsigned int hugePages = 0; hugePages < 2; ++hugePages)
+    {
+      Distance::Pointer distance = Distance::New();
+      if (input == 0)
+      {
+        distance->SetInput1(function);
+        distance->SetInput2(labels);
+      }
+      else if (input == 1)
+      {
+        distance->SetSeeds(seeds);
+        distance->SetOutputRegion(function->GetBufferedRegion());
+      }
+      else
+        distance->SetSparseInputs(functionBricks, labelBricks);
+      distance->SetNumberOfThreads(5);
+      distance->SetLinesPerTile(3);
+      distance->SetNumaAware(!hugePages);
+      distance->SetUseHugePages(hugePages);
+      if (!hugePages)
+      {
+        std::fill(distanceBuffer.begin(), distanceBuffer.end(), -1.0f);
+        std::fill(voronoiBuffer.begin(), voronoiBuffer.end(), -1);
+        distance->SetDistanceImportPointer(&distanceBuffer[0]);
+        distance->SetVoronoiMapImportPointer(&voronoiBuffer[0]);
+      }
+      distance->Update();
+      errors += compare(reference, distance, inputs[input]);
+    }
+  }
+
+  const unsigned long linesPerTile[] = { 1, 2, 5 };
+  for (unsigned int i = 0; i < 3; ++i)
+  {
+    ProgressObserver::Pointer observer = ProgressObserver::New();
+    Distance::Pointer distance = Distance::New();
+    distance->SetInput1(function);
+    distance->SetInput2(labels);
+    distance->SetNumberOfThreads(7);
+    distance->SetLinesPerTile(linesPerTile[i]);
+    distance->AddObserver(itk::ProgressEvent(), observer);
+    distance->Update();
+    errors += compare(reference, distance, "Small tiles");
+
+    const double efficiency = distance->GetLoadBalanceEfficiency();
+    if (!(efficiency > 0.0 && efficiency <= 1.0))
+    {
+      std::cerr << "Load balance efficiency is " << efficiency << std::endl;
+      ++errors;
+    }
+    if (observer->m_Wrong || observer->m_Progress != 1.0f)
+    {
+      std::cerr << "Progress went wrong with " << linesPerTile[i]
+        << " lines per tile, last at " << observer->m_Progress << std::endl;
+      ++errors;
+    }
+  }
+
+  std::cout << "Wrong voxels: " << errors << std::endl;
+  return errors ? 1 : 0;
+}
@@ -144,6 +144,39 @@ int main(int argc, char **argv)
     timer.Stop();
     std::cout << "GeneralizedDistanceTransformImageFilter with spacing, with Voronoi map: " 
               << timer.GetMeanTime() << " seconds.\n";
+    std::cout << "  load balance efficiency: "
+              << distance->GetLoadBalanceEfficiency() << ", stolen tiles: "
+              << distance->GetNumberOfStolenTiles() << "\n";
+  }
+
+  // GeneralizedDistanceTransformImageFilter with spacing, with Voronoi map,
+  // tuned for this machine
+  {
+    typedef itk::GeneralizedDistanceTransformImageFilter<FunctionImage, FunctionImage> DTF;
+
+    typedef itk::BinaryThresholdImageFilter<LabelImage, FunctionImage> Threshold;
+    Threshold::Pointer threshold = Threshold::New();
+    threshold->SetInput(img->GetOutput());
+    threshold->SetLowerThreshold(1);
+    threshold->SetUpperThreshold(std::numeric_limits<FunctionImage::PixelType>::max());
+    threshold->SetInsideValue(0);
+    threshold->SetOutsideValue(DTF::GetMaximumApexHeight());
+
+    DTF::Pointer distance = DTF::New();
+    distance->SetInput1(threshold->GetOutput());
+    distance->SetInput2(img->GetOutput());
+
+    // Calibrates if the tuning file has no entry yet, it is not timed
+    distance->Tune();
+    img->Update();
+    itk::TimeProbe timer;
+    timer.Start();
+    distance->Update();
+    timer.Stop();
+    std::cout << "GeneralizedDistanceTransformImageFilter with spacing, with Voronoi map, tuned: "
+              << timer.GetMeanTime() << " seconds.\n";
+    std::cout << "  threads: " << distance->GetTunedNumberOfThreads()
+              << ", lines per tile: " << distance->GetTunedLinesPerTile() << "\n";
   }
 
   // GeneralizedDistanceTransformImageFilter with spacing, without Voronoi map
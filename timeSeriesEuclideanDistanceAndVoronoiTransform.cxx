@@ -0,0 +1,126 @@
+#include <cstdlib>
+
+#include "itkImageFileReader.h"
+#include "itkBinaryThresholdImageFilter.h"
+#include "itkTimeSeriesGeneralizedDistanceTransform.h"
+#include "itkSqrtImageFilter.h"
+#include "itkImageFileWriter.h"
+#include "itkNumericSeriesFileNames.h"
+
+const unsigned int dimension=3;
+typedef short PixelType;
+typedef itk::Image<PixelType, dimension> ImageType;
+
+// The frames are read from and written to numbered files
+class EuclideanTimeSeries :
+  public itk::TimeSeriesGeneralizedDistanceTransform<ImageType, ImageType>
+{
+public:
+  typedef EuclideanTimeSeries Self;
+  typedef itk::TimeSeriesGeneralizedDistanceTransform<ImageType, ImageType> Superclass;
+  typedef itk::SmartPointer<Self> Pointer;
+
+  itkNewMacro(Self);
+
+  std::vector<std::string> InputFileNames;
+  std::vector<std::string> DistanceFileNames;
+  std::vector<std::string> LabelFileNames;
+
+protected:
+  void ReadFrame(unsigned int frame, FunctionImageConstPointer &functionImage,
+      LabelImageConstPointer &labelImage)
+  {
+    typedef itk::ImageFileReader<ImageType> ReaderType;
+    ReaderType::Pointer input = ReaderType::New();
+    input->SetFileName(InputFileNames[frame].c_str());
+
+    // For the label image l, create an indicator image i with
+    // i(x) = (l(x) == 0 ?  infinity : 0).
+    typedef itk::BinaryThresholdImageFilter<ImageType, ImageType> Indicator;
+    Indicator::Pointer indicator = Indicator::New();
+    indicator->SetLowerThreshold(0);
+    indicator->SetUpperThreshold(0);
+    indicator->SetOutsideValue(0);
+    indicator->SetInsideValue(GetMaximumApexHeight());
+    indicator->SetInput(input->GetOutput());
+
+    // Read in this thread
+    indicator->Update();
+    functionImage = indicator->GetOutput();
+    labelImage = input->GetOutput();
+  }
+
+  void WriteFrame(unsigned int frame, ImageType *distance, ImageType *voronoiMap)
+  {
+    // The squared euclidean distance is converted to the regular euclidean
+    // distance
+    typedef itk::SqrtImageFilter<ImageType, ImageType> Sqrt;
+    Sqrt::Pointer sqrt = Sqrt::New();
+    sqrt->SetInput(distance);
+
+    typedef itk::ImageFileWriter<ImageType> Writer;
+    Writer::Pointer writer = Writer::New();
+    writer->SetInput(sqrt->GetOutput());
+    writer->SetFileName(DistanceFileNames[frame].c_str());
+    writer->Update();
+
+    writer->SetInput(voronoiMap);
+    writer->SetFileName(LabelFileNames[frame].c_str());
+    writer->Update();
+  }
+};
+
+std::vector<std::string> fileNames(const char *format, int first, int last)
+{
+  itk::NumericSeriesFileNames::Pointer names = itk::NumericSeriesFileNames::New();
+  names->SetSeriesFormat(format);
+  names->SetStartIndex(first);
+  names->SetEndIndex(last);
+  return names->GetFileNames();
+}
+
+int main(int argc, char *argv[])
+{
+  if (argc != 6 && argc != 7)
+  {
+    std::cerr <<
+      "Compute the euclidean distance transform and Voronoi map of a time\n"
+      "series of images. Reading, computing and writing overlap.\n"
+      "\n"
+      "USAGE: " << argv[0] << " <label images> <first> <last> <distance outputs> <label outputs> [<time spacing>]\n"
+      "  <label images>: printf-like pattern of the file names of the frames,\n"
+      "     e.g. frame%03d.img. Background voxels have label 0.\n"
+      "  <first>, <last>: The numbers of the first and last frame.\n"
+      "  <distance outputs>: Pattern of the images that denote the euclidean\n"
+      "     distance to the closest foreground voxel.\n"
+      "  <label outputs>: Pattern of the images that denote the label of the\n"
+      "     closest foreground voxel.\n"
+      "  <time spacing>: If given, time is a dimension with that spacing.\n"
+      "     Otherwise, the frames are independent.\n";
+    return 1;
+  }
+
+  const int first = atoi(argv[2]);
+  const int last = atoi(argv[3]);
+
+  EuclideanTimeSeries::Pointer series = EuclideanTimeSeries::New();
+  series->InputFileNames = fileNames(argv[1], first, last);
+  series->DistanceFileNames = fileNames(argv[4], first, last);
+  series->LabelFileNames = fileNames(argv[5], first, last);
+  series->SetNumberOfFrames(last - first + 1);
+  if (argc == 7)
+  {
+    series->TimeIsDimensionOn();
+    series->SetTimeSpacing(atof(argv[6]));
+  }
+
+  try
+  {
+    series->Update();
+  }
+  catch (itk::ExceptionObject &e)
+  {
+    std::cerr << e << std::endl;
+    return 1;
+  }
+}